@@ -0,0 +1,123 @@
+/*
+ *  bench_conn_sampler.cpp
+ *
+ *  This file is part of NEST GPU.
+ *
+ *  Copyright (C) 2021 The NEST Initiative
+ *
+ *  NEST GPU is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NEST GPU is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NEST GPU.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// Micro-benchmark of the host-side sampling of source nodes used by
+// the fixed_indegree rule, compared with the previous method, which
+// checked duplicates with lower_bound and insertion in a sorted vector.
+// Usage: bench_conn_sampler [n_source] [indegree] [n_target]
+
+#include "conn_sampler.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+using namespace std;
+
+double
+ElapsedTime( chrono::steady_clock::time_point t0 )
+{
+  return chrono::duration< double >( chrono::steady_clock::now() - t0 ).count();
+}
+
+// previous method: draw, look for the index in a sorted vector and insert it
+void
+SortedInsertSample( mt19937_64& rng, int n, int k, vector< int >& idx_vect )
+{
+  vector< int > sorted_vect;
+  uniform_int_distribution< int > d( 0, n - 1 );
+  for ( int i = 0; i < k; i++ )
+  {
+    vector< int >::iterator iter;
+    int j;
+    do
+    {
+      j = d( rng );
+      iter = lower_bound( sorted_vect.begin(), sorted_vect.end(), j );
+    } while ( iter != sorted_vect.end() && *iter == j );
+    sorted_vect.insert( iter, j );
+    idx_vect.push_back( j );
+  }
+}
+
+int
+main( int argc, char* argv[] )
+{
+  int n_source = 90000; // hpc_benchmark, scale 10, excitatory + inhibitory
+  int indegree = 11250;
+  int n_target = 2000;
+  if ( argc > 1 )
+  {
+    n_source = atoi( argv[ 1 ] );
+  }
+  if ( argc > 2 )
+  {
+    indegree = atoi( argv[ 2 ] );
+  }
+  if ( argc > 3 )
+  {
+    n_target = atoi( argv[ 3 ] );
+  }
+  printf( "n_source: %d\tindegree: %d\tn_target: %d\n", n_source, indegree, n_target );
+
+  vector< int > idx_vect;
+  long long checksum = 0;
+
+  mt19937_64 rng( 1234ULL );
+  chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+  for ( int itn = 0; itn < n_target; itn++ )
+  {
+    idx_vect.clear();
+    SortedInsertSample( rng, n_source, indegree, idx_vect );
+    checksum += idx_vect[ 0 ];
+  }
+  double t_old = ElapsedTime( t0 );
+
+  ConnSampler sampler( 1234ULL );
+  t0 = chrono::steady_clock::now();
+  for ( int itn = 0; itn < n_target; itn++ )
+  {
+    idx_vect.clear();
+    sampler.SampleWithoutReplacement( n_source, indegree, idx_vect, itn % n_source );
+    checksum += idx_vect[ 0 ];
+  }
+  double t_no_multapses = ElapsedTime( t0 );
+
+  t0 = chrono::steady_clock::now();
+  for ( int itn = 0; itn < n_target; itn++ )
+  {
+    idx_vect.clear();
+    sampler.SampleWithReplacement( n_source, indegree, idx_vect, itn % n_source );
+    checksum += idx_vect[ 0 ];
+  }
+  double t_multapses = ElapsedTime( t0 );
+
+  double n_conn = ( double ) indegree * n_target;
+  printf( "sorted vector insertion:  %8.3f s\t%8.2f ns/connection\n", t_old, t_old / n_conn * 1.0e9 );
+  printf( "without multapses:        %8.3f s\t%8.2f ns/connection\n", t_no_multapses, t_no_multapses / n_conn * 1.0e9 );
+  printf( "with multapses:           %8.3f s\t%8.2f ns/connection\n", t_multapses, t_multapses / n_conn * 1.0e9 );
+  printf( "checksum: %lld\n", checksum );
+
+  return 0;
+}
@@ -0,0 +1,157 @@
+/*
+ *  bench_spatial_pairwise.cpp
+ *
+ *  This file is part of NEST GPU.
+ *
+ *  Copyright (C) 2021 The NEST Initiative
+ *
+ *  NEST GPU is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NEST GPU is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NEST GPU.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// Benchmark of the host-side sampling of the spatial_pairwise rule.
+// n_node nodes are placed at random in a periodic unit square and
+// connected with a gaussian kernel, with sigma chosen so that the
+// expected indegree is close to the value given as argument.
+// The cell list is compared with a scan of all the sources, and the
+// candidates found by the two methods are checked to be the same.
+// Usage: bench_spatial_pairwise [n_node] [indegree] [n_target]
+
+#include "spatial.h"
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+using namespace std;
+
+double
+ElapsedTime( chrono::steady_clock::time_point t0 )
+{
+  return chrono::duration< double >( chrono::steady_clock::now() - t0 ).count();
+}
+
+int
+main( int argc, char* argv[] )
+{
+  int n_node = 1000000;
+  int indegree = 100;
+  int n_target = 100000;
+  if ( argc > 1 )
+  {
+    n_node = atoi( argv[ 1 ] );
+  }
+  if ( argc > 2 )
+  {
+    indegree = atoi( argv[ 2 ] );
+  }
+  if ( argc > 3 )
+  {
+    n_target = atoi( argv[ 3 ] );
+  }
+  if ( n_target > n_node )
+  {
+    n_target = n_node;
+  }
+  // the integral of the gaussian kernel over the plane is 2*pi*sigma^2
+  float sigma = sqrt( indegree / ( 2.0 * M_PI * n_node ) );
+  printf( "n_node: %d\tindegree: %d\tn_target: %d\tsigma: %g\n", n_node, indegree, n_target, sigma );
+
+  ConnSampler sampler( 1234ULL );
+  vector< float > pos( 2 * ( size_t ) n_node );
+  for ( size_t i = 0; i < pos.size(); i++ )
+  {
+    pos[ i ] = 1.0 - sampler.Uniform();
+  }
+  SpatialExtent ext;
+  ext.n_dim_ = 2;
+  ext.lower_left_[ 0 ] = ext.lower_left_[ 1 ] = 0.0;
+  ext.extent_[ 0 ] = ext.extent_[ 1 ] = 1.0;
+  ext.periodic_ = true;
+
+  SpatialKernel kernel;
+  kernel.kernel_idx_ = KERNEL_GAUSSIAN;
+  kernel.SetParam( "sigma", sigma );
+
+  chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+  SpatialGrid grid( ext, kernel.Cutoff() );
+  grid.Build( pos.data(), n_node );
+  double t_build = ElapsedTime( t0 );
+
+  vector< int > idx_vect;
+  size_t n_conn = 0;
+  t0 = chrono::steady_clock::now();
+  for ( int itn = 0; itn < n_target; itn++ )
+  {
+    idx_vect.clear();
+    n_conn += grid.SamplePairwise( &pos[ 2 * ( size_t ) itn ], kernel, sampler, idx_vect );
+  }
+  double t_grid = ElapsedTime( t0 );
+
+  // scan of all the sources, on a few targets only
+  int n_target_scan = n_target < 100 ? n_target : 100;
+  size_t n_conn_scan = 0;
+  t0 = chrono::steady_clock::now();
+  for ( int itn = 0; itn < n_target_scan; itn++ )
+  {
+    for ( int isn = 0; isn < n_node; isn++ )
+    {
+      double d2 = grid.Dist2( &pos[ 2 * ( size_t ) itn ], &pos[ 2 * ( size_t ) isn ] );
+      if ( sampler.Uniform() <= kernel.Prob( d2 ) )
+      {
+        n_conn_scan++;
+      }
+    }
+  }
+  double t_scan = ElapsedTime( t0 ) / n_target_scan * n_target;
+
+  // with a constant kernel the candidates within the cutoff
+  // are all connected, so the two methods must give the same result
+  SpatialKernel step_kernel;
+  step_kernel.SetParam( "cutoff", kernel.Cutoff() );
+  double cutoff2 = ( double ) kernel.Cutoff() * kernel.Cutoff();
+  for ( int itn = 0; itn < n_target_scan; itn++ )
+  {
+    idx_vect.clear();
+    size_t n_grid = grid.SamplePairwise( &pos[ 2 * ( size_t ) itn ], step_kernel, sampler, idx_vect );
+    size_t n_scan = 0;
+    for ( int isn = 0; isn < n_node; isn++ )
+    {
+      if ( grid.Dist2( &pos[ 2 * ( size_t ) itn ], &pos[ 2 * ( size_t ) isn ] ) <= cutoff2 )
+      {
+        n_scan++;
+      }
+    }
+    if ( n_grid != n_scan )
+    {
+      printf( "Cell list and scan give different candidates for target %d: %zu vs %zu\n", itn, n_grid, n_scan );
+      return 1;
+    }
+  }
+
+  // expected indegree with the gaussian truncated at 4 sigma,
+  // plus the target itself, since autapses are not excluded here
+  double exp_indegree = indegree * ( 1.0 - exp( -8.0 ) ) + 1.0;
+  printf( "mean indegree: cell list %g\tscan %g\texpected %g\n",
+    ( double ) n_conn / n_target,
+    ( double ) n_conn_scan / n_target_scan,
+    exp_indegree );
+  printf( "cell list build:          %8.3f s\n", t_build );
+  printf( "cell list sampling:       %8.3f s\t%8.2f ns/connection\n", t_grid, t_grid / n_conn * 1.0e9 );
+  printf( "scan of all sources:      %8.3f s (estimated from %d targets)\n", t_scan, n_target_scan );
+
+  return 0;
+}
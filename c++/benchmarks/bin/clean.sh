@@ -0,0 +1,2 @@
+rm -f bench_conn_sampler
+rm -f bench_spatial_pairwise
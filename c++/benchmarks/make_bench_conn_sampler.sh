@@ -0,0 +1 @@
+g++ -Wall -O3 -I ../../src -o bin/bench_conn_sampler bench_conn_sampler.cpp ../../src/conn_sampler.cpp -lm
@@ -0,0 +1 @@
+g++ -Wall -O3 -I ../../src -o bin/bench_spatial_pairwise bench_spatial_pairwise.cpp ../../src/spatial.cpp ../../src/conn_sampler.cpp -lm
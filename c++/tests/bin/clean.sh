@@ -7,3 +7,8 @@ rm -f test_neuron_groups_spikes.dat
 rm -f test_neuron_groups_voltage.dat
 rm -f test_connections
 rm -f test_neuron_groups
+rm -f test_pairwise_bernoulli
+rm -f test_conn_sampler
+rm -f test_syn_distribution
+rm -f test_spatial
+rm -f test_jit_source
@@ -0,0 +1 @@
+g++ -Wall -O2 -I ../../src -o bin/test_conn_sampler test_conn_sampler.cpp ../../src/conn_sampler.cpp -lm
@@ -0,0 +1 @@
+g++ -Wall -O2 -I ../../src -o bin/test_jit_source test_jit_source.cpp ../../src/jit_source.cpp -lm
@@ -0,0 +1 @@
+g++ -Wall -O2 -I ../../src -o bin/test_pairwise_bernoulli test_pairwise_bernoulli.cpp ../../src/conn_sampler.cpp -lm
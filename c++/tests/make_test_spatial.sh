@@ -0,0 +1 @@
+g++ -Wall -O2 -I ../../src -o bin/test_spatial test_spatial.cpp ../../src/spatial.cpp ../../src/conn_sampler.cpp -lm
@@ -0,0 +1 @@
+g++ -Wall -O2 -I ../../src -o bin/test_syn_distribution test_syn_distribution.cpp ../../src/distribution.cpp -lm
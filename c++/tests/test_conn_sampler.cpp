@@ -0,0 +1,133 @@
+/*
+ *  test_conn_sampler.cpp
+ *
+ *  This file is part of NEST GPU.
+ *
+ *  Copyright (C) 2021 The NEST Initiative
+ *
+ *  NEST GPU is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NEST GPU is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NEST GPU.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// Test of the sampling used by the fixed_indegree and fixed_outdegree
+// connection rules with the allow_autapses and allow_multapses flags.
+// It runs on the host only.
+
+#include "conn_sampler.h"
+#include <cmath>
+#include <iostream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+using namespace std;
+
+// draws n_rep samples of k indexes from [0, n), checks that the excluded
+// index is never selected, that without replacement all indexes are
+// distinct, and that each allowed index is selected uniformly
+int
+TestSampling( ConnSampler& sampler, int n, int k, int n_rep, bool multapses, int i_excl )
+{
+  vector< int > idx_vect;
+  vector< int > count( n, 0 );
+  vector< int > last_rep( n, -1 );
+  for ( int i_rep = 0; i_rep < n_rep; i_rep++ )
+  {
+    idx_vect.clear();
+    if ( multapses )
+    {
+      sampler.SampleWithReplacement( n, k, idx_vect, i_excl );
+    }
+    else
+    {
+      sampler.SampleWithoutReplacement( n, k, idx_vect, i_excl );
+    }
+    if ( ( int ) idx_vect.size() != k )
+    {
+      cout << "Wrong number of sampled indexes\n";
+      return 1;
+    }
+    for ( int i = 0; i < k; i++ )
+    {
+      int idx = idx_vect[ i ];
+      if ( idx < 0 || idx >= n || idx == i_excl )
+      {
+        cout << "Sampled index out of range or excluded: " << idx << "\n";
+        return 1;
+      }
+      if ( !multapses && last_rep[ idx ] == i_rep )
+      {
+        cout << "Duplicate index in sample without replacement: " << idx << "\n";
+        return 1;
+      }
+      last_rep[ idx ] = i_rep;
+      count[ idx ]++;
+    }
+  }
+  int m = ( i_excl >= 0 ) ? n - 1 : n;
+  double exp_count = ( double ) n_rep * k / m;
+  // binomial variance of the counts, with k*n_rep trials of probability 1/m
+  // with replacement, or n_rep trials of probability k/m without replacement
+  double exp_var = multapses ? exp_count * ( 1.0 - 1.0 / m ) : exp_count * ( 1.0 - ( double ) k / m );
+  double chi2 = 0;
+  for ( int i = 0; i < n; i++ )
+  {
+    if ( i != i_excl )
+    {
+      double d = count[ i ] - exp_count;
+      chi2 += d * d / exp_var;
+    }
+  }
+  printf( "n: %d\tk: %d\tmultapses: %d\texcluded: %d\tchi2: %g (expected %d +- %g)\n",
+    n,
+    k,
+    ( int ) multapses,
+    i_excl,
+    chi2,
+    m,
+    sqrt( 2.0 * m ) );
+  if ( fabs( chi2 - m ) > 5.0 * sqrt( 2.0 * m ) )
+  {
+    cout << "Sampled indexes are not uniformly distributed\n";
+    return 1;
+  }
+
+  return 0;
+}
+
+int
+main( int argc, char* argv[] )
+{
+  ConnSampler sampler( 1234ULL );
+  int ret = 0;
+  // sparse samples (Floyd's algorithm)
+  ret |= TestSampling( sampler, 1000, 100, 10000, false, -1 );
+  ret |= TestSampling( sampler, 1000, 100, 10000, false, 17 );
+  // dense samples (partial Fisher-Yates shuffle)
+  ret |= TestSampling( sampler, 200, 150, 10000, false, -1 );
+  ret |= TestSampling( sampler, 200, 190, 10000, false, 0 );
+  ret |= TestSampling( sampler, 200, 190, 10000, false, 199 );
+  // samples with replacement
+  ret |= TestSampling( sampler, 1000, 100, 10000, true, -1 );
+  ret |= TestSampling( sampler, 10, 100, 10000, true, 5 );
+
+  if ( ret != 0 )
+  {
+    cout << "TEST NOT PASSED\n";
+    return 1;
+  }
+  cout << "TEST PASSED\n";
+
+  return 0;
+}
@@ -0,0 +1,193 @@
+/*
+ *  test_jit_source.cpp
+ *
+ *  This file is part of NEST GPU.
+ *
+ *  Copyright (C) 2021 The NEST Initiative
+ *
+ *  NEST GPU is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NEST GPU is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NEST GPU.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// Test of the source generation and of the on-disk cache of the
+// kernels compiled at run time. It runs on the host only.
+
+#include "jit_source.h"
+#include <cmath>
+#include <iostream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+using namespace std;
+
+// checks that the float literals are converted back to the same value
+int
+TestFloatLiteral()
+{
+  float val_arr[] = { 0.0, -70.0, 0.1, 1.0 / 3.0, 9.04837418e-01, 1.0e-38, 3.4e38, -2.5e-3 };
+  int n_val = sizeof( val_arr ) / sizeof( float );
+  for ( int i = 0; i < n_val; i++ )
+  {
+    string lit = JitFloatLiteral( val_arr[ i ] );
+    // literal has the form (<val>f)
+    float val = strtof( lit.c_str() + 1, NULL );
+    if ( val != val_arr[ i ] )
+    {
+      printf( "float literal %s differs from %.9g\n", lit.c_str(), val_arr[ i ] );
+      return 1;
+    }
+  }
+  if ( JitFloatLiteral( INFINITY ).find( "__int_as_float" ) == string::npos )
+  {
+    printf( "wrong literal for infinity\n" );
+    return 1;
+  }
+
+  return 0;
+}
+
+JitSource
+TestKernelSource( float tau, float I_e )
+{
+  JitSource jit_source( "test_jit_Update", 2, 3 );
+  jit_source.AddVar( "V_m", 0 );
+  jit_source.AddVar( "I_syn", 1 );
+  jit_source.AddConst( "tau", tau );
+  jit_source.AddParam( "I_e", 1 );
+  jit_source.AddConst( "I_e_c", I_e );
+  jit_source.SetBody( "    V_m += I_syn / tau + I_e + I_e_c;\n" );
+
+  return jit_source;
+}
+
+// checks the macros and the signature of the generated kernel
+int
+TestSource()
+{
+  string src = TestKernelSource( 10.0, 0.0 ).Source();
+  const char* expected_arr[] = { "#define N_VAR 2\n",
+    "#define N_PARAM 3\n",
+    "#define V_m var[ 0 ]\n",
+    "#define I_syn var[ 1 ]\n",
+    "#define tau (1.00000000e+01f)\n",
+    "#define I_e param[ 1 ]\n",
+    "extern \"C\" __global__ void\ntest_jit_Update( int n_node, float* var_arr, float* param_arr, int* spike_idx, "
+    "int* n_spike )\n",
+    "    V_m += I_syn / tau + I_e + I_e_c;\n" };
+  for ( unsigned int i = 0; i < sizeof( expected_arr ) / sizeof( char* ); i++ )
+  {
+    if ( src.find( expected_arr[ i ] ) == string::npos )
+    {
+      printf( "generated source does not contain:\n%s\nsource:\n%s\n", expected_arr[ i ], src.c_str() );
+      return 1;
+    }
+  }
+
+  return 0;
+}
+
+// checks that the key changes with the constants and the options
+int
+TestKey()
+{
+  vector< string > opt1( 1, "--gpu-architecture=sm_80" );
+  vector< string > opt2( 1, "--gpu-architecture=sm_90" );
+  string key = JitKey( TestKernelSource( 10.0, 0.0 ).Source(), opt1 );
+  if ( key.size() != 16 || key != JitKey( TestKernelSource( 10.0, 0.0 ).Source(), opt1 ) )
+  {
+    printf( "key is not reproducible\n" );
+    return 1;
+  }
+  if ( key == JitKey( TestKernelSource( 10.0, 1.0e-7 ).Source(), opt1 )
+    || key == JitKey( TestKernelSource( 10.0, 0.0 ).Source(), opt2 ) )
+  {
+    printf( "key does not depend on constants or options\n" );
+    return 1;
+  }
+
+  return 0;
+}
+
+// stores and loads a binary image in a new cache directory
+int
+TestCache()
+{
+  char tmp_dir[] = "/tmp/test_jit_cacheXXXXXX";
+  if ( mkdtemp( tmp_dir ) == NULL )
+  {
+    printf( "cannot create temporary directory\n" );
+    return 1;
+  }
+  string dir = string( tmp_dir ) + "/a/b";
+  setenv( "NESTGPU_JIT_CACHE_DIR", dir.c_str(), 1 );
+  JitCache cache;
+  if ( cache.Dir() != dir )
+  {
+    printf( "cache directory %s, expected %s\n", cache.Dir().c_str(), dir.c_str() );
+    return 1;
+  }
+  string key = JitKey( TestKernelSource( 10.0, 0.0 ).Source(), vector< string >() );
+  string image;
+  if ( cache.Load( key, image ) )
+  {
+    printf( "module found in empty cache\n" );
+    return 1;
+  }
+  string stored_image( "\x7f"
+                       "ELF\0\0\x01",
+    7 );
+  for ( int i = 0; i < 100000; i++ )
+  {
+    stored_image += ( char ) ( i % 256 );
+  }
+  if ( cache.Store( key, stored_image ) != 0 )
+  {
+    printf( "cannot store module in %s\n", cache.Path( key ).c_str() );
+    return 1;
+  }
+  // a new cache object, as in a new run
+  JitCache cache2;
+  if ( !cache2.Load( key, image ) || image != stored_image )
+  {
+    printf( "loaded module differs from stored one\n" );
+    return 1;
+  }
+  remove( cache.Path( key ).c_str() );
+  rmdir( dir.c_str() );
+  rmdir( ( string( tmp_dir ) + "/a" ).c_str() );
+  rmdir( tmp_dir );
+
+  return 0;
+}
+
+int
+main( int argc, char* argv[] )
+{
+  int ret = TestFloatLiteral();
+  ret |= TestSource();
+  ret |= TestKey();
+  ret |= TestCache();
+
+  if ( ret != 0 )
+  {
+    cout << "TEST NOT PASSED\n";
+    return 1;
+  }
+  cout << "TEST PASSED\n";
+
+  return 0;
+}
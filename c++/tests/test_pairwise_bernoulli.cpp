@@ -0,0 +1,126 @@
+/*
+ *  test_pairwise_bernoulli.cpp
+ *
+ *  This file is part of NEST GPU.
+ *
+ *  Copyright (C) 2021 The NEST Initiative
+ *
+ *  NEST GPU is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NEST GPU is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NEST GPU.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// Statistical test of the geometric-skip sampling used by the
+// pairwise_bernoulli connection rule. It runs on the host only.
+
+#include "conn_sampler.h"
+#include <cmath>
+#include <iostream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+using namespace std;
+
+// checks the indegree distribution against the binomial distribution B(n, p)
+// and the frequency with which each source is selected against n_target*p
+int
+TestBernoulli( ConnSampler& sampler, int n_source, int n_target, double p )
+{
+  vector< int > idx_vect;
+  vector< int > source_count( n_source, 0 );
+  double sum = 0;
+  double sum2 = 0;
+  for ( int itn = 0; itn < n_target; itn++ )
+  {
+    idx_vect.clear();
+    int n_sel = sampler.BernoulliSkip( n_source, p, idx_vect );
+    if ( n_sel != ( int ) idx_vect.size() )
+    {
+      cout << "Wrong number of selected indexes\n";
+      return 1;
+    }
+    for ( int i = 0; i < n_sel; i++ )
+    {
+      int isn = idx_vect[ i ];
+      if ( isn < 0 || isn >= n_source || ( i > 0 && isn <= idx_vect[ i - 1 ] ) )
+      {
+        cout << "Selected indexes out of range or not strictly increasing\n";
+        return 1;
+      }
+      source_count[ isn ]++;
+    }
+    sum += n_sel;
+    sum2 += ( double ) n_sel * n_sel;
+  }
+  double mean = sum / n_target;
+  double var = sum2 / n_target - mean * mean;
+  double exp_mean = n_source * p;
+  double exp_var = n_source * p * ( 1.0 - p );
+  // standard error of the sample mean and (approximately) of the variance
+  double mean_tol = 5.0 * sqrt( exp_var / n_target ) + 1.0e-9;
+  double var_tol = 5.0 * exp_var * sqrt( 2.0 / ( n_target - 1 ) ) + 1.0e-9;
+
+  // chi-square test of uniformity of the selected sources
+  double exp_count = n_target * p;
+  double chi2 = 0;
+  if ( p > 0.0 && p < 1.0 )
+  {
+    for ( int isn = 0; isn < n_source; isn++ )
+    {
+      double d = source_count[ isn ] - exp_count;
+      chi2 += d * d / ( exp_count * ( 1.0 - p ) );
+    }
+  }
+  // chi2 has n_source degrees of freedom, mean n_source, std sqrt(2 n_source)
+  double chi2_tol = 5.0 * sqrt( 2.0 * n_source );
+
+  printf( "n_source: %d\tn_target: %d\tp: %g\n", n_source, n_target, p );
+  printf( "  indegree mean: %g (expected %g)\tvariance: %g (expected %g)\n", mean, exp_mean, var, exp_var );
+  printf( "  chi2: %g (expected %d +- %g)\n", chi2, n_source, chi2_tol / 5.0 );
+
+  if ( fabs( mean - exp_mean ) > mean_tol || fabs( var - exp_var ) > var_tol )
+  {
+    cout << "Indegree distribution does not match the binomial distribution\n";
+    return 1;
+  }
+  if ( p > 0.0 && p < 1.0 && fabs( chi2 - n_source ) > chi2_tol )
+  {
+    cout << "Selected sources are not uniformly distributed\n";
+    return 1;
+  }
+
+  return 0;
+}
+
+int
+main( int argc, char* argv[] )
+{
+  ConnSampler sampler( 1234ULL );
+  int ret = 0;
+  ret |= TestBernoulli( sampler, 1000, 10000, 0.1 );
+  ret |= TestBernoulli( sampler, 100, 20000, 0.5 );
+  ret |= TestBernoulli( sampler, 100000, 1000, 0.001 );
+  ret |= TestBernoulli( sampler, 500, 10000, 0.95 );
+  ret |= TestBernoulli( sampler, 200, 1000, 0.0 );
+  ret |= TestBernoulli( sampler, 200, 1000, 1.0 );
+
+  if ( ret != 0 )
+  {
+    cout << "TEST NOT PASSED\n";
+    return 1;
+  }
+  cout << "TEST PASSED\n";
+
+  return 0;
+}
@@ -0,0 +1,175 @@
+/*
+ *  test_spatial.cpp
+ *
+ *  This file is part of NEST GPU.
+ *
+ *  Copyright (C) 2021 The NEST Initiative
+ *
+ *  NEST GPU is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NEST GPU is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NEST GPU.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// Test of the cell list used by the spatial_pairwise connection rule.
+// It runs on the host only.
+
+#include "spatial.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <stdio.h>
+#include <vector>
+
+using namespace std;
+
+// checks that with a constant kernel with p=1 the cell list selects
+// exactly the points within the cutoff, found by a scan of all points
+int
+TestCandidates( ConnSampler& sampler, int n_dim, bool periodic, float cutoff, int n_point )
+{
+  SpatialExtent ext;
+  ext.n_dim_ = n_dim;
+  for ( int i_dim = 0; i_dim < n_dim; i_dim++ )
+  {
+    ext.lower_left_[ i_dim ] = -1.0;
+    ext.extent_[ i_dim ] = 2.0 + i_dim;
+  }
+  ext.periodic_ = periodic;
+  vector< float > pos( n_point * n_dim );
+  for ( int i = 0; i < n_point; i++ )
+  {
+    for ( int i_dim = 0; i_dim < n_dim; i_dim++ )
+    {
+      pos[ i * n_dim + i_dim ] = ext.lower_left_[ i_dim ] + ext.extent_[ i_dim ] * ( 1.0 - sampler.Uniform() );
+    }
+  }
+  SpatialKernel kernel;
+  kernel.SetParam( "cutoff", cutoff );
+  SpatialGrid grid( ext, kernel.Cutoff() );
+  grid.Build( pos.data(), n_point );
+
+  vector< int > idx_vect;
+  for ( int itn = 0; itn < n_point; itn++ )
+  {
+    idx_vect.clear();
+    grid.SamplePairwise( &pos[ itn * n_dim ], kernel, sampler, idx_vect );
+    sort( idx_vect.begin(), idx_vect.end() );
+    vector< int > scan_vect;
+    for ( int isn = 0; isn < n_point; isn++ )
+    {
+      if ( grid.Dist2( &pos[ itn * n_dim ], &pos[ isn * n_dim ] ) <= ( double ) cutoff * cutoff )
+      {
+        scan_vect.push_back( isn );
+      }
+    }
+    if ( idx_vect != scan_vect )
+    {
+      printf( "n_dim: %d\tperiodic: %d\tcutoff: %g\ttarget %d: %d selected points, %d expected\n",
+        n_dim,
+        ( int ) periodic,
+        cutoff,
+        itn,
+        ( int ) idx_vect.size(),
+        ( int ) scan_vect.size() );
+      return 1;
+    }
+  }
+
+  return 0;
+}
+
+// checks the mean number of connections of a gaussian kernel on a regular
+// periodic 2D lattice against the sum of the connection probabilities
+int
+TestGaussianIndegree( ConnSampler& sampler )
+{
+  int n_side = 100;
+  float sigma = 3.0;
+  SpatialExtent ext;
+  ext.n_dim_ = 2;
+  ext.lower_left_[ 0 ] = ext.lower_left_[ 1 ] = 0.0;
+  ext.extent_[ 0 ] = ext.extent_[ 1 ] = n_side;
+  ext.periodic_ = true;
+  vector< float > pos;
+  for ( int ix = 0; ix < n_side; ix++ )
+  {
+    for ( int iy = 0; iy < n_side; iy++ )
+    {
+      pos.push_back( ix );
+      pos.push_back( iy );
+    }
+  }
+  int n_point = n_side * n_side;
+  SpatialKernel kernel;
+  kernel.kernel_idx_ = KERNEL_GAUSSIAN;
+  kernel.SetParam( "p", 0.5 );
+  kernel.SetParam( "sigma", sigma );
+  SpatialGrid grid( ext, kernel.Cutoff() );
+  grid.Build( pos.data(), n_point );
+
+  double exp_indegree = 0;
+  double cutoff2 = ( double ) kernel.Cutoff() * kernel.Cutoff();
+  for ( int isn = 0; isn < n_point; isn++ )
+  {
+    double d2 = grid.Dist2( &pos[ 0 ], &pos[ 2 * isn ] );
+    if ( d2 <= cutoff2 )
+    {
+      exp_indegree += kernel.Prob( d2 );
+    }
+  }
+  vector< int > idx_vect;
+  for ( int itn = 0; itn < n_point; itn++ )
+  {
+    grid.SamplePairwise( &pos[ 2 * itn ], kernel, sampler, idx_vect );
+  }
+  double indegree = ( double ) idx_vect.size() / n_point;
+  // the number of connections is a sum of independent Bernoulli variables
+  double sigma_indegree = sqrt( exp_indegree / n_point );
+  printf( "gaussian kernel mean indegree: %g (expected %g +- %g)\n", indegree, exp_indegree, sigma_indegree );
+  if ( fabs( indegree - exp_indegree ) > 5.0 * sigma_indegree )
+  {
+    cout << "Wrong mean indegree\n";
+    return 1;
+  }
+
+  return 0;
+}
+
+int
+main( int argc, char* argv[] )
+{
+  ConnSampler sampler( 1234ULL );
+  int ret = 0;
+  for ( int n_dim = 1; n_dim <= 3; n_dim++ )
+  {
+    for ( int periodic = 0; periodic <= 1; periodic++ )
+    {
+      // many cells per dimension
+      ret |= TestCandidates( sampler, n_dim, periodic, 0.3, 2000 );
+      // less than four cells per dimension
+      ret |= TestCandidates( sampler, n_dim, periodic, 0.8, 500 );
+      // cutoff larger than the extent
+      ret |= TestCandidates( sampler, n_dim, periodic, 5.0, 200 );
+    }
+  }
+  ret |= TestGaussianIndegree( sampler );
+
+  if ( ret != 0 )
+  {
+    cout << "TEST NOT PASSED\n";
+    return 1;
+  }
+  cout << "TEST PASSED\n";
+
+  return 0;
+}
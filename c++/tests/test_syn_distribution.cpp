@@ -0,0 +1,126 @@
+/*
+ *  test_syn_distribution.cpp
+ *
+ *  This file is part of NEST GPU.
+ *
+ *  Copyright (C) 2021 The NEST Initiative
+ *
+ *  NEST GPU is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NEST GPU is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NEST GPU.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// Test of the distributions of weights and delays evaluated for each
+// connection during the execution of connection rules.
+// It runs on the host only.
+
+#include "distribution.h"
+#include <cmath>
+#include <iostream>
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace std;
+
+const int n_conn = 1000000;
+
+// compares sample mean and variance with the expected values,
+// checks the range and that values are reproducible from the seed
+int
+TestDistribution( Distribution& distr, double exp_mean, double exp_var, double vmin, double vmax )
+{
+  distr.SetSeed( 1234ULL );
+  double sum = 0;
+  double sum2 = 0;
+  for ( int i = 0; i < n_conn; i++ )
+  {
+    double x = distr.Value( i );
+    if ( x < vmin || x > vmax )
+    {
+      cout << "Value out of range: " << x << "\n";
+      return 1;
+    }
+    sum += x;
+    sum2 += x * x;
+  }
+  double mean = sum / n_conn;
+  double var = sum2 / n_conn - mean * mean;
+  printf( "%s\tmean: %g (expected %g)\tvariance: %g (expected %g)\n",
+    distribution_name[ distr.distr_idx_ ].c_str(),
+    mean,
+    exp_mean,
+    var,
+    exp_var );
+  // the tolerance on the variance is loose, to accept heavy tails
+  if ( fabs( mean - exp_mean ) > 5.0 * sqrt( exp_var / n_conn ) || fabs( var - exp_var ) > 0.02 * exp_var )
+  {
+    cout << "Sample moments do not match the distribution\n";
+    return 1;
+  }
+  // each value is a function of the seed and of the connection index only
+  float x1 = distr.Value( 12345 );
+  distr.SetSeed( 4321ULL );
+  float x2 = distr.Value( 12345 );
+  distr.SetSeed( 1234ULL );
+  if ( distr.Value( 12345 ) != x1 || x1 == x2 )
+  {
+    cout << "Values are not reproducible from the seed\n";
+    return 1;
+  }
+
+  return 0;
+}
+
+int
+main( int argc, char* argv[] )
+{
+  int ret = 0;
+  Distribution distr;
+
+  distr.SetType( DISTR_NORMAL );
+  distr.SetParam( "mu", 0.5 );
+  distr.SetParam( "sigma", 0.2 );
+  ret |= TestDistribution( distr, 0.5, 0.04, -1.0e30, 1.0e30 );
+
+  // normal distribution clipped at mu +- sigma
+  distr.SetType( DISTR_NORMAL_CLIPPED );
+  distr.SetParam( "low", 0.3 );
+  distr.SetParam( "high", 0.7 );
+  ret |= TestDistribution( distr, 0.5, 0.04 * 0.291125, 0.3, 0.7 );
+
+  distr.Init();
+  distr.SetType( DISTR_LOGNORMAL );
+  distr.SetParam( "mu", 0.0 );
+  distr.SetParam( "sigma", 0.5 );
+  ret |= TestDistribution( distr, exp( 0.125 ), ( exp( 0.25 ) - 1.0 ) * exp( 0.25 ), 0.0, 1.0e30 );
+
+  distr.Init();
+  distr.SetType( DISTR_UNIFORM );
+  distr.SetParam( "low", 1.0 );
+  distr.SetParam( "high", 3.0 );
+  ret |= TestDistribution( distr, 2.0, 4.0 / 12.0, 1.0, 3.0 );
+
+  distr.Init();
+  distr.SetType( DISTR_EXPONENTIAL );
+  distr.SetParam( "beta", 2.0 );
+  ret |= TestDistribution( distr, 2.0, 4.0, 0.0, 1.0e30 );
+
+  if ( ret != 0 )
+  {
+    cout << "TEST NOT PASSED\n";
+    return 1;
+  }
+  cout << "TEST PASSED\n";
+
+  return 0;
+}
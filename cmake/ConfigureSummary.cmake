@@ -79,6 +79,18 @@ function( NEST_PRINT_CONFIG_SUMMARY )
     message( "Use MPI             : No" )
   endif ()
 
+  if ( HAVE_NVRTC )
+    message( "Use NVRTC           : Yes (run-time compilation of neuron update kernels)" )
+  else ()
+    message( "Use NVRTC           : No" )
+  endif ()
+
+  if ( HAVE_OPENMP )
+    message( "Use OpenMP          : Yes (${OpenMP_CXX_FLAGS})" )
+  else ()
+    message( "Use OpenMP          : No" )
+  endif ()
+
   if ( with-libraries )
     message( "" )
     message( "Additional libraries:" )
@@ -56,6 +56,31 @@ function( NEST_PROCESS_WITH_MPI )
 endfunction()
 
 
+function( NESTGPU_PROCESS_WITH_NVRTC )
+  # NVRTC and the CUDA driver API are used to compile neuron update kernels at run time
+  set( HAVE_NVRTC OFF PARENT_SCOPE )
+  if ( with-nvrtc )
+    find_package( CUDAToolkit )
+    if ( TARGET CUDA::nvrtc AND TARGET CUDA::cuda_driver )
+      set( HAVE_NVRTC ON PARENT_SCOPE )
+    endif ()
+  endif ()
+endfunction ()
+
+
+function( NESTGPU_PROCESS_WITH_OPENMP )
+  # OpenMP is used in host code, e.g. to sort the spike events of spike generators
+  set( HAVE_OPENMP OFF PARENT_SCOPE )
+  if ( with-openmp )
+    find_package( OpenMP )
+    if ( OpenMP_CXX_FOUND )
+      set( HAVE_OPENMP ON PARENT_SCOPE )
+      set( OpenMP_CXX_FLAGS "${OpenMP_CXX_FLAGS}" PARENT_SCOPE )
+    endif ()
+  endif ()
+endfunction ()
+
+
 function( NESTGPU_PROCESS_CUDA_ARCH )
   set( CMAKE_CUDA_ARCHITECTURES ${with-gpu-arch} PARENT_SCOPE )
 endfunction ()
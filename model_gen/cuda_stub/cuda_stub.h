@@ -0,0 +1,178 @@
+/*
+ *  cuda_stub.h
+ *
+ *  This file is part of NEST GPU.
+ *
+ *  Copyright (C) 2021 The NEST Initiative
+ *
+ *  NEST GPU is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NEST GPU is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NEST GPU.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+// Minimal declarations of the CUDA runtime, used by test_model_gen.sh
+// to check the syntax of the generated sources with the host compiler
+// when nvcc is not available. Kernel launches are removed from the
+// sources before the check, device functions are compiled as host code.
+
+#ifndef CUDASTUB_H
+#define CUDASTUB_H
+
+#include <cstddef>
+#include <math.h>
+
+#define __global__
+#define __device__
+#define __host__
+#define __constant__
+#define __shared__
+#define __forceinline__ inline
+
+struct uint3
+{
+  unsigned int x, y, z;
+};
+struct dim3
+{
+  unsigned int x, y, z;
+  dim3( unsigned int x = 1, unsigned int y = 1, unsigned int z = 1 )
+    : x( x )
+    , y( y )
+    , z( z )
+  {
+  }
+};
+static uint3 threadIdx, blockIdx;
+static dim3 blockDim, gridDim;
+static const int warpSize = 32;
+
+enum cudaError_t
+{
+  cudaSuccess = 0,
+  cudaErrorUnknown
+};
+enum cudaMemcpyKind
+{
+  cudaMemcpyHostToHost,
+  cudaMemcpyHostToDevice,
+  cudaMemcpyDeviceToHost,
+  cudaMemcpyDeviceToDevice,
+  cudaMemcpyDefault
+};
+enum cudaDeviceAttr
+{
+  cudaDevAttrComputeCapabilityMajor,
+  cudaDevAttrComputeCapabilityMinor
+};
+typedef struct CUstream_st* cudaStream_t;
+typedef struct CUevent_st* cudaEvent_t;
+#define cudaStreamNonBlocking 0x01
+#define cudaEventDisableTiming 0x02
+
+const char* cudaGetErrorString( cudaError_t );
+cudaError_t cudaGetLastError();
+cudaError_t cudaPeekAtLastError();
+cudaError_t cudaDeviceSynchronize();
+cudaError_t cudaGetDevice( int* );
+cudaError_t cudaSetDevice( int );
+cudaError_t cudaGetDeviceCount( int* );
+cudaError_t cudaDeviceGetAttribute( int*, cudaDeviceAttr, int );
+cudaError_t cudaMalloc( void**, size_t );
+cudaError_t cudaMallocHost( void**, size_t );
+cudaError_t cudaFree( void* );
+cudaError_t cudaFreeHost( void* );
+cudaError_t cudaMemset( void*, int, size_t );
+cudaError_t cudaMemsetAsync( void*, int, size_t, cudaStream_t = 0 );
+cudaError_t cudaMemcpy( void*, const void*, size_t, cudaMemcpyKind );
+cudaError_t cudaMemcpyAsync( void*, const void*, size_t, cudaMemcpyKind, cudaStream_t = 0 );
+cudaError_t cudaStreamCreate( cudaStream_t* );
+cudaError_t cudaStreamCreateWithFlags( cudaStream_t*, unsigned int );
+cudaError_t cudaStreamDestroy( cudaStream_t );
+cudaError_t cudaStreamSynchronize( cudaStream_t );
+cudaError_t cudaStreamWaitEvent( cudaStream_t, cudaEvent_t, unsigned int = 0 );
+cudaError_t cudaEventCreate( cudaEvent_t* );
+cudaError_t cudaEventCreateWithFlags( cudaEvent_t*, unsigned int );
+cudaError_t cudaEventDestroy( cudaEvent_t );
+cudaError_t cudaEventRecord( cudaEvent_t, cudaStream_t = 0 );
+cudaError_t cudaEventSynchronize( cudaEvent_t );
+
+template < class T >
+cudaError_t
+cudaMalloc( T** p, size_t size )
+{
+  return cudaMalloc( ( void** ) p, size );
+}
+template < class T >
+cudaError_t
+cudaMallocHost( T** p, size_t size )
+{
+  return cudaMallocHost( ( void** ) p, size );
+}
+template < class T >
+cudaError_t cudaMemcpyToSymbol( const T&,
+  const void*,
+  size_t,
+  size_t = 0,
+  cudaMemcpyKind = cudaMemcpyHostToDevice );
+template < class T >
+cudaError_t cudaMemcpyToSymbolAsync( const T&,
+  const void*,
+  size_t,
+  size_t = 0,
+  cudaMemcpyKind = cudaMemcpyHostToDevice,
+  cudaStream_t = 0 );
+template < class T >
+cudaError_t cudaMemcpyFromSymbol( void*,
+  const T&,
+  size_t,
+  size_t = 0,
+  cudaMemcpyKind = cudaMemcpyDeviceToHost );
+
+void __syncthreads();
+void __syncwarp( unsigned int = 0xffffffff );
+int __any_sync( unsigned int, int );
+int __all_sync( unsigned int, int );
+unsigned int __ballot_sync( unsigned int, int );
+template < class T >
+T __shfl_sync( unsigned int, T, int, int = 32 );
+template < class T >
+T __shfl_xor_sync( unsigned int, T, int, int = 32 );
+template < class T >
+T __shfl_down_sync( unsigned int, T, unsigned int, int = 32 );
+template < class T >
+T __ldg( const T* );
+int atomicAdd( int*, int );
+unsigned int atomicAdd( unsigned int*, unsigned int );
+unsigned long long atomicAdd( unsigned long long*, unsigned long long );
+float atomicAdd( float*, float );
+double atomicAdd( double*, double );
+int atomicSub( int*, int );
+int atomicMin( int*, int );
+int atomicMax( int*, int );
+int atomicCAS( int*, int, int );
+unsigned int atomicCAS( unsigned int*, unsigned int, unsigned int );
+unsigned long long atomicCAS( unsigned long long*, unsigned long long, unsigned long long );
+int atomicExch( int*, int );
+float atomicExch( float*, float );
+int __float_as_int( float );
+float __int_as_float( int );
+long long __double_as_longlong( double );
+double __longlong_as_double( long long );
+float __expf( float );
+float __logf( float );
+float __powf( float, float );
+float __fdividef( float, float );
+int __popc( unsigned int );
+int __ffs( int );
+#endif
@@ -0,0 +1,50 @@
+/*
+ *  curand.h
+ *
+ *  This file is part of NEST GPU.
+ *
+ *  Copyright (C) 2021 The NEST Initiative
+ *
+ *  NEST GPU is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NEST GPU is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NEST GPU.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+// Minimal declarations of the cuRAND host API, see cuda_stub.h
+
+#ifndef CURANDSTUB_H
+#define CURANDSTUB_H
+
+#include <cstddef>
+
+struct curandGenerator_st;
+typedef struct curandGenerator_st* curandGenerator_t;
+
+enum curandStatus_t
+{
+  CURAND_STATUS_SUCCESS = 0
+};
+enum curandRngType_t
+{
+  CURAND_RNG_PSEUDO_DEFAULT = 100
+};
+
+curandStatus_t curandCreateGenerator( curandGenerator_t*, curandRngType_t );
+curandStatus_t curandDestroyGenerator( curandGenerator_t );
+curandStatus_t curandSetPseudoRandomGeneratorSeed( curandGenerator_t, unsigned long long );
+curandStatus_t curandGenerate( curandGenerator_t, unsigned int*, size_t );
+curandStatus_t curandGenerateUniform( curandGenerator_t, float*, size_t );
+curandStatus_t curandGenerateNormal( curandGenerator_t, float*, size_t, float, float );
+
+#endif
@@ -0,0 +1,53 @@
+/*
+ *  curand_kernel.h
+ *
+ *  This file is part of NEST GPU.
+ *
+ *  Copyright (C) 2021 The NEST Initiative
+ *
+ *  NEST GPU is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NEST GPU is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NEST GPU.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+// Minimal declarations of the cuRAND device API, see cuda_stub.h
+
+#ifndef CURANDKERNELSTUB_H
+#define CURANDKERNELSTUB_H
+
+#include "curand.h"
+
+struct curandStateXORWOW
+{
+  unsigned int d, v[ 5 ];
+};
+typedef struct curandStateXORWOW curandState;
+struct curandStatePhilox4_32_10
+{
+  unsigned int ctr[ 4 ], key[ 2 ], output[ 4 ], state;
+};
+typedef struct curandStatePhilox4_32_10 curandStatePhilox4_32_10_t;
+
+template < class State >
+void curand_init( unsigned long long, unsigned long long, unsigned long long, State* );
+template < class State >
+unsigned int curand( State* );
+template < class State >
+float curand_uniform( State* );
+template < class State >
+float curand_normal( State* );
+template < class State >
+unsigned int curand_poisson( State*, double );
+
+#endif
@@ -0,0 +1,883 @@
+#!/usr/bin/env python3
+#
+#  nestgpu_model_gen.py
+#
+#  This file is part of NEST GPU.
+#
+#  Copyright (C) 2021 The NEST Initiative
+#
+#  NEST GPU is free software: you can redistribute it and/or modify
+#  it under the terms of the GNU General Public License as published by
+#  the Free Software Foundation, either version 2 of the License, or
+#  (at your option) any later version.
+#
+#  NEST GPU is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with NEST GPU.  If not, see <http://www.gnu.org/licenses/>.
+#
+
+"""Generates the sources of a NEST GPU neuron model from a description.
+
+The description is a Python literal (a dictionary), see the files in
+the examples directory. Its entries are:
+
+  name         name of the model, of its class and of its files
+  doc          short description, written in the model documentation
+  integrator   "rk5", "exp_euler" or "rosenbrock" for models described by
+               ODEs, integrated by the RungeKutta5 class with the given
+               default integrator, or "exact" for linear models updated
+               with precomputed propagators
+  state        list of (name, initial value, comment) of the state
+               variables. The initial value can be an expression of the
+               parameters
+  params       list of (name, default value, comment) of the parameters
+  spike        spike condition, C expression
+  reset        list of C statements executed after a spike
+  refractory   optional dictionary, "t_ref": name of the parameter with the
+               refractory period, "clamp": list of (variable, expression)
+               of the variables held fixed during the refractory period
+
+ODE models (rk5, exp_euler, rosenbrock):
+  aux          list of (name, expression) of auxiliary variables computed
+               before the derivatives, or (name, expression, "sum") for
+               sums of the expression over the receptor ports
+  odes         list of (variable, derivative expression)
+  port_state   optional list of (name, initial value, comment) of the state
+               variables of each receptor port. If present, the number of
+               ports is chosen when the neurons are created
+  port_params  list of (name, default value, comment) of the parameters
+               of each receptor port
+  port_odes    list of (port variable, derivative expression)
+  calibrate    optional C code executed for each neuron at calibration,
+               the number of ports is n_port
+
+Exact models:
+  propagators  list of (name, expression) computed for each neuron at
+               calibration, h is the time resolution
+  update       list of (variable, expression) assigned in order at each
+               time step. The variables in "clamp" are not updated during
+               the refractory period
+
+Inputs:
+  n_port       number of receptor ports, if there are no port variables
+  port_input   variable that receives the spikes of the first port. With
+               fixed ports, port k goes to the k-th variable after it
+  port_weight  optional port parameter that multiplies the input spikes
+
+In the expressions the variables and the parameters are used by name,
+port variables and parameters as name( i ), with i the port index.
+A parameter den_delay (dendritic delay) is added if not present.
+
+The parameters that have the same value in all the neurons of a group
+are read from constant memory (see BaseNeuron::FoldConstParam).
+
+Usage: nestgpu_model_gen.py description [-o output_dir] [--register src_dir]
+With --register, the model is added to the list of models and to the
+build files of the NEST GPU sources in src_dir.
+"""
+
+import argparse
+import ast
+import math
+import os
+import sys
+
+INTEGRATOR_INDEX = {"rk5": 0, "exp_euler": 1, "rosenbrock": 2}
+DESCRIPTION_KEYS = ["name", "doc", "integrator", "state", "params", "spike",
+                    "reset", "refractory", "aux", "odes", "port_state",
+                    "port_params", "port_odes", "calibrate", "propagators",
+                    "update", "n_port", "port_input", "port_weight"]
+COLUMN_LIMIT = 120
+
+
+class ModelError(Exception):
+    pass
+
+
+def license_header(file_name, comment="c"):
+    lines = [file_name, "", "This file is part of NEST GPU.", "",
+             "Copyright (C) 2021 The NEST Initiative", "",
+             "NEST GPU is free software: you can redistribute it and/or modify",
+             "it under the terms of the GNU General Public License as published by",
+             "the Free Software Foundation, either version 2 of the License, or",
+             "(at your option) any later version.", "",
+             "NEST GPU is distributed in the hope that it will be useful,",
+             "but WITHOUT ANY WARRANTY; without even the implied warranty of",
+             "MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the",
+             "GNU General Public License for more details.", "",
+             "You should have received a copy of the GNU General Public License",
+             "along with NEST GPU.  If not, see <http://www.gnu.org/licenses/>.",
+             ""]
+    out = "/*\n"
+    for line in lines:
+        out += (" *  " + line).rstrip() + "\n"
+    out += " */\n"
+    return out
+
+
+def c_float(val):
+    s = repr(float(val))
+    if "e" not in s and "." not in s:
+        s += ".0"
+    return s
+
+
+def entry(item, n_field):
+    """Pads a tuple of the description to n_field fields"""
+    if isinstance(item, str):
+        item = (item,)
+    item = tuple(item)
+    if len(item) > n_field:
+        raise ModelError("too many fields in " + str(item))
+    return item + ("",) * (n_field - len(item))
+
+
+def name_array(decl, n_name, names):
+    """String array definition, wrapped as clang-format does"""
+    quoted = ['"' + name + '"' for name in names]
+    head = "const std::string " + decl + "[ " + n_name + " ] = { "
+    line = head + ", ".join(quoted) + " };"
+    if len(line) <= COLUMN_LIMIT:
+        return line + "\n"
+    out = head + quoted[0] + ",\n"
+    for name in quoted[1:-1]:
+        out += "  " + name + ",\n"
+    return out + "  " + quoted[-1] + " };\n"
+
+
+def enum_block(enum_name, items, last):
+    """Enum of indexes, items is a list of (name, comment)"""
+    lines = []
+    for k, (name, comment) in enumerate(items):
+        code = "  i_" + name + (" = 0," if k == 0 else ",")
+        lines.append((code, comment))
+    width = max([len(code) for code, comment in lines if comment] + [0])
+    out = "enum " + enum_name + "\n{\n"
+    for code, comment in lines:
+        if comment:
+            out += code.ljust(width) + " // " + comment + "\n"
+        else:
+            out += code + "\n"
+    return out + "  " + last + "\n};\n"
+
+
+def statement_block(statements, indent):
+    out = ""
+    for st in statements:
+        st = st.strip()
+        if not st.endswith(";") and not st.endswith("}"):
+            st += ";"
+        out += " " * indent + st + "\n"
+    return out
+
+
+def code_block(code, indent):
+    """Reindents a block of C code"""
+    lines = code.rstrip().strip("\n").split("\n")
+    margin = min([len(l) - len(l.lstrip()) for l in lines if l.strip()])
+    out = ""
+    for l in lines:
+        out += (" " * indent + l[margin:]).rstrip() + "\n"
+    return out
+
+
+class Model:
+    def __init__(self, desc):
+        for key in desc:
+            if key not in DESCRIPTION_KEYS:
+                raise ModelError("unknown entry " + key)
+        for key in ["name", "integrator", "state", "params", "spike"]:
+            if key not in desc:
+                raise ModelError("missing entry " + key)
+        self.name = desc["name"]
+        self.doc = desc.get("doc", "")
+        self.integrator = desc["integrator"]
+        if self.integrator != "exact" and self.integrator not in INTEGRATOR_INDEX:
+            raise ModelError("unknown integrator " + self.integrator)
+        self.exact = (self.integrator == "exact")
+        self.guard = self.name.upper().replace("_", "")
+        self.ns = self.name + "_ns"
+        self.state = [entry(x, 3) for x in desc["state"]]
+        self.params = [entry(x, 3) for x in desc["params"]]
+        self.spike = desc["spike"]
+        self.reset = desc.get("reset", [])
+        self.refractory = desc.get("refractory", None)
+        self.aux = [entry(x, 3) for x in desc.get("aux", [])]
+        self.odes = [entry(x, 2) for x in desc.get("odes", [])]
+        self.port_state = [entry(x, 3) for x in desc.get("port_state", [])]
+        self.port_params = [entry(x, 3) for x in desc.get("port_params", [])]
+        self.port_odes = [entry(x, 2) for x in desc.get("port_odes", [])]
+        self.calibrate = desc.get("calibrate", "")
+        self.propagators = [entry(x, 2) for x in desc.get("propagators", [])]
+        self.update = [entry(x, 2) for x in desc.get("update", [])]
+        self.n_port = desc.get("n_port", 1)
+        self.port_input = desc.get("port_input", None)
+        self.port_weight = desc.get("port_weight", None)
+        self.multiport = len(self.port_state) > 0
+
+        param_names = [p[0] for p in self.params]
+        self.clamp = []
+        if self.refractory is not None:
+            if self.refractory.get("t_ref") not in param_names:
+                raise ModelError("refractory period must be a parameter")
+            self.clamp = [entry(x, 2) for x in self.refractory.get("clamp", [])]
+            # in ODE models the refractory counter is a parameter,
+            # modified by ExternalUpdate, in exact models a state variable
+            if self.exact:
+                self.state.append(("refractory_step", 0, "Refractory step counter"))
+            else:
+                self.params.append(("refractory_step", 0, "Refractory step counter"))
+        if "den_delay" not in param_names:
+            self.params.append(("den_delay", 0.0, "Dendritic delay in ms"))
+        self.check()
+
+    def check(self):
+        var_names = [v[0] for v in self.state]
+        if self.port_input is None:
+            raise ModelError("missing entry port_input")
+        if self.exact:
+            if self.multiport or self.odes or self.aux:
+                raise ModelError("exact models cannot have ODEs or port variables")
+            for var, expr in self.update:
+                if var not in var_names:
+                    raise ModelError("update of unknown variable " + var)
+        else:
+            if self.propagators or self.update:
+                raise ModelError("ODE models cannot have propagators or update rules")
+            ode_vars = [v for v, expr in self.odes]
+            if sorted(ode_vars) != sorted(var_names):
+                raise ModelError("each state variable must have an ODE")
+            port_ode_vars = [v for v, expr in self.port_odes]
+            if sorted(port_ode_vars) != sorted([v[0] for v in self.port_state]):
+                raise ModelError("each port variable must have an ODE")
+        if self.multiport:
+            if self.port_input not in [v[0] for v in self.port_state]:
+                raise ModelError("port_input must be a port variable")
+            if self.port_weight is not None and \
+               self.port_weight not in [p[0] for p in self.port_params]:
+                raise ModelError("port_weight must be a port parameter")
+        else:
+            if self.port_input not in var_names:
+                raise ModelError("port_input must be a state variable")
+            i0 = var_names.index(self.port_input)
+            if i0 + self.n_port > len(self.state):
+                raise ModelError("not enough state variables for the ports")
+            if self.port_weight is not None:
+                raise ModelError("port_weight requires port variables")
+        for var, expr in self.clamp:
+            if var not in var_names:
+                raise ModelError("clamp of unknown variable " + var)
+
+    # documentation block of the model header
+    def user_doc(self):
+        title = self.name.replace("_", " ")
+        out = "/* BeginUserDocs: neuron, generated\n\nShort description\n"
+        out += "+++++++++++++++++\n\n"
+        out += (self.doc.strip() if self.doc else title) + "\n\n"
+        out += "Description\n+++++++++++\n\n"
+        out += self.name + " has been generated by nestgpu_model_gen.py.\n"
+        if self.exact:
+            out += "The subthreshold dynamics are updated with propagators\n"
+            out += "computed at calibration.\n\n"
+        else:
+            out += "The ODEs are integrated by the " + self.integrator + \
+                " integrator, which can be\nchanged through the group parameter " + \
+                "``integrator``.\n\n"
+        rows = [(v[0], v[2]) for v in self.state] + \
+               [(p[0], p[2]) for p in self.params]
+        rows += [(v[0], v[2]) for v in self.port_state] + \
+                [(p[0], p[2]) for p in self.port_params]
+        out += "Parameters\n++++++++++\n\n"
+        out += "The following parameters can be set in the status dictionary.\n\n"
+        width = max([len(r[0]) for r in rows] + [10]) + 2
+        sep = "=" * width + "  " + "=" * 60 + "\n"
+        out += sep
+        for name, comment in rows:
+            out += (" " + name).ljust(width + 2) + comment + "\n"
+        out += sep + "\nEndUserDocs */\n"
+        return out
+
+    def write(self, out_dir):
+        files = self.exact_files() if self.exact else self.ode_files()
+        for file_name, text in files:
+            with open(os.path.join(out_dir, file_name), "w") as f:
+                f.write(text)
+        return [file_name for file_name, text in files]
+
+    ###################################################################
+    # ODE models
+    ###################################################################
+    def ode_files(self):
+        return [(self.name + ".h", self.ode_header()),
+                (self.name + "_kernel.h", self.ode_kernel_header()),
+                (self.name + ".cu", self.ode_source())]
+
+    def ode_header(self):
+        n = self.name
+        out = license_header(n + ".h") + "\n\n"
+        out += "#ifndef " + self.guard + "_H\n#define " + self.guard + "_H\n\n"
+        out += '#include "base_neuron.h"\n#include "cuda_error.h"\n'
+        out += '#include "neuron_models.h"\n#include "node_group.h"\n'
+        out += '#include "rk5.h"\n#include <iostream>\n#include <string>\n\n'
+        out += self.user_doc() + "\n"
+        if self.multiport:
+            out += "#define MAX_PORT_NUM 20\n\n"
+        out += "struct " + n + "_rk5\n{\n  int i_node_0_;\n};\n\n"
+        out += "class " + n + " : public BaseNeuron\n{\npublic:\n"
+        out += "  RungeKutta5< " + n + "_rk5 > rk5_;\n  float h_min_;\n  float h_;\n"
+        out += "  " + n + "_rk5 rk5_data_struct_;\n\n"
+        out += "  int Init( int i_node_0, int n_neuron, int n_port, int i_group, " \
+               "unsigned long long* seed );\n\n"
+        out += "  int Calibrate( double time_min, float time_resolution );\n\n"
+        out += "  int Update( long long it, double t1 );\n\n"
+        out += "  int\n  GetX( int i_neuron, int n_node, double* x )\n  {\n"
+        out += "    return rk5_.GetX( i_neuron, n_node, x );\n  }\n\n"
+        out += "  int\n  GetY( int i_var, int i_neuron, int n_node, float* y )\n  {\n"
+        out += "    return rk5_.GetY( i_var, i_neuron, n_node, y );\n  }\n"
+        if self.multiport:
+            out += "\n  template < int N_PORT >\n  int UpdateNR( long long it, double t1 );\n"
+        out += "};\n\n#endif\n"
+        return out
+
+    def ode_kernel_header(self):
+        n = self.name
+        out = license_header(n + "_kernel.h") + "\n\n"
+        out += "#ifndef " + self.guard + "KERNEL_H\n#define " + self.guard + "KERNEL_H\n\n"
+        includes = ['"node_group.h"', '"spike_buffer.h"', '"' + n + '.h"']
+        for inc in sorted(includes):
+            out += "#include " + inc + "\n"
+        out += "#include <cmath>\n#include <string>\n\n"
+        out += "#define MIN( a, b ) ( ( ( a ) < ( b ) ) ? ( a ) : ( b ) )\n\n"
+        out += "extern __constant__ float NESTGPUTimeResolution;\n\n"
+        out += "namespace " + self.ns + "\n{\n"
+        out += enum_block("ScalVarIndexes", [(v[0], v[2]) for v in self.state], "N_SCAL_VAR")
+        if self.multiport:
+            out += "\n" + enum_block("PortVarIndexes", [(v[0], v[2]) for v in self.port_state],
+                                     "N_PORT_VAR")
+        out += "\n" + enum_block("ScalParamIndexes", [(p[0], p[2]) for p in self.params],
+                                 "N_SCAL_PARAM")
+        if self.multiport:
+            out += "\n" + enum_block("PortParamIndexes",
+                                     [(p[0], p[2]) for p in self.port_params], "N_PORT_PARAM")
+        out += "\n" + enum_block("GroupParamIndexes", [
+            ("h_min_rel", "Min. step in ODE integr. relative to time resolution"),
+            ("h0_rel", "Starting step in ODE integr. relative to time resolution"),
+            ("warp_step", "If not 0, the neurons of a warp share the integration step"),
+            ("integrator", "ODE integrator: 0 adaptive RK5, 1 exp. Euler, 2 Rosenbrock")],
+            "N_GROUP_PARAM")
+        out += "\n\n" + name_array(n + "_scal_var_name", "N_SCAL_VAR", [v[0] for v in self.state])
+        if self.multiport:
+            out += "\n" + name_array(n + "_port_var_name", "N_PORT_VAR",
+                                     [v[0] for v in self.port_state])
+        out += "\n" + name_array(n + "_scal_param_name", "N_SCAL_PARAM",
+                                 [p[0] for p in self.params])
+        if self.multiport:
+            out += "\n" + name_array(n + "_port_param_name", "N_PORT_PARAM",
+                                     [p[0] for p in self.port_params])
+        out += "\n" + name_array(n + "_group_param_name", "N_GROUP_PARAM",
+                                 ["h_min_rel", "h0_rel", "warp_step", "integrator"])
+        out += "\n"
+        for v in self.state:
+            out += "#define " + v[0] + " y[ i_" + v[0] + " ]\n"
+        for v in self.port_state:
+            out += "#define " + v[0] + "( i ) y[ N_SCAL_VAR + N_PORT_VAR * i + i_" + v[0] + " ]\n"
+        out += "\n"
+        for v in self.state:
+            out += "#define d" + v[0] + "dt dydx[ i_" + v[0] + " ]\n"
+        for v in self.port_state:
+            out += "#define d" + v[0] + "dt( i ) dydx[ N_SCAL_VAR + N_PORT_VAR * i + i_" + \
+                v[0] + " ]\n"
+        out += "\n"
+        for p in self.params:
+            out += "#define " + p[0] + " param[ i_" + p[0] + " ]\n"
+        if self.port_params:
+            out += "\n"
+        for p in self.port_params:
+            out += "#define " + p[0] + "( i ) param[ N_SCAL_PARAM + N_PORT_PARAM * i + i_" + \
+                p[0] + " ]\n"
+        out += "\n"
+        for gp in ["h_min_rel", "h0_rel", "warp_step", "integrator"]:
+            out += "#define " + gp + "_ group_param_[ i_" + gp + " ]\n"
+        out += "\n\n" + self.derivatives() + "\n" + self.external_update()
+        out += "\n\n};\n\n"
+        if self.multiport:
+            out += "template <>\nint " + n + "::UpdateNR< 0 >( long long it, double t1 );\n\n"
+            out += "template < int N_PORT >\nint\n" + n + "::UpdateNR( long long it, double t1 )\n{\n"
+            out += "  if ( N_PORT == n_port_ )\n  {\n"
+            out += "    const int NVAR = " + self.ns + "::N_SCAL_VAR + " + self.ns + \
+                "::N_PORT_VAR * N_PORT;\n"
+            out += "    const int NPARAM = " + self.ns + "::N_SCAL_PARAM + " + self.ns + \
+                "::N_PORT_PARAM * N_PORT;\n\n"
+            out += "    rk5_.Update< NVAR, NPARAM >( t1, h_min_, rk5_data_struct_ );\n  }\n"
+            out += "  else\n  {\n    UpdateNR< N_PORT - 1 >( it, t1 );\n  }\n\n  return 0;\n}\n\n"
+        out += "template < int NVAR, int NPARAM >\n__device__ void\n"
+        out += "Derivatives( double x, float* y, float* dydx, float* param, " + n + \
+            "_rk5 data_struct )\n{\n"
+        out += "  " + self.ns + "::Derivatives< NVAR, NPARAM >( x, y, dydx, param, data_struct );\n}\n\n"
+        out += "template < int NVAR, int NPARAM >\n__device__ void\n"
+        out += "ExternalUpdate( double x, float* y, float* param, bool end_time_step, " + n + \
+            "_rk5 data_struct )\n{\n"
+        out += "  " + self.ns + "::ExternalUpdate< NVAR, NPARAM >( x, y, param, end_time_step, " \
+            "data_struct );\n}\n\n\n"
+        out += self.mutable_param() + "\n#endif\n"
+        return out
+
+    def mutable_param(self):
+        out = ""
+        if self.refractory is not None:
+            out += "// refractory_step is the only parameter modified by ExternalUpdate\n"
+            out += "template <>\nstruct RK5MutableParam< " + self.name + "_rk5 >\n{\n"
+            out += "  static const int N_MUTABLE = 1;\n"
+            out += "  __host__ __device__ static int\n  Idx( int i_mut )\n  {\n"
+            out += "    return " + self.ns + "::i_refractory_step;\n  }\n};\n"
+        else:
+            out += "// ExternalUpdate does not modify the parameters\n"
+            out += "template <>\nstruct RK5MutableParam< " + self.name + "_rk5 >\n{\n"
+            out += "  static const int N_MUTABLE = 0;\n"
+            out += "  __host__ __device__ static int\n  Idx( int i_mut )\n  {\n"
+            out += "    return 0;\n  }\n};\n"
+        return out
+
+    def port_loop(self, body, indent):
+        out = " " * indent + "for ( int i = 0; i < n_port; i++ )\n"
+        out += " " * indent + "{\n" + body + " " * indent + "}\n"
+        return out
+
+    def derivatives(self):
+        out = "template < int NVAR, int NPARAM > //, class DataStruct>\n__device__ void\n"
+        out += "Derivatives( double x, float* y, float* dydx, float* param, " + self.name + \
+            "_rk5 data_struct )\n{\n"
+        if self.multiport:
+            out += "  enum\n  {\n    n_port = ( NVAR - N_SCAL_VAR ) / N_PORT_VAR\n  };\n"
+        for name, expr, kind in self.aux:
+            if kind == "sum":
+                if not self.multiport:
+                    raise ModelError("sum over ports requires port variables")
+                out += "  float " + name + " = 0.0;\n"
+                out += self.port_loop("    " + name + " += " + expr + ";\n", 2)
+            elif kind == "":
+                out += "  float " + name + " = " + expr + ";\n"
+            else:
+                raise ModelError("unknown auxiliary variable type " + kind)
+        if self.aux:
+            out += "\n"
+        for var, expr in self.odes:
+            out += "  d" + var + "dt = " + expr + ";\n"
+        if self.port_odes:
+            body = ""
+            for var, expr in self.port_odes:
+                body += "    d" + var + "dt( i ) = " + expr + ";\n"
+            out += self.port_loop(body, 2)
+        return out + "}\n"
+
+    def spike_block(self, indent, push):
+        sp = " " * indent
+        out = sp + "if ( " + self.spike + " )\n" + sp + "{ // send spike\n"
+        out += push
+        out += statement_block(self.reset, indent + 2)
+        if self.refractory is not None:
+            out += sp + "  refractory_step = ( int ) round( " + self.refractory["t_ref"] + \
+                " / NESTGPUTimeResolution );\n"
+            out += sp + "  if ( refractory_step < 0 )\n" + sp + "  {\n"
+            out += sp + "    refractory_step = 0;\n" + sp + "  }\n"
+        return out + sp + "}\n"
+
+    def external_update(self):
+        out = "template < int NVAR, int NPARAM > //, class DataStruct>\n__device__ void\n"
+        out += "ExternalUpdate( double x, float* y, float* param, bool end_time_step, " + \
+            self.name + "_rk5 data_struct )\n{\n"
+        push = "    int neuron_idx = threadIdx.x + blockIdx.x * blockDim.x;\n"
+        push += "    PushSpike( data_struct.i_node_0_ + neuron_idx, 1.0 );\n"
+        if self.refractory is not None:
+            out += "  if ( refractory_step > 0.0 )\n  {\n"
+            for var, expr in self.clamp:
+                if expr != var:
+                    out += "    " + var + " = " + expr + ";\n"
+            out += "    if ( end_time_step )\n    {\n      refractory_step -= 1.0;\n    }\n  }\n"
+            out += "  else\n  {\n"
+            out += self.spike_block(4, push.replace("    ", "      ", 2))
+            out += "  }\n"
+        else:
+            out += self.spike_block(2, push)
+        return out + "}\n"
+
+    def ode_source(self):
+        n = self.name
+        ns = self.ns
+        out = license_header(n + ".cu") + "\n\n"
+        out += '#include "' + n + '.h"\n#include "' + n + '_kernel.h"\n#include "rk5.h"\n'
+        out += "#include <cmath>\n#include <config.h>\n#include <iostream>\n\n"
+        out += "namespace " + ns + "\n{\n\n"
+        sig = "( int n_var, int n_param, double x, float* y, float* param, " + n + \
+            "_rk5 data_struct )"
+        out += "__device__ void\nNodeInit" + sig + "\n{\n"
+        out += "  // int array_idx = threadIdx.x + blockIdx.x * blockDim.x;\n"
+        if self.multiport:
+            out += "  int n_port = ( n_var - N_SCAL_VAR ) / N_PORT_VAR;\n"
+        out += "\n"
+        for p in self.params:
+            if p[0] != "refractory_step":
+                out += "  " + p[0] + " = " + c_float(p[1]) + ";\n"
+        out += "\n"
+        for v in self.state:
+            out += "  " + v[0] + " = " + str(v[1]) + ";\n"
+        if self.refractory is not None:
+            out += "  refractory_step = 0;\n"
+        if self.multiport:
+            body = ""
+            for v in self.port_state:
+                body += "    " + v[0] + "( i ) = " + str(v[1]) + ";\n"
+            for p in self.port_params:
+                body += "    " + p[0] + "( i ) = " + c_float(p[1]) + ";\n"
+            out += self.port_loop(body, 2)
+        out += "}\n\n"
+        out += "__device__ void\nNodeCalibrate" + sig + "\n{\n"
+        out += "  // int array_idx = threadIdx.x + blockIdx.x * blockDim.x;\n"
+        if self.multiport:
+            out += "  int n_port = ( n_var - N_SCAL_VAR ) / N_PORT_VAR;\n"
+        out += "\n"
+        if self.refractory is not None:
+            out += "  refractory_step = 0;\n"
+        if self.calibrate:
+            out += code_block(self.calibrate, 2)
+        out += "}\n\n}\n\n"
+        out += "__device__ void\nNodeInit" + sig + "\n{\n"
+        out += "  " + ns + "::NodeInit( n_var, n_param, x, y, param, data_struct );\n}\n\n"
+        out += "__device__ void\nNodeCalibrate" + sig + "\n{\n"
+        out += "  " + ns + "::NodeCalibrate( n_var, n_param, x, y, param, data_struct );\n}\n\n"
+        out += "using namespace " + ns + ";\n\n"
+        out += "int\n" + n + "::Init( int i_node_0, int n_node, int n_port, int i_group, " \
+            "unsigned long long* seed )\n{\n"
+        if self.multiport:
+            out += "  BaseNeuron::Init( i_node_0, n_node, n_port, i_group, seed );\n"
+        else:
+            out += "  BaseNeuron::Init( i_node_0, n_node, " + str(self.n_port) + \
+                " /*n_port*/, i_group, seed );\n"
+        out += "  node_type_ = i_" + n + "_model;\n"
+        out += "  n_scal_var_ = N_SCAL_VAR;\n"
+        if self.multiport:
+            out += "  n_port_var_ = N_PORT_VAR;\n"
+        out += "  n_scal_param_ = N_SCAL_PARAM;\n"
+        if self.multiport:
+            out += "  n_port_param_ = N_PORT_PARAM;\n"
+        out += "  n_group_param_ = N_GROUP_PARAM;\n\n"
+        if self.multiport:
+            out += "  n_var_ = n_scal_var_ + n_port_var_ * n_port;\n"
+            out += "  n_param_ = n_scal_param_ + n_port_param_ * n_port;\n\n"
+        else:
+            out += "  n_var_ = n_scal_var_;\n  n_param_ = n_scal_param_;\n\n"
+        out += "  group_param_ = new float[ N_GROUP_PARAM ];\n\n"
+        out += "  scal_var_name_ = " + n + "_scal_var_name;\n"
+        if self.multiport:
+            out += "  port_var_name_ = " + n + "_port_var_name;\n"
+        out += "  scal_param_name_ = " + n + "_scal_param_name;\n"
+        if self.multiport:
+            out += "  port_param_name_ = " + n + "_port_param_name;\n"
+        out += "  group_param_name_ = " + n + "_group_param_name;\n"
+        out += "  rk5_data_struct_.i_node_0_ = i_node_0_;\n\n"
+        out += '  SetGroupParam( "h_min_rel", 1.0e-3 );\n'
+        out += '  SetGroupParam( "h0_rel", 1.0e-2 );\n'
+        out += '  SetGroupParam( "warp_step", 0.0 );\n'
+        out += '  SetGroupParam( "integrator", ' + c_float(INTEGRATOR_INDEX[self.integrator]) + \
+            " );\n"
+        out += "  h_ = h0_rel_ * 0.1;\n\n"
+        out += "  rk5_.Init( n_node, n_var_, n_param_, 0.0, h_, rk5_data_struct_ );\n"
+        out += "  var_arr_ = rk5_.GetYArr();\n  param_arr_ = rk5_.GetParamArr();\n\n"
+        out += self.port_arrays() + "\n"
+        out += '  den_delay_arr_ = GetParamArr() + GetScalParamIdx( "den_delay" );\n\n'
+        out += "  return 0;\n}\n\n"
+        out += "int\n" + n + "::Calibrate( double time_min, float time_resolution )\n{\n"
+        out += "  h_min_ = h_min_rel_ * time_resolution;\n"
+        out += "  h_ = h0_rel_ * time_resolution;\n"
+        out += "  rk5_.Calibrate( time_min, h_, rk5_data_struct_ );\n"
+        out += "  rk5_.SetWarpStep( warp_step_ != 0.0 );\n"
+        out += "  rk5_.SetIntegrator( ( int ) integrator_ );\n"
+        out += "  FoldConstParam( MutableParamMask< " + n + "_rk5 >() );\n"
+        out += "  rk5_.SetConstParam( &const_param_mask_, const_param_offset_ );\n"
+        out += "  rk5_.SetInputSpikes( FuseInputSpikes() );\n"
+        out += "  rk5_.SetStream( stream_ );\n\n"
+        out += "  return 0;\n}\n\n"
+        if self.multiport:
+            out += "template <>\nint\n" + n + "::UpdateNR< 0 >( long long it, double t1 )\n{\n"
+            out += "  return 0;\n}\n\n"
+            out += "int\n" + n + "::Update( long long it, double t1 )\n{\n"
+            out += "  UpdateNR< MAX_PORT_NUM >( it, t1 );\n\n  return 0;\n}\n"
+        else:
+            out += "int\n" + n + "::Update( long long it, double t1 )\n{\n"
+            out += "  rk5_.Update< N_SCAL_VAR, N_SCAL_PARAM >( t1, h_min_, rk5_data_struct_ );\n\n"
+            out += "  return 0;\n}\n"
+        return out
+
+    def port_arrays(self):
+        out = ""
+        if self.port_weight is not None:
+            out += "  port_weight_arr_ = GetParamArr() + n_scal_param_ + GetPortParamIdx( \"" + \
+                self.port_weight + "\" );\n"
+            out += "  port_weight_arr_step_ = n_param_;\n"
+            out += "  port_weight_port_step_ = n_port_param_;\n\n"
+        else:
+            out += "  // multiplication factor of input signal is always 1 for all nodes\n"
+            out += "  float input_weight = 1.0;\n"
+            out += "  gpuErrchk( cudaMalloc( &port_weight_arr_, sizeof( float ) ) );\n"
+            out += "  gpuErrchk( cudaMemcpy( port_weight_arr_, &input_weight, sizeof( float ), " \
+                "cudaMemcpyHostToDevice ) );\n"
+            out += "  port_weight_arr_step_ = 0;\n  port_weight_port_step_ = 0;\n\n"
+        if self.multiport:
+            out += "  port_input_arr_ = GetVarArr() + n_scal_var_ + GetPortVarIdx( \"" + \
+                self.port_input + "\" );\n"
+            out += "  port_input_arr_step_ = n_var_;\n"
+            out += "  port_input_port_step_ = n_port_var_;\n"
+        else:
+            out += "  port_input_arr_ = GetVarArr() + GetScalVarIdx( \"" + self.port_input + \
+                "\" );\n"
+            out += "  port_input_arr_step_ = n_var_;\n"
+            out += "  port_input_port_step_ = 1;\n"
+        return out
+
+    ###################################################################
+    # exact models
+    ###################################################################
+    def exact_files(self):
+        return [(self.name + ".h", self.exact_header()),
+                (self.name + ".cu", self.exact_source())]
+
+    def exact_header(self):
+        n = self.name
+        out = license_header(n + ".h") + "\n\n"
+        out += "#ifndef " + self.guard + "_H\n#define " + self.guard + "_H\n\n"
+        out += '#include "base_neuron.h"\n#include "cuda_error.h"\n'
+        out += '#include "neuron_models.h"\n#include "node_group.h"\n'
+        out += "#include <iostream>\n#include <string>\n\n"
+        out += self.user_doc() + "\n"
+        out += "namespace " + self.ns + "\n{\n"
+        out += enum_block("ScalVarIndexes", [(v[0], v[2]) for v in self.state], "N_SCAL_VAR")
+        params = [(p[0], p[2]) for p in self.params]
+        params += [(p[0], "propagator" if k == 0 else "") for k, p in enumerate(self.propagators)]
+        out += "\n" + enum_block("ScalParamIndexes", params, "N_SCAL_PARAM")
+        out += "\n" + name_array(n + "_scal_var_name", "N_SCAL_VAR", [v[0] for v in self.state])
+        out += "\n" + name_array(n + "_scal_param_name", "N_SCAL_PARAM", [p[0] for p in params])
+        out += "\n} // namespace\n\n"
+        out += "class " + n + " : public BaseNeuron\n{\n"
+        out += "  InputSpikeArray input_spikes_; // input spikes folded by the update kernel\n\n"
+        out += "public:\n  ~" + n + "();\n\n"
+        out += "  int Init( int i_node_0, int n_neuron, int n_port, int i_group, " \
+               "unsigned long long* seed );\n\n"
+        out += "  int Calibrate( double, float time_resolution );\n\n"
+        out += "  int Update( long long it, double t1 );\n\n"
+        out += "  int Free();\n};\n\n\n#endif\n"
+        return out
+
+    def initial_value(self, expr):
+        """Initial value of a state variable of an exact model, computed
+        from the default values of the parameters"""
+        env = {p[0]: float(p[1]) for p in self.params}
+        env.update({k: getattr(math, k) for k in dir(math) if not k.startswith("_")})
+        try:
+            return float(eval(str(expr), {"__builtins__": {}}, env))
+        except Exception:
+            raise ModelError("cannot compute the initial value " + str(expr))
+
+    def exact_source(self):
+        n = self.name
+        out = license_header(n + ".cu") + "\n\n"
+        use_p32 = any("propagator_32" in expr for name, expr in self.propagators)
+        out += '#include "get_spike.h"\n#include "' + n + '.h"\n'
+        if use_p32:
+            out += '#include "propagator_stability.h"\n'
+        out += '#include "rk5_param.h"\n#include "spike_buffer.h"\n'
+        out += "#include <cmath>\n#include <config.h>\n#include <iostream>\n\n"
+        out += "using namespace " + self.ns + ";\n\n"
+        out += "extern __constant__ float NESTGPUTimeResolution;\n"
+        if use_p32:
+            out += "extern __device__ double propagator_32( double, double, double, double );\n"
+        out += "\n"
+        for v in self.state:
+            out += "#define " + v[0] + " var[ i_" + v[0] + " ]\n"
+        out += "\n"
+        for p in self.params:
+            out += "#define " + p[0] + " param[ i_" + p[0] + " ]\n"
+        out += "\n"
+        for p in self.propagators:
+            out += "#define " + p[0] + " param[ i_" + p[0] + " ]\n"
+        out += "\n\n__global__ void\n" + n + \
+            "_Calibrate( int n_node, float* param_arr, int n_param, float h )\n{\n"
+        out += "  int i_neuron = threadIdx.x + blockIdx.x * blockDim.x;\n"
+        out += "  if ( i_neuron < n_node )\n  {\n"
+        out += "    float* param = param_arr + n_param * i_neuron;\n\n"
+        for name, expr in self.propagators:
+            out += "    " + name + " = " + expr + ";\n"
+        out += "  }\n}\n\n"
+        out += "// the state of each neuron is kept in registers during the update,\n"
+        out += "// the parameters in const_mask are read from constant memory.\n"
+        out += "// The input spikes are folded in the state before it is loaded\n"
+        out += "__global__ void\n" + n + "_Update( int n_node,\n  int i_node_0,\n" \
+            "  float* var_arr,\n  float* param_arr,\n  unsigned long long const_mask,\n" \
+            "  int const_offset,\n  InputSpikeArray input_spikes )\n{\n"
+        out += "  int i_neuron = threadIdx.x + blockIdx.x * blockDim.x;\n"
+        out += "  if ( i_neuron < n_node )\n  {\n"
+        out += "    FoldInputSpikes( input_spikes, i_neuron );\n"
+        out += "    float var[ N_SCAL_VAR ];\n    float param[ N_SCAL_PARAM ];\n"
+        out += "    for ( int i = 0; i < N_SCAL_VAR; i++ )\n    {\n"
+        out += "      var[ i ] = var_arr[ N_SCAL_VAR * i_neuron + i ];\n    }\n"
+        out += "    LoadParam< N_SCAL_PARAM >( param, &param_arr[ N_SCAL_PARAM * i_neuron ], " \
+            "const_mask, const_offset );\n\n"
+        if self.refractory is not None:
+            clamped = [var for var, expr in self.clamp]
+            out += "    if ( refractory_step > 0.0 )\n    {\n"
+            out += "      // neuron is absolute refractory\n"
+            out += "      refractory_step -= 1.0;\n"
+            for var, expr in self.clamp:
+                if expr != var:
+                    out += "      " + var + " = " + expr + ";\n"
+            for var, expr in self.update:
+                if var not in clamped:
+                    out += "      " + var + " = " + expr + ";\n"
+            out += "    }\n    else\n    {\n"
+            for var, expr in self.update:
+                out += "      " + var + " = " + expr + ";\n"
+            out += "    }\n\n"
+        else:
+            for var, expr in self.update:
+                out += "    " + var + " = " + expr + ";\n"
+            out += "\n"
+        push = "      PushSpike( i_node_0 + i_neuron, 1.0 );\n"
+        out += self.spike_block(4, push)
+        out += "\n    for ( int i = 0; i < N_SCAL_VAR; i++ )\n    {\n"
+        out += "      var_arr[ N_SCAL_VAR * i_neuron + i ] = var[ i ];\n    }\n"
+        out += "  }\n}\n\n"
+        out += n + "::~" + n + "()\n{\n  FreeVarArr();\n  FreeParamArr();\n}\n\n"
+        out += "int\n" + n + "::Init( int i_node_0, int n_node, int /*n_port*/, int i_group, " \
+            "unsigned long long* seed )\n{\n"
+        out += "  BaseNeuron::Init( i_node_0, n_node, " + str(self.n_port) + \
+            " /*n_port*/, i_group, seed );\n"
+        out += "  node_type_ = i_" + n + "_model;\n\n"
+        out += "  n_scal_var_ = N_SCAL_VAR;\n  n_var_ = n_scal_var_;\n"
+        out += "  n_scal_param_ = N_SCAL_PARAM;\n  n_param_ = n_scal_param_;\n\n"
+        out += "  AllocParamArr();\n  AllocVarArr();\n\n"
+        out += "  scal_var_name_ = " + n + "_scal_var_name;\n"
+        out += "  scal_param_name_ = " + n + "_scal_param_name;\n\n"
+        for p in self.params:
+            out += '  SetScalParam( 0, n_node, "' + p[0] + '", ' + c_float(p[1]) + " );\n"
+        for p in self.propagators:
+            out += '  SetScalParam( 0, n_node, "' + p[0] + '", 0.0 );\n'
+        out += "\n"
+        for v in self.state:
+            out += '  SetScalVar( 0, n_node, "' + v[0] + '", ' + \
+                c_float(self.initial_value(v[1])) + " );\n"
+        out += "\n" + self.port_arrays() + "\n"
+        out += '  den_delay_arr_ = GetParamArr() + GetScalParamIdx( "den_delay" );\n\n'
+        out += "  return 0;\n}\n\n"
+        out += "int\n" + n + "::Update( long long it, double t1 )\n{\n"
+        out += "  " + n + "_Update<<< ( n_node_ + 1023 ) / 1024, 1024, 0, stream_ >>>(\n"
+        out += "    n_node_, i_node_0_, var_arr_, param_arr_, const_param_mask_, " \
+            "const_param_offset_, input_spikes_ );\n\n"
+        out += "  return 0;\n}\n\n"
+        out += "int\n" + n + "::Free()\n{\n  FreeVarArr();\n  FreeParamArr();\n\n  return 0;\n}\n\n"
+        out += "int\n" + n + "::Calibrate( double, float time_resolution )\n{\n"
+        out += "  " + n + "_Calibrate<<< ( n_node_ + 1023 ) / 1024, 1024 >>>( n_node_, " \
+            "param_arr_, n_param_, time_resolution );\n"
+        out += "  // the update kernel does not modify the parameters\n"
+        out += "  FoldConstParam( 0 );\n"
+        out += "  input_spikes_ = FuseInputSpikes();\n\n"
+        out += "  return 0;\n}\n"
+        return out
+
+
+###################################################################
+# registration of the model in the NEST GPU sources
+###################################################################
+def insert_line(lines, new_line, match, after=True):
+    """Inserts new_line after (or before) the last line that satisfies match"""
+    idx = [k for k, line in enumerate(lines) if match(line)]
+    if not idx:
+        raise ModelError("cannot find where to insert " + new_line.strip())
+    k = idx[-1] + (1 if after else 0)
+    lines.insert(k, new_line)
+
+
+def register(model, files, src_dir):
+    n = model.name
+
+    def edit(file_name, fn):
+        path = os.path.join(src_dir, file_name)
+        with open(path) as f:
+            lines = f.read().split("\n")
+        fn(lines)
+        with open(path, "w") as f:
+            f.write("\n".join(lines))
+
+    def models_h(lines):
+        if ("  i_" + n + "_model,") in lines:
+            return
+        insert_line(lines, "  i_" + n + "_model,", lambda l: l.strip() == "N_NEURON_MODELS",
+                    after=False)
+        k = [i for i, l in enumerate(lines) if l.rstrip().endswith('" };')][-1]
+        lines[k] = lines[k][:-len(" };")] + ","
+        lines.insert(k + 1, '  "' + n + '" };')
+
+    def models_cu(lines):
+        include = '#include "' + n + '.h"'
+        if include in lines:
+            return
+        insert_line(lines, include, lambda l: l.startswith('#include "') and l < include)
+        block = ["  else if ( model_name == neuron_model_name[ i_" + n + "_model ] )",
+                 "  {",
+                 "    " + n + "* " + n + "_group = new " + n + ";",
+                 "    node_vect_.push_back( " + n + "_group );",
+                 "  }"]
+        k = [i for i, l in enumerate(lines)
+             if "neuron_model_name[ i_poisson_generator_model ]" in l][0]
+        lines[k:k] = block
+
+    def cmake(lines):
+        for file_name in files:
+            if ("\t" + file_name) in lines:
+                continue
+            ext = os.path.splitext(file_name)[1]
+            insert_line(lines, "\t" + file_name,
+                        lambda l: l.startswith("\t") and l.endswith(ext) and
+                        not l.endswith(".cpp") or (ext == ".h" and l == "\t" + file_name))
+
+    def makefile(lines):
+        for file_name in files:
+            if (file_name + " \\") in lines:
+                continue
+            ext = os.path.splitext(file_name)[1]
+            first = [k for k, l in enumerate(lines)
+                     if l == ("HCUSRC=\\" if ext == ".h" else "CUSRC=\\")][0]
+            lines.insert(first + 1, file_name + " \\")
+
+    edit("neuron_models.h", models_h)
+    edit("neuron_models.cu", models_cu)
+    edit("CMakeLists.txt", cmake)
+    edit(os.path.join("..", "Makefile.am"), makefile)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="NEST GPU neuron model generator")
+    parser.add_argument("description", help="model description file")
+    parser.add_argument("-o", "--output-dir", default=".", help="output directory")
+    parser.add_argument("--register", metavar="SRC_DIR",
+                        help="add the model to the NEST GPU sources in SRC_DIR")
+    args = parser.parse_args()
+    with open(args.description) as f:
+        desc = ast.literal_eval(f.read())
+    try:
+        model = Model(desc)
+        files = model.write(args.output_dir)
+        if args.register:
+            register(model, files, args.register)
+    except ModelError as e:
+        print("Error in model " + args.description + ": " + str(e), file=sys.stderr)
+        return 1
+    for file_name in files:
+        print(os.path.join(args.output_dir, file_name))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,118 @@
+/*
+ *  aeif_cond_beta_gen.h
+ *
+ *  This file is part of NEST GPU.
+ *
+ *  Copyright (C) 2021 The NEST Initiative
+ *
+ *  NEST GPU is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NEST GPU is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NEST GPU.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef AEIFCONDBETAGEN_H
+#define AEIFCONDBETAGEN_H
+
+#include "base_neuron.h"
+#include "cuda_error.h"
+#include "neuron_models.h"
+#include "node_group.h"
+#include "rk5.h"
+#include <iostream>
+#include <string>
+
+/* BeginUserDocs: neuron, generated
+
+Short description
++++++++++++++++++
+
+Conductance based adaptive exponential integrate-and-fire neuron model
+
+Description
++++++++++++
+
+aeif_cond_beta_gen has been generated by nestgpu_model_gen.py.
+The ODEs are integrated by the rk5 integrator, which can be
+changed through the group parameter ``integrator``.
+
+Parameters
+++++++++++
+
+The following parameters can be set in the status dictionary.
+
+=================  ============================================================
+ V_m               Membrane potential in mV
+ w                 Adaptation current in pA
+ V_th              Spike initiation threshold in mV
+ Delta_T           Slope factor in mV
+ g_L               Leak conductance in nS
+ E_L               Leak reversal potential in mV
+ C_m               Capacity of the membrane in pF
+ a                 Subthreshold adaptation in nS
+ b                 Spike-triggered adaptation in pA
+ tau_w             Adaptation time constant in ms
+ I_e               Constant external input current in pA
+ V_peak            Spike detection threshold in mV
+ V_reset           Reset value for V_m after a spike in mV
+ t_ref             Duration of refractory period in ms
+ refractory_step   Refractory step counter
+ den_delay         Dendritic delay in ms
+ g                 Synaptic conductance in nS
+ g1                Second state variable of the synaptic conductance
+ E_rev             Reversal potential in mV
+ tau_rise          Rise time constant of synaptic conductance in ms
+ tau_decay         Decay time constant of synaptic conductance in ms
+ g0                Normalization factor of the synaptic conductance
+=================  ============================================================
+
+EndUserDocs */
+
+#define MAX_PORT_NUM 20
+
+struct aeif_cond_beta_gen_rk5
+{
+  int i_node_0_;
+};
+
+class aeif_cond_beta_gen : public BaseNeuron
+{
+public:
+  RungeKutta5< aeif_cond_beta_gen_rk5 > rk5_;
+  float h_min_;
+  float h_;
+  aeif_cond_beta_gen_rk5 rk5_data_struct_;
+
+  int Init( int i_node_0, int n_neuron, int n_port, int i_group, unsigned long long* seed );
+
+  int Calibrate( double time_min, float time_resolution );
+
+  int Update( long long it, double t1 );
+
+  int
+  GetX( int i_neuron, int n_node, double* x )
+  {
+    return rk5_.GetX( i_neuron, n_node, x );
+  }
+
+  int
+  GetY( int i_var, int i_neuron, int n_node, float* y )
+  {
+    return rk5_.GetY( i_var, i_neuron, n_node, y );
+  }
+
+  template < int N_PORT >
+  int UpdateNR( long long it, double t1 );
+};
+
+#endif
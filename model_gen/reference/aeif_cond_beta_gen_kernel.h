@@ -0,0 +1,259 @@
+/*
+ *  aeif_cond_beta_gen_kernel.h
+ *
+ *  This file is part of NEST GPU.
+ *
+ *  Copyright (C) 2021 The NEST Initiative
+ *
+ *  NEST GPU is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NEST GPU is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NEST GPU.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef AEIFCONDBETAGENKERNEL_H
+#define AEIFCONDBETAGENKERNEL_H
+
+#include "aeif_cond_beta_gen.h"
+#include "node_group.h"
+#include "spike_buffer.h"
+#include <cmath>
+#include <string>
+
+#define MIN( a, b ) ( ( ( a ) < ( b ) ) ? ( a ) : ( b ) )
+
+extern __constant__ float NESTGPUTimeResolution;
+
+namespace aeif_cond_beta_gen_ns
+{
+enum ScalVarIndexes
+{
+  i_V_m = 0, // Membrane potential in mV
+  i_w,       // Adaptation current in pA
+  N_SCAL_VAR
+};
+
+enum PortVarIndexes
+{
+  i_g = 0, // Synaptic conductance in nS
+  i_g1,    // Second state variable of the synaptic conductance
+  N_PORT_VAR
+};
+
+enum ScalParamIndexes
+{
+  i_V_th = 0,        // Spike initiation threshold in mV
+  i_Delta_T,         // Slope factor in mV
+  i_g_L,             // Leak conductance in nS
+  i_E_L,             // Leak reversal potential in mV
+  i_C_m,             // Capacity of the membrane in pF
+  i_a,               // Subthreshold adaptation in nS
+  i_b,               // Spike-triggered adaptation in pA
+  i_tau_w,           // Adaptation time constant in ms
+  i_I_e,             // Constant external input current in pA
+  i_V_peak,          // Spike detection threshold in mV
+  i_V_reset,         // Reset value for V_m after a spike in mV
+  i_t_ref,           // Duration of refractory period in ms
+  i_refractory_step, // Refractory step counter
+  i_den_delay,       // Dendritic delay in ms
+  N_SCAL_PARAM
+};
+
+enum PortParamIndexes
+{
+  i_E_rev = 0, // Reversal potential in mV
+  i_tau_rise,  // Rise time constant of synaptic conductance in ms
+  i_tau_decay, // Decay time constant of synaptic conductance in ms
+  i_g0,        // Normalization factor of the synaptic conductance
+  N_PORT_PARAM
+};
+
+enum GroupParamIndexes
+{
+  i_h_min_rel = 0, // Min. step in ODE integr. relative to time resolution
+  i_h0_rel,        // Starting step in ODE integr. relative to time resolution
+  i_warp_step,     // If not 0, the neurons of a warp share the integration step
+  i_integrator,    // ODE integrator: 0 adaptive RK5, 1 exp. Euler, 2 Rosenbrock
+  N_GROUP_PARAM
+};
+
+
+const std::string aeif_cond_beta_gen_scal_var_name[ N_SCAL_VAR ] = { "V_m", "w" };
+
+const std::string aeif_cond_beta_gen_port_var_name[ N_PORT_VAR ] = { "g", "g1" };
+
+const std::string aeif_cond_beta_gen_scal_param_name[ N_SCAL_PARAM ] = { "V_th",
+  "Delta_T",
+  "g_L",
+  "E_L",
+  "C_m",
+  "a",
+  "b",
+  "tau_w",
+  "I_e",
+  "V_peak",
+  "V_reset",
+  "t_ref",
+  "refractory_step",
+  "den_delay" };
+
+const std::string aeif_cond_beta_gen_port_param_name[ N_PORT_PARAM ] = { "E_rev", "tau_rise", "tau_decay", "g0" };
+
+const std::string aeif_cond_beta_gen_group_param_name[ N_GROUP_PARAM ] = { "h_min_rel",
+  "h0_rel",
+  "warp_step",
+  "integrator" };
+
+#define V_m y[ i_V_m ]
+#define w y[ i_w ]
+#define g( i ) y[ N_SCAL_VAR + N_PORT_VAR * i + i_g ]
+#define g1( i ) y[ N_SCAL_VAR + N_PORT_VAR * i + i_g1 ]
+
+#define dV_mdt dydx[ i_V_m ]
+#define dwdt dydx[ i_w ]
+#define dgdt( i ) dydx[ N_SCAL_VAR + N_PORT_VAR * i + i_g ]
+#define dg1dt( i ) dydx[ N_SCAL_VAR + N_PORT_VAR * i + i_g1 ]
+
+#define V_th param[ i_V_th ]
+#define Delta_T param[ i_Delta_T ]
+#define g_L param[ i_g_L ]
+#define E_L param[ i_E_L ]
+#define C_m param[ i_C_m ]
+#define a param[ i_a ]
+#define b param[ i_b ]
+#define tau_w param[ i_tau_w ]
+#define I_e param[ i_I_e ]
+#define V_peak param[ i_V_peak ]
+#define V_reset param[ i_V_reset ]
+#define t_ref param[ i_t_ref ]
+#define refractory_step param[ i_refractory_step ]
+#define den_delay param[ i_den_delay ]
+
+#define E_rev( i ) param[ N_SCAL_PARAM + N_PORT_PARAM * i + i_E_rev ]
+#define tau_rise( i ) param[ N_SCAL_PARAM + N_PORT_PARAM * i + i_tau_rise ]
+#define tau_decay( i ) param[ N_SCAL_PARAM + N_PORT_PARAM * i + i_tau_decay ]
+#define g0( i ) param[ N_SCAL_PARAM + N_PORT_PARAM * i + i_g0 ]
+
+#define h_min_rel_ group_param_[ i_h_min_rel ]
+#define h0_rel_ group_param_[ i_h0_rel ]
+#define warp_step_ group_param_[ i_warp_step ]
+#define integrator_ group_param_[ i_integrator ]
+
+
+template < int NVAR, int NPARAM > //, class DataStruct>
+__device__ void
+Derivatives( double x, float* y, float* dydx, float* param, aeif_cond_beta_gen_rk5 data_struct )
+{
+  enum
+  {
+    n_port = ( NVAR - N_SCAL_VAR ) / N_PORT_VAR
+  };
+  float V = ( refractory_step > 0 ) ? V_reset : MIN( V_m, V_peak );
+  float I_syn = 0.0;
+  for ( int i = 0; i < n_port; i++ )
+  {
+    I_syn += g( i ) * ( E_rev( i ) - V );
+  }
+  float V_spike = Delta_T * exp( ( V - V_th ) / Delta_T );
+
+  dV_mdt = ( refractory_step > 0 ) ? 0 : ( -g_L * ( V - E_L - V_spike ) + I_syn - w + I_e ) / C_m;
+  dwdt = ( a * ( V - E_L ) - w ) / tau_w;
+  for ( int i = 0; i < n_port; i++ )
+  {
+    dg1dt( i ) = -g1( i ) / tau_rise( i );
+    dgdt( i ) = g1( i ) - g( i ) / tau_decay( i );
+  }
+}
+
+template < int NVAR, int NPARAM > //, class DataStruct>
+__device__ void
+ExternalUpdate( double x, float* y, float* param, bool end_time_step, aeif_cond_beta_gen_rk5 data_struct )
+{
+  if ( refractory_step > 0.0 )
+  {
+    V_m = V_reset;
+    if ( end_time_step )
+    {
+      refractory_step -= 1.0;
+    }
+  }
+  else
+  {
+    if ( V_m >= V_peak )
+    { // send spike
+      int neuron_idx = threadIdx.x + blockIdx.x * blockDim.x;
+      PushSpike( data_struct.i_node_0_ + neuron_idx, 1.0 );
+      V_m = V_reset;
+      w += b;
+      refractory_step = ( int ) round( t_ref / NESTGPUTimeResolution );
+      if ( refractory_step < 0 )
+      {
+        refractory_step = 0;
+      }
+    }
+  }
+}
+
+
+};
+
+template <>
+int aeif_cond_beta_gen::UpdateNR< 0 >( long long it, double t1 );
+
+template < int N_PORT >
+int
+aeif_cond_beta_gen::UpdateNR( long long it, double t1 )
+{
+  if ( N_PORT == n_port_ )
+  {
+    const int NVAR = aeif_cond_beta_gen_ns::N_SCAL_VAR + aeif_cond_beta_gen_ns::N_PORT_VAR * N_PORT;
+    const int NPARAM = aeif_cond_beta_gen_ns::N_SCAL_PARAM + aeif_cond_beta_gen_ns::N_PORT_PARAM * N_PORT;
+
+    rk5_.Update< NVAR, NPARAM >( t1, h_min_, rk5_data_struct_ );
+  }
+  else
+  {
+    UpdateNR< N_PORT - 1 >( it, t1 );
+  }
+
+  return 0;
+}
+
+template < int NVAR, int NPARAM >
+__device__ void
+Derivatives( double x, float* y, float* dydx, float* param, aeif_cond_beta_gen_rk5 data_struct )
+{
+  aeif_cond_beta_gen_ns::Derivatives< NVAR, NPARAM >( x, y, dydx, param, data_struct );
+}
+
+template < int NVAR, int NPARAM >
+__device__ void
+ExternalUpdate( double x, float* y, float* param, bool end_time_step, aeif_cond_beta_gen_rk5 data_struct )
+{
+  aeif_cond_beta_gen_ns::ExternalUpdate< NVAR, NPARAM >( x, y, param, end_time_step, data_struct );
+}
+
+
+// refractory_step is the only parameter modified by ExternalUpdate
+template <>
+struct RK5MutableParam< aeif_cond_beta_gen_rk5 >
+{
+  static const int N_MUTABLE = 1;
+  __host__ __device__ static int
+  Idx( int i_mut )
+  {
+    return aeif_cond_beta_gen_ns::i_refractory_step;
+  }
+};
+
+#endif
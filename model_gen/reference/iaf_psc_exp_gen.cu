@@ -0,0 +1,223 @@
+/*
+ *  iaf_psc_exp_gen.cu
+ *
+ *  This file is part of NEST GPU.
+ *
+ *  Copyright (C) 2021 The NEST Initiative
+ *
+ *  NEST GPU is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NEST GPU is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NEST GPU.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "get_spike.h"
+#include "iaf_psc_exp_gen.h"
+#include "propagator_stability.h"
+#include "rk5_param.h"
+#include "spike_buffer.h"
+#include <cmath>
+#include <config.h>
+#include <iostream>
+
+using namespace iaf_psc_exp_gen_ns;
+
+extern __constant__ float NESTGPUTimeResolution;
+extern __device__ double propagator_32( double, double, double, double );
+
+#define I_syn_ex var[ i_I_syn_ex ]
+#define I_syn_in var[ i_I_syn_in ]
+#define V_m_rel var[ i_V_m_rel ]
+#define refractory_step var[ i_refractory_step ]
+
+#define tau_m param[ i_tau_m ]
+#define C_m param[ i_C_m ]
+#define E_L param[ i_E_L ]
+#define I_e param[ i_I_e ]
+#define Theta_rel param[ i_Theta_rel ]
+#define V_reset_rel param[ i_V_reset_rel ]
+#define tau_ex param[ i_tau_ex ]
+#define tau_in param[ i_tau_in ]
+#define t_ref param[ i_t_ref ]
+#define den_delay param[ i_den_delay ]
+
+#define P11ex param[ i_P11ex ]
+#define P11in param[ i_P11in ]
+#define P22 param[ i_P22 ]
+#define P21ex param[ i_P21ex ]
+#define P21in param[ i_P21in ]
+#define P20 param[ i_P20 ]
+
+
+__global__ void
+iaf_psc_exp_gen_Calibrate( int n_node, float* param_arr, int n_param, float h )
+{
+  int i_neuron = threadIdx.x + blockIdx.x * blockDim.x;
+  if ( i_neuron < n_node )
+  {
+    float* param = param_arr + n_param * i_neuron;
+
+    P11ex = exp( -h / tau_ex );
+    P11in = exp( -h / tau_in );
+    P22 = exp( -h / tau_m );
+    P21ex = ( float ) propagator_32( tau_ex, tau_m, C_m, h );
+    P21in = ( float ) propagator_32( tau_in, tau_m, C_m, h );
+    P20 = tau_m / C_m * ( 1.0 - P22 );
+  }
+}
+
+// the state of each neuron is kept in registers during the update,
+// the parameters in const_mask are read from constant memory.
+// The input spikes are folded in the state before it is loaded
+__global__ void
+iaf_psc_exp_gen_Update( int n_node,
+  int i_node_0,
+  float* var_arr,
+  float* param_arr,
+  unsigned long long const_mask,
+  int const_offset,
+  InputSpikeArray input_spikes )
+{
+  int i_neuron = threadIdx.x + blockIdx.x * blockDim.x;
+  if ( i_neuron < n_node )
+  {
+    FoldInputSpikes( input_spikes, i_neuron );
+    float var[ N_SCAL_VAR ];
+    float param[ N_SCAL_PARAM ];
+    for ( int i = 0; i < N_SCAL_VAR; i++ )
+    {
+      var[ i ] = var_arr[ N_SCAL_VAR * i_neuron + i ];
+    }
+    LoadParam< N_SCAL_PARAM >( param, &param_arr[ N_SCAL_PARAM * i_neuron ], const_mask, const_offset );
+
+    if ( refractory_step > 0.0 )
+    {
+      // neuron is absolute refractory
+      refractory_step -= 1.0;
+      I_syn_ex = I_syn_ex * P11ex;
+      I_syn_in = I_syn_in * P11in;
+    }
+    else
+    {
+      V_m_rel = V_m_rel * P22 + I_syn_ex * P21ex + I_syn_in * P21in + I_e * P20;
+      I_syn_ex = I_syn_ex * P11ex;
+      I_syn_in = I_syn_in * P11in;
+    }
+
+    if ( V_m_rel >= Theta_rel )
+    { // send spike
+      PushSpike( i_node_0 + i_neuron, 1.0 );
+      V_m_rel = V_reset_rel;
+      refractory_step = ( int ) round( t_ref / NESTGPUTimeResolution );
+      if ( refractory_step < 0 )
+      {
+        refractory_step = 0;
+      }
+    }
+
+    for ( int i = 0; i < N_SCAL_VAR; i++ )
+    {
+      var_arr[ N_SCAL_VAR * i_neuron + i ] = var[ i ];
+    }
+  }
+}
+
+iaf_psc_exp_gen::~iaf_psc_exp_gen()
+{
+  FreeVarArr();
+  FreeParamArr();
+}
+
+int
+iaf_psc_exp_gen::Init( int i_node_0, int n_node, int /*n_port*/, int i_group, unsigned long long* seed )
+{
+  BaseNeuron::Init( i_node_0, n_node, 2 /*n_port*/, i_group, seed );
+  node_type_ = i_iaf_psc_exp_gen_model;
+
+  n_scal_var_ = N_SCAL_VAR;
+  n_var_ = n_scal_var_;
+  n_scal_param_ = N_SCAL_PARAM;
+  n_param_ = n_scal_param_;
+
+  AllocParamArr();
+  AllocVarArr();
+
+  scal_var_name_ = iaf_psc_exp_gen_scal_var_name;
+  scal_param_name_ = iaf_psc_exp_gen_scal_param_name;
+
+  SetScalParam( 0, n_node, "tau_m", 10.0 );
+  SetScalParam( 0, n_node, "C_m", 250.0 );
+  SetScalParam( 0, n_node, "E_L", -70.0 );
+  SetScalParam( 0, n_node, "I_e", 0.0 );
+  SetScalParam( 0, n_node, "Theta_rel", 15.0 );
+  SetScalParam( 0, n_node, "V_reset_rel", 0.0 );
+  SetScalParam( 0, n_node, "tau_ex", 2.0 );
+  SetScalParam( 0, n_node, "tau_in", 2.0 );
+  SetScalParam( 0, n_node, "t_ref", 2.0 );
+  SetScalParam( 0, n_node, "den_delay", 0.0 );
+  SetScalParam( 0, n_node, "P11ex", 0.0 );
+  SetScalParam( 0, n_node, "P11in", 0.0 );
+  SetScalParam( 0, n_node, "P22", 0.0 );
+  SetScalParam( 0, n_node, "P21ex", 0.0 );
+  SetScalParam( 0, n_node, "P21in", 0.0 );
+  SetScalParam( 0, n_node, "P20", 0.0 );
+
+  SetScalVar( 0, n_node, "I_syn_ex", 0.0 );
+  SetScalVar( 0, n_node, "I_syn_in", 0.0 );
+  SetScalVar( 0, n_node, "V_m_rel", 0.0 );
+  SetScalVar( 0, n_node, "refractory_step", 0.0 );
+
+  // multiplication factor of input signal is always 1 for all nodes
+  float input_weight = 1.0;
+  gpuErrchk( cudaMalloc( &port_weight_arr_, sizeof( float ) ) );
+  gpuErrchk( cudaMemcpy( port_weight_arr_, &input_weight, sizeof( float ), cudaMemcpyHostToDevice ) );
+  port_weight_arr_step_ = 0;
+  port_weight_port_step_ = 0;
+
+  port_input_arr_ = GetVarArr() + GetScalVarIdx( "I_syn_ex" );
+  port_input_arr_step_ = n_var_;
+  port_input_port_step_ = 1;
+
+  den_delay_arr_ = GetParamArr() + GetScalParamIdx( "den_delay" );
+
+  return 0;
+}
+
+int
+iaf_psc_exp_gen::Update( long long it, double t1 )
+{
+  iaf_psc_exp_gen_Update<<< ( n_node_ + 1023 ) / 1024, 1024, 0, stream_ >>>(
+    n_node_, i_node_0_, var_arr_, param_arr_, const_param_mask_, const_param_offset_, input_spikes_ );
+
+  return 0;
+}
+
+int
+iaf_psc_exp_gen::Free()
+{
+  FreeVarArr();
+  FreeParamArr();
+
+  return 0;
+}
+
+int
+iaf_psc_exp_gen::Calibrate( double, float time_resolution )
+{
+  iaf_psc_exp_gen_Calibrate<<< ( n_node_ + 1023 ) / 1024, 1024 >>>( n_node_, param_arr_, n_param_, time_resolution );
+  // the update kernel does not modify the parameters
+  FoldConstParam( 0 );
+  input_spikes_ = FuseInputSpikes();
+
+  return 0;
+}
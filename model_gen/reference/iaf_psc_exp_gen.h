@@ -0,0 +1,145 @@
+/*
+ *  iaf_psc_exp_gen.h
+ *
+ *  This file is part of NEST GPU.
+ *
+ *  Copyright (C) 2021 The NEST Initiative
+ *
+ *  NEST GPU is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NEST GPU is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NEST GPU.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef IAFPSCEXPGEN_H
+#define IAFPSCEXPGEN_H
+
+#include "base_neuron.h"
+#include "cuda_error.h"
+#include "neuron_models.h"
+#include "node_group.h"
+#include <iostream>
+#include <string>
+
+/* BeginUserDocs: neuron, generated
+
+Short description
++++++++++++++++++
+
+Leaky integrate-and-fire neuron model with exponential PSCs
+
+Description
++++++++++++
+
+iaf_psc_exp_gen has been generated by nestgpu_model_gen.py.
+The subthreshold dynamics are updated with propagators
+computed at calibration.
+
+Parameters
+++++++++++
+
+The following parameters can be set in the status dictionary.
+
+=================  ============================================================
+ I_syn_ex          Excitatory synaptic current in pA
+ I_syn_in          Inhibitory synaptic current in pA
+ V_m_rel           Membrane potential relative to E_L in mV
+ refractory_step   Refractory step counter
+ tau_m             Membrane time constant in ms
+ C_m               Membrane capacitance in pF
+ E_L               Resting potential in mV
+ I_e               External current in pA
+ Theta_rel         Threshold relative to E_L in mV
+ V_reset_rel       Reset potential relative to E_L in mV
+ tau_ex            Excitatory synaptic time constant in ms
+ tau_in            Inhibitory synaptic time constant in ms
+ t_ref             Refractory period in ms
+ den_delay         Dendritic delay in ms
+=================  ============================================================
+
+EndUserDocs */
+
+namespace iaf_psc_exp_gen_ns
+{
+enum ScalVarIndexes
+{
+  i_I_syn_ex = 0,    // Excitatory synaptic current in pA
+  i_I_syn_in,        // Inhibitory synaptic current in pA
+  i_V_m_rel,         // Membrane potential relative to E_L in mV
+  i_refractory_step, // Refractory step counter
+  N_SCAL_VAR
+};
+
+enum ScalParamIndexes
+{
+  i_tau_m = 0,   // Membrane time constant in ms
+  i_C_m,         // Membrane capacitance in pF
+  i_E_L,         // Resting potential in mV
+  i_I_e,         // External current in pA
+  i_Theta_rel,   // Threshold relative to E_L in mV
+  i_V_reset_rel, // Reset potential relative to E_L in mV
+  i_tau_ex,      // Excitatory synaptic time constant in ms
+  i_tau_in,      // Inhibitory synaptic time constant in ms
+  i_t_ref,       // Refractory period in ms
+  i_den_delay,   // Dendritic delay in ms
+  i_P11ex,       // propagator
+  i_P11in,
+  i_P22,
+  i_P21ex,
+  i_P21in,
+  i_P20,
+  N_SCAL_PARAM
+};
+
+const std::string iaf_psc_exp_gen_scal_var_name[ N_SCAL_VAR ] = { "I_syn_ex",
+  "I_syn_in",
+  "V_m_rel",
+  "refractory_step" };
+
+const std::string iaf_psc_exp_gen_scal_param_name[ N_SCAL_PARAM ] = { "tau_m",
+  "C_m",
+  "E_L",
+  "I_e",
+  "Theta_rel",
+  "V_reset_rel",
+  "tau_ex",
+  "tau_in",
+  "t_ref",
+  "den_delay",
+  "P11ex",
+  "P11in",
+  "P22",
+  "P21ex",
+  "P21in",
+  "P20" };
+
+} // namespace
+
+class iaf_psc_exp_gen : public BaseNeuron
+{
+  InputSpikeArray input_spikes_; // input spikes folded by the update kernel
+
+public:
+  ~iaf_psc_exp_gen();
+
+  int Init( int i_node_0, int n_neuron, int n_port, int i_group, unsigned long long* seed );
+
+  int Calibrate( double, float time_resolution );
+
+  int Update( long long it, double t1 );
+
+  int Free();
+};
+
+
+#endif
@@ -0,0 +1,50 @@
+#!/bin/bash
+# Generates the example models and compares the sources with those in
+# the reference directory. The generated models are then added to a
+# copy of the NEST GPU sources and compiled with nvcc, if available.
+# Otherwise their syntax is checked with the host C++ compiler, using
+# the minimal CUDA headers of the cuda_stub directory, after removing
+# the kernel launch configurations. A GPU is not needed.
+# The test fails if neither nvcc nor a host C++ compiler is found.
+pass_str[0]="TEST PASSED"
+pass_str[1]="TEST NOT PASSED"
+cd "$(dirname "$0")"
+tmp_dir=$(mktemp -d)
+res=0
+for fn in examples/*.model; do
+    python3 nestgpu_model_gen.py $fn -o $tmp_dir > /dev/null || res=1
+done
+diff -r reference $tmp_dir || res=1
+echo generated sources : ${pass_str[$res]}
+
+if [ "$res" -eq "0" ]; then
+    mkdir $tmp_dir/src
+    cp ../src/*.h ../src/*.cu ../src/CMakeLists.txt $tmp_dir/src
+    cp ../Makefile.am $tmp_dir
+    # configuration header without optional features
+    : > $tmp_dir/src/config.h
+    for fn in examples/*.model; do
+	python3 nestgpu_model_gen.py $fn -o $tmp_dir/src --register $tmp_dir/src > /dev/null || res=1
+    done
+    host_cxx=${CXX:-g++}
+    if which nvcc > /dev/null 2>&1; then
+	for fn in reference/*.cu neuron_models.cu; do
+	    nvcc -std=c++14 -rdc=true -c -I $tmp_dir/src -o $tmp_dir/tmp.o \
+		 $tmp_dir/src/$(basename $fn) || res=1
+	done
+    elif which $host_cxx > /dev/null 2>&1; then
+	echo "nvcc not found, checking the syntax with $host_cxx"
+	sed -i 's/<<<[^>]*>>>//' $tmp_dir/src/*.h $tmp_dir/src/*.cu
+	for fn in reference/*.cu neuron_models.cu; do
+	    $host_cxx -std=c++14 -fsyntax-only -x c++ \
+		      -include cuda_stub/cuda_stub.h -I cuda_stub -I $tmp_dir/src \
+		      $tmp_dir/src/$(basename $fn) || res=1
+	done
+    else
+	echo "Neither nvcc nor $host_cxx found, the generated sources cannot be compiled"
+	res=1
+    fi
+    echo compilation : ${pass_str[$res]}
+fi
+rm -rf $tmp_dir
+exit $res
@@ -328,8 +328,10 @@ def build_network():
         i_conn_rule = {'rule': 'all_to_all'}
         e_conn_rule = {'rule': 'all_to_all'}
     else:
-        i_conn_rule = {'rule': 'fixed_indegree', 'indegree': CI_distrib}
-        e_conn_rule = {'rule': 'fixed_indegree', 'indegree': CE_distrib}
+        i_conn_rule = {'rule': 'fixed_indegree', 'indegree': CI_distrib,
+                       'allow_autapses': False, 'allow_multapses': True}
+        e_conn_rule = {'rule': 'fixed_indegree', 'indegree': CE_distrib,
+                       'allow_autapses': False, 'allow_multapses': True}
 
     brunel_params["connection_rules"] = {"inhibitory": i_conn_rule, "excitatory": e_conn_rule}
     
@@ -0,0 +1,72 @@
+# Benchmark of the per-step overhead of many small node groups.
+# The same population of iaf_psc_exp neurons driven by Poisson input is
+# created as a single group and as n_groups groups, the latter simulated
+# with and without the merging of the groups of the same model in a
+# single update kernel launch (kernel parameter merge_node_groups).
+# The total number of spikes must be the same in all cases.
+# Usage: python3 bench_merge_groups.py [n_neurons] [n_groups] [merge]
+# If merge is not given, the three cases are run in separate processes.
+import sys
+import subprocess
+import time
+import nestgpu as ngpu
+
+n_neurons = 10000
+n_groups = 50
+if len(sys.argv)>1:
+    n_neurons = int(sys.argv[1])
+if len(sys.argv)>2:
+    n_groups = int(sys.argv[2])
+
+if len(sys.argv)<4:
+    spike_num_list = []
+    for n_gr, merge in [(1, 1), (n_groups, 1), (n_groups, 0)]:
+        out = subprocess.check_output([sys.executable, sys.argv[0],
+                                       str(n_neurons), str(n_gr), str(merge)])
+        out = out.decode()
+        print(out)
+        spike_num_list.append(out.split("total spikes: ")[-1].split()[0])
+    if len(set(spike_num_list)) != 1:
+        print("Different number of spikes: ", spike_num_list)
+        sys.exit(1)
+    sys.exit(0)
+
+merge = (int(sys.argv[3]) != 0)
+sim_time = 1000.0
+poiss_rate = 20000.0 # poisson signal rate in Hz
+poiss_weight = 50.0
+poiss_delay = 0.2 # poisson signal delay in ms
+
+ngpu.SetKernelStatus("rnd_seed", 1234) # seed for GPU random numbers
+ngpu.SetKernelStatus("merge_node_groups", merge)
+
+pg = ngpu.Create("poisson_generator")
+ngpu.SetStatus(pg, "rate", poiss_rate)
+conn_spec={"rule": "all_to_all"}
+syn_spec={'receptor': 0, 'weight': poiss_weight, 'delay': poiss_delay}
+
+group_size = n_neurons // n_groups
+neuron_list = []
+for i_group in range(n_groups):
+    neuron = ngpu.Create('iaf_psc_exp', group_size)
+    ngpu.Connect(pg, neuron, conn_spec, syn_spec)
+    ngpu.ActivateSpikeCount(neuron)
+    neuron_list.append(neuron)
+
+ngpu.Calibrate()
+t0 = time.time()
+ngpu.Simulate(sim_time)
+t_sim = time.time() - t0
+
+n_spikes = 0
+for neuron in neuron_list:
+    n_spikes += sum([row[0] for row in ngpu.GetStatus(neuron, "spike_count")])
+
+n_steps = int(round(sim_time/ngpu.GetTimeResolution()))
+print("n_groups: ", n_groups, " merge_node_groups: ", int(merge),
+      " n_neurons: ", group_size*n_groups)
+print("simulation time: ", t_sim, " s")
+print("time per step: ", 1.0e6*t_sim/n_steps, " us")
+print("total spikes: ", n_spikes)
+
+sys.exit(0)
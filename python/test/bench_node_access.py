@@ -0,0 +1,59 @@
+# Benchmark of the latency of SetStatus and GetStatus calls on neuron
+# state variables between simulation chunks. The variables are accessed
+# both through node sequences and through lists of node indexes, which
+# use temporary device arrays for the indexes and the values.
+# The values read must be equal to those set.
+# Usage: python3 bench_node_access.py [n_neurons] [n_calls]
+import sys
+import time
+import nestgpu as ngpu
+
+n_neurons = 10000
+n_calls = 200
+if len(sys.argv)>1:
+    n_neurons = int(sys.argv[1])
+if len(sys.argv)>2:
+    n_calls = int(sys.argv[2])
+sim_chunk = 1.0
+
+ngpu.SetKernelStatus("verbosity_level", 0)
+neuron = ngpu.Create("iaf_psc_exp", n_neurons)
+# every other neuron of the population, accessed by index
+neuron_list = neuron.ToList()[::2]
+n_list = len(neuron_list)
+
+ngpu.Calibrate()
+ngpu.Simulate(sim_chunk)
+
+t_set_seq = t_get_seq = t_set_list = t_get_list = 0.0
+for i_call in range(n_calls):
+    val = -70.0 + 0.01*i_call
+    t0 = time.time()
+    ngpu.SetStatus(neuron, "V_m_rel", val)
+    t_set_seq += time.time() - t0
+    t0 = time.time()
+    v_seq = ngpu.GetStatus(neuron, "V_m_rel")
+    t_get_seq += time.time() - t0
+    t0 = time.time()
+    ngpu.SetStatus(neuron_list, "V_m_rel", val + 1.0)
+    t_set_list += time.time() - t0
+    t0 = time.time()
+    v_list = ngpu.GetStatus(neuron_list, "V_m_rel")
+    t_get_list += time.time() - t0
+    if abs(v_seq[1][0] - val) > 1.0e-4 or \
+       abs(v_list[-1][0] - val - 1.0) > 1.0e-4:
+        print("Wrong value of V_m_rel")
+        sys.exit(1)
+    ngpu.Simulate(sim_chunk)
+
+print("n_neurons: ", n_neurons, " n_calls: ", n_calls)
+print("SetStatus node sequence (", n_neurons, " neurons): ",
+      1.0e6*t_set_seq/n_calls, " us")
+print("GetStatus node sequence (", n_neurons, " neurons): ",
+      1.0e6*t_get_seq/n_calls, " us")
+print("SetStatus node list (", n_list, " neurons): ",
+      1.0e6*t_set_list/n_calls, " us")
+print("GetStatus node list (", n_list, " neurons): ",
+      1.0e6*t_get_list/n_calls, " us")
+
+sys.exit(0)
@@ -0,0 +1,88 @@
+# Benchmark of the two step-size policies of the RK5 integrator.
+# A population of aeif_cond_beta neurons driven by Poisson input is
+# simulated with warp_step=0 (each neuron has its own adaptive step)
+# and with warp_step=1 (the neurons of a warp share a common step).
+# The first neuron of the population receives the same input as in
+# test_aeif_cond_beta.py, and its membrane potential is compared with
+# the NEST reference trace, so that the accuracy of the shared step
+# is checked while the other neurons of its warp are spiking.
+# Usage: python3 bench_rk5_warp_step.py [n_neurons] [warp_step]
+# If warp_step is not given, both policies are run in separate processes.
+import sys
+import subprocess
+import time
+import nestgpu as ngpu
+import numpy as np
+
+tolerance = 0.00005
+n_neurons = 100000
+if len(sys.argv)>1:
+    n_neurons = int(sys.argv[1])
+
+if len(sys.argv)<3:
+    ret = 0
+    for warp_step in [0, 1]:
+        ret |= subprocess.call([sys.executable, sys.argv[0], str(n_neurons),
+                                str(warp_step)])
+    sys.exit(ret)
+
+warp_step = float(sys.argv[2])
+sim_time = 800.0
+poiss_rate = 2000.0 # poisson signal rate in Hz
+poiss_weight = 0.2
+poiss_delay = 0.2 # poisson signal delay in ms
+
+ngpu.SetKernelStatus("rnd_seed", 1234) # seed for GPU random numbers
+
+neuron = ngpu.Create('aeif_cond_beta', n_neurons)
+ngpu.SetStatus(neuron, {"V_peak": 0.0, "a": 4.0, "b":80.5, "E_L":-70.6,
+                        "g_L":300.0,
+                        'E_rev_ex': 20.0, 'E_rev_in': -85.0,
+                        'tau_decay_ex': 40.0,
+                        'tau_decay_in': 20.0,
+                        'tau_rise_ex': 20.0,
+                        'tau_rise_in': 5.0,
+                        'warp_step': warp_step})
+
+# reference neuron, with the same input as in test_aeif_cond_beta.py
+spike = ngpu.Create("spike_generator")
+spike_times = [10.0, 400.0]
+ngpu.SetStatus(spike, {"spike_times": spike_times})
+delay = [1.0, 100.0]
+weight = [0.1, 0.2]
+conn_spec={"rule": "all_to_all"}
+for syn in range(2):
+    syn_spec={'receptor': syn, 'weight': weight[syn], 'delay': delay[syn]}
+    ngpu.Connect(spike, neuron[0:1], conn_spec, syn_spec)
+
+# the other neurons are driven by poisson input
+if n_neurons>1:
+    pg = ngpu.Create("poisson_generator")
+    ngpu.SetStatus(pg, "rate", poiss_rate)
+    syn_spec={'receptor': 0, 'weight': poiss_weight, 'delay': poiss_delay}
+    ngpu.Connect(pg, neuron[1:n_neurons], conn_spec, syn_spec)
+
+record = ngpu.CreateRecord("", ["V_m"], [neuron[0]], [0])
+
+ngpu.Calibrate()
+t0 = time.time()
+ngpu.Simulate(sim_time)
+t_sim = time.time() - t0
+
+data_list = ngpu.GetRecordData(record)
+V_m=[row[1] for row in data_list]
+data = np.loadtxt('test_aeif_cond_beta_nest.txt', delimiter="\t")
+V_m1=[x[1] for x in data ]
+dV=[V_m[i*10+20]-V_m1[i] for i in range(len(V_m1))]
+rmse =np.std(dV)/abs(np.mean(V_m))
+
+n_steps = int(round(sim_time/ngpu.GetTimeResolution()))
+print("warp_step: ", int(warp_step), " n_neurons: ", n_neurons)
+print("simulation time: ", t_sim, " s")
+print("time steps per second: ", n_steps/t_sim)
+print("neuron updates per second: ", n_steps*n_neurons/t_sim)
+print("rmse : ", rmse, " tolerance: ", tolerance)
+if rmse>tolerance:
+    sys.exit(1)
+
+sys.exit(0)
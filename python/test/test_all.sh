@@ -1,7 +1,7 @@
 pass_str[0]="TEST PASSED"
 pass_str[1]="TEST NOT PASSED"
 :>log.txt
-for fn in test_iaf_psc_exp_g.py test_fixed_total_number.py test_iaf_psc_exp.py test_spike_times.py test_aeif_cond_alpha.py test_aeif_cond_beta.py test_aeif_psc_alpha.py test_aeif_psc_delta.py test_aeif_psc_exp.py test_aeif_cond_alpha_multisynapse.py  test_aeif_cond_beta_multisynapse.py  test_aeif_psc_alpha_multisynapse.py  test_aeif_psc_exp_multisynapse.py test_stdp_list.py test_stdp.py test_syn_model.py test_brunel_list.py test_brunel_outdegree.py test_brunel_user_m1.py test_spike_detector.py; do
+for fn in test_iaf_psc_exp_g.py test_fixed_total_number.py test_iaf_psc_exp.py test_spike_times.py test_aeif_cond_alpha.py test_aeif_cond_beta.py test_aeif_psc_alpha.py test_aeif_psc_delta.py test_aeif_psc_exp.py test_aeif_cond_alpha_multisynapse.py  test_aeif_cond_beta_multisynapse.py  test_aeif_psc_alpha_multisynapse.py  test_aeif_psc_exp_multisynapse.py test_stdp_list.py test_stdp.py test_syn_model.py test_brunel_list.py test_brunel_outdegree.py test_brunel_user_m1.py test_spike_detector.py test_get_connections.py test_fixed_step.py test_const_param.py test_jit.py test_streams.py test_precise_spike.py test_poiss_gen_stateless.py test_merge_dir_conn.py test_poisson_modulation.py test_spike_generator_chunks.py test_spike_train_loading.py test_stdp_trace.py test_rev_conn_device.py test_plastic_partition.py test_connection_weights.py; do
     python3 $fn >> log.txt 2>err.txt
     res=$?
     cat err.txt >> log.txt
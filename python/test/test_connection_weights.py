@@ -0,0 +1,100 @@
+import sys
+import os
+import nestgpu as ngpu
+import numpy as np
+tolerance = 1.0e-6
+# A population of parrot neurons driven by poisson generators is connected
+# randomly through static and plastic synapses. The weights read in bulk
+# with GetConnectionWeights must match those of GetStatus, before and after
+# calibration and after the stdp updates. The weights set in bulk and the
+# ones restored from a binary dump of the whole network must be read back
+h = 0.1
+n_neuron = 200
+indegree = 20
+sim_time = 200.0
+weight_file = "test_connection_weights.dat"
+
+ngpu.SetKernelStatus("rnd_seed", 1234)
+ngpu.SetKernelStatus("verbosity_level", 0)
+ngpu.SetTimeResolution(h)
+
+def CheckBadConnectionId(message):
+    bad_conn_id = [ngpu.ConnectionId(parrot[0], 0, 2*indegree*n_neuron)]
+    for func in [lambda: ngpu.GetConnectionWeights(bad_conn_id),
+                 lambda: ngpu.SetConnectionWeights(bad_conn_id, [0.0])]:
+        try:
+            func()
+        except ValueError:
+            continue
+        print(message)
+        sys.exit(1)
+
+def CheckWeights(conn_id, expected_w, message):
+    w = ngpu.GetConnectionWeights(conn_id)
+    if len(w) != len(expected_w) \
+       or np.max(np.abs(w - np.array(expected_w))) > tolerance:
+        print(message)
+        sys.exit(1)
+
+syn_group = ngpu.CreateSynGroup("stdp", {"lambda": 0.01, "Wmax": 1.0})
+pg = ngpu.Create("poisson_generator")
+ngpu.SetStatus(pg, "rate", 20.0)
+parrot = ngpu.Create("parrot_neuron", n_neuron)
+ngpu.Connect(pg, parrot, {"rule": "all_to_all"},
+             {"receptor": 0, "weight": 1.0, "delay": 1.0})
+# plastic and static connections target the dummy port of the parrot
+# neurons. The plastic connections are created first, so that on the GPU
+# they are stored in a different order
+ngpu.Connect(parrot, parrot, {"rule": "fixed_indegree", "indegree": indegree},
+             {"receptor": 1, "weight": 0.5, "delay": 2.0,
+              "synapse_group": syn_group})
+ngpu.Connect(parrot, parrot, {"rule": "fixed_indegree", "indegree": indegree},
+             {"receptor": 1, "weight": 0.2, "delay": 2.0})
+
+# before calibration the weights are set and read on the host
+conn_id = ngpu.GetConnections(parrot, parrot)
+init_w = np.random.default_rng(1234).uniform(0.1, 0.9, len(conn_id))
+ngpu.SetConnectionWeights(conn_id, init_w)
+CheckWeights(conn_id, ngpu.GetStatus(conn_id, "weight"),
+             "Wrong weights set before calibration")
+ngpu.SaveConnectionWeights(weight_file)
+saved_w = np.fromfile(weight_file, dtype=np.float32)
+CheckBadConnectionId("Wrong connection id accepted before calibration")
+
+ngpu.Simulate(sim_time)
+
+# the connection ids obtained before calibration are still valid
+if len(ngpu.GetConnections(parrot, parrot)) != len(conn_id):
+    print("Wrong number of connections")
+    sys.exit(1)
+CheckWeights(conn_id, ngpu.GetStatus(conn_id, "weight"),
+             "Bulk weights differ from the connection status")
+syn = np.array(ngpu.GetStatus(conn_id, "syn"))
+static_w = ngpu.GetConnectionWeights(conn_id)[syn == 0]
+if np.max(np.abs(static_w - init_w[syn == 0])) > tolerance:
+    print("Static weights changed in the simulation")
+    sys.exit(1)
+
+new_w = np.random.default_rng(5678).uniform(0.0, 1.0, len(conn_id))
+ngpu.SetConnectionWeights(conn_id, new_w)
+CheckWeights(conn_id, new_w.astype(np.float32),
+             "Wrong weights set after calibration")
+CheckBadConnectionId("Wrong connection id accepted after calibration")
+
+# the dump taken before calibration is in the order of the GPU arrays
+ngpu.LoadConnectionWeights(weight_file)
+ngpu.SaveConnectionWeights(weight_file)
+if np.max(np.abs(np.fromfile(weight_file, dtype=np.float32) - saved_w)) \
+   > tolerance:
+    print("Weight dumps before and after calibration differ")
+    sys.exit(1)
+CheckWeights(conn_id, ngpu.GetStatus(conn_id, "weight"),
+             "Wrong weights loaded after calibration")
+CheckWeights(conn_id, init_w.astype(np.float32),
+             "Wrong weights loaded from file")
+
+ngpu.Simulate(sim_time)
+CheckWeights(conn_id, ngpu.GetStatus(conn_id, "weight"),
+             "Bulk weights differ from the connection status")
+os.remove(weight_file)
+sys.exit(0)
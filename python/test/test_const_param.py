@@ -0,0 +1,75 @@
+import sys
+import nestgpu as ngpu
+# two groups of aeif_cond_beta neurons with the same parameters, except
+# for the threshold of the last neuron of the second group. The parameters
+# of the first group are all folded in constant memory at calibration,
+# while V_th is read from the per-neuron array in the second group.
+# The first neurons of the two groups must have the same dynamics
+n_neurons = 10
+neuron_list = []
+for i in range(2):
+    neuron = ngpu.Create('aeif_cond_beta', n_neurons)
+    ngpu.SetStatus(neuron, {"V_peak": 0.0, "a": 4.0, "b":80.5, "E_L":-70.6,
+                            "g_L":300.0,
+                            'E_rev_ex': 20.0, 'E_rev_in': -85.0,
+                            'tau_decay_ex': 40.0,
+                            'tau_decay_in': 20.0,
+                            'tau_rise_ex': 20.0,
+                            'tau_rise_in': 5.0})
+    neuron_list.append(neuron)
+ngpu.SetStatus(neuron_list[1][n_neurons-1:n_neurons], "V_th", -40.0)
+
+spike = ngpu.Create("spike_generator")
+spike_times = [10.0, 400.0]
+ngpu.SetStatus(spike, {"spike_times": spike_times})
+delay = [1.0, 100.0]
+weight = [0.1, 0.2]
+conn_spec={"rule": "all_to_all"}
+for neuron in neuron_list:
+    for syn in range(2):
+        syn_spec={'receptor': syn, 'weight': weight[syn], 'delay': delay[syn]}
+        ngpu.Connect(spike, neuron, conn_spec, syn_spec)
+
+record_list = []
+for neuron in neuron_list:
+    record_list.append(ngpu.CreateRecord("", ["V_m"], [neuron[0]], [0]))
+
+ngpu.Simulate(800.0)
+
+const_param0 = ngpu.GetConstParamNames(neuron_list[0][0])
+const_param1 = ngpu.GetConstParamNames(neuron_list[1][0])
+print("folded parameters of group 0: ", const_param0)
+print("folded parameters of group 1: ", const_param1)
+ret = 0
+if ("C_m" not in const_param0) | ("V_th" not in const_param0):
+    print("C_m and V_th should be folded in group 0")
+    ret = 1
+if ("C_m" not in const_param1) | ("V_th" in const_param1):
+    print("C_m should be folded in group 1, V_th should not")
+    ret = 1
+# refractory_step is modified by the neuron update
+if "refractory_step" in const_param0:
+    print("refractory_step should not be folded")
+    ret = 1
+
+V_m0=[row[1] for row in ngpu.GetRecordData(record_list[0])]
+V_m1=[row[1] for row in ngpu.GetRecordData(record_list[1])]
+if V_m0 != V_m1:
+    print("Different dynamics with and without folded parameters")
+    ret = 1
+
+# a parameter set after calibration is no more folded
+ngpu.SetStatus(neuron_list[0], "C_m", 200.0)
+if "C_m" in ngpu.GetConstParamNames(neuron_list[0][0]):
+    print("C_m should not be folded after being set")
+    ret = 1
+
+# the spike generator is the last node created
+try:
+    ngpu.GetConstParamNames(spike[0] + 1)
+    print("Node index out of range accepted")
+    ret = 1
+except ValueError:
+    pass
+
+sys.exit(ret)
@@ -0,0 +1,148 @@
+import sys
+import math
+import nestgpu as ngpu
+import numpy as np
+# same neuron and input as in test_aeif_cond_beta.py, integrated
+# with the fixed-step integrators, one neuron group for each integrator.
+# The membrane potential is compared with the NEST reference and with
+# a double-precision implementation of the same fixed-step schemes
+h = 0.1
+integrator_list = ["exp_euler", "rosenbrock"]
+# the global truncation error of a scheme of order p is C*h**p.
+# The error constants are about half of these, as measured with the
+# double-precision implementation for h = 0.1 and h = 0.05
+order = {"exp_euler": 1, "rosenbrock": 2}
+error_const = {"exp_euler": 1.0e-7, "rosenbrock": 5.0e-6}
+# the rounding errors of the single-precision integration on the GPU
+# give a relative rmse of about 3e-7
+roundoff_tolerance = 1.0e-6
+tolerance = {}
+for integrator in integrator_list:
+    tolerance[integrator] = roundoff_tolerance \
+        + error_const[integrator]*h**order[integrator]
+
+param = {"V_peak": 0.0, "a": 4.0, "b":80.5, "E_L":-70.6, "g_L":300.0,
+         'E_rev_ex': 20.0, 'E_rev_in': -85.0,
+         'tau_decay_ex': 40.0,
+         'tau_decay_in': 20.0,
+         'tau_rise_ex': 20.0,
+         'tau_rise_in': 5.0}
+ngpu.SetTimeResolution(h)
+neuron_list = []
+for integrator in integrator_list:
+    neuron = ngpu.Create('aeif_cond_beta', 1)
+    ngpu.SetStatus(neuron, param)
+    ngpu.SetStatus(neuron, {'integrator': integrator})
+    neuron_list.append(neuron)
+
+spike = ngpu.Create("spike_generator")
+spike_times = [10.0, 400.0]
+n_spikes = 2
+
+# set spike times and heights
+ngpu.SetStatus(spike, {"spike_times": spike_times})
+delay = [1.0, 100.0]
+weight = [0.1, 0.2]
+
+conn_spec={"rule": "all_to_all"}
+for neuron in neuron_list:
+    for syn in range(2):
+        syn_spec={'receptor': syn, 'weight': weight[syn], 'delay': delay[syn]}
+        ngpu.Connect(spike, neuron, conn_spec, syn_spec)
+
+record_list = []
+for neuron in neuron_list:
+    record_list.append(ngpu.CreateRecord("", ["V_m"], [neuron[0]], [0]))
+
+sim_time = 800.0
+ngpu.Simulate(sim_time)
+
+# double-precision implementation of the model and of the schemes,
+# as in aeif_cond_beta_kernel.h and fixed_step.h
+V_th = -50.4
+Delta_T = 2.0
+C_m = 281.0
+tau_w = 144.0
+def G0(tau_rise, tau_decay):
+    t_p = tau_decay*tau_rise*math.log(tau_decay/tau_rise) \
+        / (tau_decay - tau_rise)
+    return (1.0/tau_rise - 1.0/tau_decay) \
+        / (math.exp(-t_p/tau_decay) - math.exp(-t_p/tau_rise))
+
+def Derivatives(y):
+    V, w, g1_ex, g_ex, g1_in, g_in = y
+    V = min(V, param["V_peak"])
+    I_syn = g_ex*(param["E_rev_ex"] - V) + g_in*(param["E_rev_in"] - V)
+    V_spike = Delta_T*math.exp((V - V_th)/Delta_T)
+    return [(-param["g_L"]*(V - param["E_L"] - V_spike) + I_syn - w)/C_m,
+            (param["a"]*(V - param["E_L"]) - w)/tau_w,
+            -g1_ex/param["tau_rise_ex"], g1_ex - g_ex/param["tau_decay_ex"],
+            -g1_in/param["tau_rise_in"], g1_in - g_in/param["tau_decay_in"]]
+
+def StepRate(y):
+    k1 = Derivatives(y)
+    k2 = Derivatives([y[i] + h*k1[i] for i in range(6)])
+    hrate = [(k2[i] - k1[i])/k1[i] if k1[i] != 0.0 else 0.0
+             for i in range(6)]
+    return k1, hrate
+
+def Phi1(z):
+    return 1.0 + 0.5*z if abs(z) < 1.0e-4 else math.expm1(z)/z
+
+def ExpEulerStep(y):
+    k1, hrate = StepRate(y)
+    return [y[i] + h*Phi1(min(hrate[i], 1.0))*k1[i] for i in range(6)]
+
+def RosenbrockStep(y):
+    k1, hrate = StepRate(y)
+    w_diag = [1.0 - (1.0 + 1.0/math.sqrt(2.0))*min(r, 0.0) for r in hrate]
+    k1 = [k1[i]/w_diag[i] for i in range(6)]
+    k2 = Derivatives([y[i] + h*k1[i] for i in range(6)])
+    k2 = [(k2[i] - 2.0*k1[i])/w_diag[i] for i in range(6)]
+    return [y[i] + h*(1.5*k1[i] + 0.5*k2[i]) for i in range(6)]
+
+step_func = {"exp_euler": ExpEulerStep, "rosenbrock": RosenbrockStep}
+# input spikes (time step, variable, increment)
+g0_ex = G0(param["tau_rise_ex"], param["tau_decay_ex"])
+g0_in = G0(param["tau_rise_in"], param["tau_decay_in"])
+input_spikes = {}
+for t in spike_times:
+    input_spikes[int(round((t + delay[0])/h))] = (2, weight[0]*g0_ex)
+    input_spikes[int(round((t + delay[1])/h))] = (4, weight[1]*g0_in)
+
+def ReferenceVm(integrator):
+    y = [param["E_L"], 0.0, 0.0, 0.0, 0.0, 0.0]
+    V_m = []
+    for i_step in range(int(round(sim_time/h))):
+        if i_step in input_spikes:
+            i_var, dg = input_spikes[i_step]
+            y[i_var] += dg
+        y = step_func[integrator](y)
+        V_m.append(y[0])
+    return V_m
+
+data = np.loadtxt('test_aeif_cond_beta_nest.txt', delimiter="\t")
+t1=[x[0] for x in data ]
+V_m1=[x[1] for x in data ]
+
+ret = 0
+for k in range(len(integrator_list)):
+    integrator = integrator_list[k]
+    data_list = ngpu.GetRecordData(record_list[k])
+    V_m=[row[1] for row in data_list]
+    dV=[V_m[i*10+20]-V_m1[i] for i in range(len(t1))]
+    rmse =np.std(dV)/abs(np.mean(V_m))
+    print(integrator, " rmse : ", rmse, " tolerance: ",
+          tolerance[integrator])
+    if rmse>tolerance[integrator]:
+        ret = 1
+    # the value of the reference at t is the one after the step ending at t
+    V_m_ref = ReferenceVm(integrator)
+    dV=[V_m[i*10+20]-V_m_ref[int(round(t1[i]/h))-1] for i in range(len(t1))]
+    rmse =np.std(dV)/abs(np.mean(V_m))
+    print(integrator, " rmse from double-precision scheme : ", rmse,
+          " tolerance: ", roundoff_tolerance)
+    if rmse>roundoff_tolerance:
+        ret = 1
+
+sys.exit(ret)
@@ -0,0 +1,63 @@
+import sys
+import nestgpu as ngpu
+
+# Compares the connections returned by population queries, which can use
+# the reverse (by target) index, with those obtained filtering the list
+# of all connections
+N = 1000
+K = 50
+
+neuron = ngpu.Create("iaf_psc_exp", N)
+conn_dict={"rule": "fixed_indegree", "indegree": K}
+syn_dict={"weight": 1.0, "delay": {"distribution":"uniform", "low":0.1,
+                                   "high":2.0}}
+ngpu.Connect(neuron, neuron, conn_dict, syn_dict)
+
+all_conn = ngpu.GetConnections()
+all_status = ngpu.GetStatus(all_conn)
+
+def Check(source, target, syn_group=-1):
+    conn = ngpu.GetConnections(source, target, syn_group)
+    status = ngpu.GetStatus(conn)
+    source_set = set(source.ToList() if type(source)==ngpu.NodeSeq
+                     else source)
+    target_set = set(target.ToList() if type(target)==ngpu.NodeSeq
+                     else target)
+    expected = [st for st in all_status
+                if (st["source"] in source_set) &
+                (st["target"] in target_set) &
+                ((syn_group<0) | (st["syn"]==syn_group))]
+    if status != expected:
+        print("Wrong connections from ", source, " to ", target)
+        return False
+    return True
+
+ok = True
+# inputs to a small population, from all nodes
+ok &= Check(neuron, neuron[10:20])
+ok &= Check(neuron, [3, 500, 999])
+ok &= Check(neuron[100:900], neuron[0:5], 0)
+# outputs of a small population
+ok &= Check(neuron[10:20], neuron)
+ok &= Check([7, 8, 900], neuron[0:500])
+# after new connections the index must be updated
+ngpu.Connect(neuron[0:10], neuron[10:20], {"rule": "all_to_all"},
+             {"weight": 2.0, "delay": 1.0})
+all_conn = ngpu.GetConnections()
+all_status = ngpu.GetStatus(all_conn)
+ok &= Check(neuron, neuron[10:20])
+
+# columnar and per-connection status must agree
+columns = ngpu.GetConnectionColumns(all_conn[0:100])
+for i in range(100):
+    st = ngpu.GetConnectionStatus(all_conn[i])
+    for key in st:
+        if columns[key][i] != st[key]:
+            ok = False
+
+if ok:
+    print("TEST PASSED")
+    sys.exit(0)
+else:
+    print("TEST NOT PASSED")
+    sys.exit(1)
@@ -0,0 +1,51 @@
+import sys
+import nestgpu as ngpu
+import numpy as np
+tolerance = 0.00005
+# same neuron and input as in test_iaf_psc_exp.py, with the update kernel
+# compiled at run time. Each group has a second neuron with a constant
+# input current, so that I_e is not a group constant, and its dynamics
+# must be the same as with the precompiled kernel
+neuron_list = []
+for jit in [0, 1]:
+    neuron = ngpu.Create('iaf_psc_exp', 2)
+    ngpu.SetStatus(neuron, {"jit": jit})
+    ngpu.SetStatus(neuron[1:2], {"I_e": 400.0})
+    neuron_list.append(neuron)
+
+spike = ngpu.Create("spike_generator")
+spike_times = [10.0, 400.0]
+ngpu.SetStatus(spike, {"spike_times": spike_times})
+delay = [1.0, 100.0]
+weight = [1.0, -2.0]
+conn_spec={"rule": "all_to_all"}
+for neuron in neuron_list:
+    for syn in range(2):
+        syn_spec={'receptor': syn, 'weight': weight[syn], 'delay': delay[syn]}
+        ngpu.Connect(spike, neuron, conn_spec, syn_spec)
+
+record_list = []
+for neuron in neuron_list:
+    record_list.append(ngpu.CreateRecord("", ["V_m_rel", "V_m_rel"],
+                                         [neuron[0], neuron[1]], [0, 0]))
+
+ngpu.Simulate(800.0)
+
+data_list = [ngpu.GetRecordData(record) for record in record_list]
+V_m=[-70.0+row[1] for row in data_list[1]]
+data = np.loadtxt('test_iaf_psc_exp_nest.txt', delimiter="\t")
+t1=[x[0] for x in data ]
+V_m1=[x[1] for x in data ]
+dV=[V_m[i*10+20]-V_m1[i] for i in range(len(t1))]
+rmse =np.std(dV)/abs(np.mean(V_m))
+print("rmse : ", rmse, " tolerance: ", tolerance)
+ret = 0
+if rmse>tolerance:
+    ret = 1
+
+V_m_I_e = [[row[2] for row in data] for data in data_list]
+if V_m_I_e[0] != V_m_I_e[1]:
+    print("Different dynamics with precompiled and run-time compiled kernels")
+    ret = 1
+
+sys.exit(ret)
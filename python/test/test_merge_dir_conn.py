@@ -0,0 +1,67 @@
+import sys
+import subprocess
+import nestgpu as ngpu
+import numpy as np
+tolerance = 0.03
+fano_tolerance = 0.2
+# A group of poisson generators with two different rates drives each
+# neuron of a population of parrot neurons. The simulation is run with
+# and without merging the direct connections of the generators with
+# equal parameters (kernel parameter merge_dir_conn), in separate
+# processes. In both cases the number of time steps with a spike must
+# agree with the Poisson statistics, and the spike counts of the parrot
+# neurons must have a Fano factor close to 1. With merged connections,
+# the rate can be changed after the simulation only for the whole group
+h = 0.1
+n_neuron = 1000
+n_gen = 20
+rate = [5.0, 15.0]
+sim_time = 1000.0
+if len(sys.argv)<2:
+    # probability of at least one spike in a time step
+    p_spike = 1.0 - np.exp(-n_gen*np.mean(rate)*h/1000.0)
+    n_step = int(round((sim_time - 1.0)/h))
+    expected = p_spike*n_step
+    ret = 0
+    for merge in [0, 1]:
+        data_file = "test_merge_dir_conn_%d.txt" % merge
+        if subprocess.call([sys.executable, sys.argv[0], str(merge),
+                            data_file]) != 0:
+            sys.exit(1)
+        count = np.loadtxt(data_file)
+        subprocess.call(["rm", "-f", data_file])
+        rel_err = abs(np.mean(count) - expected)/expected
+        fano = np.var(count)/np.mean(count)
+        print("merge_dir_conn: ", merge, " mean count: ", np.mean(count),
+              " expected: ", expected, " Fano factor: ", fano)
+        if rel_err > tolerance or abs(fano - 1.0) > fano_tolerance:
+            ret = 1
+    sys.exit(ret)
+
+ngpu.SetKernelStatus("rnd_seed", 1234)
+ngpu.SetKernelStatus("verbosity_level", 0)
+ngpu.SetKernelStatus("merge_dir_conn", bool(int(sys.argv[1])))
+ngpu.SetTimeResolution(h)
+
+pg = ngpu.Create("poisson_generator", n_gen)
+ngpu.SetStatus(pg[0:n_gen//2], "rate", rate[0])
+ngpu.SetStatus(pg[n_gen//2:n_gen], "rate", rate[1])
+parrot = ngpu.Create("parrot_neuron", n_neuron)
+ngpu.Connect(pg, parrot, {"rule": "all_to_all"},
+             {"receptor": 0, "weight": 1.0, "delay": 1.0})
+ngpu.ActivateRecSpikeTimes(parrot, 1000)
+
+ngpu.Simulate(sim_time)
+
+spike_times = ngpu.GetRecSpikeTimes(parrot)
+np.savetxt(sys.argv[2], np.array([len(st) for st in spike_times]))
+if int(sys.argv[1]) != 0:
+    try:
+        ngpu.SetStatus(pg[0:1], "rate", rate[1])
+    except ValueError:
+        ngpu.SetStatus(pg, "rate", rate[1])
+        ngpu.Simulate(10.0)
+        sys.exit(0)
+    print("Rate of a single merged generator changed after calibration")
+    sys.exit(1)
+sys.exit(0)
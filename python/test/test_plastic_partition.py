@@ -0,0 +1,102 @@
+import sys
+import math
+import nestgpu as ngpu
+tolerance = 1.0e-6
+# Static and plastic connections from a parrot neuron are created in
+# alternate order with the same delay, so that they are mixed in the same
+# connection group. After calibration the plastic connections are moved
+# after the static ones on the GPU, while the connection ids obtained
+# before calibration keep referring to the same connections. The static
+# weights must be unchanged, and the plastic weights must be updated by
+# the stdp rule with the spike times of the target parrot neurons
+ngpu.SetKernelStatus("verbosity_level", 0)
+h = 0.1
+ngpu.SetTimeResolution(h)
+
+def STDPUpdate(w, Dt, tau_plus, tau_minus, Wplus, alpha, mu_plus, mu_minus, \
+               Wmax):
+    if (Dt>=0):
+        fact = Wplus*math.exp(-Dt/tau_plus)
+        w1 = w + fact*math.pow(1.0 - w/Wmax, mu_plus)
+    else:
+        fact = -alpha*Wplus*math.exp(Dt/tau_minus)
+        w1 = w + fact*math.pow(w/Wmax, mu_minus)
+    return min(max(w1, 0.0), Wmax)
+
+N = 20
+tau_plus = 20.0
+tau_minus = 20.0
+lambd = 0.1
+alpha = 1.0
+mu_plus = 1.0
+mu_minus = 1.0
+Wmax = 1.0
+weight_static = 0.3
+weight_stdp = 0.5
+delay = 2.0
+pre_spike_time = 50.0
+
+syn_group = ngpu.CreateSynGroup \
+            ("stdp", {"tau_plus":tau_plus, "tau_minus":tau_minus, \
+                      "lambda":lambd, "alpha":alpha, "mu_plus":mu_plus, \
+                      "mu_minus":mu_minus,  "Wmax":Wmax})
+
+sg_pre = ngpu.Create("spike_generator")
+sg_post = ngpu.Create("spike_generator", N)
+ngpu.SetStatus(sg_pre, {"spike_times": [pre_spike_time]})
+for i in range(N):
+    # postsynaptic spikes before and after the presynaptic spike arrival
+    ngpu.SetStatus([sg_post[i]], {"spike_times": [40.0 + 2.0*i]})
+pre = ngpu.Create("parrot_neuron")
+post = ngpu.Create("parrot_neuron", N)
+
+conn_dict={"rule": "one_to_one"}
+syn_dict={"weight":1.0, "delay":1.0}
+ngpu.Connect(sg_pre, pre, conn_dict, syn_dict)
+ngpu.Connect(sg_post, post, conn_dict, syn_dict)
+# the connections target the dummy port of the parrot neurons
+for i in range(N):
+    for j in range(2):
+        syn_dict_static={"weight":weight_static, "delay":delay, \
+                         "receptor":1}
+        syn_dict_stdp={"weight":weight_stdp, "delay":delay, \
+                       "receptor":1, "synapse_group":syn_group}
+        if (i + j)%2 == 0:
+            ngpu.Connect(pre, [post[i]], conn_dict, syn_dict_static)
+        else:
+            ngpu.Connect(pre, [post[i]], conn_dict, syn_dict_stdp)
+
+conn_id_list = [ngpu.GetConnections(pre, [post[i]]) for i in range(N)]
+
+ngpu.ActivateRecSpikeTimes(pre, 10)
+ngpu.ActivateRecSpikeTimes(post, 10)
+
+ngpu.Simulate(200.0)
+
+t_pre = ngpu.GetRecSpikeTimes(pre)[0][0]
+post_spike_times = ngpu.GetRecSpikeTimes(post)
+ret = 0
+for i in range(N):
+    conn_id = conn_id_list[i]
+    syn = ngpu.GetStatus(conn_id, "syn")
+    w = ngpu.GetStatus(conn_id, "weight")
+    if len(w) != 2:
+        print("Wrong number of connections ", len(w))
+        sys.exit(1)
+    Dt = post_spike_times[i][0] - (t_pre + delay)
+    for k in range(2):
+        # connections in creation order
+        if (syn[k] == 0) != ((i + k)%2 == 0):
+            print("Wrong synapse group ", syn[k], " of connection ", k)
+            ret = 1
+        if syn[k] == 0:
+            expect_w = weight_static
+        else:
+            expect_w = STDPUpdate(weight_stdp, Dt, tau_plus, tau_minus, \
+                                  lambd*Wmax, alpha, mu_plus, mu_minus, Wmax)
+        if abs(w[k] - expect_w) > tolerance:
+            print("Dt: ", Dt, " syn: ", syn[k], " expected weight: ",
+                  expect_w, " simulated: ", w[k])
+            ret = 1
+
+sys.exit(ret)
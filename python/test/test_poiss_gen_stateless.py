@@ -0,0 +1,57 @@
+import sys
+import nestgpu as ngpu
+import numpy as np
+tolerance = 0.03
+fano_tolerance = 0.2
+# Two poisson generators drive each neuron of a population of parrot
+# neurons, with the default generator mode and with the stateless mode,
+# in which the Poisson counts are drawn from a counter-based generator
+# and the inputs of each target are summed before being delivered.
+# In both modes the number of time steps with a spike must agree with
+# the Poisson statistics, and the spike counts of the parrot neurons
+# must have a Fano factor close to 1. A second stateless group with the
+# same seed must draw different spike counts from the first one
+ngpu.SetKernelStatus("rnd_seed", 1234)
+ngpu.SetKernelStatus("verbosity_level", 0)
+h = 0.1
+ngpu.SetTimeResolution(h)
+n_neuron = 1000
+rate = 25.0
+sim_time = 1000.0
+
+stateless_list = [0, 1, 1]
+parrot_list = []
+for stateless in stateless_list:
+    pg = ngpu.Create("poisson_generator", 2)
+    ngpu.SetStatus(pg, "rate", rate)
+    ngpu.SetStatus(pg, {"stateless": stateless})
+    parrot = ngpu.Create("parrot_neuron", n_neuron)
+    ngpu.Connect(pg, parrot, {"rule": "all_to_all"},
+                 {"receptor": 0, "weight": 1.0, "delay": 1.0})
+    ngpu.ActivateRecSpikeTimes(parrot, 1000)
+    parrot_list.append(parrot)
+
+ngpu.Simulate(sim_time)
+
+# probability of at least one spike in a time step
+p_spike = 1.0 - np.exp(-2.0*rate*h/1000.0)
+n_step = int(round((sim_time - 1.0)/h))
+expected = p_spike*n_step
+ret = 0
+count_list = []
+for parrot, stateless in zip(parrot_list, stateless_list):
+    spike_times = ngpu.GetRecSpikeTimes(parrot)
+    count = np.array([len(st) for st in spike_times], dtype=float)
+    count_list.append(count)
+    rel_err = abs(np.mean(count) - expected)/expected
+    fano = np.var(count)/np.mean(count)
+    print("stateless: ", stateless, " mean count: ", np.mean(count),
+          " expected: ", expected, " Fano factor: ", fano)
+    if rel_err > tolerance or abs(fano - 1.0) > fano_tolerance:
+        ret = 1
+
+if np.array_equal(count_list[1], count_list[2]):
+    print("Two stateless groups drew the same spike counts")
+    ret = 1
+
+sys.exit(ret)
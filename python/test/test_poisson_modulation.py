@@ -0,0 +1,68 @@
+import sys
+import math
+import nestgpu as ngpu
+import numpy as np
+# Groups of poisson generators created with CreatePoissonGenerator,
+# with constant, piecewise-constant and sinusoidal rate modulation.
+# The number of spikes of each group in time bins must agree with the
+# expected number, within 4 standard deviations
+ngpu.SetKernelStatus("rnd_seed", 1234)
+ngpu.SetKernelStatus("verbosity_level", 0)
+h = 0.1
+ngpu.SetTimeResolution(h)
+n_node = 1000
+rate = 20.0
+sim_time = 1000.0
+n_bin = 8
+mod_times = [0.0, 500.0]
+mod_factors = [2.0, 0.5]
+mod_amplitude = 0.8
+mod_frequency = 2.0
+mod_phase = 90.0
+
+def factor(mod_type, t):
+    if mod_type == 1:
+        k = np.searchsorted(mod_times, t, side='right')
+        return 1.0 if k==0 else mod_factors[k - 1]
+    elif mod_type == 2:
+        return max(1.0 + mod_amplitude
+                   *math.sin(2.0*math.pi*(mod_frequency*t/1000.0
+                                          + mod_phase/360.0)), 0.0)
+    return 1.0
+
+pg_list = []
+for mod_type in [0, 1, 2]:
+    pg = ngpu.CreatePoissonGenerator(n_node, rate)
+    ngpu.SetStatus(pg, {"mod_type": mod_type})
+    if mod_type == 1:
+        ngpu.SetStatus(pg, {"mod_times": mod_times,
+                            "mod_factors": mod_factors})
+    elif mod_type == 2:
+        ngpu.SetStatus(pg, {"mod_amplitude": mod_amplitude,
+                            "mod_frequency": mod_frequency,
+                            "mod_phase": mod_phase})
+    ngpu.ActivateRecSpikeTimes(pg, 1000)
+    pg_list.append(pg)
+
+ngpu.Simulate(sim_time)
+
+n_step = int(round(sim_time/h))
+# spikes drawn in the step starting at t are recorded at t + h,
+# both are binned by the middle of the time step
+t_start = np.arange(n_step)*h
+bin_edges = np.linspace(0.0, sim_time, n_bin + 1)
+ret = 0
+for mod_type in [0, 1, 2]:
+    p_spike = np.array([1.0 - math.exp(-rate*h/1000.0*factor(mod_type, t))
+                        for t in t_start])
+    expected = n_node*np.histogram(t_start + h/2.0, bin_edges,
+                                   weights=p_spike)[0]
+    spike_times = ngpu.GetRecSpikeTimes(pg_list[mod_type])
+    all_times = np.concatenate([np.array(st) for st in spike_times])
+    count = np.histogram(all_times - h/2.0, bin_edges)[0]
+    print("mod_type: ", mod_type, " counts: ", count, " expected: ",
+          np.round(expected))
+    if np.any(np.abs(count - expected) > 4.0*np.sqrt(expected)):
+        ret = 1
+
+sys.exit(ret)
@@ -0,0 +1,89 @@
+import sys
+import math
+import nestgpu as ngpu
+import numpy as np
+tolerance = 1.0e-3
+# Precise-spiking models simulated with a coarse time resolution.
+# A source neuron driven by a constant current emits spikes at the
+# analytical threshold crossing times, which are not on the time grid.
+# The membrane potential of the target neuron, on the time grid, must be
+# equal to the sum of the postsynaptic potentials of these spikes
+h = 0.5
+ngpu.SetTimeResolution(h)
+
+tau_m = 10.0
+C_m = 250.0
+tau_syn = 2.0
+t_ref = 2.0
+theta = 15.0
+I_e = 400.0
+weight = 10.0
+delay = 2.0
+
+def propagator_31(tau_syn, tau, C, t):
+    return 1.0/C*(math.exp(-t/tau_syn)*math.expm1(-t/tau + t/tau_syn) \
+                  /(tau/tau_syn - 1.0)*tau - t*math.exp(-t/tau_syn)) \
+                  /(-1.0 + tau/tau_syn)*tau
+
+def propagator_32(tau_syn, tau, C, t):
+    return -tau/(C*(1.0 - tau/tau_syn))*math.exp(-t/tau_syn) \
+        *math.expm1(t*(1.0/tau_syn - 1.0/tau))
+
+# postsynaptic potentials of a spike of unit weight
+psp = {"iaf_psc_exp_ps": lambda t: propagator_32(tau_syn, tau_m, C_m, t),
+       "iaf_psc_alpha_ps": lambda t: math.e/tau_syn \
+       *propagator_31(tau_syn, tau_m, C_m, t)}
+tau_syn_name = {"iaf_psc_exp_ps": ["tau_ex", "tau_in"],
+                "iaf_psc_alpha_ps": ["tau_syn_ex", "tau_syn_in"]}
+
+source_list = []
+record_list = []
+for model in ["iaf_psc_exp_ps", "iaf_psc_alpha_ps"]:
+    source = ngpu.Create(model, 1)
+    target = ngpu.Create(model, 1)
+    for node in [source, target]:
+        ngpu.SetStatus(node, {"tau_m": tau_m, "C_m": C_m, "t_ref": t_ref,
+                              "Theta_rel": theta,
+                              tau_syn_name[model][0]: tau_syn,
+                              tau_syn_name[model][1]: tau_syn})
+    ngpu.SetStatus(source, {"I_e": I_e})
+    ngpu.ActivateRecSpikeTimes(source, 100)
+    ngpu.Connect(source, target, {"rule": "one_to_one"},
+                 {"receptor": 0, "weight": weight, "delay": delay})
+    source_list.append(source)
+    record_list.append(ngpu.CreateRecord("", ["V_m_rel"], [target[0]], [0]))
+
+ngpu.Simulate(200.0)
+
+# first threshold crossing time from V_m = 0, the following ones
+# after the refractory periods
+t_cross = -tau_m*math.log(1.0 - theta*C_m/(I_e*tau_m))
+spike_times = [t_cross + i*(t_cross + t_ref) for i in range(6)]
+
+ret = 0
+for i, model in enumerate(["iaf_psc_exp_ps", "iaf_psc_alpha_ps"]):
+    rec_spike_times = ngpu.GetRecSpikeTimes(source_list[i])[0]
+    if len(rec_spike_times) != len(spike_times):
+        print(model, ": wrong number of spikes ", len(rec_spike_times))
+        ret = 1
+        continue
+    dt = np.max(np.abs(np.array(rec_spike_times) - np.array(spike_times)))
+    print(model, " spike time error: ", dt, " tolerance: ", tolerance)
+    if dt > tolerance:
+        ret = 1
+
+    data = ngpu.GetRecordData(record_list[i])
+    V_max = 0.0
+    dV_max = 0.0
+    for row in data:
+        t = row[0]
+        V = sum([weight*psp[model](t - ts - delay) for ts in spike_times
+                 if t > ts + delay])
+        V_max = max(V_max, abs(V))
+        dV_max = max(dV_max, abs(row[1] - V))
+    print(model, " V_m relative error: ", dV_max/V_max, " tolerance: ",
+          tolerance)
+    if dV_max/V_max > tolerance:
+        ret = 1
+
+sys.exit(ret)
@@ -0,0 +1,75 @@
+import sys
+import subprocess
+import nestgpu as ngpu
+import numpy as np
+tolerance = 1.0e-6
+# A population of parrot neurons driven by poisson generators is connected
+# randomly through plastic synapses of two models. The simulation is run
+# with the reverse connection index built on the device and with the host
+# reference implementation (kernel parameter rev_conn_on_device), in
+# separate processes. The final weights must be the same in both cases.
+# A network without connections, where the index is empty, is also
+# simulated with the index built on the device
+h = 0.1
+n_neuron = 500
+indegree = 50
+sim_time = 500.0
+if len(sys.argv)<2:
+    weight = []
+    for on_device in [0, 1]:
+        data_file = "test_rev_conn_device_%d.txt" % on_device
+        if subprocess.call([sys.executable, sys.argv[0], str(on_device),
+                            data_file]) != 0:
+            sys.exit(1)
+        weight.append(np.loadtxt(data_file))
+        subprocess.call(["rm", "-f", data_file])
+    if subprocess.call([sys.executable, sys.argv[0], "no_conn"]) != 0:
+        print("Simulation without connections failed")
+        sys.exit(1)
+    if len(weight[0]) != 2*n_neuron*indegree \
+       or np.max(np.abs(weight[0] - weight[1])) > tolerance:
+        print("Different weights with the reverse connection index "
+              "built on the host and on the device")
+        sys.exit(1)
+    sys.exit(0)
+
+if sys.argv[1] == "no_conn":
+    # a neuron driven by a constant current, with a plastic synapse
+    # group that is not used by any connection
+    ngpu.SetKernelStatus("verbosity_level", 0)
+    ngpu.SetKernelStatus("rev_conn_on_device", True)
+    ngpu.CreateSynGroup("stdp")
+    neuron = ngpu.Create("iaf_psc_exp")
+    ngpu.SetStatus(neuron, "I_e", 1000.0)
+    ngpu.ActivateSpikeCount(neuron)
+    ngpu.Simulate(100.0)
+    if ngpu.GetStatus(neuron, "spike_count")[0][0] == 0:
+        print("No spikes without connections")
+        sys.exit(1)
+    sys.exit(0)
+
+ngpu.SetKernelStatus("rnd_seed", 1234)
+ngpu.SetKernelStatus("verbosity_level", 0)
+ngpu.SetKernelStatus("rev_conn_on_device", bool(int(sys.argv[1])))
+ngpu.SetTimeResolution(h)
+
+syn_group_stdp = ngpu.CreateSynGroup("stdp", {"lambda": 0.01, "Wmax": 1.0})
+syn_group_trace = ngpu.CreateSynGroup("stdp_trace",
+                                      {"lambda": 0.01, "Wmax": 1.0})
+pg = ngpu.Create("poisson_generator")
+ngpu.SetStatus(pg, "rate", 20.0)
+parrot = ngpu.Create("parrot_neuron", n_neuron)
+ngpu.Connect(pg, parrot, {"rule": "all_to_all"},
+             {"receptor": 0, "weight": 1.0, "delay": 1.0})
+# the plastic connections target the dummy port of the parrot neurons
+for syn_group in [syn_group_stdp, syn_group_trace]:
+    ngpu.Connect(parrot, parrot, {"rule": "fixed_indegree",
+                                  "indegree": indegree},
+                 {"receptor": 1, "weight": 0.5, "delay": 2.0,
+                  "synapse_group": syn_group})
+
+ngpu.Simulate(sim_time)
+
+conn_id = ngpu.GetConnections(parrot, parrot)
+np.savetxt(sys.argv[2], np.array(ngpu.GetStatus(conn_id, "weight")))
+sys.exit(0)
@@ -0,0 +1,55 @@
+import sys
+import nestgpu as ngpu
+import numpy as np
+tolerance = 1.0e-3
+# Spike generators with random spike trains, copied to the GPU memory
+# in chunks of a few spikes while the simulation runs, over two
+# successive simulations. The spike times recorded from the generators
+# must be equal to the input spike times, delayed by one time step
+ngpu.SetKernelStatus("rnd_seed", 1234)
+ngpu.SetKernelStatus("verbosity_level", 0)
+h = 0.1
+ngpu.SetTimeResolution(h)
+n_node = 50
+n_step = 5000
+rng = np.random.default_rng(1234)
+
+spike_times = []
+for i in range(n_node):
+    n_spikes = rng.integers(0, 40)
+    step = np.sort(rng.choice(np.arange(1, n_step), n_spikes, replace=False))
+    spike_times.append(list(step*h))
+
+ret = 0
+for chunk_size in [0, 7]:
+    sg = ngpu.Create("spike_generator", n_node)
+    ngpu.SetStatus(sg, {"chunk_size": chunk_size})
+    for i in range(n_node):
+        if len(spike_times[i]) > 0:
+            ngpu.SetStatus(sg[i:i+1], {"spike_times": spike_times[i]})
+    ngpu.ActivateRecSpikeTimes(sg, 100)
+    if chunk_size == 0:
+        sg0 = sg
+    else:
+        sg1 = sg
+
+ngpu.Simulate(n_step*h*0.6)
+ngpu.Simulate(n_step*h*0.4)
+
+for sg in [sg0, sg1]:
+    rec_spike_times = ngpu.GetRecSpikeTimes(sg)
+    for i in range(n_node):
+        if len(rec_spike_times[i]) != len(spike_times[i]):
+            print("node ", i, ": wrong number of spikes ",
+                  len(rec_spike_times[i]), len(spike_times[i]))
+            ret = 1
+        elif len(spike_times[i]) > 0:
+            dt = np.max(np.abs(np.array(rec_spike_times[i])
+                               - np.array(spike_times[i]) - h))
+            if dt > tolerance:
+                print("node ", i, ": spike time error ", dt)
+                ret = 1
+
+if ret == 0:
+    print("spike times correct")
+sys.exit(ret)
@@ -0,0 +1,70 @@
+import sys
+import os
+import nestgpu as ngpu
+import numpy as np
+tolerance = 1.0e-3
+# Spike trains of spike generators set in bulk from arrays of events in
+# random order, from memory-mapped numpy arrays and from a binary event
+# file. The spike times recorded from the generators must be equal to
+# the input spike times, delayed by one time step
+ngpu.SetKernelStatus("verbosity_level", 0)
+h = 0.1
+ngpu.SetTimeResolution(h)
+n_node = 200
+n_step = 2000
+n_event_max = 20000
+rng = np.random.default_rng(1234)
+
+# random events, with at most one spike per node and time step
+key = np.unique(rng.integers(0, n_node*(n_step - 1), n_event_max))
+rng.shuffle(key)
+event_node = (key // (n_step - 1)).astype(np.int32)
+event_time = ((key % (n_step - 1) + 1)*h).astype(np.float32)
+event_height = rng.uniform(0.5, 2.0, len(key)).astype(np.float32)
+
+sg_arr = ngpu.Create("spike_generator", n_node)
+ngpu.SetSpikeTrains(sg_arr, event_node, event_time, event_height)
+
+np.save("test_spike_train_node.npy", event_node)
+np.save("test_spike_train_time.npy", event_time)
+sg_mmap = ngpu.Create("spike_generator", n_node)
+ngpu.SetSpikeTrains(sg_mmap,
+                    np.load("test_spike_train_node.npy", mmap_mode='r'),
+                    np.load("test_spike_train_time.npy", mmap_mode='r'))
+
+event = np.zeros(len(key), dtype=[('node', '<i4'), ('time', '<f4')])
+event['node'] = event_node
+event['time'] = event_time
+event.tofile("test_spike_train_events.bin")
+sg_file = ngpu.Create("spike_generator", n_node)
+ngpu.LoadSpikeTrains(sg_file, "test_spike_train_events.bin")
+
+for fn in ["test_spike_train_node.npy", "test_spike_train_time.npy",
+           "test_spike_train_events.bin"]:
+    os.remove(fn)
+
+sg_list = [sg_arr, sg_mmap, sg_file]
+for sg in sg_list:
+    ngpu.ActivateRecSpikeTimes(sg, 1000)
+
+ngpu.Simulate(n_step*h)
+
+ret = 0
+for sg in sg_list:
+    rec_spike_times = ngpu.GetRecSpikeTimes(sg)
+    for i in range(n_node):
+        spike_times = np.sort(event_time[event_node==i])
+        if len(rec_spike_times[i]) != len(spike_times):
+            print("node ", i, ": wrong number of spikes ",
+                  len(rec_spike_times[i]), len(spike_times))
+            ret = 1
+        elif len(spike_times) > 0:
+            dt = np.max(np.abs(np.array(rec_spike_times[i])
+                               - spike_times - h))
+            if dt > tolerance:
+                print("node ", i, ": spike time error ", dt)
+                ret = 1
+
+if ret == 0:
+    print("spike times correct")
+sys.exit(ret)
@@ -0,0 +1,91 @@
+import sys
+import math
+import nestgpu as ngpu
+tolerance = 1.0e-5
+# Trace-based STDP with all-to-all spike pairing. A parrot neuron is
+# connected with two delays to two parrot neurons through synapses of
+# the stdp_trace model. The weights are compared with the ones computed
+# from all the pairs of presynaptic spike arrivals and postsynaptic spikes
+ngpu.SetKernelStatus("verbosity_level", 0)
+h = 0.1
+ngpu.SetTimeResolution(h)
+
+tau_plus = 20.0
+tau_minus = 30.0
+lambd = 0.01
+alpha = 1.2
+mu_plus = 0.5
+mu_minus = 0.8
+Wmax = 1.0
+weight_stdp = 0.5
+delay_list = [2.0, 5.0]
+pre_spike_times = [10.0, 15.0, 22.0, 40.0, 41.0, 60.0, 75.0]
+post_spike_times = [[12.0, 17.0, 20.0, 42.0, 45.0, 63.0, 70.0],
+                    [8.0, 20.0, 27.0, 30.0, 46.0, 66.0, 80.0]]
+
+syn_group = ngpu.CreateSynGroup \
+            ("stdp_trace", {"tau_plus":tau_plus, "tau_minus":tau_minus, \
+                            "lambda":lambd, "alpha":alpha, \
+                            "mu_plus":mu_plus, "mu_minus":mu_minus, \
+                            "Wmax":Wmax})
+
+sg_pre = ngpu.Create("spike_generator")
+sg_post = ngpu.Create("spike_generator", 2)
+ngpu.SetStatus(sg_pre, {"spike_times": pre_spike_times})
+for i in range(2):
+    ngpu.SetStatus([sg_post[i]], {"spike_times": post_spike_times[i]})
+pre = ngpu.Create("parrot_neuron")
+post = ngpu.Create("parrot_neuron", 2)
+
+conn_dict={"rule": "one_to_one"}
+syn_dict={"weight":1.0, "delay":1.0}
+ngpu.Connect(sg_pre, pre, conn_dict, syn_dict)
+ngpu.Connect(sg_post, post, conn_dict, syn_dict)
+# the plastic connections target the dummy port of the parrot neurons
+for i in range(2):
+    syn_dict_stdp={"weight":weight_stdp, "delay":delay_list[i], \
+                   "receptor":1, "synapse_group":syn_group}
+    ngpu.Connect(pre, [post[i]], conn_dict, syn_dict_stdp)
+
+ngpu.ActivateRecSpikeTimes(pre, 100)
+ngpu.ActivateRecSpikeTimes(post, 100)
+
+ngpu.Simulate(100.0)
+
+pre_idx = [int(round(t/h)) for t in ngpu.GetRecSpikeTimes(pre)[0]]
+post_rec_spike_times = ngpu.GetRecSpikeTimes(post)
+if len(pre_idx) != len(pre_spike_times):
+    print("Wrong number of presynaptic spikes ", len(pre_idx))
+    sys.exit(1)
+
+ret = 0
+for i in range(2):
+    post_idx = [int(round(t/h)) for t in post_rec_spike_times[i]]
+    if len(post_idx) != len(post_spike_times[i]):
+        print("Wrong number of postsynaptic spikes ", len(post_idx))
+        sys.exit(1)
+    delay_idx = int(round(delay_list[i]/h))
+    arrival_idx = [t + delay_idx for t in pre_idx]
+    # in each time step, the presynaptic spikes reach the synapse before
+    # the postsynaptic spikes are emitted
+    event_list = sorted([(t, 0) for t in arrival_idx] + \
+                        [(t, 1) for t in post_idx])
+    w = weight_stdp
+    for t, is_post in event_list:
+        if is_post:
+            x = sum([math.exp(-(t - ta)*h/tau_plus) for ta in arrival_idx \
+                     if ta <= t])
+            w = w + lambd*Wmax*math.pow(1.0 - w/Wmax, mu_plus)*x
+        else:
+            y = sum([math.exp(-(t - tp)*h/tau_minus) for tp in post_idx \
+                     if tp < t])
+            w = w - alpha*lambd*Wmax*math.pow(w/Wmax, mu_minus)*y
+        w = min(max(w, 0.0), Wmax)
+
+    conn_id = ngpu.GetConnections(pre, [post[i]])
+    sim_w = ngpu.GetStatus(conn_id, "weight")[0]
+    if abs(sim_w - w) > tolerance:
+        print("Expected weight: ", w, " simulated: ", sim_w)
+        ret = 1
+
+sys.exit(ret)
@@ -0,0 +1,59 @@
+import sys
+import subprocess
+import nestgpu as ngpu
+import numpy as np
+tolerance = 1.0e-5
+# Network of node groups of different models, driven by poisson generators
+# and by a recurrent connection. The groups are updated in the default
+# stream and in a pool of 4 streams, in separate processes, and the
+# membrane potentials of the recorded neurons must be the same
+if len(sys.argv)<2:
+    out = []
+    for n_streams in [0, 4]:
+        data_file = "test_streams_%d.txt" % n_streams
+        ret = subprocess.call([sys.executable, sys.argv[0], str(n_streams),
+                               data_file])
+        if ret != 0:
+            sys.exit(1)
+        out.append(np.loadtxt(data_file))
+        subprocess.call(["rm", "-f", data_file])
+    dV = out[1] - out[0]
+    rmse = np.sqrt(np.mean(dV*dV))/np.mean(np.abs(out[0]))
+    print("rmse : ", rmse, " tolerance: ", tolerance)
+    if rmse>tolerance:
+        sys.exit(1)
+    sys.exit(0)
+
+n_streams = int(sys.argv[1])
+ngpu.SetKernelStatus("rnd_seed", 1234)
+ngpu.SetKernelStatus("n_streams", n_streams)
+ngpu.SetKernelStatus("verbosity_level", 0)
+
+aeif = ngpu.Create("aeif_cond_beta", 1000)
+iaf = ngpu.Create("iaf_psc_exp", 100)
+iaf_alpha = ngpu.Create("iaf_psc_alpha", 100)
+pg = ngpu.Create("poisson_generator")
+ngpu.SetStatus(pg, "rate", 12000.0)
+conn_spec = {"rule": "all_to_all"}
+ngpu.Connect(pg, aeif, conn_spec, {"receptor": 0, "weight": 0.5,
+                                   "delay": 0.2})
+ngpu.Connect(pg, iaf, conn_spec, {"receptor": 0, "weight": 30.0,
+                                  "delay": 0.2})
+ngpu.Connect(pg, iaf_alpha, conn_spec, {"receptor": 0, "weight": 30.0,
+                                        "delay": 0.2})
+indeg_conn_spec = {"rule": "fixed_indegree", "indegree": 10}
+ngpu.Connect(aeif, iaf, indeg_conn_spec, {"receptor": 1, "weight": -5.0,
+                                          "delay": 1.0})
+ngpu.Connect(iaf, aeif, indeg_conn_spec, {"receptor": 0, "weight": 0.1,
+                                          "delay": 1.0})
+
+i_neuron_list = [aeif[0], aeif[999], iaf[0], iaf[99], iaf_alpha[0]]
+var_name_list = ["V_m", "V_m", "V_m_rel", "V_m_rel", "V_m_rel"]
+record = ngpu.CreateRecord("", var_name_list, i_neuron_list,
+                           [0]*len(i_neuron_list))
+
+ngpu.Simulate(300.0)
+
+data = ngpu.GetRecordData(record)
+np.savetxt(sys.argv[2], np.array(data)[:, 1:])
+sys.exit(0)
@@ -95,7 +95,20 @@ def waitenter(val):
         return raw_input(val)
     
 conn_rule_name = ("one_to_one", "all_to_all", "fixed_total_number",
-                  "fixed_indegree", "fixed_outdegree")
+                  "fixed_indegree", "fixed_outdegree", "pairwise_bernoulli",
+                  "spatial_pairwise")
+
+# distance-dependent kernels of the spatial_pairwise rule
+spatial_kernel_name = ("constant", "gaussian", "exponential")
+
+# ODE integrators of the neuron models based on RK5,
+# selected through the group parameter "integrator"
+integrator_name = ("rk5", "exp_euler", "rosenbrock")
+
+# distributions of synaptic parameters evaluated natively,
+# connection by connection, during the execution of connection rules
+distribution_name = ("none", "normal", "normal_clipped", "lognormal",
+                     "uniform", "exponential")
     
 NESTGPU_GetErrorMessage = _nestgpu.NESTGPU_GetErrorMessage
 NESTGPU_GetErrorMessage.restype = ctypes.POINTER(ctypes.c_char)
@@ -326,6 +339,52 @@ def SetNeuronArrayParam(i_node, n_node, param_name, param_list):
     return ret
 
 
+NESTGPU_SetNodePositions = _nestgpu.NESTGPU_SetNodePositions
+NESTGPU_SetNodePositions.argtypes = (ctypes.c_int, ctypes.c_int, c_float_p,
+                                     ctypes.c_int)
+NESTGPU_SetNodePositions.restype = ctypes.c_int
+def SetPositions(nodes, pos_list):
+    "Set node positions, pos_list is a list of n_dim-dimensional positions"
+    if type(nodes)!=NodeSeq:
+        raise ValueError("Node positions can be set only for NodeSeq")
+    if len(pos_list)!=nodes.n:
+        raise ValueError("Number of positions different from number of nodes")
+    n_dim = len(pos_list[0])
+    flat_pos = [float(x) for pos in pos_list for x in pos]
+    if len(flat_pos)!=nodes.n*n_dim:
+        raise ValueError("All positions must have the same dimension")
+    array_float_type = ctypes.c_float * len(flat_pos)
+    ret = NESTGPU_SetNodePositions(ctypes.c_int(nodes.i0),
+                                   ctypes.c_int(nodes.n),
+                                   array_float_type(*flat_pos),
+                                   ctypes.c_int(n_dim))
+    if GetErrorCode() != 0:
+        raise ValueError(GetErrorMessage())
+    return ret
+
+
+NESTGPU_SetSpatialExtent = _nestgpu.NESTGPU_SetSpatialExtent
+NESTGPU_SetSpatialExtent.argtypes = (ctypes.c_int, c_float_p, c_float_p,
+                                     ctypes.c_int, ctypes.c_int)
+NESTGPU_SetSpatialExtent.restype = ctypes.c_int
+def SetSpatialExtent(nodes, lower_left, extent, periodic=False):
+    "Set the region containing the positions of a node group"
+    if type(nodes)!=NodeSeq:
+        raise ValueError("Spatial extent can be set only for NodeSeq")
+    n_dim = len(extent)
+    if len(lower_left)!=n_dim:
+        raise ValueError("lower_left and extent must have the same dimension")
+    array_float_type = ctypes.c_float * n_dim
+    ret = NESTGPU_SetSpatialExtent(ctypes.c_int(nodes.i0),
+                                   array_float_type(*lower_left),
+                                   array_float_type(*extent),
+                                   ctypes.c_int(n_dim),
+                                   ctypes.c_int(int(periodic)))
+    if GetErrorCode() != 0:
+        raise ValueError(GetErrorMessage())
+    return ret
+
+
 NESTGPU_SetNeuronPtScalParam = _nestgpu.NESTGPU_SetNeuronPtScalParam
 NESTGPU_SetNeuronPtScalParam.argtypes = (ctypes.c_void_p, ctypes.c_int,
                                            c_char_p, ctypes.c_float)
@@ -1025,6 +1084,35 @@ def GetScalParamNames(i_node):
         raise ValueError(GetErrorMessage())
     return param_name_list
 
+NESTGPU_GetNConstParam = _nestgpu.NESTGPU_GetNConstParam
+NESTGPU_GetNConstParam.argtypes = (ctypes.c_int,)
+NESTGPU_GetNConstParam.restype = ctypes.c_int
+def GetNConstParam(i_node):
+    "Get number of scalar parameters folded in constant memory"
+    ret = NESTGPU_GetNConstParam(ctypes.c_int(i_node))
+    if GetErrorCode() != 0:
+        raise ValueError(GetErrorMessage())
+    return ret
+
+NESTGPU_GetConstParamNames = _nestgpu.NESTGPU_GetConstParamNames
+NESTGPU_GetConstParamNames.argtypes = (ctypes.c_int,)
+NESTGPU_GetConstParamNames.restype = ctypes.POINTER(c_char_p)
+def GetConstParamNames(i_node):
+    """Get list of scalar parameters that have the same value in all the
+    neurons of the group, folded in constant memory at calibration"""
+    n_param = GetNConstParam(i_node)
+    param_name_pp = ctypes.cast(NESTGPU_GetConstParamNames(
+        ctypes.c_int(i_node)), ctypes.POINTER(c_char_p))
+    param_name_list = []
+    for i in range(n_param):
+        param_name_p = param_name_pp[i]
+        param_name = ctypes.cast(param_name_p, ctypes.c_char_p).value
+        param_name_list.append(to_def_str(param_name))
+    
+    if GetErrorCode() != 0:
+        raise ValueError(GetErrorMessage())
+    return param_name_list
+
 NESTGPU_GetNPortParam = _nestgpu.NESTGPU_GetNPortParam
 NESTGPU_GetNPortParam.argtypes = (ctypes.c_int,)
 NESTGPU_GetNPortParam.restype = ctypes.c_int
@@ -1152,6 +1240,10 @@ def SetNeuronStatus(nodes, var_name, val):
         for i in range(array_size):
             SetNeuronStatus([nodes[i]], var_name, arr[i])
         return
+    if (var_name=="integrator") & (type(val)==str):
+        if val not in integrator_name:
+            raise ValueError("Unknown ODE integrator " + val)
+        val = integrator_name.index(val)
     
     c_var_name = ctypes.create_string_buffer(to_byte_str(var_name),
                                                len(var_name)+1)
@@ -1370,6 +1462,30 @@ def ConnSpecIsParam(param_name):
     return ret
 
 
+NESTGPU_SetConnSpecFloatParam = _nestgpu.NESTGPU_SetConnSpecFloatParam
+NESTGPU_SetConnSpecFloatParam.argtypes = (c_char_p, ctypes.c_float)
+NESTGPU_SetConnSpecFloatParam.restype = ctypes.c_int
+def SetConnSpecFloatParam(param_name, val):
+    "Set connection float parameter"
+    c_param_name = ctypes.create_string_buffer(to_byte_str(param_name), len(param_name)+1)
+    ret = NESTGPU_SetConnSpecFloatParam(c_param_name, ctypes.c_float(val))
+    if GetErrorCode() != 0:
+        raise ValueError(GetErrorMessage())
+    return ret
+
+
+NESTGPU_ConnSpecIsFloatParam = _nestgpu.NESTGPU_ConnSpecIsFloatParam
+NESTGPU_ConnSpecIsFloatParam.argtypes = (c_char_p,)
+NESTGPU_ConnSpecIsFloatParam.restype = ctypes.c_int
+def ConnSpecIsFloatParam(param_name):
+    "Check name of connection float parameter"
+    c_param_name = ctypes.create_string_buffer(to_byte_str(param_name), len(param_name)+1)
+    ret = (NESTGPU_ConnSpecIsFloatParam(c_param_name) != 0)
+    if GetErrorCode() != 0:
+        raise ValueError(GetErrorMessage())
+    return ret
+
+
 NESTGPU_SynSpecInit = _nestgpu.NESTGPU_SynSpecInit
 NESTGPU_SynSpecInit.restype = ctypes.c_int
 def SynSpecInit():
@@ -1508,12 +1624,38 @@ def RuleArraySize(conn_dict, source, target):
         array_size = len(target)*conn_dict["indegree"]
     elif conn_dict["rule"]=="fixed_outdegree":
         array_size = len(source)*conn_dict["outdegree"]
+    elif ((conn_dict["rule"]=="pairwise_bernoulli") |
+          (conn_dict["rule"]=="spatial_pairwise")):
+        # the number of connections is not known in advance
+        array_size = None
     else:
         raise ValueError("Unknown number of connections for this rule")
     return array_size
 
 
+def IsNativeDistribution(par_dict):
+    "Check if a synapse parameter dictionary defines a native distribution"
+    return ("distribution" in par_dict) & \
+        (par_dict.get("distribution") in distribution_name)
+
+
+def SetSynParamFromDistribution(param_name, par_dict):
+    "Set a synapse parameter distribution evaluated for each connection"
+    for key in par_dict:
+        pval = par_dict[key]
+        if key=="distribution":
+            SetSynSpecIntParam(param_name + "_distribution",
+                               distribution_name.index(pval))
+        elif SynSpecIsFloatParam(param_name + "_" + key):
+            SetSynSpecFloatParam(param_name + "_" + key, pval)
+        else:
+            raise ValueError("Unknown distribution parameter " + key)
+
+
 def SetSynParamFromArray(param_name, par_dict, array_size):
+    if array_size is None:
+        raise ValueError("Synapse parameter cannot be set by arrays or"
+                         " distributions for this connection rule")
     arr_param_name = param_name + "_array"
     if (not SynSpecIsFloatPtParam(arr_param_name)):
         raise ValueError("Synapse parameter cannot be set by"
@@ -1556,15 +1698,21 @@ def Connect(source, target, conn_dict, syn_dict):
     SynSpecInit()
     for param_name in conn_dict:
         if param_name=="rule":
-            for i_rule in range(len(conn_rule_name)):
-                if conn_dict[param_name]==conn_rule_name[i_rule]:
-                    break
-            if i_rule < len(conn_rule_name):
+            if conn_dict[param_name] in conn_rule_name:
+                i_rule = conn_rule_name.index(conn_dict[param_name])
                 SetConnSpecParam(param_name, i_rule)
             else:
                 raise ValueError("Unknown connection rule")
+        elif param_name=="kernel":
+            if conn_dict[param_name] in spatial_kernel_name:
+                i_kernel = spatial_kernel_name.index(conn_dict[param_name])
+                SetConnSpecParam(param_name, i_kernel)
+            else:
+                raise ValueError("Unknown spatial kernel")
         elif ConnSpecIsParam(param_name):
             SetConnSpecParam(param_name, conn_dict[param_name])
+        elif ConnSpecIsFloatParam(param_name):
+            SetConnSpecFloatParam(param_name, conn_dict[param_name])
         else:
             raise ValueError("Unknown connection parameter")
     
@@ -1579,7 +1727,10 @@ def Connect(source, target, conn_dict, syn_dict):
         elif SynSpecIsFloatParam(param_name):
             fpar = syn_dict[param_name]
             if (type(fpar)==dict):
-                SetSynParamFromArray(param_name, fpar, array_size)
+                if IsNativeDistribution(fpar):
+                    SetSynParamFromDistribution(param_name, fpar)
+                else:
+                    SetSynParamFromArray(param_name, fpar, array_size)
             else:
                 SetSynSpecFloatParam(param_name, fpar)
 
@@ -1649,16 +1800,22 @@ def RemoteConnect(i_source_host, source, i_target_host, target,
     SynSpecInit()
     for param_name in conn_dict:
         if param_name=="rule":
-            for i_rule in range(len(conn_rule_name)):
-                if conn_dict[param_name]==conn_rule_name[i_rule]:
-                    break
-            if i_rule < len(conn_rule_name):
+            if conn_dict[param_name] in conn_rule_name:
+                i_rule = conn_rule_name.index(conn_dict[param_name])
                 SetConnSpecParam(param_name, i_rule)
             else:
                 raise ValueError("Unknown connection rule")
+        elif param_name=="kernel":
+            if conn_dict[param_name] in spatial_kernel_name:
+                i_kernel = spatial_kernel_name.index(conn_dict[param_name])
+                SetConnSpecParam(param_name, i_kernel)
+            else:
+                raise ValueError("Unknown spatial kernel")
                 
         elif ConnSpecIsParam(param_name):
             SetConnSpecParam(param_name, conn_dict[param_name])
+        elif ConnSpecIsFloatParam(param_name):
+            SetConnSpecFloatParam(param_name, conn_dict[param_name])
         else:
             raise ValueError("Unknown connection parameter")
         
@@ -1670,7 +1827,10 @@ def RemoteConnect(i_source_host, source, i_target_host, target,
         elif SynSpecIsFloatParam(param_name):
             fpar = syn_dict[param_name]
             if (type(fpar)==dict):
-                SetSynParamFromArray(param_name, fpar, array_size)
+                if IsNativeDistribution(fpar):
+                    SetSynParamFromDistribution(param_name, fpar)
+                else:
+                    SetSynParamFromArray(param_name, fpar, array_size)
             else:
                 SetSynSpecFloatParam(param_name, fpar)
                 
@@ -1865,6 +2025,110 @@ def GetConnectionStatus(conn_id):
     return conn_status_dict
 
 
+NESTGPU_GetConnectionColumns = _nestgpu.NESTGPU_GetConnectionColumns
+NESTGPU_GetConnectionColumns.argtypes = (c_int_p, ctypes.c_int,
+                                         c_int_p, c_int_p, c_int_p, c_int_p,
+                                         c_float_p, c_float_p)
+NESTGPU_GetConnectionColumns.restype = ctypes.c_int
+def GetConnectionColumns(conn_list):
+    """Get the status of a list of connections in columnar form, as a
+    dictionary of lists with the same keys of GetConnectionStatus"""
+    n_conn = len(conn_list)
+    conn_id_list = []
+    for conn_id in conn_list:
+        conn_id_list += [conn_id.i_source, conn_id.i_group, conn_id.i_conn]
+    conn_id_arr = (ctypes.c_int * (3*n_conn))(*conn_id_list)
+    i_source = (ctypes.c_int * n_conn)()
+    i_target = (ctypes.c_int * n_conn)()
+    i_port = (ctypes.c_int * n_conn)()
+    i_syn = (ctypes.c_int * n_conn)()
+    delay = (ctypes.c_float * n_conn)()
+    weight = (ctypes.c_float * n_conn)()
+    NESTGPU_GetConnectionColumns(conn_id_arr, ctypes.c_int(n_conn),
+                                 i_source, i_target, i_port, i_syn,
+                                 delay, weight)
+    if GetErrorCode() != 0:
+        raise ValueError(GetErrorMessage())
+    
+    return {"source":list(i_source), "target":list(i_target),
+            "port":list(i_port), "syn":list(i_syn), "delay":list(delay),
+            "weight":list(weight)}
+
+
+def ConnIdArray(conn_list):
+    "Array of (i_source, i_group, i_conn) triplets of a list of connections"
+    import numpy as np
+    conn_id_arr = np.empty((len(conn_list), 3), dtype=np.int32)
+    for i, conn_id in enumerate(conn_list):
+        conn_id_arr[i] = (conn_id.i_source, conn_id.i_group, conn_id.i_conn)
+    return conn_id_arr
+
+
+NESTGPU_GetConnectionWeights = _nestgpu.NESTGPU_GetConnectionWeights
+NESTGPU_GetConnectionWeights.argtypes = (c_int_p, ctypes.c_int, c_float_p)
+NESTGPU_GetConnectionWeights.restype = ctypes.c_int
+def GetConnectionWeights(conn_list):
+    """Get the weights of a list of connections as a numpy array, read
+    from the GPU after calibration in a single transfer"""
+    import numpy as np
+    conn_id_arr = ConnIdArray(conn_list)
+    weight = np.empty(len(conn_list), dtype=np.float32)
+    NESTGPU_GetConnectionWeights(conn_id_arr.ctypes.data_as(c_int_p),
+                                 ctypes.c_int(len(conn_list)),
+                                 weight.ctypes.data_as(c_float_p))
+    if GetErrorCode() != 0:
+        raise ValueError(GetErrorMessage())
+    return weight
+
+
+NESTGPU_SetConnectionWeights = _nestgpu.NESTGPU_SetConnectionWeights
+NESTGPU_SetConnectionWeights.argtypes = (c_int_p, ctypes.c_int, c_float_p)
+NESTGPU_SetConnectionWeights.restype = ctypes.c_int
+def SetConnectionWeights(conn_list, weight):
+    """Set the weights of a list of connections from a list or a numpy
+    array, written to the GPU after calibration in a single transfer"""
+    import numpy as np
+    conn_id_arr = ConnIdArray(conn_list)
+    weight_arr = np.ascontiguousarray(weight, dtype=np.float32)
+    if len(weight_arr) != len(conn_list):
+        raise ValueError("Weight array and connection list must have "
+                         "the same size")
+    ret = NESTGPU_SetConnectionWeights(conn_id_arr.ctypes.data_as(c_int_p),
+                                       ctypes.c_int(len(conn_list)),
+                                       weight_arr.ctypes.data_as(c_float_p))
+    if GetErrorCode() != 0:
+        raise ValueError(GetErrorMessage())
+    return ret
+
+
+NESTGPU_SaveConnectionWeights = _nestgpu.NESTGPU_SaveConnectionWeights
+NESTGPU_SaveConnectionWeights.argtypes = (c_char_p,)
+NESTGPU_SaveConnectionWeights.restype = ctypes.c_int
+def SaveConnectionWeights(file_name):
+    """Save the weights of all the connections to a binary file of float32,
+    in the order in which they are stored on the GPU"""
+    c_file_name = ctypes.create_string_buffer(to_byte_str(file_name),
+                                              len(file_name)+1)
+    ret = NESTGPU_SaveConnectionWeights(c_file_name)
+    if GetErrorCode() != 0:
+        raise ValueError(GetErrorMessage())
+    return ret
+
+
+NESTGPU_LoadConnectionWeights = _nestgpu.NESTGPU_LoadConnectionWeights
+NESTGPU_LoadConnectionWeights.argtypes = (c_char_p,)
+NESTGPU_LoadConnectionWeights.restype = ctypes.c_int
+def LoadConnectionWeights(file_name):
+    """Load the weights of all the connections from a binary file written
+    by SaveConnectionWeights for the same network"""
+    c_file_name = ctypes.create_string_buffer(to_byte_str(file_name),
+                                              len(file_name)+1)
+    ret = NESTGPU_LoadConnectionWeights(c_file_name)
+    if GetErrorCode() != 0:
+        raise ValueError(GetErrorMessage())
+    return ret
+
+
 def GetStatus(gen_object, var_key=None):
     "Get neuron group, connection or synapse group status"
     if type(gen_object)==SynGroup:
@@ -1872,6 +2136,25 @@ def GetStatus(gen_object, var_key=None):
     
     if type(gen_object)==NodeSeq:
         gen_object = gen_object.ToList()
+    if (((type(gen_object)==list) | (type(gen_object)==tuple)) &
+        (len(gen_object)>0) &
+        all(type(elem)==ConnectionId for elem in gen_object)):
+        # connection lists are read in columnar form with a single call
+        columns = GetConnectionColumns(gen_object)
+        key_list = ["source", "target", "port", "syn", "delay", "weight"]
+        if (type(var_key)==str) | (type(var_key)==bytes):
+            return columns[to_def_str(to_byte_str(var_key))]
+        if (type(var_key)==list) | (type(var_key)==tuple):
+            key_list = var_key
+        elif var_key!=None:
+            raise ValueError("Unknown key type in GetStatus", type(var_key))
+        status_list = []
+        for i in range(len(gen_object)):
+            if (type(var_key)==list) | (type(var_key)==tuple):
+                status_list.append([columns[key][i] for key in key_list])
+            else:
+                status_list.append({key:columns[key][i] for key in key_list})
+        return status_list
     if (type(gen_object)==list) | (type(gen_object)==tuple):
         status_list = []
         for gen_elem in gen_object:
@@ -2085,6 +2368,61 @@ def ActivateSpikeCount(nodes):
     return ret
 
 
+NESTGPU_SetSpikeGeneratorEvents = _nestgpu.NESTGPU_SetSpikeGeneratorEvents
+NESTGPU_SetSpikeGeneratorEvents.argtypes = (ctypes.c_int, ctypes.c_int,
+                                            ctypes.c_longlong, c_int_p,
+                                            c_float_p, c_float_p)
+NESTGPU_SetSpikeGeneratorEvents.restype = ctypes.c_int
+def SetSpikeTrains(nodes, event_node, event_time, event_height=None):
+    "Set the spike trains of spike generators from arrays of events"
+    # event_node is relative to the first node of nodes. The arrays can be
+    # lists, numpy arrays or memory-mapped numpy arrays
+    import numpy as np
+    if type(nodes)!=NodeSeq:
+        raise ValueError("Argument type of SetSpikeTrains must be NodeSeq")
+    # no copy is made if the arrays already have the right type and layout
+    node_arr = np.ascontiguousarray(event_node, dtype=np.int32)
+    time_arr = np.ascontiguousarray(event_time, dtype=np.float32)
+    if len(node_arr) != len(time_arr):
+        raise ValueError("Event node and time arrays must have the same size")
+    height_pt = None
+    if event_height is not None:
+        height_arr = np.ascontiguousarray(event_height, dtype=np.float32)
+        if len(height_arr) != len(time_arr):
+            raise ValueError("Event height and time arrays must have the "
+                             "same size")
+        height_pt = height_arr.ctypes.data_as(c_float_p)
+    ret = NESTGPU_SetSpikeGeneratorEvents(ctypes.c_int(nodes.i0),
+                                          ctypes.c_int(nodes.n),
+                                          ctypes.c_longlong(len(node_arr)),
+                                          node_arr.ctypes.data_as(c_int_p),
+                                          time_arr.ctypes.data_as(c_float_p),
+                                          height_pt)
+    if GetErrorCode() != 0:
+        raise ValueError(GetErrorMessage())
+    return ret
+
+
+NESTGPU_LoadSpikeGeneratorEvents = _nestgpu.NESTGPU_LoadSpikeGeneratorEvents
+NESTGPU_LoadSpikeGeneratorEvents.argtypes = (ctypes.c_int, ctypes.c_int,
+                                             c_char_p)
+NESTGPU_LoadSpikeGeneratorEvents.restype = ctypes.c_int
+def LoadSpikeTrains(nodes, file_name):
+    "Load the spike trains of spike generators from a binary file of events"
+    # each event is made of the node index relative to the first node
+    # of nodes (int32) and the spike time in ms (float32)
+    if type(nodes)!=NodeSeq:
+        raise ValueError("Argument type of LoadSpikeTrains must be NodeSeq")
+    c_file_name = ctypes.create_string_buffer(to_byte_str(file_name),
+                                              len(file_name)+1)
+    ret = NESTGPU_LoadSpikeGeneratorEvents(ctypes.c_int(nodes.i0),
+                                           ctypes.c_int(nodes.n),
+                                           c_file_name)
+    if GetErrorCode() != 0:
+        raise ValueError(GetErrorMessage())
+    return ret
+
+
 NESTGPU_ActivateRecSpikeTimes = _nestgpu.NESTGPU_ActivateRecSpikeTimes
 NESTGPU_ActivateRecSpikeTimes.argtypes = (ctypes.c_int, ctypes.c_int, \
                                             ctypes.c_int)
@@ -112,6 +112,8 @@ aeif_cond_alpha::Init( int i_node_0, int n_node, int n_port, int i_group, unsign
 
   SetGroupParam( "h_min_rel", 1.0e-3 );
   SetGroupParam( "h0_rel", 1.0e-2 );
+  SetGroupParam( "warp_step", 0.0 );
+  SetGroupParam( "integrator", 0.0 );
   h_ = h0_rel_ * 0.1;
 
   rk5_.Init( n_node, n_var_, n_param_, 0.0, h_, rk5_data_struct_ );
@@ -136,6 +138,12 @@ aeif_cond_alpha::Calibrate( double time_min, float time_resolution )
   h_min_ = h_min_rel_ * time_resolution;
   h_ = h0_rel_ * time_resolution;
   rk5_.Calibrate( time_min, h_, rk5_data_struct_ );
+  rk5_.SetWarpStep( warp_step_ != 0.0 );
+  rk5_.SetIntegrator( ( int ) integrator_ );
+  FoldConstParam( MutableParamMask< aeif_cond_alpha_rk5 >() );
+  rk5_.SetConstParam( &const_param_mask_, const_param_offset_ );
+  rk5_.SetInputSpikes( FuseInputSpikes() );
+  rk5_.SetStream( stream_ );
 
   return 0;
 }
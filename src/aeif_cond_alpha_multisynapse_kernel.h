@@ -81,6 +81,8 @@ enum GroupParamIndexes
 {
   i_h_min_rel = 0, // Min. step in ODE integr. relative to time resolution
   i_h0_rel,        // Starting step in ODE integr. relative to time resolution
+  i_warp_step,     // If not 0, the neurons of a warp share the integration step
+  i_integrator,    // ODE integrator: 0 adaptive RK5, 1 exp. Euler, 2 Rosenbrock
   N_GROUP_PARAM
 };
 
@@ -105,7 +107,10 @@ const std::string aeif_cond_alpha_multisynapse_scal_param_name[ N_SCAL_PARAM ] =
 
 const std::string aeif_cond_alpha_multisynapse_port_param_name[ N_PORT_PARAM ] = { "E_rev", "tau_syn", "g0" };
 
-const std::string aeif_cond_alpha_multisynapse_group_param_name[ N_GROUP_PARAM ] = { "h_min_rel", "h0_rel" };
+const std::string aeif_cond_alpha_multisynapse_group_param_name[ N_GROUP_PARAM ] = { "h_min_rel",
+  "h0_rel",
+  "warp_step",
+  "integrator" };
 
 //
 // I know that defines are "bad", but the defines below make the
@@ -143,6 +148,8 @@ const std::string aeif_cond_alpha_multisynapse_group_param_name[ N_GROUP_PARAM ]
 
 #define h_min_rel_ group_param_[ i_h_min_rel ]
 #define h0_rel_ group_param_[ i_h0_rel ]
+#define warp_step_ group_param_[ i_warp_step ]
+#define integrator_ group_param_[ i_integrator ]
 
 
 template < int NVAR, int NPARAM > //, class DataStruct>
@@ -258,4 +265,16 @@ ExternalUpdate( double x, float* y, float* param, bool end_time_step, aeif_cond_
 }
 
 
+// refractory_step is the only parameter modified by ExternalUpdate
+template <>
+struct RK5MutableParam< aeif_cond_alpha_multisynapse_rk5 >
+{
+  static const int N_MUTABLE = 1;
+  __host__ __device__ static int
+  Idx( int i_mut )
+  {
+    return aeif_cond_alpha_multisynapse_ns::i_refractory_step;
+  }
+};
+
 #endif
@@ -120,14 +120,20 @@ tau_decay_ex ms            Decay time constant of excitatory synaptic conductanc
 tau_decay_in ms            Decay time constant of inhibitory synaptic conductance
 ============ ============= ======================================================
 
-========= ======= =========================================================
+========== ======= =========================================================
 **Integration parameters**
----------------------------------------------------------------------------
-h0_rel    real    Starting step in ODE integration relative to time
-                  resolution
-h_min_rel real    Minimum step in ODE integration relative to time
-                  resolution
-========= ======= =========================================================
+----------------------------------------------------------------------------
+h0_rel     real    Starting step in ODE integration relative to time
+                   resolution
+h_min_rel  real    Minimum step in ODE integration relative to time
+                   resolution
+warp_step  real    If not 0, the neurons of a warp share a common step
+                   size, to reduce thread divergence (default 0)
+integrator real    ODE integrator: 0 adaptive RK5 (default),
+                   1 exponential Euler, 2 Rosenbrock (ROS2). The last two
+                   take a single step per time step. From Python it can be
+                   given also by name, "rk5", "exp_euler" or "rosenbrock"
+========== ======= =========================================================
 
 References
 ++++++++++
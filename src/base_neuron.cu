@@ -22,14 +22,48 @@
 
 
 #include "base_neuron.h"
+#include "buffer_pool.h"
 #include "cuda_error.h"
 #include "locate.h"
 #include "ngpu_exception.h"
 #include "scan.h"
 #include "spike_buffer.h"
 #include <config.h>
+#include <cstring>
 #include <iostream>
 
+// scalar parameters with the same value in all the neurons of a group
+__constant__ float NESTGPUConstParam[ MAX_CONST_PARAM ];
+// number of elements of NESTGPUConstParam already assigned to groups
+static int n_const_param_used = 0;
+
+// copies the node indexes i_neuron[0], ..., i_neuron[n_neuron -1]
+// to a reusable device buffer, through a pinned host buffer.
+// The copy is synchronized with the kernels that use the indexes
+static int*
+NodeIdxToDevice( int* i_neuron, int n_neuron )
+{
+  int* h_i_neuron = ( int* ) NodeAccessBufferPool.HostBuffer( 0, n_neuron * sizeof( int ) );
+  int* d_i_neuron = ( int* ) NodeAccessBufferPool.DeviceBuffer( 0, n_neuron * sizeof( int ) );
+  memcpy( h_i_neuron, i_neuron, n_neuron * sizeof( int ) );
+  gpuErrchk( cudaMemcpyAsync( d_i_neuron, h_i_neuron, n_neuron * sizeof( int ), cudaMemcpyHostToDevice ) );
+
+  return d_i_neuron;
+}
+
+// copies the array d_arr of n_elem elements from the device to a new
+// host array, through a pinned host buffer
+template < class T >
+static T*
+ArrayToHost( T* d_arr, int n_elem )
+{
+  T* h_buffer = ( T* ) NodeAccessBufferPool.HostBuffer( 1, n_elem * sizeof( T ) );
+  gpuErrchk( cudaMemcpy( h_buffer, d_arr, n_elem * sizeof( T ), cudaMemcpyDeviceToHost ) );
+  T* h_arr = ( T* ) malloc( n_elem * sizeof( T ) );
+  memcpy( h_arr, h_buffer, n_elem * sizeof( T ) );
+
+  return h_arr;
+}
 
 // set equally spaced (index i*step) elements of array arr to value val
 __global__ void
@@ -148,6 +182,12 @@ BaseNeuron::Init( int i_node_0, int n_node, int n_port, int i_group, unsigned lo
   n_param_ = 0;       // total number of parameters
 
   get_spike_array_ = NULL;
+  fused_input_ = false;       // input spikes folded by GetSpikes kernel
+  merged_update_ = false;     // group updated by its own Update method
+  stream_ = NULL;             // kernels issued in the default stream
+  precise_spike_ = false;     // spikes emitted and received on the grid
+  precise_spikes_.max_n_spike_ = 0;
+  precise_spikes_.n_spike_ = NULL;
   port_weight_arr_ = NULL;    // pointer to array of receptor-port weights
   port_weight_arr_step_ = 0;  // step between elements for different neurons
   port_weight_port_step_ = 0; // step between elements for different ports
@@ -181,6 +221,13 @@ BaseNeuron::Init( int i_node_0, int n_node, int n_port, int i_group, unsigned lo
                               // 0 for no buffering
   den_delay_arr_ = NULL;      // array of dendritic backward delays
 
+  n_pos_dim_ = 0;              // node positions not set
+  pos_vect_.clear();           // vector of node positions
+  has_spatial_extent_ = false; // spatial extent not set
+
+  const_param_mask_ = 0;    // no parameter folded in constant memory
+  const_param_offset_ = -1; // no slot of the constant-memory block
+
   return 0;
 }
 
@@ -234,6 +281,7 @@ BaseNeuron::SetScalParam( int i_neuron, int n_neuron, std::string param_name, fl
   {
     throw ngpu_exception( std::string( "Unrecognized scalar parameter " ) + param_name );
   }
+  UnfoldConstParam( param_name );
   CheckNeuronIdx( i_neuron );
   CheckNeuronIdx( i_neuron + n_neuron - 1 );
   float* param_pt = GetParamPt( i_neuron, param_name );
@@ -254,15 +302,12 @@ BaseNeuron::SetScalParam( int* i_neuron, int n_neuron, std::string param_name, f
   {
     throw ngpu_exception( std::string( "Unrecognized scalar parameter " ) + param_name );
   }
-  int* d_i_neuron;
-  gpuErrchk( cudaMalloc( &d_i_neuron, n_neuron * sizeof( int ) ) );
-  // Memcopy will be synchronized with BaseNeuronSetFloatPtArray kernel
-  gpuErrchk( cudaMemcpyAsync( d_i_neuron, i_neuron, n_neuron * sizeof( int ), cudaMemcpyHostToDevice ) );
+  UnfoldConstParam( param_name );
+  int* d_i_neuron = NodeIdxToDevice( i_neuron, n_neuron );
   float* param_pt = GetParamPt( 0, param_name );
   BaseNeuronSetFloatPtArray<<< ( n_neuron + 1023 ) / 1024, 1024 >>>( param_pt, d_i_neuron, n_neuron, n_param_, val );
   gpuErrchk( cudaPeekAtLastError() );
   gpuErrchk( cudaDeviceSynchronize() );
-  gpuErrchk( cudaFree( d_i_neuron ) );
 
   return 0;
 }
@@ -313,10 +358,7 @@ BaseNeuron::SetPortParam( int* i_neuron, int n_neuron, std::string param_name, f
       "Parameter array size must be equal "
       "to the number of ports." );
   }
-  int* d_i_neuron;
-  gpuErrchk( cudaMalloc( &d_i_neuron, n_neuron * sizeof( int ) ) );
-  // Memcopy will be synchronized with BaseNeuronSetFloatPtArray kernel
-  gpuErrchk( cudaMemcpyAsync( d_i_neuron, i_neuron, n_neuron * sizeof( int ), cudaMemcpyHostToDevice ) );
+  int* d_i_neuron = NodeIdxToDevice( i_neuron, n_neuron );
   for ( int i_vect = 0; i_vect < vect_size; i_vect++ )
   {
     float* param_pt = GetParamPt( 0, param_name, i_vect );
@@ -325,7 +367,6 @@ BaseNeuron::SetPortParam( int* i_neuron, int n_neuron, std::string param_name, f
     gpuErrchk( cudaPeekAtLastError() );
     gpuErrchk( cudaDeviceSynchronize() );
   }
-  gpuErrchk( cudaFree( d_i_neuron ) );
 
   return 0;
 }
@@ -396,15 +437,11 @@ BaseNeuron::SetIntVar( int* i_neuron, int n_neuron, std::string var_name, int va
   {
     throw ngpu_exception( std::string( "Unrecognized integer variable " ) + var_name );
   }
-  int* d_i_neuron;
-  gpuErrchk( cudaMalloc( &d_i_neuron, n_neuron * sizeof( int ) ) );
-  // Memcopy will be synchronized with BaseNeuronSetIntPtArray kernel
-  gpuErrchk( cudaMemcpyAsync( d_i_neuron, i_neuron, n_neuron * sizeof( int ), cudaMemcpyHostToDevice ) );
+  int* d_i_neuron = NodeIdxToDevice( i_neuron, n_neuron );
   int* var_pt = GetIntVarPt( 0, var_name );
   BaseNeuronSetIntPtArray<<< ( n_neuron + 1023 ) / 1024, 1024 >>>( var_pt, d_i_neuron, n_neuron, 1, val );
   gpuErrchk( cudaPeekAtLastError() );
   gpuErrchk( cudaDeviceSynchronize() );
-  gpuErrchk( cudaFree( d_i_neuron ) );
 
   return 0;
 }
@@ -439,15 +476,11 @@ BaseNeuron::SetScalVar( int* i_neuron, int n_neuron, std::string var_name, float
   {
     throw ngpu_exception( std::string( "Unrecognized scalar variable " ) + var_name );
   }
-  int* d_i_neuron;
-  gpuErrchk( cudaMalloc( &d_i_neuron, n_neuron * sizeof( int ) ) );
-  // Memcopy will be synchronized with BaseNeuronSetFloatPtArray kernel
-  gpuErrchk( cudaMemcpyAsync( d_i_neuron, i_neuron, n_neuron * sizeof( int ), cudaMemcpyHostToDevice ) );
+  int* d_i_neuron = NodeIdxToDevice( i_neuron, n_neuron );
   float* var_pt = GetVarPt( 0, var_name );
   BaseNeuronSetFloatPtArray<<< ( n_neuron + 1023 ) / 1024, 1024 >>>( var_pt, d_i_neuron, n_neuron, n_var_, val );
   gpuErrchk( cudaPeekAtLastError() );
   gpuErrchk( cudaDeviceSynchronize() );
-  gpuErrchk( cudaFree( d_i_neuron ) );
 
   return 0;
 }
@@ -498,10 +531,7 @@ BaseNeuron::SetPortVar( int* i_neuron, int n_neuron, std::string var_name, float
       "Variable array size must be equal "
       "to the number of ports." );
   }
-  int* d_i_neuron;
-  gpuErrchk( cudaMalloc( &d_i_neuron, n_neuron * sizeof( int ) ) );
-  // Memcopy will be synchronized with BaseNeuronSetFloatPtArray kernel
-  gpuErrchk( cudaMemcpyAsync( d_i_neuron, i_neuron, n_neuron * sizeof( int ), cudaMemcpyHostToDevice ) );
+  int* d_i_neuron = NodeIdxToDevice( i_neuron, n_neuron );
   for ( int i_vect = 0; i_vect < vect_size; i_vect++ )
   {
     float* var_pt = GetVarPt( 0, var_name, i_vect );
@@ -510,7 +540,6 @@ BaseNeuron::SetPortVar( int* i_neuron, int n_neuron, std::string var_name, float
     gpuErrchk( cudaPeekAtLastError() );
     gpuErrchk( cudaDeviceSynchronize() );
   }
-  gpuErrchk( cudaFree( d_i_neuron ) );
 
   return 0;
 }
@@ -548,16 +577,13 @@ BaseNeuron::GetScalParam( int i_neuron, int n_neuron, std::string param_name )
   CheckNeuronIdx( i_neuron + n_neuron - 1 );
   float* param_pt = GetParamPt( i_neuron, param_name );
 
-  float* d_param_arr;
-  gpuErrchk( cudaMalloc( &d_param_arr, n_neuron * sizeof( float ) ) );
-  float* h_param_arr = ( float* ) malloc( n_neuron * sizeof( float ) );
+  float* d_param_arr = ( float* ) NodeAccessBufferPool.DeviceBuffer( 1, n_neuron * sizeof( float ) );
 
   BaseNeuronGetFloatArray<<< ( n_neuron + 1023 ) / 1024, 1024 >>>( param_pt, d_param_arr, n_neuron, n_param_, 1 );
   gpuErrchk( cudaPeekAtLastError() );
   gpuErrchk( cudaDeviceSynchronize() );
 
-  gpuErrchk( cudaMemcpy( h_param_arr, d_param_arr, n_neuron * sizeof( float ), cudaMemcpyDeviceToHost ) );
-  gpuErrchk( cudaFree( d_param_arr ) );
+  float* h_param_arr = ArrayToHost( d_param_arr, n_neuron );
 
   return h_param_arr;
 }
@@ -571,24 +597,17 @@ BaseNeuron::GetScalParam( int* i_neuron, int n_neuron, std::string param_name )
   {
     throw ngpu_exception( std::string( "Unrecognized scalar parameter " ) + param_name );
   }
-  int* d_i_neuron;
-  gpuErrchk( cudaMalloc( &d_i_neuron, n_neuron * sizeof( int ) ) );
-  // Memcopy will be synchronized with BaseNeuronGetFloatPtArray kernel
-  gpuErrchk( cudaMemcpyAsync( d_i_neuron, i_neuron, n_neuron * sizeof( int ), cudaMemcpyHostToDevice ) );
+  int* d_i_neuron = NodeIdxToDevice( i_neuron, n_neuron );
   float* param_pt = GetParamPt( 0, param_name );
 
-  float* d_param_arr;
-  gpuErrchk( cudaMalloc( &d_param_arr, n_neuron * sizeof( float ) ) );
-  float* h_param_arr = ( float* ) malloc( n_neuron * sizeof( float ) );
+  float* d_param_arr = ( float* ) NodeAccessBufferPool.DeviceBuffer( 1, n_neuron * sizeof( float ) );
 
   BaseNeuronGetFloatPtArray<<< ( n_neuron + 1023 ) / 1024, 1024 >>>(
     param_pt, d_param_arr, d_i_neuron, n_neuron, n_param_, 1 );
   gpuErrchk( cudaPeekAtLastError() );
   gpuErrchk( cudaDeviceSynchronize() );
-  gpuErrchk( cudaFree( d_i_neuron ) );
 
-  gpuErrchk( cudaMemcpy( h_param_arr, d_param_arr, n_neuron * sizeof( float ), cudaMemcpyDeviceToHost ) );
-  gpuErrchk( cudaFree( d_param_arr ) );
+  float* h_param_arr = ArrayToHost( d_param_arr, n_neuron );
 
   return h_param_arr;
 }
@@ -606,9 +625,7 @@ BaseNeuron::GetPortParam( int i_neuron, int n_neuron, std::string param_name )
   CheckNeuronIdx( i_neuron + n_neuron - 1 );
   float* param_pt;
 
-  float* d_param_arr;
-  gpuErrchk( cudaMalloc( &d_param_arr, n_neuron * n_port_ * sizeof( float ) ) );
-  float* h_param_arr = ( float* ) malloc( n_neuron * n_port_ * sizeof( float ) );
+  float* d_param_arr = ( float* ) NodeAccessBufferPool.DeviceBuffer( 1, n_neuron * n_port_ * sizeof( float ) );
 
   for ( int port = 0; port < n_port_; port++ )
   {
@@ -619,8 +636,7 @@ BaseNeuron::GetPortParam( int i_neuron, int n_neuron, std::string param_name )
     gpuErrchk( cudaDeviceSynchronize() );
   }
 
-  gpuErrchk( cudaMemcpy( h_param_arr, d_param_arr, n_neuron * n_port_ * sizeof( float ), cudaMemcpyDeviceToHost ) );
-  gpuErrchk( cudaFree( d_param_arr ) );
+  float* h_param_arr = ArrayToHost( d_param_arr, n_neuron * n_port_ );
 
   return h_param_arr;
 }
@@ -634,14 +650,9 @@ BaseNeuron::GetPortParam( int* i_neuron, int n_neuron, std::string param_name )
   {
     throw ngpu_exception( std::string( "Unrecognized port parameter " ) + param_name );
   }
-  int* d_i_neuron;
-  gpuErrchk( cudaMalloc( &d_i_neuron, n_neuron * sizeof( int ) ) );
-  // Memcopy will be synchronized with BaseNeuronGetFloatPtArray kernel
-  gpuErrchk( cudaMemcpyAsync( d_i_neuron, i_neuron, n_neuron * sizeof( int ), cudaMemcpyHostToDevice ) );
+  int* d_i_neuron = NodeIdxToDevice( i_neuron, n_neuron );
 
-  float* d_param_arr;
-  gpuErrchk( cudaMalloc( &d_param_arr, n_neuron * n_port_ * sizeof( float ) ) );
-  float* h_param_arr = ( float* ) malloc( n_neuron * n_port_ * sizeof( float ) );
+  float* d_param_arr = ( float* ) NodeAccessBufferPool.DeviceBuffer( 1, n_neuron * n_port_ * sizeof( float ) );
 
   for ( int port = 0; port < n_port_; port++ )
   {
@@ -651,10 +662,8 @@ BaseNeuron::GetPortParam( int* i_neuron, int n_neuron, std::string param_name )
     gpuErrchk( cudaPeekAtLastError() );
     gpuErrchk( cudaDeviceSynchronize() );
   }
-  gpuErrchk( cudaFree( d_i_neuron ) );
 
-  gpuErrchk( cudaMemcpy( h_param_arr, d_param_arr, n_neuron * n_port_ * sizeof( float ), cudaMemcpyDeviceToHost ) );
-  gpuErrchk( cudaFree( d_param_arr ) );
+  float* h_param_arr = ArrayToHost( d_param_arr, n_neuron * n_port_ );
 
   return h_param_arr;
 }
@@ -697,16 +706,13 @@ BaseNeuron::GetIntVar( int i_neuron, int n_neuron, std::string var_name )
   CheckNeuronIdx( i_neuron + n_neuron - 1 );
   int* var_pt = GetIntVarPt( i_neuron, var_name );
 
-  int* d_var_arr;
-  gpuErrchk( cudaMalloc( &d_var_arr, n_neuron * sizeof( int ) ) );
-  int* h_var_arr = ( int* ) malloc( n_neuron * sizeof( int ) );
+  int* d_var_arr = ( int* ) NodeAccessBufferPool.DeviceBuffer( 1, n_neuron * sizeof( int ) );
 
   BaseNeuronGetIntArray<<< ( n_neuron + 1023 ) / 1024, 1024 >>>( var_pt, d_var_arr, n_neuron, 1, 1 );
   gpuErrchk( cudaPeekAtLastError() );
   gpuErrchk( cudaDeviceSynchronize() );
 
-  gpuErrchk( cudaMemcpy( h_var_arr, d_var_arr, n_neuron * sizeof( int ), cudaMemcpyDeviceToHost ) );
-  gpuErrchk( cudaFree( d_var_arr ) );
+  int* h_var_arr = ArrayToHost( d_var_arr, n_neuron );
 
   return h_var_arr;
 }
@@ -720,23 +726,16 @@ BaseNeuron::GetIntVar( int* i_neuron, int n_neuron, std::string var_name )
   {
     throw ngpu_exception( std::string( "Unrecognized integer variable " ) + var_name );
   }
-  int* d_i_neuron;
-  gpuErrchk( cudaMalloc( &d_i_neuron, n_neuron * sizeof( int ) ) );
-  // Memcopy will be synchronized with BaseNeuronGetIntPtArray kernel
-  gpuErrchk( cudaMemcpyAsync( d_i_neuron, i_neuron, n_neuron * sizeof( int ), cudaMemcpyHostToDevice ) );
+  int* d_i_neuron = NodeIdxToDevice( i_neuron, n_neuron );
   int* var_pt = GetIntVarPt( 0, var_name );
 
-  int* d_var_arr;
-  gpuErrchk( cudaMalloc( &d_var_arr, n_neuron * sizeof( int ) ) );
-  int* h_var_arr = ( int* ) malloc( n_neuron * sizeof( int ) );
+  int* d_var_arr = ( int* ) NodeAccessBufferPool.DeviceBuffer( 1, n_neuron * sizeof( int ) );
 
   BaseNeuronGetIntPtArray<<< ( n_neuron + 1023 ) / 1024, 1024 >>>( var_pt, d_var_arr, d_i_neuron, n_neuron, 1, 1 );
   gpuErrchk( cudaPeekAtLastError() );
   gpuErrchk( cudaDeviceSynchronize() );
-  gpuErrchk( cudaFree( d_i_neuron ) );
 
-  gpuErrchk( cudaMemcpy( h_var_arr, d_var_arr, n_neuron * sizeof( int ), cudaMemcpyDeviceToHost ) );
-  gpuErrchk( cudaFree( d_var_arr ) );
+  int* h_var_arr = ArrayToHost( d_var_arr, n_neuron );
 
   return h_var_arr;
 }
@@ -754,16 +753,13 @@ BaseNeuron::GetScalVar( int i_neuron, int n_neuron, std::string var_name )
   CheckNeuronIdx( i_neuron + n_neuron - 1 );
   float* var_pt = GetVarPt( i_neuron, var_name );
 
-  float* d_var_arr;
-  gpuErrchk( cudaMalloc( &d_var_arr, n_neuron * sizeof( float ) ) );
-  float* h_var_arr = ( float* ) malloc( n_neuron * sizeof( float ) );
+  float* d_var_arr = ( float* ) NodeAccessBufferPool.DeviceBuffer( 1, n_neuron * sizeof( float ) );
 
   BaseNeuronGetFloatArray<<< ( n_neuron + 1023 ) / 1024, 1024 >>>( var_pt, d_var_arr, n_neuron, n_var_, 1 );
   gpuErrchk( cudaPeekAtLastError() );
   gpuErrchk( cudaDeviceSynchronize() );
 
-  gpuErrchk( cudaMemcpy( h_var_arr, d_var_arr, n_neuron * sizeof( float ), cudaMemcpyDeviceToHost ) );
-  gpuErrchk( cudaFree( d_var_arr ) );
+  float* h_var_arr = ArrayToHost( d_var_arr, n_neuron );
 
   return h_var_arr;
 }
@@ -777,24 +773,17 @@ BaseNeuron::GetScalVar( int* i_neuron, int n_neuron, std::string var_name )
   {
     throw ngpu_exception( std::string( "Unrecognized scalar variable " ) + var_name );
   }
-  int* d_i_neuron;
-  gpuErrchk( cudaMalloc( &d_i_neuron, n_neuron * sizeof( int ) ) );
-  // Memcopy will be synchronized with BaseNeuronGetFloatPtArray kernel
-  gpuErrchk( cudaMemcpyAsync( d_i_neuron, i_neuron, n_neuron * sizeof( int ), cudaMemcpyHostToDevice ) );
+  int* d_i_neuron = NodeIdxToDevice( i_neuron, n_neuron );
   float* var_pt = GetVarPt( 0, var_name );
 
-  float* d_var_arr;
-  gpuErrchk( cudaMalloc( &d_var_arr, n_neuron * sizeof( float ) ) );
-  float* h_var_arr = ( float* ) malloc( n_neuron * sizeof( float ) );
+  float* d_var_arr = ( float* ) NodeAccessBufferPool.DeviceBuffer( 1, n_neuron * sizeof( float ) );
 
   BaseNeuronGetFloatPtArray<<< ( n_neuron + 1023 ) / 1024, 1024 >>>(
     var_pt, d_var_arr, d_i_neuron, n_neuron, n_var_, 1 );
   gpuErrchk( cudaPeekAtLastError() );
   gpuErrchk( cudaDeviceSynchronize() );
-  gpuErrchk( cudaFree( d_i_neuron ) );
 
-  gpuErrchk( cudaMemcpy( h_var_arr, d_var_arr, n_neuron * sizeof( float ), cudaMemcpyDeviceToHost ) );
-  gpuErrchk( cudaFree( d_var_arr ) );
+  float* h_var_arr = ArrayToHost( d_var_arr, n_neuron );
 
   return h_var_arr;
 }
@@ -812,9 +801,7 @@ BaseNeuron::GetPortVar( int i_neuron, int n_neuron, std::string var_name )
   CheckNeuronIdx( i_neuron + n_neuron - 1 );
   float* var_pt;
 
-  float* d_var_arr;
-  gpuErrchk( cudaMalloc( &d_var_arr, n_neuron * n_port_ * sizeof( float ) ) );
-  float* h_var_arr = ( float* ) malloc( n_neuron * n_port_ * sizeof( float ) );
+  float* d_var_arr = ( float* ) NodeAccessBufferPool.DeviceBuffer( 1, n_neuron * n_port_ * sizeof( float ) );
 
   for ( int port = 0; port < n_port_; port++ )
   {
@@ -825,8 +812,7 @@ BaseNeuron::GetPortVar( int i_neuron, int n_neuron, std::string var_name )
     gpuErrchk( cudaDeviceSynchronize() );
   }
 
-  gpuErrchk( cudaMemcpy( h_var_arr, d_var_arr, n_neuron * n_port_ * sizeof( float ), cudaMemcpyDeviceToHost ) );
-  gpuErrchk( cudaFree( d_var_arr ) );
+  float* h_var_arr = ArrayToHost( d_var_arr, n_neuron * n_port_ );
 
   return h_var_arr;
 }
@@ -840,14 +826,9 @@ BaseNeuron::GetPortVar( int* i_neuron, int n_neuron, std::string var_name )
   {
     throw ngpu_exception( std::string( "Unrecognized port variable " ) + var_name );
   }
-  int* d_i_neuron;
-  gpuErrchk( cudaMalloc( &d_i_neuron, n_neuron * sizeof( int ) ) );
-  // Memcopy will be synchronized with BaseNeuronGetFloatPtArray kernel
-  gpuErrchk( cudaMemcpyAsync( d_i_neuron, i_neuron, n_neuron * sizeof( int ), cudaMemcpyHostToDevice ) );
+  int* d_i_neuron = NodeIdxToDevice( i_neuron, n_neuron );
 
-  float* d_var_arr;
-  gpuErrchk( cudaMalloc( &d_var_arr, n_neuron * n_port_ * sizeof( float ) ) );
-  float* h_var_arr = ( float* ) malloc( n_neuron * n_port_ * sizeof( float ) );
+  float* d_var_arr = ( float* ) NodeAccessBufferPool.DeviceBuffer( 1, n_neuron * n_port_ * sizeof( float ) );
 
   for ( int port = 0; port < n_port_; port++ )
   {
@@ -857,10 +838,8 @@ BaseNeuron::GetPortVar( int* i_neuron, int n_neuron, std::string var_name )
     gpuErrchk( cudaPeekAtLastError() );
     gpuErrchk( cudaDeviceSynchronize() );
   }
-  gpuErrchk( cudaFree( d_i_neuron ) );
 
-  gpuErrchk( cudaMemcpy( h_var_arr, d_var_arr, n_neuron * n_port_ * sizeof( float ), cudaMemcpyDeviceToHost ) );
-  gpuErrchk( cudaFree( d_var_arr ) );
+  float* h_var_arr = ArrayToHost( d_var_arr, n_neuron * n_port_ );
 
   return h_var_arr;
 }
@@ -1687,3 +1666,135 @@ BaseNeuron::GetRecSpikeTimes( int** n_spike_times_pt, float*** spike_times_pt )
 
   return 0;
 }
+
+// Detects the scalar parameters that have the same value in all the
+// neurons of the group, except those in excl_mask, and copies them
+// to the constant-memory block NESTGPUConstParam
+int
+BaseNeuron::FoldConstParam( unsigned long long excl_mask )
+{
+  const_param_mask_ = 0;
+  int n_param = n_scal_param_ < MAX_FOLDED_PARAM ? n_scal_param_ : MAX_FOLDED_PARAM;
+  if ( n_node_ <= 0 || ( const_param_offset_ < 0 && n_const_param_used + n_param > MAX_CONST_PARAM ) )
+  {
+    return 0;
+  }
+  const_param_val_.assign( n_param, 0.0 );
+  for ( int i_param = 0; i_param < n_param; i_param++ )
+  {
+    if ( ( excl_mask >> i_param ) & 1ULL )
+    {
+      continue;
+    }
+    float* h_param = GetScalParam( 0, n_node_, scal_param_name_[ i_param ] );
+    bool homogeneous = true;
+    for ( int i_neuron = 1; i_neuron < n_node_; i_neuron++ )
+    {
+      if ( h_param[ i_neuron ] != h_param[ 0 ] )
+      {
+        homogeneous = false;
+        break;
+      }
+    }
+    if ( homogeneous )
+    {
+      const_param_mask_ |= ( 1ULL << i_param );
+      const_param_val_[ i_param ] = h_param[ 0 ];
+    }
+    free( h_param );
+  }
+  if ( const_param_mask_ != 0 )
+  {
+    if ( const_param_offset_ < 0 )
+    { // the slot is kept if the group is calibrated again
+      const_param_offset_ = n_const_param_used;
+      n_const_param_used += n_param;
+    }
+    gpuErrchk( cudaMemcpyToSymbol(
+      NESTGPUConstParam, const_param_val_.data(), n_param * sizeof( float ), const_param_offset_ * sizeof( float ) ) );
+  }
+
+  return 0;
+}
+
+// a parameter is no more read from the constant-memory block
+// after its value has been changed
+int
+BaseNeuron::UnfoldConstParam( std::string param_name )
+{
+  int i_param = GetScalParamIdx( param_name );
+  if ( i_param < MAX_FOLDED_PARAM )
+  {
+    const_param_mask_ &= ~( 1ULL << i_param );
+  }
+
+  return 0;
+}
+
+// names of the scalar parameters folded in the constant-memory block
+std::vector< std::string >
+BaseNeuron::GetConstParamNames()
+{
+  std::vector< std::string > param_name_vect;
+  for ( int i_param = 0; i_param < n_scal_param_ && i_param < MAX_FOLDED_PARAM; i_param++ )
+  {
+    if ( ( const_param_mask_ >> i_param ) & 1ULL )
+    {
+      param_name_vect.push_back( scal_param_name_[ i_param ] );
+    }
+  }
+
+  return param_name_vect;
+}
+
+// Called by the models that fold the input spikes in the port input
+// variables at the beginning of their Update kernel
+InputSpikeArray
+BaseNeuron::FuseInputSpikes()
+{
+  InputSpikeArray input_spikes;
+  input_spikes.spike_array_ = get_spike_array_;
+  input_spikes.n_node_ = n_node_;
+  input_spikes.n_port_ = ( get_spike_array_ != NULL ) ? n_port_ : 0;
+  input_spikes.port_weight_arr_ = port_weight_arr_;
+  input_spikes.port_weight_arr_step_ = port_weight_arr_step_;
+  input_spikes.port_weight_port_step_ = port_weight_port_step_;
+  input_spikes.port_input_arr_ = port_input_arr_;
+  input_spikes.port_input_arr_step_ = port_input_arr_step_;
+  input_spikes.port_input_port_step_ = port_input_port_step_;
+  fused_input_ = true;
+
+  return input_spikes;
+}
+
+int
+BaseNeuron::InitPreciseSpikeArray()
+{
+  int max_n_spike = ( int ) round( GetGroupParam( "max_input_spikes" ) * n_node_ );
+  max_n_spike = ( max_n_spike > 1 ) ? max_n_spike : 1;
+  precise_spikes_.max_n_spike_ = max_n_spike;
+  gpuErrchk( cudaMalloc( &precise_spikes_.n_spike_, sizeof( int ) ) );
+  gpuErrchk( cudaMalloc( &precise_spikes_.i_target_, max_n_spike * sizeof( int ) ) );
+  gpuErrchk( cudaMalloc( &precise_spikes_.port_, max_n_spike * sizeof( int ) ) );
+  gpuErrchk( cudaMalloc( &precise_spikes_.weight_, max_n_spike * sizeof( float ) ) );
+  gpuErrchk( cudaMalloc( &precise_spikes_.offset_, max_n_spike * sizeof( float ) ) );
+  gpuErrchk( cudaMemset( precise_spikes_.n_spike_, 0, sizeof( int ) ) );
+
+  return 0;
+}
+
+int
+BaseNeuron::FreePreciseSpikeArray()
+{
+  if ( precise_spikes_.n_spike_ != NULL )
+  {
+    gpuErrchk( cudaFree( precise_spikes_.n_spike_ ) );
+    gpuErrchk( cudaFree( precise_spikes_.i_target_ ) );
+    gpuErrchk( cudaFree( precise_spikes_.port_ ) );
+    gpuErrchk( cudaFree( precise_spikes_.weight_ ) );
+    gpuErrchk( cudaFree( precise_spikes_.offset_ ) );
+    precise_spikes_.n_spike_ = NULL;
+  }
+
+  return 0;
+}
@@ -25,11 +25,24 @@
 #define BASENEURON_H
 
 #include "dir_connect.h"
+#include "input_spike.h"
+#include "precise_spike.h"
+#include "spatial.h"
 #include <stdint.h>
 #include <string>
 #include <vector>
 
+// size of the constant-memory block that holds the scalar parameters
+// with the same value in all the neurons of a group
+#define MAX_CONST_PARAM 4096
+
+// maximum number of scalar parameters that can be folded in
+// the constant-memory block, one bit of a 64-bit mask for each
+#define MAX_FOLDED_PARAM 64
+
 class NESTGPU;
+struct CUstream_st;
+typedef struct CUstream_st* cudaStream_t;
 
 class BaseNeuron
 {
@@ -53,6 +66,15 @@ protected:
   int n_param_;
 
   double* get_spike_array_;
+  bool fused_input_; // if true, the Update kernel folds get_spike_array_
+                     // in the port input variables and clears it
+  bool merged_update_; // if true, the group is updated together with
+                       // other groups of the same model, see MergeUpdate
+  cudaStream_t stream_; // stream of the Update kernels of the group,
+                        // NULL for the default stream
+  bool precise_spike_;  // if true, the group emits spikes with offset
+                        // and receives them in precise_spikes_
+  PreciseSpikeArray precise_spikes_;
   float* port_weight_arr_;
   int port_weight_arr_step_;
   int port_weight_port_step_;
@@ -95,6 +117,17 @@ protected:
 
   std::vector< float > ext_neuron_input_spikes_;
 
+  int n_pos_dim_;                  // number of dimensions of node positions
+  std::vector< float > pos_vect_;  // node positions, pos[i_neuron*n_dim + i_dim]
+  bool has_spatial_extent_;        // true if the spatial extent has been set
+  SpatialExtent spatial_extent_;   // region of the node positions
+
+  unsigned long long const_param_mask_;  // scalar parameters folded in
+                                         // the constant-memory block
+  int const_param_offset_;               // offset of the group parameters
+                                         // in the constant-memory block
+  std::vector< float > const_param_val_; // values of the folded parameters
+
 public:
   virtual ~BaseNeuron()
   {
@@ -135,6 +168,24 @@ public:
     return 0;
   }
 
+  // Groups of the same model can be updated by a single kernel launch
+  // over the concatenation of their neurons. Returns true if the group
+  // node can be updated together with this group
+  virtual bool
+  CanMergeUpdate( BaseNeuron* node )
+  {
+    return false;
+  }
+
+  // Called at calibration on the first group of a batch of groups that
+  // can be updated together, group_vect includes the group itself.
+  // The Update method of the first group must then update all of them
+  virtual int
+  MergeUpdate( std::vector< BaseNeuron* > group_vect )
+  {
+    return 0;
+  }
+
   virtual int
   GetX( int i_neuron, int n_neuron, double* x )
   {
@@ -305,6 +356,30 @@ public:
   virtual float* GetExtNeuronInputSpikes( int* n_node, int* n_port );
 
   virtual int SetNeuronGroupParam( std::string param_name, float val );
+
+  // Detects the scalar parameters that have the same value in all the
+  // neurons of the group, except those in excl_mask, and copies them
+  // to the constant-memory block NESTGPUConstParam
+  int FoldConstParam( unsigned long long excl_mask );
+
+  // a parameter is no more read from the constant-memory block
+  // after its value has been changed
+  int UnfoldConstParam( std::string param_name );
+
+  std::vector< std::string > GetConstParamNames();
+
+  // Called by the models that fold the input spikes in the port input
+  // variables at the beginning of their Update kernel, in place of the
+  // GetSpikes kernel and of the clearing of the spike array.
+  // Returns the arrays to be passed to the kernel
+  InputSpikeArray FuseInputSpikes();
+
+  // Allocates the array of the spikes with offset received in a time step
+  // by the groups of the precise-spiking models, which have the group
+  // parameter max_input_spikes (maximum mean number of spikes per node)
+  int InitPreciseSpikeArray();
+
+  int FreePreciseSpikeArray();
 };
 
 #endif
@@ -0,0 +1,105 @@
+/*
+ *  buffer_pool.cu
+ *
+ *  This file is part of NEST GPU.
+ *
+ *  Copyright (C) 2021 The NEST Initiative
+ *
+ *  NEST GPU is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NEST GPU is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NEST GPU.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+
+#include <algorithm>
+#include <config.h>
+
+#include "buffer_pool.h"
+#include "cuda_error.h"
+
+BufferPool NodeAccessBufferPool;
+
+BufferPool::BufferPool()
+{
+  for ( int i = 0; i < n_buffer_; i++ )
+  {
+    h_buffer_[ i ] = NULL;
+    h_size_[ i ] = 0;
+    d_buffer_[ i ] = NULL;
+    d_size_[ i ] = 0;
+  }
+}
+
+BufferPool::~BufferPool()
+{
+  Free();
+}
+
+int
+BufferPool::Free()
+{
+  for ( int i = 0; i < n_buffer_; i++ )
+  {
+    if ( h_buffer_[ i ] != NULL )
+    {
+      cudaFreeHost( h_buffer_[ i ] );
+      h_buffer_[ i ] = NULL;
+      h_size_[ i ] = 0;
+    }
+    if ( d_buffer_[ i ] != NULL )
+    {
+      cudaFree( d_buffer_[ i ] );
+      d_buffer_[ i ] = NULL;
+      d_size_[ i ] = 0;
+    }
+  }
+
+  return 0;
+}
+
+// The buffers grow at least geometrically, so that a sequence of
+// requests of increasing size makes a logarithmic number of allocations
+void*
+BufferPool::HostBuffer( int i, size_t size )
+{
+  if ( size > h_size_[ i ] )
+  {
+    size_t new_size = std::max( size, 2 * h_size_[ i ] );
+    if ( h_buffer_[ i ] != NULL )
+    {
+      gpuErrchk( cudaFreeHost( h_buffer_[ i ] ) );
+    }
+    gpuErrchk( cudaMallocHost( &h_buffer_[ i ], new_size ) );
+    h_size_[ i ] = new_size;
+  }
+
+  return h_buffer_[ i ];
+}
+
+void*
+BufferPool::DeviceBuffer( int i, size_t size )
+{
+  if ( size > d_size_[ i ] )
+  {
+    size_t new_size = std::max( size, 2 * d_size_[ i ] );
+    if ( d_buffer_[ i ] != NULL )
+    {
+      gpuErrchk( cudaFree( d_buffer_[ i ] ) );
+    }
+    gpuErrchk( cudaMalloc( &d_buffer_[ i ], new_size ) );
+    d_size_[ i ] = new_size;
+  }
+
+  return d_buffer_[ i ];
+}
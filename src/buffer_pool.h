@@ -0,0 +1,63 @@
+/*
+ *  buffer_pool.h
+ *
+ *  This file is part of NEST GPU.
+ *
+ *  Copyright (C) 2021 The NEST Initiative
+ *
+ *  NEST GPU is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NEST GPU is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NEST GPU.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+
+#ifndef BUFFERPOOL_H
+#define BUFFERPOOL_H
+
+#include <stddef.h>
+
+// Reusable pinned host buffers and device buffers for the temporary
+// arrays used to access the parameters and the variables of the nodes
+// from the host. Each buffer grows to the largest size requested and is
+// kept until Free is called, so that repeated accesses do not allocate
+// memory. The content of a buffer is valid until the next request of the
+// same buffer, therefore the work that uses it must be completed before
+// returning to the caller.
+class BufferPool
+{
+  static const int n_buffer_ = 2;
+  void* h_buffer_[ n_buffer_ ];
+  size_t h_size_[ n_buffer_ ];
+  void* d_buffer_[ n_buffer_ ];
+  size_t d_size_[ n_buffer_ ];
+
+public:
+  BufferPool();
+
+  ~BufferPool();
+
+  int Free();
+
+  // i-th pinned host buffer, with size at least equal to size bytes
+  void* HostBuffer( int i, size_t size );
+
+  // i-th device buffer, with size at least equal to size bytes
+  void* DeviceBuffer( int i, size_t size );
+};
+
+// buffers of the node accessors of BaseNeuron: buffer 0 is used for the
+// node indexes, buffer 1 for the values of the parameters and variables
+extern BufferPool NodeAccessBufferPool;
+
+#endif
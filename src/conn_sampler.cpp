@@ -0,0 +1,171 @@
+/*
+ *  conn_sampler.cpp
+ *
+ *  This file is part of NEST GPU.
+ *
+ *  Copyright (C) 2021 The NEST Initiative
+ *
+ *  NEST GPU is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NEST GPU is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NEST GPU.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#include "conn_sampler.h"
+#include "ngpu_exception.h"
+
+ConnSampler::ConnSampler( unsigned long long seed /*=0*/ )
+  : rng_( seed )
+  , uniform_( 0.0, 1.0 )
+  , uniform_int_( 0, 1 )
+{
+}
+
+int
+ConnSampler::Seed( unsigned long long seed )
+{
+  rng_.seed( seed );
+  uniform_.reset();
+  uniform_int_.reset();
+
+  return 0;
+}
+
+double
+ConnSampler::Uniform()
+{
+  // uniform_ returns values in [0,1)
+  return 1.0 - uniform_( rng_ );
+}
+
+int
+ConnSampler::BernoulliSkip( int n, double p, std::vector< int >& idx_vect )
+{
+  if ( n <= 0 || p <= 0.0 )
+  {
+    return 0;
+  }
+  if ( p >= 1.0 )
+  {
+    for ( int i = 0; i < n; i++ )
+    {
+      idx_vect.push_back( i );
+    }
+    return n;
+  }
+  // the number of failed trials before the next success
+  // is floor(log(u) / log(1-p)), with u uniform in (0,1]
+  double inv_log_q = 1.0 / std::log1p( -p );
+  int n_sel = 0;
+  double i = -1.0;
+  for ( ;; )
+  {
+    i += 1.0 + std::floor( std::log( Uniform() ) * inv_log_q );
+    if ( i >= n )
+    {
+      break;
+    }
+    idx_vect.push_back( ( int ) i );
+    n_sel++;
+  }
+
+  return n_sel;
+}
+
+int
+ConnSampler::SampleWithReplacement( int n, int k, std::vector< int >& idx_vect, int i_excl /*=-1*/ )
+{
+  // if an index is excluded, draw from [0, n-1) and skip it
+  int m = ( i_excl >= 0 && i_excl < n ) ? n - 1 : n;
+  if ( k > 0 && m <= 0 )
+  {
+    throw ngpu_exception( "Cannot sample indexes from an empty range" );
+  }
+  for ( int i = 0; i < k; i++ )
+  {
+    int j = UniformInt( m );
+    if ( m < n && j >= i_excl )
+    {
+      j++;
+    }
+    idx_vect.push_back( j );
+  }
+
+  return k;
+}
+
+int
+ConnSampler::SampleWithoutReplacement( int n, int k, std::vector< int >& idx_vect, int i_excl /*=-1*/ )
+{
+  int m = ( i_excl >= 0 && i_excl < n ) ? n - 1 : n;
+  if ( k > m )
+  {
+    throw ngpu_exception( "Number of samples larger than number of indexes" );
+  }
+  if ( 2 * k > m )
+  {
+    // dense case: the first k elements of a partial Fisher-Yates shuffle.
+    // The stored permutation does not need to be reset between calls,
+    // because shuffling any permutation gives a uniform sample
+    if ( ( int ) perm_.size() != m )
+    {
+      perm_.resize( m );
+      for ( int i = 0; i < m; i++ )
+      {
+        perm_[ i ] = i;
+      }
+    }
+    for ( int i = 0; i < k; i++ )
+    {
+      int j = i + UniformInt( m - i );
+      std::swap( perm_[ i ], perm_[ j ] );
+      int idx = perm_[ i ];
+      idx_vect.push_back( ( m < n && idx >= i_excl ) ? idx + 1 : idx );
+    }
+  }
+  else
+  {
+    // sparse case: Floyd's algorithm, duplicates are checked
+    // with an array of marks that is cleared after use
+    if ( ( int ) mark_.size() < m )
+    {
+      mark_.resize( m, 0 );
+    }
+    int i0 = idx_vect.size();
+    for ( int j = m - k; j < m; j++ )
+    {
+      int idx = UniformInt( j + 1 );
+      if ( mark_[ idx ] )
+      {
+        idx = j;
+      }
+      mark_[ idx ] = 1;
+      idx_vect.push_back( idx );
+    }
+    for ( int i = i0; i < i0 + k; i++ )
+    {
+      int idx = idx_vect[ i ];
+      mark_[ idx ] = 0;
+      if ( m < n && idx >= i_excl )
+      {
+        idx_vect[ i ] = idx + 1;
+      }
+    }
+  }
+
+  return k;
+}
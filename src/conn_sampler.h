@@ -0,0 +1,76 @@
+/*
+ *  conn_sampler.h
+ *
+ *  This file is part of NEST GPU.
+ *
+ *  Copyright (C) 2021 The NEST Initiative
+ *
+ *  NEST GPU is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NEST GPU is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NEST GPU.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/////////////////////////////////////////////////////////////////
+// ConnSampler class definition
+// host-side random sampling of node indexes for connection rules
+// It does not depend on CUDA, so that it can be tested on the host
+/////////////////////////////////////////////////////////////////
+
+#ifndef CONNSAMPLER_H
+#define CONNSAMPLER_H
+
+#include <random>
+#include <vector>
+
+class ConnSampler
+{
+  std::mt19937_64 rng_;
+  std::uniform_real_distribution< double > uniform_;
+  std::uniform_int_distribution< int > uniform_int_;
+  std::vector< unsigned char > mark_; // marks indexes already selected
+  std::vector< int > perm_;           // permutation used for dense sampling
+
+  // uniformly distributed random integer in [0, m)
+  inline int
+  UniformInt( int m )
+  {
+    return uniform_int_( rng_, std::uniform_int_distribution< int >::param_type( 0, m - 1 ) );
+  }
+
+public:
+  ConnSampler( unsigned long long seed = 0 );
+
+  int Seed( unsigned long long seed );
+
+  // uniformly distributed random number in the interval (0,1]
+  double Uniform();
+
+  // Appends to idx_vect, in increasing order, the indexes in [0, n)
+  // that pass independent Bernoulli trials with probability p.
+  // Instead of drawing one number per index, the gap to the next selected
+  // index is drawn from a geometric distribution, so that the cost
+  // is proportional to the number of selected indexes
+  int BernoulliSkip( int n, double p, std::vector< int >& idx_vect );
+
+  // Appends to idx_vect k indexes drawn uniformly and independently
+  // from [0, n). If i_excl >= 0, the index i_excl is never drawn
+  int SampleWithReplacement( int n, int k, std::vector< int >& idx_vect, int i_excl = -1 );
+
+  // Appends to idx_vect k distinct indexes drawn uniformly from [0, n).
+  // If i_excl >= 0, the index i_excl is never drawn.
+  // The cost is O(k): sparse samples use Floyd's algorithm,
+  // dense ones a partial Fisher-Yates shuffle of a stored permutation
+  int SampleWithoutReplacement( int n, int k, std::vector< int >& idx_vect, int i_excl = -1 );
+};
+
+#endif
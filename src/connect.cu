@@ -30,8 +30,6 @@
 #include "connect.h"
 #include "ngpu_exception.h"
 
-extern bool ConnectionSpikeTimeFlag; // provare a mettere nella classe?
-
 int
 NetConnection::Connect( int i_source,
   int i_target,
@@ -44,12 +42,6 @@ NetConnection::Connect( int i_source,
   {
     throw ngpu_exception( "Delay must be >= time resolution" );
   }
-  // TEMPORARY, TO BE IMPROVED
-  if ( syn_group >= 1 )
-  {
-    ConnectionSpikeTimeFlag = true;
-  }
-
   int d_int = ( int ) round( delay / time_resolution_ ) - 1;
   TargetSyn tg = { i_target, port, syn_group, weight };
   Insert( d_int, i_source, tg );
@@ -57,10 +49,107 @@ NetConnection::Connect( int i_source,
   return 0;
 }
 
+// On the GPU the plastic connections of each connection group are
+// stored after the static ones, keeping their order, so that they can be
+// handled in separate loops. The host connections keep their creation
+// order, so that connection ids do not change in calibration, and the
+// positions on the GPU are stored for the groups where they differ
+int
+NetConnection::BuildStoredIndex()
+{
+  for ( unsigned int i_source = 0; i_source < connection_.size(); i_source++ )
+  {
+    std::vector< ConnGroup >& conn = connection_[ i_source ];
+    for ( unsigned int id = 0; id < conn.size(); id++ )
+    {
+      std::vector< TargetSyn >& tv = conn[ id ].target_vect;
+      std::vector< unsigned int >& stored_idx = conn[ id ].stored_idx;
+      stored_idx.clear();
+      unsigned int n_static = 0;
+      bool partitioned = true;
+      for ( unsigned int i = 0; i < tv.size(); i++ )
+      {
+        if ( tv[ i ].syn_group == 0 )
+        {
+          partitioned = partitioned && ( n_static == i );
+          n_static++;
+        }
+      }
+      if ( partitioned )
+      {
+        continue;
+      }
+      stored_idx.resize( tv.size() );
+      unsigned int i_static = 0;
+      unsigned int i_plastic = n_static;
+      for ( unsigned int i = 0; i < tv.size(); i++ )
+      {
+        stored_idx[ i ] = ( tv[ i ].syn_group == 0 ) ? i_static++ : i_plastic++;
+      }
+    }
+  }
+
+  return 0;
+}
+
+int
+NetConnection::GetStoredWeights( float* weight )
+{
+  unsigned int i_conn = 0;
+  for ( unsigned int i_source = 0; i_source < connection_.size(); i_source++ )
+  {
+    std::vector< ConnGroup >& conn = connection_[ i_source ];
+    for ( unsigned int id = 0; id < conn.size(); id++ )
+    {
+      std::vector< TargetSyn >& tv = conn[ id ].target_vect;
+      for ( int plastic = 0; plastic < 2; plastic++ )
+      {
+        for ( unsigned int i = 0; i < tv.size(); i++ )
+        {
+          if ( ( tv[ i ].syn_group > 0 ) == ( plastic > 0 ) )
+          {
+            weight[ i_conn++ ] = tv[ i ].weight;
+          }
+        }
+      }
+    }
+  }
+
+  return 0;
+}
+
+int
+NetConnection::SetStoredWeights( float* weight )
+{
+  unsigned int i_conn = 0;
+  for ( unsigned int i_source = 0; i_source < connection_.size(); i_source++ )
+  {
+    std::vector< ConnGroup >& conn = connection_[ i_source ];
+    for ( unsigned int id = 0; id < conn.size(); id++ )
+    {
+      std::vector< TargetSyn >& tv = conn[ id ].target_vect;
+      for ( int plastic = 0; plastic < 2; plastic++ )
+      {
+        for ( unsigned int i = 0; i < tv.size(); i++ )
+        {
+          if ( ( tv[ i ].syn_group > 0 ) == ( plastic > 0 ) )
+          {
+            tv[ i ].weight = weight[ i_conn++ ];
+          }
+        }
+      }
+    }
+  }
+
+  return 0;
+}
+
 int
 NetConnection::Insert( int d_int, int i_source, TargetSyn tg )
 {
   int id;
+  // connection groups may be shifted, so connection indexes change
+  rev_index_ready_ = false;
   std::vector< ConnGroup >& conn = connection_[ i_source ];
   int conn_size = conn.size();
   for ( id = 0; id < conn_size && d_int > conn[ id ].delay; id++ )
@@ -101,7 +190,7 @@ NetConnection::ConnGroupPrint( int i_source )
   for ( unsigned int id = 0; id < conn.size(); id++ )
   {
     std::cout << "\tDelay: " << conn[ id ].delay << std::endl;
-    std::vector< TargetSyn > tv = conn[ id ].target_vect;
+    std::vector< TargetSyn >& tv = conn[ id ].target_vect;
     std::cout << "\tTargets: " << std::endl;
     for ( unsigned int i = 0; i < tv.size(); i++ )
     {
@@ -180,7 +269,7 @@ NetConnection::GetConnectionStatus( ConnectionId conn_id )
   int i_group = conn_id.i_group_;
   int i_conn = conn_id.i_conn_;
   std::vector< ConnGroup >& conn = connection_[ i_source ];
-  std::vector< TargetSyn > tv = conn[ i_group ].target_vect;
+  std::vector< TargetSyn >& tv = conn[ i_group ].target_vect;
 
   ConnectionStatus conn_stat;
   conn_stat.i_source = i_source;
@@ -197,6 +286,7 @@ std::vector< ConnectionStatus >
 NetConnection::GetConnectionStatus( std::vector< ConnectionId >& conn_id_vect )
 {
   std::vector< ConnectionStatus > conn_stat_vect;
+  conn_stat_vect.reserve( conn_id_vect.size() );
 
   for ( unsigned int i = 0; i < conn_id_vect.size(); i++ )
   {
@@ -207,3 +297,75 @@ NetConnection::GetConnectionStatus( std::vector< ConnectionId >& conn_id_vect )
 
   return conn_stat_vect;
 }
+
+int
+NetConnection::GetConnectionColumns( std::vector< ConnectionId >& conn_id_vect, ConnectionColumns& columns )
+{
+  size_t n_conn = conn_id_vect.size();
+  columns.i_source.resize( n_conn );
+  columns.i_target.resize( n_conn );
+  columns.port.resize( n_conn );
+  columns.syn_group.resize( n_conn );
+  columns.delay.resize( n_conn );
+  columns.weight.resize( n_conn );
+  for ( size_t i = 0; i < n_conn; i++ )
+  {
+    ConnectionId& conn_id = conn_id_vect[ i ];
+    ConnGroup& conn_group = connection_[ conn_id.i_source_ ][ conn_id.i_group_ ];
+    TargetSyn& tg = conn_group.target_vect[ conn_id.i_conn_ ];
+    columns.i_source[ i ] = conn_id.i_source_;
+    columns.i_target[ i ] = tg.node;
+    columns.port[ i ] = tg.port;
+    columns.syn_group[ i ] = tg.syn_group;
+    columns.delay[ i ] = time_resolution_ * ( conn_group.delay + 1 );
+    columns.weight[ i ] = tg.weight;
+  }
+
+  return 0;
+}
+
+// Builds the reverse index with a counting sort of the connections
+// by target node. Within each target, connections are ordered by
+// source node, connection group and index in the group
+int
+NetConnection::BuildReverseIndex()
+{
+  unsigned int n_node = connection_.size();
+  rev_index_start_.assign( n_node + 1, 0 );
+  for ( unsigned int i_source = 0; i_source < n_node; i_source++ )
+  {
+    std::vector< ConnGroup >& conn = connection_[ i_source ];
+    for ( unsigned int id = 0; id < conn.size(); id++ )
+    {
+      std::vector< TargetSyn >& tv = conn[ id ].target_vect;
+      for ( unsigned int i = 0; i < tv.size(); i++ )
+      {
+        rev_index_start_[ tv[ i ].node + 1 ]++;
+      }
+    }
+  }
+  for ( unsigned int i_node = 0; i_node < n_node; i_node++ )
+  {
+    rev_index_start_[ i_node + 1 ] += rev_index_start_[ i_node ];
+  }
+  rev_index_conn_.resize( rev_index_start_[ n_node ] );
+  std::vector< unsigned int > fill( rev_index_start_.begin(), rev_index_start_.end() - 1 );
+  for ( unsigned int i_source = 0; i_source < n_node; i_source++ )
+  {
+    std::vector< ConnGroup >& conn = connection_[ i_source ];
+    for ( unsigned int id = 0; id < conn.size(); id++ )
+    {
+      std::vector< TargetSyn >& tv = conn[ id ].target_vect;
+      for ( unsigned int i = 0; i < tv.size(); i++ )
+      {
+        ConnectionId& conn_id = rev_index_conn_[ fill[ tv[ i ].node ]++ ];
+        conn_id.i_source_ = i_source;
+        conn_id.i_group_ = id;
+        conn_id.i_conn_ = i;
+      }
+    }
+  }
+  rev_index_ready_ = true;
+
+  return 0;
+}
@@ -26,6 +26,8 @@
 #include <algorithm>
 #include <vector>
 
+#include "ngpu_exception.h"
+
 #define PORT_N_SHIFT 1
 #define POW2_PORT_N_SHIFT 2 // 2^PORT_N_SHIFT
 #define PORT_MASK \
@@ -43,6 +45,20 @@ struct ConnectionId
   int i_conn_;
 };
 
+inline bool
+ConnectionIdLess( const ConnectionId& a, const ConnectionId& b )
+{
+  if ( a.i_source_ != b.i_source_ )
+  {
+    return a.i_source_ < b.i_source_;
+  }
+  if ( a.i_group_ != b.i_group_ )
+  {
+    return a.i_group_ < b.i_group_;
+  }
+  return a.i_conn_ < b.i_conn_;
+}
+
 struct ConnectionStatus
 {
   int i_source;
@@ -53,6 +69,18 @@ struct ConnectionStatus
   float weight;
 };
 
+// Parameters of a set of connections in columnar form,
+// with one array per field
+struct ConnectionColumns
+{
+  std::vector< int > i_source;
+  std::vector< int > i_target;
+  std::vector< unsigned char > port;
+  std::vector< unsigned char > syn_group;
+  std::vector< float > delay;
+  std::vector< float > weight;
+};
+
 struct TargetSyn
 {
   int node;
@@ -65,6 +93,9 @@ struct ConnGroup // connections from the same source node with same delay
 {
   int delay;
   std::vector< TargetSyn > target_vect;
+  // position on the GPU of each connection, relative to the first
+  // connection of the group, empty if equal to its index
+  std::vector< unsigned int > stored_idx;
 };
 
 struct RemoteConnection
@@ -85,12 +116,34 @@ class NetConnection
   unsigned int n_conn_;
   unsigned int n_rev_conn_;
 
+  // reverse index of the connections, in CSR format by target node.
+  // It is built at the first query that needs it, and it is invalidated
+  // when connections or nodes are added
+  bool rev_index_ready_;
+  std::vector< unsigned int > rev_index_start_;
+  std::vector< ConnectionId > rev_index_conn_;
+
+  bool
+  RevIndexReady()
+  {
+    return rev_index_ready_ && rev_index_start_.size() == connection_.size() + 1;
+  }
+
+  template < class T1, class T2 >
+  std::vector< ConnectionId >
+  GetConnectionsBySource( T1 source, int n_source, std::vector< char >& target_mask, int syn_group );
+
+  template < class T1, class T2 >
+  std::vector< ConnectionId >
+  GetConnectionsByTarget( std::vector< char >& source_mask, T2 target, int n_target, int syn_group );
+
 public:
   float time_resolution_;
 
   NetConnection()
   {
     n_conn_ = 0;
+    rev_index_ready_ = false;
   }
 
   std::vector< std::vector< ConnGroup > > connection_;
@@ -122,34 +175,123 @@ public:
     return 0;
   }
 
+  int BuildReverseIndex();
+
+  int BuildStoredIndex();
+
+  // position on the GPU of connection i_conn of group i_group of source
+  // i_source, relative to the first connection of the group
+  unsigned int
+  StoredIdx( int i_source, int i_group, int i_conn )
+  {
+    ConnGroup& conn_group = connection_[ i_source ][ i_group ];
+    return conn_group.stored_idx.empty() ? i_conn : conn_group.stored_idx[ i_conn ];
+  }
+
+  // weights of all the connections in the order in which they are stored
+  // on the GPU, with the static connections of each group first
+  int GetStoredWeights( float* weight );
+
+  int SetStoredWeights( float* weight );
+
   ConnectionStatus GetConnectionStatus( ConnectionId conn_id );
 
   std::vector< ConnectionStatus > GetConnectionStatus( std::vector< ConnectionId >& conn_id_vect );
 
+  int GetConnectionColumns( std::vector< ConnectionId >& conn_id_vect, ConnectionColumns& columns );
 
-  template < class T >
-  std::vector< ConnectionId > GetConnections( T source, int n_source, int i_target, int n_target, int syn_group = -1 );
-
-  template < class T >
-  std::vector< ConnectionId > GetConnections( T source, int n_source, int* i_target, int n_target, int syn_group = -1 );
+  // connections from the nodes source to the nodes target, with the
+  // synapse group syn_group, or with any synapse group if syn_group<0.
+  // T1 and T2 are int for sequences of nodes or int* for arrays
+  template < class T1, class T2 >
+  std::vector< ConnectionId > GetConnections( T1 source, int n_source, T2 target, int n_target, int syn_group = -1 );
 };
 
+// array of flags of the nodes belonging to a sequence or an array
 template < class T >
+std::vector< char >
+NodeMask( T node, int n_node, int n_all_node )
+{
+  std::vector< char > mask( n_all_node, 0 );
+  for ( int in = 0; in < n_node; in++ )
+  {
+    int i_node = GetINode< T >( node, in );
+    if ( i_node >= 0 && i_node < n_all_node )
+    {
+      mask[ i_node ] = 1;
+    }
+  }
+
+  return mask;
+}
+
+template < class T1, class T2 >
+std::vector< ConnectionId >
+NetConnection::GetConnections( T1 source, int n_source, T2 target, int n_target, int syn_group /*=-1*/ )
+{
+  int n_node = connection_.size();
+  for ( int is = 0; is < n_source; is++ )
+  {
+    int i_source = GetINode< T1 >( source, is );
+    if ( i_source < 0 || i_source >= n_node )
+    {
+      throw ngpu_exception( "Unrecognized source node in getting connections" );
+    }
+  }
+  // number of connections examined by a scan by source
+  size_t n_scan_source = 0;
+  for ( int is = 0; is < n_source; is++ )
+  {
+    std::vector< ConnGroup >& conn = connection_[ GetINode< T1 >( source, is ) ];
+    for ( unsigned int id = 0; id < conn.size(); id++ )
+    {
+      n_scan_source += conn[ id ].target_vect.size();
+    }
+  }
+  // the reverse index is built only if the scan by source
+  // examines a significant fraction of all the connections
+  if ( !RevIndexReady() && n_target < n_source && n_scan_source > NConnections() / 4 )
+  {
+    BuildReverseIndex();
+  }
+  if ( RevIndexReady() )
+  {
+    // number of connections examined by a scan by target
+    size_t n_scan_target = 0;
+    for ( int it = 0; it < n_target; it++ )
+    {
+      int i_target = GetINode< T2 >( target, it );
+      if ( i_target >= 0 && i_target < n_node )
+      {
+        n_scan_target += rev_index_start_[ i_target + 1 ] - rev_index_start_[ i_target ];
+      }
+    }
+    if ( n_scan_target < n_scan_source )
+    {
+      std::vector< char > source_mask = NodeMask< T1 >( source, n_source, n_node );
+      return GetConnectionsByTarget< T1, T2 >( source_mask, target, n_target, syn_group );
+    }
+  }
+  std::vector< char > target_mask = NodeMask< T2 >( target, n_target, n_node );
+
+  return GetConnectionsBySource< T1, T2 >( source, n_source, target_mask, syn_group );
+}
+
+template < class T1, class T2 >
 std::vector< ConnectionId >
-NetConnection::GetConnections( T source, int n_source, int i_target, int n_target, int /*syn_group*/ )
+NetConnection::GetConnectionsBySource( T1 source, int n_source, std::vector< char >& target_mask, int syn_group )
 {
   std::vector< ConnectionId > conn_id_vect;
   for ( int is = 0; is < n_source; is++ )
   {
-    int i_source = GetINode< T >( source, is );
+    int i_source = GetINode< T1 >( source, is );
     std::vector< ConnGroup >& conn = connection_[ i_source ];
     for ( unsigned int id = 0; id < conn.size(); id++ )
     {
-      std::vector< TargetSyn > tv = conn[ id ].target_vect;
+      std::vector< TargetSyn >& tv = conn[ id ].target_vect;
       for ( unsigned int i = 0; i < tv.size(); i++ )
       {
-        int itg = tv[ i ].node;
-        if ( ( itg >= i_target ) && ( itg < i_target + n_target ) )
+        if ( target_mask[ tv[ i ].node ] && ( syn_group < 0 || tv[ i ].syn_group == syn_group ) )
         {
           ConnectionId conn_id;
           conn_id.i_source_ = i_source;
@@ -164,38 +306,36 @@ NetConnection::GetConnections( T source, int n_source, int i_target, int n_targe
   return conn_id_vect;
 }
 
-template < class T >
+template < class T1, class T2 >
 std::vector< ConnectionId >
-NetConnection::GetConnections( T source, int n_source, int* i_target, int n_target, int /*syn_group*/ )
+NetConnection::GetConnectionsByTarget( std::vector< char >& source_mask, T2 target, int n_target, int syn_group )
 {
-  std::vector< int > target_vect( i_target, i_target + n_target );
-  std::sort( target_vect.begin(), target_vect.end() );
-
+  int n_node = connection_.size();
+  // each target is examined only once, as in the scan by source
+  std::vector< char > target_done( n_node, 0 );
   std::vector< ConnectionId > conn_id_vect;
-  for ( int is = 0; is < n_source; is++ )
+  for ( int it = 0; it < n_target; it++ )
   {
-    int i_source = GetINode< T >( source, is );
-    std::vector< ConnGroup >& conn = connection_[ i_source ];
-    for ( unsigned int id = 0; id < conn.size(); id++ )
+    int i_target = GetINode< T2 >( target, it );
+    if ( i_target < 0 || i_target >= n_node || target_done[ i_target ] )
     {
-      std::vector< TargetSyn > tv = conn[ id ].target_vect;
-      for ( unsigned int i = 0; i < tv.size(); i++ )
+      continue;
+    }
+    target_done[ i_target ] = 1;
+    for ( unsigned int k = rev_index_start_[ i_target ]; k < rev_index_start_[ i_target + 1 ]; k++ )
+    {
+      ConnectionId& conn_id = rev_index_conn_[ k ];
+      if ( source_mask[ conn_id.i_source_ ]
+        && ( syn_group < 0
+          || connection_[ conn_id.i_source_ ][ conn_id.i_group_ ].target_vect[ conn_id.i_conn_ ].syn_group
+            == syn_group ) )
       {
-        int itg = tv[ i ].node;
-        // https://riptutorial.com/cplusplus/example/7270/using-a-sorted-vector-for-fast-element-lookup
-        // check if itg is in target_vect
-        std::vector< int >::iterator it = std::lower_bound( target_vect.begin(), target_vect.end(), itg );
-        if ( it != target_vect.end() && *it == itg )
-        { // we found the element
-          ConnectionId conn_id;
-          conn_id.i_source_ = i_source;
-          conn_id.i_group_ = id;
-          conn_id.i_conn_ = i;
-          conn_id_vect.push_back( conn_id );
-        }
+        conn_id_vect.push_back( conn_id );
       }
     }
   }
+  // same order as the scan by source
+  std::sort( conn_id_vect.begin(), conn_id_vect.end(), ConnectionIdLess );
 
   return conn_id_vect;
 }
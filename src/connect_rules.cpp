@@ -25,6 +25,7 @@
 #include "connect_rules.h"
 #include "nestgpu.h"
 #include "ngpu_exception.h"
+#include <cmath>
 #include <config.h>
 #include <iostream>
 
@@ -35,6 +36,10 @@ ConnSpec::Init()
   total_num_ = 0;
   indegree_ = 0;
   outdegree_ = 0;
+  prob_ = 0.0;
+  allow_autapses_ = true;
+  allow_multapses_ = false;
+  kernel_.Init();
   return 0;
 }
 
@@ -51,7 +56,8 @@ ConnSpec::Init( int rule, int degree /*=0*/ )
   {
     throw ngpu_exception( "Unknown connection rule" );
   }
-  if ( ( rule == ALL_TO_ALL || rule == ONE_TO_ONE ) && ( degree != 0 ) )
+  if ( ( rule == ALL_TO_ALL || rule == ONE_TO_ONE || rule == PAIRWISE_BERNOULLI || rule == SPATIAL_PAIRWISE )
+    && ( degree != 0 ) )
   {
     throw ngpu_exception( std::string( "Connection rule " ) + conn_rule_name[ rule ] + " does not have a degree" );
   }
@@ -116,6 +122,25 @@ ConnSpec::SetParam( std::string param_name, int value )
     total_num_ = value;
     return 0;
   }
+  else if ( param_name == "allow_autapses" )
+  {
+    allow_autapses_ = ( value != 0 );
+    return 0;
+  }
+  else if ( param_name == "allow_multapses" )
+  {
+    allow_multapses_ = ( value != 0 );
+    return 0;
+  }
+  else if ( param_name == "kernel" )
+  {
+    if ( value < 0 || value >= N_KERNEL )
+    {
+      throw ngpu_exception( "Unknown spatial kernel" );
+    }
+    kernel_.kernel_idx_ = value;
+    return 0;
+  }
 
   throw ngpu_exception( "Unknown connection int parameter" );
 }
@@ -123,7 +148,44 @@ ConnSpec::SetParam( std::string param_name, int value )
 bool
 ConnSpec::IsParam( std::string param_name )
 {
-  if ( param_name == "rule" || param_name == "indegree" || param_name == "outdegree" || param_name == "total_num" )
+  if ( param_name == "rule" || param_name == "indegree" || param_name == "outdegree" || param_name == "total_num"
+    || param_name == "allow_autapses" || param_name == "allow_multapses" || param_name == "kernel" )
+  {
+    return true;
+  }
+  else
+  {
+    return false;
+  }
+}
+
+int
+ConnSpec::SetParam( std::string param_name, float value )
+{
+  if ( param_name == "p" )
+  {
+    if ( value < 0.0 || value > 1.0 )
+    {
+      throw ngpu_exception( "Connection probability p must be in the range [0,1]" );
+    }
+    prob_ = value;
+    // p is also the kernel amplitude of the spatial_pairwise rule
+    kernel_.SetParam( param_name, value );
+    return 0;
+  }
+  else if ( SpatialKernel::IsFloatParam( param_name ) )
+  {
+    kernel_.SetParam( param_name, value );
+    return 0;
+  }
+
+  throw ngpu_exception( "Unknown connection float parameter" );
+}
+
+bool
+ConnSpec::IsFloatParam( std::string param_name )
+{
+  if ( param_name == "p" || SpatialKernel::IsFloatParam( param_name ) )
   {
     return true;
   }
@@ -146,8 +208,8 @@ SynSpec::Init()
   port_ = 0;
   weight_ = 0;
   delay_ = 0;
-  weight_distr_ = 0;
-  delay_distr_ = 0;
+  weight_distr_.Init();
+  delay_distr_.Init();
   weight_array_ = NULL;
   delay_array_ = NULL;
 
@@ -218,6 +280,14 @@ SynSpec::SetParam( std::string param_name, int value )
     port_ = value;
     return 0;
   }
+  else if ( param_name == "weight_distribution" )
+  {
+    return weight_distr_.SetType( value );
+  }
+  else if ( param_name == "delay_distribution" )
+  {
+    return delay_distr_.SetType( value );
+  }
 
   throw ngpu_exception( "Unknown synapse int parameter" );
 }
@@ -225,7 +295,8 @@ SynSpec::SetParam( std::string param_name, int value )
 bool
 SynSpec::IsIntParam( std::string param_name )
 {
-  if ( param_name == "synapse_group" || param_name == "receptor" )
+  if ( param_name == "synapse_group" || param_name == "receptor" || param_name == "weight_distribution"
+    || param_name == "delay_distribution" )
   {
     return true;
   }
@@ -250,6 +321,14 @@ SynSpec::SetParam( std::string param_name, float value )
     }
     delay_ = value;
   }
+  else if ( param_name.compare( 0, 7, "weight_" ) == 0 && Distribution::IsFloatParam( param_name.substr( 7 ) ) )
+  {
+    weight_distr_.SetParam( param_name.substr( 7 ), value );
+  }
+  else if ( param_name.compare( 0, 6, "delay_" ) == 0 && Distribution::IsFloatParam( param_name.substr( 6 ) ) )
+  {
+    delay_distr_.SetParam( param_name.substr( 6 ), value );
+  }
   else
   {
     throw ngpu_exception( "Unknown synapse float parameter" );
@@ -264,6 +343,15 @@ SynSpec::IsFloatParam( std::string param_name )
   {
     return true;
   }
+  // parameters of weight and delay distributions, e.g. weight_mu, delay_low
+  else if ( param_name.compare( 0, 7, "weight_" ) == 0 && Distribution::IsFloatParam( param_name.substr( 7 ) ) )
+  {
+    return true;
+  }
+  else if ( param_name.compare( 0, 6, "delay_" ) == 0 && Distribution::IsFloatParam( param_name.substr( 6 ) ) )
+  {
+    return true;
+  }
   else
   {
     return false;
@@ -302,6 +390,155 @@ SynSpec::IsFloatPtParam( std::string param_name )
   }
 }
 
+// Seed for the host-side sampler of connection rules, drawn from the
+// GPU random number generator so that connectivity depends only on
+// the user-defined seed
+unsigned long long
+NESTGPU::ConnSamplerSeed()
+{
+  unsigned int* rnd = RandomInt( 2 );
+  unsigned long long seed = ( ( unsigned long long ) rnd[ 0 ] << 32 ) | rnd[ 1 ];
+  delete[] rnd;
+
+  return seed;
+}
+
+// Checks the weight and delay distributions of syn_spec and gives them
+// new seeds, so that each Connect call has independent random streams
+int
+NESTGPU::InitSynSpecDistributions( SynSpec& syn_spec )
+{
+  if ( syn_spec.weight_distr_.IsActive() )
+  {
+    syn_spec.weight_distr_.Check();
+    syn_spec.weight_distr_.SetSeed( ConnSamplerSeed() );
+  }
+  if ( syn_spec.delay_distr_.IsActive() )
+  {
+    syn_spec.delay_distr_.Check();
+    syn_spec.delay_distr_.SetSeed( ConnSamplerSeed() );
+  }
+
+  return 0;
+}
+
+int
+NESTGPU::SetNodePositions( int i_node, int n_node, float* pos, int n_dim )
+{
+  if ( n_dim < 1 || n_dim > MAX_SPATIAL_DIM )
+  {
+    throw ngpu_exception( "Number of spatial dimensions must be 1, 2 or 3" );
+  }
+  int i_group;
+  int i_neuron = i_node - GetNodeSequenceOffset( i_node, n_node, i_group );
+  BaseNeuron* node = node_vect_[ i_group ];
+  if ( node->n_pos_dim_ != n_dim )
+  {
+    // positions that are not set are marked as NAN
+    node->n_pos_dim_ = n_dim;
+    node->pos_vect_.assign( ( size_t ) node->n_node_ * n_dim, NAN );
+  }
+  std::copy( pos, pos + ( size_t ) n_node * n_dim, node->pos_vect_.begin() + ( size_t ) i_neuron * n_dim );
+
+  return 0;
+}
+
+int
+NESTGPU::SetSpatialExtent( int i_node, float* lower_left, float* extent, int n_dim, bool periodic )
+{
+  if ( n_dim < 1 || n_dim > MAX_SPATIAL_DIM )
+  {
+    throw ngpu_exception( "Number of spatial dimensions must be 1, 2 or 3" );
+  }
+  int i_group;
+  GetNodeSequenceOffset( i_node, 1, i_group );
+  SpatialExtent& ext = node_vect_[ i_group ]->spatial_extent_;
+  ext.n_dim_ = n_dim;
+  for ( int i_dim = 0; i_dim < n_dim; i_dim++ )
+  {
+    if ( extent[ i_dim ] <= 0.0 )
+    {
+      throw ngpu_exception( "Spatial extent must be >0 in all dimensions" );
+    }
+    ext.lower_left_[ i_dim ] = lower_left[ i_dim ];
+    ext.extent_[ i_dim ] = extent[ i_dim ];
+  }
+  ext.periodic_ = periodic;
+  node_vect_[ i_group ]->has_spatial_extent_ = true;
+
+  return 0;
+}
+
+// Copies the positions of the nodes in node_vect to pos_vect,
+// and returns the number of dimensions
+int
+NESTGPU::GatherNodePositions( std::vector< int >& node_vect, std::vector< float >& pos_vect )
+{
+  int n_dim = 0;
+  pos_vect.clear();
+  for ( unsigned int i = 0; i < node_vect.size(); i++ )
+  {
+    int i_node = node_vect[ i ];
+    if ( i_node < 0 || i_node >= ( int ) node_group_map_.size() )
+    {
+      throw ngpu_exception( "Unrecognized node in connection rule" );
+    }
+    BaseNeuron* node = node_vect_[ node_group_map_[ i_node ] ];
+    if ( node->n_pos_dim_ == 0 || ( n_dim != 0 && node->n_pos_dim_ != n_dim ) )
+    {
+      throw ngpu_exception(
+        "Spatial connection rules require the positions of all nodes, "
+        "with the same number of dimensions" );
+    }
+    n_dim = node->n_pos_dim_;
+    const float* pos = &node->pos_vect_[ ( size_t ) ( i_node - node->i_node_0_ ) * n_dim ];
+    for ( int i_dim = 0; i_dim < n_dim; i_dim++ )
+    {
+      if ( std::isnan( pos[ i_dim ] ) )
+      {
+        throw ngpu_exception( "Position not set for node " + std::to_string( i_node ) );
+      }
+      pos_vect.push_back( pos[ i_dim ] );
+    }
+  }
+
+  return n_dim;
+}
+
+// Spatial extent of the node group of i_node, or the bounding box
+// of the positions in pos_vect if it has not been set
+SpatialExtent
+NESTGPU::GetSpatialExtent( int i_node, std::vector< float >& pos_vect, int n_dim )
+{
+  BaseNeuron* node = node_vect_[ node_group_map_[ i_node ] ];
+  if ( node->has_spatial_extent_ )
+  {
+    if ( node->spatial_extent_.n_dim_ != n_dim )
+    {
+      throw ngpu_exception( "Spatial extent and node positions have different dimensions" );
+    }
+    return node->spatial_extent_;
+  }
+  SpatialExtent ext;
+  ext.n_dim_ = n_dim;
+  ext.periodic_ = false;
+  int n_point = pos_vect.size() / n_dim;
+  for ( int i_dim = 0; i_dim < n_dim; i_dim++ )
+  {
+    float x_min = pos_vect[ i_dim ];
+    float x_max = pos_vect[ i_dim ];
+    for ( int i = 1; i < n_point; i++ )
+    {
+      x_min = std::min( x_min, pos_vect[ i * n_dim + i_dim ] );
+      x_max = std::max( x_max, pos_vect[ i * n_dim + i_dim ] );
+    }
+    ext.lower_left_[ i_dim ] = x_min;
+    ext.extent_[ i_dim ] = ( x_max > x_min ) ? x_max - x_min : 1.0;
+  }
+
+  return ext;
+}
+
 int
 NESTGPU::Connect( int i_source_node,
   int i_target_node,
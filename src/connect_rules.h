@@ -27,7 +27,9 @@
 #include <config.h>
 #include <stdio.h>
 
+#include "conn_sampler.h"
 #include "nestgpu.h"
+#include "spatial.h"
 #include <iostream>
 #include <numeric>
 
@@ -57,14 +59,7 @@ int
 NESTGPU::_Connect( T1 source, int n_source, T2 target, int n_target, ConnSpec& conn_spec, SynSpec& syn_spec )
 {
   CheckUncalibrated( "Connections cannot be created after calibration" );
-  ////////////////////////
-  // TO DO:
-  // if (syn_spec.weight_distr_ != NULL) {
-  //   syn_spec.weight_array_ = Distribution(syn_spec.weight_distr, n);
-  // }
-  // if (syn_spec.delay_distr_ != NULL) {
-  //   syn_spec.delay_array_ = Distribution(syn_spec.delay_distr, n);
-  // }
+  InitSynSpecDistributions( syn_spec );
 
   switch ( conn_spec.rule_ )
   {
@@ -84,10 +79,32 @@ NESTGPU::_Connect( T1 source, int n_source, T2 target, int n_target, ConnSpec& c
     return _ConnectFixedTotalNumber< T1, T2 >( source, n_source, target, n_target, conn_spec.total_num_, syn_spec );
     break;
   case FIXED_INDEGREE:
-    return _ConnectFixedIndegree< T1, T2 >( source, n_source, target, n_target, conn_spec.indegree_, syn_spec );
+    return _ConnectFixedIndegree< T1, T2 >( source,
+      n_source,
+      target,
+      n_target,
+      conn_spec.indegree_,
+      conn_spec.allow_autapses_,
+      conn_spec.allow_multapses_,
+      syn_spec );
     break;
   case FIXED_OUTDEGREE:
-    return _ConnectFixedOutdegree< T1, T2 >( source, n_source, target, n_target, conn_spec.outdegree_, syn_spec );
+    return _ConnectFixedOutdegree< T1, T2 >( source,
+      n_source,
+      target,
+      n_target,
+      conn_spec.outdegree_,
+      conn_spec.allow_autapses_,
+      conn_spec.allow_multapses_,
+      syn_spec );
+    break;
+  case PAIRWISE_BERNOULLI:
+    return _ConnectPairwiseBernoulli< T1, T2 >(
+      source, n_source, target, n_target, conn_spec.prob_, conn_spec.allow_autapses_, syn_spec );
+    break;
+  case SPATIAL_PAIRWISE:
+    return _ConnectSpatialPairwise< T1, T2 >(
+      source, n_source, target, n_target, conn_spec.kernel_, conn_spec.allow_autapses_, syn_spec );
     break;
   default:
     throw ngpu_exception( "Unknown connection rule" );
@@ -104,6 +121,10 @@ NESTGPU::_SingleConnect( T1 source, int i_source, T2 target, int i_target, int i
   {
     weight = syn_spec.weight_array_[ i_array ];
   }
+  else if ( syn_spec.weight_distr_.IsActive() )
+  {
+    weight = syn_spec.weight_distr_.Value( i_array );
+  }
   else
   {
     weight = syn_spec.weight_;
@@ -113,6 +134,10 @@ NESTGPU::_SingleConnect( T1 source, int i_source, T2 target, int i_target, int i
   {
     delay = syn_spec.delay_array_[ i_array ];
   }
+  else if ( syn_spec.delay_distr_.IsActive() )
+  {
+    delay = syn_spec.delay_distr_.Value( i_array );
+  }
   else
   {
     delay = syn_spec.delay_;
@@ -143,6 +168,10 @@ NESTGPU::_RemoteSingleConnect( int i_source, T target, int i_target, int i_array
   {
     weight = syn_spec.weight_array_[ i_array ];
   }
+  else if ( syn_spec.weight_distr_.IsActive() )
+  {
+    weight = syn_spec.weight_distr_.Value( i_array );
+  }
   else
   {
     weight = syn_spec.weight_;
@@ -152,6 +181,10 @@ NESTGPU::_RemoteSingleConnect( int i_source, T target, int i_target, int i_array
   {
     delay = syn_spec.delay_array_[ i_array ];
   }
+  else if ( syn_spec.delay_distr_.IsActive() )
+  {
+    delay = syn_spec.delay_distr_.Value( i_array );
+  }
   else
   {
     delay = syn_spec.delay_;
@@ -218,77 +251,85 @@ NESTGPU::_ConnectFixedTotalNumber( T1 source, int n_source, T2 target, int n_tar
 }
 
 
+// For each node of the sequence node2, returns its position
+// in the sequence node1, or -1 if it is not included in node1.
+// Used to exclude autapses from connection rules
+template < class T1, class T2 >
+std::vector< int >
+NodePosition( T1 node1, int n_node1, T2 node2, int n_node2 )
+{
+  std::vector< std::pair< int, int > > node_pos( n_node1 );
+  for ( int i = 0; i < n_node1; i++ )
+  {
+    node_pos[ i ] = std::make_pair( GetINode< T1 >( node1, i ), i );
+  }
+  std::sort( node_pos.begin(), node_pos.end() );
+
+  std::vector< int > pos_vect( n_node2, -1 );
+  for ( int i = 0; i < n_node2; i++ )
+  {
+    std::pair< int, int > key = std::make_pair( GetINode< T2 >( node2, i ), -1 );
+    std::vector< std::pair< int, int > >::iterator it = std::lower_bound( node_pos.begin(), node_pos.end(), key );
+    if ( it != node_pos.end() && it->first == key.first )
+    {
+      pos_vect[ i ] = it->second;
+    }
+  }
+
+  return pos_vect;
+}
+
 template < class T1, class T2 >
 int
-NESTGPU::_ConnectFixedIndegree( T1 source, int n_source, T2 target, int n_target, int indegree, SynSpec& syn_spec )
+NESTGPU::_ConnectFixedIndegree( T1 source,
+  int n_source,
+  T2 target,
+  int n_target,
+  int indegree,
+  bool allow_autapses,
+  bool allow_multapses,
+  SynSpec& syn_spec )
 {
-  const int method_thresh = 5;
-  if ( indegree > n_source )
+  if ( !allow_multapses && indegree > n_source )
   {
     throw ngpu_exception( "Indegree larger than number of source nodes" );
   }
-  int n_rnd = indegree * THREAD_MAXNUM;
-  if ( n_source >= method_thresh * indegree )
-  { // nuovo metodo
-    n_rnd *= 5;
+  if ( indegree > 0 && n_source == 0 )
+  {
+    throw ngpu_exception( "Indegree larger than zero with no source nodes" );
+  }
+  ConnSampler sampler( ConnSamplerSeed() );
+  // position of each target node in the source sequence
+  std::vector< int > i_excl_vect;
+  if ( !allow_autapses )
+  {
+    i_excl_vect = NodePosition< T1, T2 >( source, n_source, target, n_target );
   }
-  unsigned int* rnd = RandomInt( n_rnd );
 
-  for ( int k = 0; k < n_target; k += THREAD_MAXNUM )
+  std::vector< int > int_vect;
+  for ( int itn = 0; itn < n_target; itn++ )
   {
-    for ( int ith = 0; ith < THREAD_MAXNUM; ith++ )
+    int i_excl = allow_autapses ? -1 : i_excl_vect[ itn ];
+    int_vect.clear();
+    if ( allow_multapses )
     {
-      int itn = k + ith;
-      if ( itn < n_target )
+      sampler.SampleWithReplacement( n_source, indegree, int_vect, i_excl );
+    }
+    else
+    {
+      if ( i_excl >= 0 && indegree > n_source - 1 )
       {
-        std::vector< int > int_vect;
-        // int_vect.clear();
-        if ( n_source < method_thresh * indegree )
-        { // vecchio metodo
-          // https://stackoverflow.com/questions/18625223
-          //  v = sequence(0, n_source-1)
-          int_vect.resize( n_source );
-          int start = 0;
-          std::iota( int_vect.begin(), int_vect.end(), start );
-          for ( int i = 0; i < indegree; i++ )
-          {
-            int j = i + rnd[ i * THREAD_MAXNUM + ith ] % ( n_source - i );
-            if ( j != i )
-            {
-              std::swap( int_vect[ i ], int_vect[ j ] );
-            }
-          }
-        }
-        else
-        { // nuovo metodo
-          std::vector< int > sorted_vect;
-          for ( int i = 0; i < indegree; i++ )
-          {
-            int i1 = 0;
-            std::vector< int >::iterator iter;
-            int j;
-            do
-            {
-              j = rnd[ ( i1 * indegree + i ) * THREAD_MAXNUM + ith ] % n_source;
-              // https://riptutorial.com/cplusplus/example/7270/using-a-sorted-vector-for-fast-element-lookup
-              // check if j is in target_vect
-              iter = std::lower_bound( sorted_vect.begin(), sorted_vect.end(), j );
-              i1++;
-            } while ( iter != sorted_vect.end() && *iter == j ); // we found j
-            sorted_vect.insert( iter, j );
-            int_vect.push_back( j );
-          }
-        }
-        for ( int i = 0; i < indegree; i++ )
-        {
-          int isn = int_vect[ i ];
-          size_t i_array = ( size_t ) itn * indegree + i;
-          _SingleConnect< T1, T2 >( source, isn, target, itn, i_array, syn_spec );
-        }
+        throw ngpu_exception( "Indegree larger than number of source nodes, excluding autapses" );
       }
+      sampler.SampleWithoutReplacement( n_source, indegree, int_vect, i_excl );
+    }
+    for ( int i = 0; i < indegree; i++ )
+    {
+      int isn = int_vect[ i ];
+      size_t i_array = ( size_t ) itn * indegree + i;
+      _SingleConnect< T1, T2 >( source, isn, target, itn, i_array, syn_spec );
     }
   }
-  delete[] rnd;
 
   return 0;
 }
@@ -296,80 +337,168 @@ NESTGPU::_ConnectFixedIndegree( T1 source, int n_source, T2 target, int n_target
 
 template < class T1, class T2 >
 int
-NESTGPU::_ConnectFixedOutdegree( T1 source, int n_source, T2 target, int n_target, int outdegree, SynSpec& syn_spec )
+NESTGPU::_ConnectFixedOutdegree( T1 source,
+  int n_source,
+  T2 target,
+  int n_target,
+  int outdegree,
+  bool allow_autapses,
+  bool allow_multapses,
+  SynSpec& syn_spec )
 {
-  const int method_thresh = 5;
-  if ( outdegree > n_target )
+  if ( !allow_multapses && outdegree > n_target )
   {
     throw ngpu_exception( "Outdegree larger than number of target nodes" );
   }
-  int n_rnd = outdegree * THREAD_MAXNUM;
-  if ( n_target >= method_thresh * outdegree )
-  { // choose method
-    n_rnd *= 5;
+  if ( outdegree > 0 && n_target == 0 )
+  {
+    throw ngpu_exception( "Outdegree larger than zero with no target nodes" );
+  }
+  ConnSampler sampler( ConnSamplerSeed() );
+  // position of each source node in the target sequence
+  std::vector< int > i_excl_vect;
+  if ( !allow_autapses )
+  {
+    i_excl_vect = NodePosition< T2, T1 >( target, n_target, source, n_source );
   }
-  unsigned int* rnd = RandomInt( n_rnd );
 
+  std::vector< int > int_vect;
+  for ( int isn = 0; isn < n_source; isn++ )
+  {
+    int i_excl = allow_autapses ? -1 : i_excl_vect[ isn ];
+    int_vect.clear();
+    if ( allow_multapses )
+    {
+      sampler.SampleWithReplacement( n_target, outdegree, int_vect, i_excl );
+    }
+    else
+    {
+      if ( i_excl >= 0 && outdegree > n_target - 1 )
+      {
+        throw ngpu_exception( "Outdegree larger than number of target nodes, excluding autapses" );
+      }
+      sampler.SampleWithoutReplacement( n_target, outdegree, int_vect, i_excl );
+    }
+    for ( int k = 0; k < outdegree; k++ )
+    {
+      int itn = int_vect[ k ];
+      size_t i_array = ( size_t ) isn * outdegree + k;
+      _SingleConnect< T1, T2 >( source, isn, target, itn, i_array, syn_spec );
+    }
+  }
+
+  return 0;
+}
+
+template < class T1, class T2 >
+int
+NESTGPU::_ConnectPairwiseBernoulli( T1 source,
+  int n_source,
+  T2 target,
+  int n_target,
+  float p,
+  bool allow_autapses,
+  SynSpec& syn_spec )
+{
+  if ( syn_spec.weight_array_ != NULL || syn_spec.delay_array_ != NULL )
+  {
+    throw ngpu_exception(
+      "Weight and delay arrays cannot be used with the pairwise_bernoulli "
+      "rule, since the number of connections is not known in advance" );
+  }
+  ConnSampler sampler( ConnSamplerSeed() );
 
-  for ( int is0 = 0; is0 < n_source; is0 += THREAD_MAXNUM )
+  size_t i_array = 0;
+  std::vector< int > int_vect;
+  for ( int itn = 0; itn < n_target; itn++ )
   {
-    for ( int ith = 0; ith < THREAD_MAXNUM; ith++ )
+    int_vect.clear();
+    sampler.BernoulliSkip( n_source, p, int_vect );
+    int i_target_node = GetINode< T2 >( target, itn );
+    for ( unsigned int i = 0; i < int_vect.size(); i++ )
     {
-      int isn = is0 + ith;
-      if ( isn < n_source )
+      int isn = int_vect[ i ];
+      if ( !allow_autapses && GetINode< T1 >( source, isn ) == i_target_node )
       {
-        std::vector< int > int_vect;
-        if ( n_target < method_thresh * outdegree )
-        { // choose method
-          // https://stackoverflow.com/questions/18625223
-          //  v = sequence(0, n_target-1)
-          int_vect.resize( n_target );
-          int start = 0;
-          std::iota( int_vect.begin(), int_vect.end(), start );
-          for ( int i = 0; i < outdegree; i++ )
-          {
-            int j = i + rnd[ i * THREAD_MAXNUM + ith ] % ( n_target - i );
-            if ( j != i )
-            {
-              std::swap( int_vect[ i ], int_vect[ j ] );
-            }
-          }
-        }
-        else
-        { // other method
-          std::vector< int > sorted_vect;
-          for ( int i = 0; i < outdegree; i++ )
-          {
-            int i1 = 0;
-            std::vector< int >::iterator iter;
-            int j;
-            do
-            {
-              j = rnd[ ( i1 * outdegree + i ) * THREAD_MAXNUM + ith ] % n_target;
-              // https://riptutorial.com/cplusplus/example/7270/using-a-sorted-vector-for-fast-element-lookup
-              // check if j is in target_vect
-              iter = std::lower_bound( sorted_vect.begin(), sorted_vect.end(), j );
-              i1++;
-            } while ( iter != sorted_vect.end() && *iter == j ); // we found j
-            sorted_vect.insert( iter, j );
-            int_vect.push_back( j );
-          }
-        }
-        for ( int k = 0; k < outdegree; k++ )
-        {
-          int itn = int_vect[ k ];
-          size_t i_array = ( size_t ) isn * outdegree + k;
-          _SingleConnect< T1, T2 >( source, isn, target, itn, i_array, syn_spec );
-        }
+        continue;
       }
+      _SingleConnect< T1, T2 >( source, isn, target, itn, i_array, syn_spec );
+      i_array++;
     }
   }
-  delete[] rnd;
 
   return 0;
 }
 
 
+// Each target is connected to the sources within the kernel cutoff
+// with a distance-dependent probability. The source positions are
+// indexed by a cell list, so that the cost is proportional to the
+// number of candidate sources rather than to n_source*n_target
+template < class T1, class T2 >
+int
+NESTGPU::_ConnectSpatialPairwise( T1 source,
+  int n_source,
+  T2 target,
+  int n_target,
+  SpatialKernel& kernel,
+  bool allow_autapses,
+  SynSpec& syn_spec )
+{
+  if ( syn_spec.weight_array_ != NULL || syn_spec.delay_array_ != NULL )
+  {
+    throw ngpu_exception(
+      "Weight and delay arrays cannot be used with the spatial_pairwise "
+      "rule, since the number of connections is not known in advance" );
+  }
+  if ( n_source <= 0 || n_target <= 0 )
+  {
+    return 0;
+  }
+  float cutoff = kernel.Cutoff();
+
+  std::vector< int > source_node( n_source );
+  for ( int isn = 0; isn < n_source; isn++ )
+  {
+    source_node[ isn ] = GetINode< T1 >( source, isn );
+  }
+  std::vector< int > target_node( n_target );
+  for ( int itn = 0; itn < n_target; itn++ )
+  {
+    target_node[ itn ] = GetINode< T2 >( target, itn );
+  }
+  std::vector< float > source_pos;
+  std::vector< float > target_pos;
+  int n_dim = GatherNodePositions( source_node, source_pos );
+  if ( GatherNodePositions( target_node, target_pos ) != n_dim )
+  {
+    throw ngpu_exception( "Source and target positions have different dimensions" );
+  }
+  SpatialGrid grid( GetSpatialExtent( source_node[ 0 ], source_pos, n_dim ), cutoff );
+  grid.Build( source_pos.data(), n_source );
+
+  ConnSampler sampler( ConnSamplerSeed() );
+  size_t i_array = 0;
+  std::vector< int > int_vect;
+  for ( int itn = 0; itn < n_target; itn++ )
+  {
+    int_vect.clear();
+    grid.SamplePairwise( &target_pos[ ( size_t ) itn * n_dim ], kernel, sampler, int_vect );
+    for ( unsigned int i = 0; i < int_vect.size(); i++ )
+    {
+      int isn = int_vect[ i ];
+      if ( !allow_autapses && source_node[ isn ] == target_node[ itn ] )
+      {
+        continue;
+      }
+      _SingleConnect< T1, T2 >( source, isn, target, itn, i_array, syn_spec );
+      i_array++;
+    }
+  }
+
+  return 0;
+}
+
 #ifdef HAVE_MPI
 
 template < class T1, class T2 >
@@ -382,6 +511,7 @@ NESTGPU::_RemoteConnect( RemoteNode< T1 > source,
   SynSpec& syn_spec )
 {
   CheckUncalibrated( "Connections cannot be created after calibration" );
+  InitSynSpecDistributions( syn_spec );
   switch ( conn_spec.rule_ )
   {
   case ONE_TO_ONE:
@@ -401,10 +531,53 @@ NESTGPU::_RemoteConnect( RemoteNode< T1 > source,
       source, n_source, target, n_target, conn_spec.total_num_, syn_spec );
     break;
   case FIXED_INDEGREE:
-    return _RemoteConnectFixedIndegree< T1, T2 >( source, n_source, target, n_target, conn_spec.indegree_, syn_spec );
+    return _RemoteConnectFixedIndegree< T1, T2 >( source,
+      n_source,
+      target,
+      n_target,
+      conn_spec.indegree_,
+      conn_spec.allow_autapses_,
+      conn_spec.allow_multapses_,
+      syn_spec );
     break;
   case FIXED_OUTDEGREE:
-    return _RemoteConnectFixedOutdegree< T1, T2 >( source, n_source, target, n_target, conn_spec.outdegree_, syn_spec );
+    return _RemoteConnectFixedOutdegree< T1, T2 >( source,
+      n_source,
+      target,
+      n_target,
+      conn_spec.outdegree_,
+      conn_spec.allow_autapses_,
+      conn_spec.allow_multapses_,
+      syn_spec );
+    break;
+  case PAIRWISE_BERNOULLI:
+    if ( source.i_host_ != target.i_host_ )
+    {
+      throw ngpu_exception( "Connection rule pairwise_bernoulli is not available for remote connections" );
+    }
+    if ( MpiId() == source.i_host_ )
+    {
+      return _ConnectPairwiseBernoulli< T1, T2 >(
+        source.i_node_, n_source, target.i_node_, n_target, conn_spec.prob_, conn_spec.allow_autapses_, syn_spec );
+    }
+    return 0;
+    break;
+  case SPATIAL_PAIRWISE:
+    if ( source.i_host_ != target.i_host_ )
+    {
+      throw ngpu_exception( "Connection rule spatial_pairwise is not available for remote connections" );
+    }
+    if ( MpiId() == source.i_host_ )
+    {
+      return _ConnectSpatialPairwise< T1, T2 >( source.i_node_,
+        n_source,
+        target.i_node_,
+        n_target,
+        conn_spec.kernel_,
+        conn_spec.allow_autapses_,
+        syn_spec );
+    }
+    return 0;
     break;
   default:
     throw ngpu_exception( "Unknown connection rule" );
@@ -623,16 +796,24 @@ NESTGPU::_RemoteConnectFixedIndegree( RemoteNode< T1 > source,
   RemoteNode< T2 > target,
   int n_target,
   int indegree,
+  bool allow_autapses,
+  bool allow_multapses,
   SynSpec& syn_spec )
 {
-  const int method_thresh = 5;
-  if ( indegree > n_source )
+  if ( !allow_multapses && indegree > n_source )
   {
     throw ngpu_exception( "Indegree larger than number of source nodes" );
   }
   if ( MpiId() == source.i_host_ && source.i_host_ == target.i_host_ )
   {
-    return _ConnectFixedIndegree< T1, T2 >( source.i_node_, n_source, target.i_node_, n_target, indegree, syn_spec );
+    return _ConnectFixedIndegree< T1, T2 >( source.i_node_,
+      n_source,
+      target.i_node_,
+      n_target,
+      indegree,
+      allow_autapses,
+      allow_multapses,
+      syn_spec );
   }
   else if ( MpiId() == source.i_host_ || MpiId() == target.i_host_ )
   {
@@ -657,55 +838,20 @@ NESTGPU::_RemoteConnectFixedIndegree( RemoteNode< T1 > source,
     {
       int i_new_remote_node;
       connect_mpi_->MPI_Recv_int( &i_new_remote_node, 1, target.i_host_ );
-      int n_rnd = indegree;
-      if ( n_source >= method_thresh * indegree )
-      { // choose method
-        n_rnd *= 5;
-      }
-      unsigned int* rnd = RandomInt( n_rnd );
-
-      // std::vector<int> input_array;
-      // for (int i=0; i<n_source; i++) {
-      // input_array.push_back(source.GetINode(i));
-      // }
+      // source and target nodes are on different hosts,
+      // so that autapses are not possible
+      ConnSampler sampler( ConnSamplerSeed() );
+      std::vector< int > int_vect;
       for ( int k = 0; k < n_target; k++ )
       {
-        std::vector< int > int_vect;
-        if ( n_source < method_thresh * indegree )
-        { // choose method
-          // https://stackoverflow.com/questions/18625223
-          //  v = sequence(0, n_source-1)
-          int_vect.resize( n_source );
-          int start = 0;
-          std::iota( int_vect.begin(), int_vect.end(), start );
-          for ( int i = 0; i < indegree; i++ )
-          {
-            int j = i + rnd[ i ] % ( n_source - i );
-            if ( j != i )
-            {
-              std::swap( int_vect[ i ], int_vect[ j ] );
-            }
-          }
+        int_vect.clear();
+        if ( allow_multapses )
+        {
+          sampler.SampleWithReplacement( n_source, indegree, int_vect );
         }
         else
-        { // nuovo metodo
-          std::vector< int > sorted_vect;
-          for ( int i = 0; i < indegree; i++ )
-          {
-            int i1 = 0;
-            std::vector< int >::iterator iter;
-            int j;
-            do
-            {
-              j = rnd[ i1 * indegree + i ] % n_source;
-              // https://riptutorial.com/cplusplus/example/7270/using-a-sorted-vector-for-fast-element-lookup
-              // check if j is in target_vect
-              iter = std::lower_bound( sorted_vect.begin(), sorted_vect.end(), j );
-              i1++;
-            } while ( iter != sorted_vect.end() && *iter == j ); // we found j
-            sorted_vect.insert( iter, j );
-            int_vect.push_back( j );
-          }
+        {
+          sampler.SampleWithoutReplacement( n_source, indegree, int_vect );
         }
         for ( int i = 0; i < indegree; i++ )
         {
@@ -734,7 +880,6 @@ NESTGPU::_RemoteConnectFixedIndegree( RemoteNode< T1 > source,
       }
       connect_mpi_->MPI_Send_int( &i_new_remote_node, 1, target.i_host_ );
       connect_mpi_->MPI_Send_int( i_remote_node_arr, n_target * indegree, target.i_host_ );
-      delete[] rnd;
     }
     delete[] i_remote_node_arr;
   }
@@ -751,16 +896,24 @@ NESTGPU::_RemoteConnectFixedOutdegree( RemoteNode< T1 > source,
   RemoteNode< T2 > target,
   int n_target,
   int outdegree,
+  bool allow_autapses,
+  bool allow_multapses,
   SynSpec& syn_spec )
 {
-  const int method_thresh = 5;
-  if ( outdegree > n_target )
+  if ( !allow_multapses && outdegree > n_target )
   {
     throw ngpu_exception( "Outdegree larger than number of target nodes" );
   }
   if ( MpiId() == source.i_host_ && source.i_host_ == target.i_host_ )
   {
-    return _ConnectFixedOutdegree< T1, T2 >( source.i_node_, n_source, target.i_node_, n_target, outdegree, syn_spec );
+    return _ConnectFixedOutdegree< T1, T2 >( source.i_node_,
+      n_source,
+      target.i_node_,
+      n_target,
+      outdegree,
+      allow_autapses,
+      allow_multapses,
+      syn_spec );
   }
   else if ( MpiId() == source.i_host_ || MpiId() == target.i_host_ )
   {
@@ -771,51 +924,20 @@ NESTGPU::_RemoteConnectFixedOutdegree( RemoteNode< T1 > source,
       connect_mpi_->MPI_Recv_int( &n_remote_node_, 1, source.i_host_ );
       connect_mpi_->MPI_Recv_int( i_remote_node_arr, n_source, source.i_host_ );
 
-      int n_rnd = outdegree;
-      if ( n_target >= method_thresh * outdegree )
-      { // choose method
-        n_rnd *= 5;
-      }
-      unsigned int* rnd = RandomInt( n_rnd );
-
+      // source and target nodes are on different hosts,
+      // so that autapses are not possible
+      ConnSampler sampler( ConnSamplerSeed() );
+      std::vector< int > int_vect;
       for ( int isn = 0; isn < n_source; isn++ )
       {
-        std::vector< int > int_vect;
-        if ( n_target < method_thresh * outdegree )
-        { // choose method
-          // https://stackoverflow.com/questions/18625223
-          //  v = sequence(0, n_target-1)
-          int_vect.resize( n_target );
-          int start = 0;
-          std::iota( int_vect.begin(), int_vect.end(), start );
-          for ( int i = 0; i < outdegree; i++ )
-          {
-            int j = i + rnd[ i ] % ( n_target - i );
-            if ( j != i )
-            {
-              std::swap( int_vect[ i ], int_vect[ j ] );
-            }
-          }
+        int_vect.clear();
+        if ( allow_multapses )
+        {
+          sampler.SampleWithReplacement( n_target, outdegree, int_vect );
         }
         else
-        { // other method
-          std::vector< int > sorted_vect;
-          for ( int i = 0; i < outdegree; i++ )
-          {
-            int i1 = 0;
-            std::vector< int >::iterator iter;
-            int j;
-            do
-            {
-              j = rnd[ i1 * outdegree + i ] % n_target;
-              // https://riptutorial.com/cplusplus/example/7270/using-a-sorted-vector-for-fast-element-lookup
-              // check if j is in target_vect
-              iter = std::lower_bound( sorted_vect.begin(), sorted_vect.end(), j );
-              i1++;
-            } while ( iter != sorted_vect.end() && *iter == j ); // we found j
-            sorted_vect.insert( iter, j );
-            int_vect.push_back( j );
-          }
+        {
+          sampler.SampleWithoutReplacement( n_target, outdegree, int_vect );
         }
         for ( int k = 0; k < outdegree; k++ )
         {
@@ -825,7 +947,6 @@ NESTGPU::_RemoteConnectFixedOutdegree( RemoteNode< T1 > source,
           _RemoteSingleConnect< T2 >( i_remote_node, target.i_node_, itn, i_array, syn_spec );
         }
       }
-      delete[] rnd;
     }
     else if ( MpiId() == source.i_host_ )
     {
@@ -26,6 +26,9 @@
 
 #include <iostream>
 
+#include "distribution.h"
+#include "spatial.h"
+
 #define STANDARD_SYNAPSE 0
 
 class NESTGPU;
@@ -51,6 +54,8 @@ enum ConnectionRules
   FIXED_TOTAL_NUMBER,
   FIXED_INDEGREE,
   FIXED_OUTDEGREE,
+  PAIRWISE_BERNOULLI,
+  SPATIAL_PAIRWISE,
   N_CONN_RULE
 };
 
@@ -58,7 +63,9 @@ const std::string conn_rule_name[ N_CONN_RULE ] = { "one_to_one",
   "all_to_all",
   "fixed_total_number",
   "fixed_indegree",
-  "fixed_outdegree" };
+  "fixed_outdegree",
+  "pairwise_bernoulli",
+  "spatial_pairwise" };
 
 class ConnSpec
 {
@@ -66,6 +73,10 @@ class ConnSpec
   int total_num_;
   int indegree_;
   int outdegree_;
+  float prob_;
+  bool allow_autapses_;
+  bool allow_multapses_;
+  SpatialKernel kernel_;
 
 public:
   ConnSpec();
@@ -73,8 +84,10 @@ public:
   int Init();
   int Init( int rule, int degree = 0 );
   int SetParam( std::string param_name, int value );
+  int SetParam( std::string param_name, float value );
   int GetParam( std::string param_name );
   static bool IsParam( std::string param_name );
+  static bool IsFloatParam( std::string param_name );
 
   friend class NESTGPU;
 };
@@ -86,10 +99,10 @@ class SynSpec
   unsigned char port_;
 
 public:
-  int weight_distr_;
+  Distribution weight_distr_;
   float* weight_array_;
   float weight_;
-  int delay_distr_;
+  Distribution delay_distr_;
   float* delay_array_;
   float delay_;
 
@@ -24,11 +24,16 @@
 #ifndef DIRCONNECT_H
 #define DIRCONNECT_H
 
+// Outgoing direct connection of a node (e.g. a poisson generator).
+// multiplicity_ > 1 when the connection replaces several connections
+// with the same target, port, weight and delay from equivalent sources
+// (see NESTGPU::BuildDirectConnections)
 struct DirectConnection
 {
   int irel_source_;
   int i_target_;
   unsigned char port_;
+  unsigned short multiplicity_;
   float weight_;
   float delay_;
 };
@@ -0,0 +1,206 @@
+/*
+ *  distribution.cpp
+ *
+ *  This file is part of NEST GPU.
+ *
+ *  Copyright (C) 2021 The NEST Initiative
+ *
+ *  NEST GPU is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NEST GPU is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NEST GPU.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <cmath>
+#include <string>
+
+#include "distribution.h"
+#include "ngpu_exception.h"
+
+// maximum number of draws for the rejection method of normal_clipped
+#define MAX_CLIP_ITER 1000
+
+// splitmix64 finalizer
+static inline unsigned long long
+Mix64( unsigned long long x )
+{
+  x = ( x ^ ( x >> 30 ) ) * 0xBF58476D1CE4E5B9ULL;
+  x = ( x ^ ( x >> 27 ) ) * 0x94D049BB133111EBULL;
+  return x ^ ( x >> 31 );
+}
+
+double
+HashUniform( unsigned long long seed, unsigned long long i, unsigned int counter )
+{
+  unsigned long long x = Mix64( seed + 0x9E3779B97F4A7C15ULL * ( i + 1 ) );
+  x = Mix64( x + 0xD1B54A32D192ED03ULL * ( ( unsigned long long ) counter + 1 ) );
+  // 53 random bits mapped to (0,1]
+  return ( ( x >> 11 ) + 1 ) * ( 1.0 / 9007199254740992.0 );
+}
+
+Distribution::Distribution()
+{
+  Init();
+}
+
+int
+Distribution::Init()
+{
+  seed_ = 0;
+  distr_idx_ = DISTR_NONE;
+  mu_ = 0.0;
+  sigma_ = 1.0;
+  low_ = -1.0e35;
+  high_ = 1.0e35;
+  beta_ = 1.0;
+  step_ = 0.0;
+
+  return 0;
+}
+
+int
+Distribution::SetType( int distr_idx )
+{
+  if ( distr_idx < 0 || distr_idx >= N_DISTR )
+  {
+    throw ngpu_exception( "Unknown distribution" );
+  }
+  distr_idx_ = distr_idx;
+
+  return 0;
+}
+
+int
+Distribution::SetParam( std::string param_name, float value )
+{
+  if ( param_name == "mu" )
+  {
+    mu_ = value;
+  }
+  else if ( param_name == "sigma" )
+  {
+    if ( value < 0 )
+    {
+      throw ngpu_exception( "Distribution parameter sigma must be >=0" );
+    }
+    sigma_ = value;
+  }
+  else if ( param_name == "low" )
+  {
+    low_ = value;
+  }
+  else if ( param_name == "high" )
+  {
+    high_ = value;
+  }
+  else if ( param_name == "beta" )
+  {
+    if ( value <= 0 )
+    {
+      throw ngpu_exception( "Distribution parameter beta must be >0" );
+    }
+    beta_ = value;
+  }
+  else if ( param_name == "step" )
+  {
+    if ( value < 0 )
+    {
+      throw ngpu_exception( "Distribution parameter step must be >=0" );
+    }
+    step_ = value;
+  }
+  else
+  {
+    throw ngpu_exception( "Unknown distribution parameter " + param_name );
+  }
+
+  return 0;
+}
+
+bool
+Distribution::IsFloatParam( std::string param_name )
+{
+  if ( param_name == "mu" || param_name == "sigma" || param_name == "low" || param_name == "high"
+    || param_name == "beta" || param_name == "step" )
+  {
+    return true;
+  }
+  else
+  {
+    return false;
+  }
+}
+
+int
+Distribution::Check()
+{
+  if ( ( distr_idx_ == DISTR_NORMAL_CLIPPED || distr_idx_ == DISTR_UNIFORM ) && high_ <= low_ )
+  {
+    throw ngpu_exception( "Distribution parameter high must be larger than low" );
+  }
+  if ( distr_idx_ == DISTR_UNIFORM && ( low_ < -1.0e30 || high_ > 1.0e30 ) )
+  {
+    throw ngpu_exception( "Uniform distribution requires finite low and high parameters" );
+  }
+
+  return 0;
+}
+
+float
+Distribution::Value( size_t i_conn )
+{
+  switch ( distr_idx_ )
+  {
+  case DISTR_NORMAL:
+  case DISTR_LOGNORMAL:
+  {
+    // Box-Muller transform
+    double u1 = HashUniform( seed_, i_conn, 0 );
+    double u2 = HashUniform( seed_, i_conn, 1 );
+    double x = mu_ + sigma_ * sqrt( -2.0 * log( u1 ) ) * cos( 2.0 * M_PI * u2 );
+    return ( distr_idx_ == DISTR_NORMAL ) ? ( float ) x : ( float ) exp( x );
+  }
+  case DISTR_NORMAL_CLIPPED:
+  {
+    double x = 0;
+    int iter;
+    for ( iter = 0; iter < MAX_CLIP_ITER; iter++ )
+    {
+      double u1 = HashUniform( seed_, i_conn, 2 * iter );
+      double u2 = HashUniform( seed_, i_conn, 2 * iter + 1 );
+      x = mu_ + sigma_ * sqrt( -2.0 * log( u1 ) ) * cos( 2.0 * M_PI * u2 );
+      if ( x >= low_ && x <= high_ )
+      {
+        break;
+      }
+    }
+    if ( iter == MAX_CLIP_ITER )
+    {
+      throw ngpu_exception(
+        "Too many rejected values in normal_clipped distribution, "
+        "check the parameters mu, sigma, low and high" );
+    }
+    if ( step_ > sigma_ * 1.0e-6 )
+    {
+      x = low_ + step_ * round( ( x - low_ ) / step_ );
+    }
+    return ( float ) x;
+  }
+  case DISTR_UNIFORM:
+    return ( float ) ( low_ + ( high_ - low_ ) * ( 1.0 - HashUniform( seed_, i_conn, 0 ) ) );
+  case DISTR_EXPONENTIAL:
+    return ( float ) ( -beta_ * log( HashUniform( seed_, i_conn, 0 ) ) );
+  default:
+    throw ngpu_exception( "Unknown distribution" );
+  }
+}
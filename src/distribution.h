@@ -0,0 +1,95 @@
+/*
+ *  distribution.h
+ *
+ *  This file is part of NEST GPU.
+ *
+ *  Copyright (C) 2021 The NEST Initiative
+ *
+ *  NEST GPU is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NEST GPU is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NEST GPU.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/////////////////////////////////////////////////////////////////
+// Distribution class definition
+// random distributions of synaptic parameters, evaluated
+// connection by connection while the connection rule is executed
+/////////////////////////////////////////////////////////////////
+
+#ifndef DISTRIBUTION_H
+#define DISTRIBUTION_H
+
+#include <stddef.h>
+#include <string>
+
+enum DistributionType
+{
+  DISTR_NONE = 0,
+  DISTR_NORMAL,
+  DISTR_NORMAL_CLIPPED,
+  DISTR_LOGNORMAL,
+  DISTR_UNIFORM,
+  DISTR_EXPONENTIAL,
+  N_DISTR
+};
+
+const std::string distribution_name[ N_DISTR ] = { "none",
+  "normal",
+  "normal_clipped",
+  "lognormal",
+  "uniform",
+  "exponential" };
+
+// uniform random number in (0,1], function only of seed, i and counter.
+// It is used to give each connection its own deterministic random stream
+double HashUniform( unsigned long long seed, unsigned long long i, unsigned int counter );
+
+class Distribution
+{
+  unsigned long long seed_;
+
+public:
+  int distr_idx_;
+  float mu_;
+  float sigma_;
+  float low_;
+  float high_;
+  float beta_;
+  float step_;
+
+  Distribution();
+  int Init();
+  int SetType( int distr_idx );
+  int SetParam( std::string param_name, float value );
+  static bool IsFloatParam( std::string param_name );
+  int Check();
+
+  int
+  SetSeed( unsigned long long seed )
+  {
+    seed_ = seed;
+    return 0;
+  }
+
+  bool
+  IsActive()
+  {
+    return distr_idx_ != DISTR_NONE;
+  }
+
+  // value of the parameter for the connection of index i_conn
+  // within a Connect call. It depends only on the seed and on i_conn
+  float Value( size_t i_conn );
+};
+
+#endif
@@ -0,0 +1,191 @@
+/*
+ *  fixed_step.h
+ *
+ *  This file is part of NEST GPU.
+ *
+ *  Copyright (C) 2021 The NEST Initiative
+ *
+ *  NEST GPU is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NEST GPU is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NEST GPU.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/////////////////////////////////////////////////////////////////
+// Fixed-step integrators, alternative to the adaptive RK5 scheme.
+// They take a single step per time step and use the same
+// Derivatives and ExternalUpdate functions of the model.
+// The stiffness of each variable is described by a rate,
+// estimated from the derivatives at the start and at the end of
+// an explicit Euler step, so that no Jacobian is needed:
+//   h*rate_i = (f_i(y + h*f(y)) - f_i(y)) / f_i(y)
+/////////////////////////////////////////////////////////////////
+
+#ifndef FIXEDSTEP_H
+#define FIXEDSTEP_H
+
+#include "get_spike.h"
+#include "rk5_interface.h"
+#include "rk5_param.h"
+#include <string>
+
+enum OdeIntegrator
+{
+  INTEGRATOR_RK5 = 0,    // adaptive Runge-Kutta 5th order (Cash-Karp)
+  INTEGRATOR_EXP_EULER,  // exponential Euler
+  INTEGRATOR_ROSENBROCK, // 2-stage Rosenbrock (ROS2), linearly implicit
+  N_INTEGRATOR
+};
+
+const std::string integrator_name[ N_INTEGRATOR ] = { "rk5", "exp_euler", "rosenbrock" };
+
+// upper bound of h*rate in the exponential Euler step, it limits
+// the growth of the variables when the rate is positive
+#define EXP_EULER_MAX_RATE_STEP 1.0f
+
+// gamma coefficient of the ROS2 scheme, 1 + 1/sqrt(2)
+#define ROS2_GAMMA 1.70710678f
+
+// (exp(z) - 1) / z
+__device__ __forceinline__ float
+Phi1( float z )
+{
+  if ( fabsf( z ) < 1.0e-4f )
+  {
+    return 1.0f + 0.5f * z;
+  }
+  return expm1f( z ) / z;
+}
+
+// Computes in k1 the derivatives at (x, y) and in hrate the product of
+// the step h and the rate of each variable
+template < int NVAR, int NPARAM, class DataStruct >
+__device__ void
+StepRate( double x, float* y, float h, float* k1, float* hrate, float* param, DataStruct data_struct )
+{
+  float y_new[ NVAR ];
+  float k2[ NVAR ];
+
+  Derivatives< NVAR, NPARAM >( x, y, k1, param, data_struct );
+  for ( int i = 0; i < NVAR; i++ )
+  {
+    y_new[ i ] = y[ i ] + h * k1[ i ];
+  }
+  Derivatives< NVAR, NPARAM >( x + h, y_new, k2, param, data_struct );
+  for ( int i = 0; i < NVAR; i++ )
+  {
+    hrate[ i ] = ( k1[ i ] != 0.0f ) ? ( k2[ i ] - k1[ i ] ) / k1[ i ] : 0.0f;
+  }
+}
+
+// y(x+h) = y(x) + h*phi1(h*rate)*f(y)
+// exact for linear decoupled variables, such as the synaptic
+// currents and conductances
+template < int NVAR, int NPARAM, class DataStruct >
+__device__ void
+ExpEulerStep( double x, float* y, float h, float* param, DataStruct data_struct )
+{
+  float k1[ NVAR ];
+  float hrate[ NVAR ];
+
+  StepRate< NVAR, NPARAM, DataStruct >( x, y, h, k1, hrate, param, data_struct );
+  for ( int i = 0; i < NVAR; i++ )
+  {
+    float z = fminf( hrate[ i ], EXP_EULER_MAX_RATE_STEP );
+    y[ i ] += h * Phi1( z ) * k1[ i ];
+  }
+}
+
+// ROS2 scheme (Verwer et al., SIAM J. Sci. Comput. 20, 1999), with
+// a diagonal approximation W of the Jacobian. It is second order for
+// any W, while the negative rates make it stable for stiff variables
+//   W_i = 1 - gamma*h*min(rate_i, 0)
+//   W k1 = f(y)
+//   W k2 = f(y + h*k1) - 2*k1
+//   y(x+h) = y(x) + 1.5*h*k1 + 0.5*h*k2
+template < int NVAR, int NPARAM, class DataStruct >
+__device__ void
+RosenbrockStep( double x, float* y, float h, float* param, DataStruct data_struct )
+{
+  float k1[ NVAR ];
+  float k2[ NVAR ];
+  float w_diag[ NVAR ];
+  float y_new[ NVAR ];
+
+  StepRate< NVAR, NPARAM, DataStruct >( x, y, h, k1, w_diag, param, data_struct );
+  for ( int i = 0; i < NVAR; i++ )
+  {
+    w_diag[ i ] = 1.0f - ROS2_GAMMA * fminf( w_diag[ i ], 0.0f );
+    k1[ i ] /= w_diag[ i ];
+    y_new[ i ] = y[ i ] + h * k1[ i ];
+  }
+  Derivatives< NVAR, NPARAM >( x + h, y_new, k2, param, data_struct );
+  for ( int i = 0; i < NVAR; i++ )
+  {
+    k2[ i ] = ( k2[ i ] - 2.0f * k1[ i ] ) / w_diag[ i ];
+    y[ i ] += h * ( 1.5f * k1[ i ] + 0.5f * k2[ i ] );
+  }
+}
+
+// Advances the array of ODE systems up to x1 with a single step
+template < int NVAR, int NPARAM, class DataStruct >
+__global__ void
+ArrayUpdateFixedStep( int array_size,
+  double* x_arr,
+  float* y_arr,
+  float* par_arr,
+  double x1,
+  int integrator,
+  unsigned long long const_mask,
+  int const_offset,
+  InputSpikeArray input_spikes,
+  DataStruct data_struct )
+{
+  int ArrayIdx = threadIdx.x + blockIdx.x * blockDim.x;
+  if ( ArrayIdx < array_size )
+  {
+    double x = x_arr[ ArrayIdx ];
+    float h = ( float ) ( x1 - x );
+    float y[ NVAR ];
+    float param[ NPARAM ];
+
+    FoldInputSpikes( input_spikes, ArrayIdx );
+    for ( int i = 0; i < NVAR; i++ )
+    {
+      y[ i ] = y_arr[ ArrayIdx * NVAR + i ];
+    }
+    LoadParam< NPARAM >( param, &par_arr[ ArrayIdx * NPARAM ], const_mask, const_offset );
+
+    if ( h > 0.0f )
+    {
+      if ( integrator == INTEGRATOR_ROSENBROCK )
+      {
+        RosenbrockStep< NVAR, NPARAM, DataStruct >( x, y, h, param, data_struct );
+      }
+      else
+      {
+        ExpEulerStep< NVAR, NPARAM, DataStruct >( x, y, h, param, data_struct );
+      }
+    }
+    x = x1;
+    ExternalUpdate< NVAR, NPARAM >( x, y, param, true, data_struct );
+
+    x_arr[ ArrayIdx ] = x;
+    for ( int i = 0; i < NVAR; i++ )
+    {
+      y_arr[ ArrayIdx * NVAR + i ] = y[ i ];
+    }
+    StoreParam< NPARAM, DataStruct >( &par_arr[ ArrayIdx * NPARAM ], param );
+  }
+}
+
+#endif
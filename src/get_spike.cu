@@ -25,10 +25,12 @@
 #include <stdio.h>
 
 #include "cuda_error.h"
+#include "get_spike.h"
 #include "nestgpu.h"
 #include "node_group.h"
 #include "send_spike.h"
 #include "spike_buffer.h"
+#include "stdp_trace.h"
 
 extern __constant__ long long NESTGPUTimeIdx;
 extern __constant__ float NESTGPUTimeResolution;
@@ -37,6 +39,8 @@ extern __device__ signed char* NodeGroupMap;
 
 extern __device__ void SynapseUpdate( int syn_group, float* w, float Dt );
 
+extern __device__ bool SynapsePreSpikeUpdate( int syn_group, float* w, int i_target );
+
 __device__ double
 atomicAddDouble( double* address, double val )
 {
@@ -50,57 +54,151 @@ atomicAddDouble( double* address, double val )
   return __longlong_as_double( old );
 }
 
+// Adds a spike to the input of the target node. The spikes with
+// index < n_precise_spikes have already been delivered with their
+// offset to the nodes of the precise-spiking models by
+// CollectPreciseSpikeKernel
+__device__ __forceinline__ void
+DeliverSpike( int i_spike, unsigned int target_port, float weight, int n_precise_spikes )
+{
+  int i_target = target_port & PORT_MASK;
+  unsigned char port = ( unsigned char ) ( target_port >> ( PORT_N_SHIFT + 24 ) );
+  float height = SpikeHeight[ i_spike ];
+
+  int i_group = NodeGroupMap[ i_target ];
+  int i = port * NodeGroupArray[ i_group ].n_node_ + i_target - NodeGroupArray[ i_group ].i_node_0_;
+  double d_val = ( double ) ( height * weight );
+
+  if ( i_spike >= n_precise_spikes || NodeGroupArray[ i_group ].precise_spikes_.n_spike_ == NULL
+    || SpikeOffset[ i_spike ] == 0.0 )
+  {
+    atomicAddDouble( &NodeGroupArray[ i_group ].get_spike_array_[ i ], d_val );
+  }
+}
+
 //////////////////////////////////////////////////////////////////////
 // This is the function called by the nested loop
-// that collects the spikes
+// that collects the spikes through the static connections
 __device__ void
-CollectSpikeFunction( int i_spike, int i_syn )
+CollectSpikeFunction( int i_spike, int i_syn, int n_precise_spikes )
+{
+  int i_source = SpikeSourceIdx[ i_spike ];
+  int i_conn = SpikeConnIdx[ i_spike ];
+  unsigned int target_port = ConnectionGroupTargetNode[ i_conn * NSpikeBuffer + i_source ][ i_syn ];
+  float weight = ConnectionGroupTargetWeight[ i_conn * NSpikeBuffer + i_source ][ i_syn ];
+  DeliverSpike( i_spike, target_port, weight, n_precise_spikes );
+}
+
+//////////////////////////////////////////////////////////////////////
+// This is the function called by the nested loop
+// that collects the spikes through the plastic connections.
+// i_plastic is the index of the connection in the arrays
+// of the plastic connections
+__device__ void
+CollectPlasticSpikeFunction( int i_spike, int i_syn, unsigned int i_plastic, int n_precise_spikes )
 {
   int i_source = SpikeSourceIdx[ i_spike ];
   int i_conn = SpikeConnIdx[ i_spike ];
-  float height = SpikeHeight[ i_spike ];
   unsigned int target_port = ConnectionGroupTargetNode[ i_conn * NSpikeBuffer + i_source ][ i_syn ];
   int i_target = target_port & PORT_MASK;
-  unsigned char port = ( unsigned char ) ( target_port >> ( PORT_N_SHIFT + 24 ) );
   unsigned char syn_group = ConnectionGroupTargetSynGroup[ i_conn * NSpikeBuffer + i_source ][ i_syn ];
-  float weight = ConnectionGroupTargetWeight[ i_conn * NSpikeBuffer + i_source ][ i_syn ];
-  // printf("handles spike %d src %d conn %d syn %d target %d"
-  //" port %d weight %f\n",
-  // i_spike, i_source, i_conn, i_syn, i_target,
-  // port, weight);
+  float* weight_pt = &ConnectionGroupTargetWeight[ i_conn * NSpikeBuffer + i_source ][ i_syn ];
 
-  /////////////////////////////////////////////////////////////////
-  int i_group = NodeGroupMap[ i_target ];
-  int i = port * NodeGroupArray[ i_group ].n_node_ + i_target - NodeGroupArray[ i_group ].i_node_0_;
-  double d_val = ( double ) ( height * weight );
+  DeliverSpike( i_spike, target_port, *weight_pt, n_precise_spikes );
 
-  atomicAddDouble( &NodeGroupArray[ i_group ].get_spike_array_[ i ], d_val );
-  if ( syn_group > 0 )
+  if ( SynapsePreSpikeUpdate( syn_group, weight_pt, i_target ) )
   {
-    ConnectionGroupTargetSpikeTime[ i_conn * NSpikeBuffer + i_source ][ i_syn ] =
-      ( unsigned short ) ( NESTGPUTimeIdx & 0xffff );
+    return;
+  }
+  ConnectionSpikeTime[ i_plastic ] = ( unsigned short ) ( NESTGPUTimeIdx & 0xffff );
 
-    long long Dt_int = NESTGPUTimeIdx - LastRevSpikeTimeIdx[ i_target ];
-    if ( Dt_int > 0 && Dt_int < MAX_SYN_DT )
-    {
-      SynapseUpdate( syn_group,
-        &ConnectionGroupTargetWeight[ i_conn * NSpikeBuffer + i_source ][ i_syn ],
-        -NESTGPUTimeResolution * Dt_int );
-    }
+  long long Dt_int = NESTGPUTimeIdx - LastRevSpikeTimeIdx[ i_target ];
+  if ( Dt_int > 0 && Dt_int < MAX_SYN_DT )
+  {
+    SynapseUpdate( syn_group, weight_pt, -NESTGPUTimeResolution * Dt_int );
   }
-  ////////////////////////////////////////////////////////////////
 }
 
 __global__ void
-CollectSpikeKernel( int n_spikes, int* SpikeTargetNum )
+CollectSpikeKernel( int n_spikes, int* SpikeTargetNum, int n_precise_spikes )
 {
   const int i_spike = blockIdx.x;
   if ( i_spike < n_spikes )
   {
+    const int i_conn_group = SourceFirstConnGroup[ SpikeSourceIdx[ i_spike ] ] + SpikeConnIdx[ i_spike ];
+    // the presynaptic traces of the trace-based synapse models are
+    // incremented when the spikes reach the synapses
+    if ( threadIdx.x == 0 && PreTrace != NULL )
+    {
+      PreTraceUpdate( i_conn_group, SpikeHeight[ i_spike ] );
+    }
     const int n_spike_targets = SpikeTargetNum[ i_spike ];
-    for ( int i_syn = threadIdx.x; i_syn < n_spike_targets; i_syn += blockDim.x )
+    // the static connections of the group are followed by the plastic ones
+    const unsigned int i_plastic_0 = ConnGroupFirstPlastic[ i_conn_group ];
+    const int n_static = n_spike_targets - ( int ) ( ConnGroupFirstPlastic[ i_conn_group + 1 ] - i_plastic_0 );
+    for ( int i_syn = threadIdx.x; i_syn < n_static; i_syn += blockDim.x )
+    {
+      CollectSpikeFunction( i_spike, i_syn, n_precise_spikes );
+    }
+    for ( int i_syn = n_static + threadIdx.x; i_syn < n_spike_targets; i_syn += blockDim.x )
     {
-      CollectSpikeFunction( i_spike, i_syn );
+      CollectPlasticSpikeFunction( i_spike, i_syn, i_plastic_0 + i_syn - n_static, n_precise_spikes );
+    }
+  }
+}
+
+// Stores a spike in the array of the spikes with offset of the target
+// group, returns false if the array is full
+__device__ __forceinline__ bool
+AddPreciseSpike( PreciseSpikeArray precise_spikes, int i_target, int port, float weight, float offset )
+{
+  int pos = atomicAdd( precise_spikes.n_spike_, 1 );
+  if ( pos >= precise_spikes.max_n_spike_ )
+  {
+    return false;
+  }
+  precise_spikes.i_target_[ pos ] = i_target;
+  precise_spikes.port_[ pos ] = port;
+  precise_spikes.weight_[ pos ] = weight;
+  precise_spikes.offset_[ pos ] = offset;
+
+  return true;
+}
+
+// Delivers the spikes with offset sent in the current time step to the
+// nodes of the precise-spiking models, before their update. The spikes
+// on the grid and those exceeding the capacity of the array of the target
+// group are collected by CollectSpikeKernel as usual
+__global__ void
+CollectPreciseSpikeKernel( int n_spikes, int* SpikeTargetNum )
+{
+  const int i_spike = blockIdx.x;
+  if ( i_spike >= n_spikes || SpikeOffset[ i_spike ] == 0.0 )
+  {
+    return;
+  }
+  int i_source = SpikeSourceIdx[ i_spike ];
+  int i_conn = SpikeConnIdx[ i_spike ];
+  float height = SpikeHeight[ i_spike ];
+  float offset = SpikeOffset[ i_spike ];
+  const int n_spike_targets = SpikeTargetNum[ i_spike ];
+  for ( int i_syn = threadIdx.x; i_syn < n_spike_targets; i_syn += blockDim.x )
+  {
+    unsigned int target_port = ConnectionGroupTargetNode[ i_conn * NSpikeBuffer + i_source ][ i_syn ];
+    int i_target = target_port & PORT_MASK;
+    int i_group = NodeGroupMap[ i_target ];
+    PreciseSpikeArray precise_spikes = NodeGroupArray[ i_group ].precise_spikes_;
+    if ( precise_spikes.n_spike_ != NULL )
+    {
+      int port = ( int ) ( target_port >> ( PORT_N_SHIFT + 24 ) );
+      float weight = ConnectionGroupTargetWeight[ i_conn * NSpikeBuffer + i_source ][ i_syn ];
+      int i_node_rel = i_target - NodeGroupArray[ i_group ].i_node_0_;
+      if ( !AddPreciseSpike( precise_spikes, i_node_rel, port, height * weight, offset ) )
+      {
+        // the array is full, the spike is delivered on the grid
+        int i = port * NodeGroupArray[ i_group ].n_node_ + i_node_rel;
+        atomicAddDouble( &NodeGroupArray[ i_group ].get_spike_array_[ i ], ( double ) ( height * weight ) );
+      }
     }
   }
 }
@@ -163,13 +261,26 @@ GetSpikes( double* spike_array,
 }
 
 
+// used by the models with fused input when their Update kernel
+// cannot fold the input spikes
+__global__ void
+FoldInputSpikesKernel( InputSpikeArray input_spikes )
+{
+  int i_target = blockIdx.x * blockDim.x + threadIdx.x;
+  if ( i_target < input_spikes.n_node_ )
+  {
+    FoldInputSpikes( input_spikes, i_target );
+  }
+}
+
 int
 NESTGPU::ClearGetSpikeArrays()
 {
   for ( unsigned int i = 0; i < node_vect_.size(); i++ )
   {
     BaseNeuron* bn = node_vect_[ i ];
-    if ( bn->get_spike_array_ != NULL )
+    // groups with fused input clear the array in their Update kernel
+    if ( bn->get_spike_array_ != NULL && !bn->fused_input_ )
     {
       gpuErrchk( cudaMemsetAsync( bn->get_spike_array_, 0, bn->n_node_ * bn->n_port_ * sizeof( double ) ) );
     }
@@ -24,6 +24,8 @@
 #ifndef GETSPIKE_H
 #define GETSPIKE_H
 
+#include "input_spike.h"
+
 __global__ void GetSpikes( double* spike_array,
   int array_size,
   int n_port,
@@ -36,6 +38,32 @@ __global__ void GetSpikes( double* spike_array,
   int port_input_port_step );
 
 
-__global__ void CollectSpikeKernel( int n_spikes, int* SpikeTargetNum );
+__global__ void CollectSpikeKernel( int n_spikes, int* SpikeTargetNum, int n_precise_spikes );
+
+__global__ void CollectPreciseSpikeKernel( int n_spikes, int* SpikeTargetNum );
+
+// Adds the spikes received by the node i_target to the input variables of
+// its ports, as the GetSpikes kernel, and clears them from the spike array
+__device__ __forceinline__ void
+FoldInputSpikes( InputSpikeArray input_spikes, int i_target )
+{
+  for ( int port = 0; port < input_spikes.n_port_; port++ )
+  {
+    int i_array = port * input_spikes.n_node_ + i_target;
+    double spike_val = input_spikes.spike_array_[ i_array ];
+    if ( spike_val != 0.0 )
+    {
+      int port_input = i_target * input_spikes.port_input_arr_step_ + input_spikes.port_input_port_step_ * port;
+      int port_weight = i_target * input_spikes.port_weight_arr_step_ + input_spikes.port_weight_port_step_ * port;
+      double d_val = ( double ) input_spikes.port_input_arr_[ port_input ]
+        + spike_val * input_spikes.port_weight_arr_[ port_weight ];
+
+      input_spikes.port_input_arr_[ port_input ] = ( float ) d_val;
+      input_spikes.spike_array_[ i_array ] = 0.0;
+    }
+  }
+}
+
+__global__ void FoldInputSpikesKernel( InputSpikeArray input_spikes );
 
 #endif
@@ -0,0 +1,330 @@
+/*
+ *  iaf_psc_alpha_ps.cu
+ *
+ *  This file is part of NEST GPU.
+ *
+ *  Copyright (C) 2021 The NEST Initiative
+ *
+ *  NEST GPU is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NEST GPU is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NEST GPU.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+// adapted from:
+// https://github.com/nest/nest-simulator/blob/master/models/iaf_psc_alpha_ps.cpp
+
+#include "get_spike.h"
+#include "iaf_psc_alpha_ps.h"
+#include "precise_spike_kernel.h"
+#include "propagator_stability.h"
+#include "spike_buffer.h"
+#include <cmath>
+#include <config.h>
+#include <iostream>
+
+using namespace iaf_psc_alpha_ps_ns;
+
+extern __constant__ float NESTGPUTimeResolution;
+extern __device__ double propagator_31( double, double, double, double );
+extern __device__ double propagator_32( double, double, double, double );
+
+#define I_ex var[ i_I_ex ]
+#define I_in var[ i_I_in ]
+#define dI_ex var[ i_dI_ex ]
+#define dI_in var[ i_dI_in ]
+#define V_m_rel var[ i_V_m_rel ]
+#define refractory_time var[ i_refractory_time ]
+#define in_I_ex var[ i_in_I_ex ]
+#define in_I_in var[ i_in_I_in ]
+#define in_dI_ex var[ i_in_dI_ex ]
+#define in_dI_in var[ i_in_dI_in ]
+#define in_V_m_rel var[ i_in_V_m_rel ]
+
+#define tau_m param[ i_tau_m ]
+#define C_m param[ i_C_m ]
+#define E_L param[ i_E_L ]
+#define I_e param[ i_I_e ]
+#define Theta_rel param[ i_Theta_rel ]
+#define V_reset_rel param[ i_V_reset_rel ]
+#define tau_ex param[ i_tau_ex ]
+#define tau_in param[ i_tau_in ]
+#define t_ref param[ i_t_ref ]
+#define den_delay param[ i_den_delay ]
+
+#define P11ex param[ i_P11ex ]
+#define P11in param[ i_P11in ]
+#define P21ex param[ i_P21ex ]
+#define P21in param[ i_P21in ]
+#define P22ex param[ i_P22ex ]
+#define P22in param[ i_P22in ]
+#define P31ex param[ i_P31ex ]
+#define P31in param[ i_P31in ]
+#define P32ex param[ i_P32ex ]
+#define P32in param[ i_P32in ]
+#define P30 param[ i_P30 ]
+#define expm1_tau_m param[ i_expm1_tau_m ]
+#define EPSCInitialValue param[ i_EPSCInitialValue ]
+#define IPSCInitialValue param[ i_IPSCInitialValue ]
+
+
+__global__ void
+iaf_psc_alpha_ps_Calibrate( int n_node, float* param_arr, int n_param, float h )
+{
+  int i_neuron = threadIdx.x + blockIdx.x * blockDim.x;
+  if ( i_neuron < n_node )
+  {
+    float* param = param_arr + n_param * i_neuron;
+
+    P11ex = P22ex = exp( -h / tau_ex );
+    P11in = P22in = exp( -h / tau_in );
+    expm1_tau_m = expm1( -h / tau_m );
+
+    P30 = -tau_m / C_m * expm1( -h / tau_m );
+    P21ex = h * P11ex;
+    P21in = h * P11in;
+
+    P31ex = ( float ) propagator_31( tau_ex, tau_m, C_m, h );
+    P32ex = ( float ) propagator_32( tau_ex, tau_m, C_m, h );
+    P31in = ( float ) propagator_31( tau_in, tau_m, C_m, h );
+    P32in = ( float ) propagator_32( tau_in, tau_m, C_m, h );
+
+    EPSCInitialValue = M_E / tau_ex;
+    IPSCInitialValue = M_E / tau_in;
+  }
+}
+
+// Adds the contributions of the spikes with offset received in the time
+// step to the state at the end of the step. The membrane potential is
+// affected only after the end of the refractory period
+__global__ void
+iaf_psc_alpha_ps_Deliver( float* var_arr, float* param_arr, PreciseSpikeArray precise_spikes )
+{
+  int n_spike = *precise_spikes.n_spike_;
+  n_spike = ( n_spike < precise_spikes.max_n_spike_ ) ? n_spike : precise_spikes.max_n_spike_;
+  float h = NESTGPUTimeResolution;
+  for ( int i_spike = threadIdx.x + blockIdx.x * blockDim.x; i_spike < n_spike; i_spike += blockDim.x * gridDim.x )
+  {
+    int i_neuron = precise_spikes.i_target_[ i_spike ];
+    int port = precise_spikes.port_[ i_spike ];
+    float offset = precise_spikes.offset_[ i_spike ];
+    float* var = var_arr + N_SCAL_VAR * i_neuron;
+    float* param = param_arr + N_SCAL_PARAM * i_neuron;
+    float tau_syn = ( port == 0 ) ? tau_ex : tau_in;
+    float weight = precise_spikes.weight_[ i_spike ] * ( ( port == 0 ) ? EPSCInitialValue : IPSCInitialValue );
+
+    float decay = exp( -offset / tau_syn );
+    atomicAdd( ( port == 0 ) ? &in_dI_ex : &in_dI_in, weight * decay );
+    atomicAdd( ( port == 0 ) ? &in_I_ex : &in_I_in, weight * offset * decay );
+    if ( refractory_time < h )
+    {
+      // arrival time and time when the input starts affecting V_m,
+      // from the beginning of the step
+      float t_arr = h - offset;
+      float t_v = ( t_arr > refractory_time ) ? t_arr : refractory_time;
+      float dI_v = weight * exp( -( t_v - t_arr ) / tau_syn );
+      float I_v = dI_v * ( t_v - t_arr );
+      float dV =
+        dI_v * propagator_31( tau_syn, tau_m, C_m, h - t_v ) + I_v * propagator_32( tau_syn, tau_m, C_m, h - t_v );
+      atomicAdd( &in_V_m_rel, dV );
+    }
+  }
+}
+
+__global__ void
+iaf_psc_alpha_ps_Update( int n_node,
+  int i_node_0,
+  float* var_arr,
+  float* param_arr,
+  InputSpikeArray input_spikes,
+  PreciseSpikeArray precise_spikes )
+{
+  int i_neuron = threadIdx.x + blockIdx.x * blockDim.x;
+  if ( i_neuron == 0 )
+  {
+    // the spikes with offset have been delivered
+    *precise_spikes.n_spike_ = 0;
+  }
+  if ( i_neuron < n_node )
+  {
+    FoldInputSpikes( input_spikes, i_neuron );
+    float* var = var_arr + N_SCAL_VAR * i_neuron;
+    float* param = param_arr + N_SCAL_PARAM * i_neuron;
+    float h = NESTGPUTimeResolution;
+
+    // time when the neuron leaves the refractory period,
+    // from the beginning of the step
+    float t0 = ( refractory_time < h ) ? refractory_time : h;
+    float I_ex_0 = I_ex;
+    float I_in_0 = I_in;
+    float V_m_rel_0 = V_m_rel;
+    if ( t0 == 0.0 )
+    {
+      V_m_rel =
+        P30 * I_e + P31ex * dI_ex + P32ex * I_ex + P31in * dI_in + P32in * I_in + expm1_tau_m * V_m_rel + V_m_rel;
+      V_m_rel += in_V_m_rel;
+    }
+    else if ( t0 < h )
+    {
+      // the neuron leaves the refractory period within the step
+      float dt = h - t0;
+      float dI_ex_0 = dI_ex * exp( -t0 / tau_ex );
+      float dI_in_0 = dI_in * exp( -t0 / tau_in );
+      I_ex_0 = ( I_ex + t0 * dI_ex ) * exp( -t0 / tau_ex );
+      I_in_0 = ( I_in + t0 * dI_in ) * exp( -t0 / tau_in );
+      V_m_rel_0 = V_reset_rel;
+      V_m_rel = V_reset_rel * exp( -dt / tau_m ) + dI_ex_0 * propagator_31( tau_ex, tau_m, C_m, dt )
+        + I_ex_0 * propagator_32( tau_ex, tau_m, C_m, dt ) + dI_in_0 * propagator_31( tau_in, tau_m, C_m, dt )
+        + I_in_0 * propagator_32( tau_in, tau_m, C_m, dt ) - I_e * tau_m / C_m * expm1( -dt / tau_m ) + in_V_m_rel;
+    }
+    refractory_time = ( refractory_time > h ) ? refractory_time - h : 0.0;
+
+    // alpha shape PSCs
+    I_ex = P21ex * dI_ex + P22ex * I_ex + in_I_ex;
+    dI_ex = dI_ex * P11ex + in_dI_ex;
+
+    I_in = P21in * dI_in + P22in * I_in + in_I_in;
+    dI_in = dI_in * P11in + in_dI_in;
+
+    in_I_ex = 0.0;
+    in_I_in = 0.0;
+    in_dI_ex = 0.0;
+    in_dI_in = 0.0;
+    in_V_m_rel = 0.0;
+
+    if ( t0 < h && V_m_rel >= Theta_rel )
+    { // threshold crossing, its time is interpolated using the
+      // derivatives of V_m at the boundaries of the interval [t0, h]
+      float dV0 = -V_m_rel_0 / tau_m + ( I_ex_0 + I_in_0 + I_e ) / C_m;
+      float dV1 = -V_m_rel / tau_m + ( I_ex + I_in + I_e ) / C_m;
+      float t_spike =
+        t0 + PreciseSpikeCrossingTime( V_m_rel_0 - Theta_rel, V_m_rel - Theta_rel, dV0, dV1, h - t0 );
+      float offset = h - t_spike;
+      PushSpike( i_node_0 + i_neuron, 1.0, offset );
+      V_m_rel = V_reset_rel;
+      refractory_time = ( t_ref > offset ) ? t_ref - offset : 0.0;
+    }
+  }
+}
+
+iaf_psc_alpha_ps::~iaf_psc_alpha_ps()
+{
+  FreeVarArr();
+  FreeParamArr();
+  FreePreciseSpikeArray();
+}
+
+int
+iaf_psc_alpha_ps::Init( int i_node_0, int n_node, int /*n_port*/, int i_group, unsigned long long* seed )
+{
+  BaseNeuron::Init( i_node_0, n_node, 2 /*n_port*/, i_group, seed );
+  node_type_ = i_iaf_psc_alpha_ps_model;
+  precise_spike_ = true;
+
+  n_scal_var_ = N_SCAL_VAR;
+  n_var_ = n_scal_var_;
+  n_scal_param_ = N_SCAL_PARAM;
+  n_group_param_ = N_GROUP_PARAM;
+  n_param_ = n_scal_param_;
+
+  AllocParamArr();
+  AllocVarArr();
+  group_param_ = new float[ N_GROUP_PARAM ];
+
+  scal_var_name_ = iaf_psc_alpha_ps_scal_var_name;
+  scal_param_name_ = iaf_psc_alpha_ps_scal_param_name;
+  group_param_name_ = iaf_psc_alpha_ps_group_param_name;
+
+  SetScalParam( 0, n_node, "tau_m", 10.0 );                    // in ms
+  SetScalParam( 0, n_node, "C_m", 250.0 );                     // in pF
+  SetScalParam( 0, n_node, "E_L", -70.0 );                     // in mV
+  SetScalParam( 0, n_node, "I_e", 0.0 );                       // in pA
+  SetScalParam( 0, n_node, "Theta_rel", -55.0 - ( -70.0 ) );   // relative to E_L_
+  SetScalParam( 0, n_node, "V_reset_rel", -70.0 - ( -70.0 ) ); // relative to E_L_
+  SetScalParam( 0, n_node, "tau_syn_ex", 2.0 );                // in ms
+  SetScalParam( 0, n_node, "tau_syn_in", 2.0 );                // in ms
+  SetScalParam( 0, n_node, "t_ref", 2.0 );                     // in ms
+  SetScalParam( 0, n_node, "den_delay", 0.0 );                 // in ms
+  SetScalParam( 0, n_node, "P11ex", 0.0 );
+  SetScalParam( 0, n_node, "P11in", 0.0 );
+  SetScalParam( 0, n_node, "P21ex", 0.0 );
+  SetScalParam( 0, n_node, "P21in", 0.0 );
+  SetScalParam( 0, n_node, "P22ex", 0.0 );
+  SetScalParam( 0, n_node, "P22in", 0.0 );
+  SetScalParam( 0, n_node, "P31ex", 0.0 );
+  SetScalParam( 0, n_node, "P31in", 0.0 );
+  SetScalParam( 0, n_node, "P32ex", 0.0 );
+  SetScalParam( 0, n_node, "P32in", 0.0 );
+  SetScalParam( 0, n_node, "P30", 0.0 );
+  SetScalParam( 0, n_node, "expm1_tau_m", 0.0 );
+  SetScalParam( 0, n_node, "EPSCInitialValue", 0.0 );
+  SetScalParam( 0, n_node, "IPSCInitialValue", 0.0 );
+
+  SetScalVar( 0, n_node, "I_syn_ex", 0.0 );
+  SetScalVar( 0, n_node, "dI_ex", 0.0 );
+  SetScalVar( 0, n_node, "I_syn_in", 0.0 );
+  SetScalVar( 0, n_node, "dI_in", 0.0 );
+  SetScalVar( 0, n_node, "V_m_rel", -70.0 - ( -70.0 ) ); // in mV, relative to E_L
+  SetScalVar( 0, n_node, "refractory_time", 0.0 );       // in ms
+  SetScalVar( 0, n_node, "in_I_syn_ex", 0.0 );
+  SetScalVar( 0, n_node, "in_I_syn_in", 0.0 );
+  SetScalVar( 0, n_node, "in_dI_ex", 0.0 );
+  SetScalVar( 0, n_node, "in_dI_in", 0.0 );
+  SetScalVar( 0, n_node, "in_V_m_rel", 0.0 );
+
+  SetGroupParam( "max_input_spikes", 16.0 );
+
+  // input spike signal on the grid is stored in dI_ex, dI_in
+  port_weight_arr_ = GetParamArr() + GetScalParamIdx( "EPSCInitialValue" );
+  port_weight_arr_step_ = n_param_;
+  port_weight_port_step_ = 1;
+
+  port_input_arr_ = GetVarArr() + GetScalVarIdx( "dI_ex" );
+  port_input_arr_step_ = n_var_;
+  port_input_port_step_ = 1;
+
+  den_delay_arr_ = GetParamArr() + GetScalParamIdx( "den_delay" );
+
+  return 0;
+}
+
+int
+iaf_psc_alpha_ps::Update( long long it, double t1 )
+{
+  iaf_psc_alpha_ps_Deliver<<< ( n_node_ + 1023 ) / 1024, 1024, 0, stream_ >>>( var_arr_, param_arr_, precise_spikes_ );
+  iaf_psc_alpha_ps_Update<<< ( n_node_ + 1023 ) / 1024, 1024, 0, stream_ >>>(
+    n_node_, i_node_0_, var_arr_, param_arr_, input_spikes_, precise_spikes_ );
+  // gpuErrchk( cudaDeviceSynchronize() );
+
+  return 0;
+}
+
+int
+iaf_psc_alpha_ps::Free()
+{
+  FreeVarArr();
+  FreeParamArr();
+  FreePreciseSpikeArray();
+  delete[] group_param_;
+
+  return 0;
+}
+
+int
+iaf_psc_alpha_ps::Calibrate( double, float time_resolution )
+{
+  iaf_psc_alpha_ps_Calibrate<<< ( n_node_ + 1023 ) / 1024, 1024 >>>( n_node_, param_arr_, n_param_, time_resolution );
+  input_spikes_ = FuseInputSpikes();
+
+  return 0;
+}
@@ -24,7 +24,9 @@
 // adapted from:
 // https://github.com/nest/nest-simulator/blob/master/models/iaf_psc_exp.cpp
 
+#include "get_spike.h"
 #include "iaf_psc_exp.h"
+#include "jit_kernel.h"
 #include "propagator_stability.h"
 #include "spike_buffer.h"
 #include <cmath>
@@ -61,6 +63,8 @@ extern __device__ double propagator_32( double, double, double, double );
 #define P21in param[ i_P21in ]
 #define P22 param[ i_P22 ]
 
+#define jit_ group_param_[ i_jit ]
+
 
 __global__ void
 iaf_psc_exp_Calibrate( int n_node, float* param_arr, int n_param, float h )
@@ -80,37 +84,94 @@ iaf_psc_exp_Calibrate( int n_node, float* param_arr, int n_param, float h )
 }
 
 
+__device__ __forceinline__ void
+iaf_psc_exp_NodeUpdate( int i_neuron, int i_node_0, float* var_arr, float* param_arr, InputSpikeArray input_spikes )
+{
+  FoldInputSpikes( input_spikes, i_neuron );
+  float* var = var_arr + N_SCAL_VAR * i_neuron;
+  float* param = param_arr + N_SCAL_PARAM * i_neuron;
+
+  if ( refractory_step > 0.0 )
+  {
+    // neuron is absolute refractory
+    refractory_step -= 1.0;
+  }
+  else
+  { // neuron is not refractory, so evolve V
+    V_m_rel = V_m_rel * P22 + I_syn_ex * P21ex + I_syn_in * P21in + I_e * P20;
+  }
+  // exponential decaying PSCs
+  I_syn_ex *= P11ex;
+  I_syn_in *= P11in;
+
+  if ( V_m_rel >= Theta_rel )
+  { // threshold crossing
+    PushSpike( i_node_0 + i_neuron, 1.0 );
+    V_m_rel = V_reset_rel;
+    refractory_step = ( int ) round( t_ref / NESTGPUTimeResolution );
+  }
+}
+
 __global__ void
-iaf_psc_exp_Update( int n_node, int i_node_0, float* var_arr, float* param_arr, int n_var, int n_param )
+iaf_psc_exp_Update( int n_node, int i_node_0, float* var_arr, float* param_arr, InputSpikeArray input_spikes )
 {
   int i_neuron = threadIdx.x + blockIdx.x * blockDim.x;
   if ( i_neuron < n_node )
   {
-    float* var = var_arr + n_var * i_neuron;
-    float* param = param_arr + n_param * i_neuron;
+    iaf_psc_exp_NodeUpdate( i_neuron, i_node_0, var_arr, param_arr, input_spikes );
+  }
+}
 
-    if ( refractory_step > 0.0 )
+// updates the neurons of a batch of groups, the threads are assigned
+// to the groups in the order of the array, each group starting from
+// the thread i_thread_0_
+__global__ void
+iaf_psc_exp_BatchUpdate( int n_group, int n_thread, iaf_psc_exp_batch_group* group_arr )
+{
+  int i_thread = threadIdx.x + blockIdx.x * blockDim.x;
+  if ( i_thread < n_thread )
+  {
+    // binary search of the group of the thread
+    int i_group = 0;
+    int i_group_end = n_group;
+    while ( i_group_end - i_group > 1 )
     {
-      // neuron is absolute refractory
-      refractory_step -= 1.0;
-    }
-    else
-    { // neuron is not refractory, so evolve V
-      V_m_rel = V_m_rel * P22 + I_syn_ex * P21ex + I_syn_in * P21in + I_e * P20;
-    }
-    // exponential decaying PSCs
-    I_syn_ex *= P11ex;
-    I_syn_in *= P11in;
-
-    if ( V_m_rel >= Theta_rel )
-    { // threshold crossing
-      PushSpike( i_node_0 + i_neuron, 1.0 );
-      V_m_rel = V_reset_rel;
-      refractory_step = ( int ) round( t_ref / NESTGPUTimeResolution );
+      int i_mid = ( i_group + i_group_end ) / 2;
+      if ( group_arr[ i_mid ].i_thread_0_ <= i_thread )
+      {
+        i_group = i_mid;
+      }
+      else
+      {
+        i_group_end = i_mid;
+      }
     }
+    iaf_psc_exp_batch_group group = group_arr[ i_group ];
+    iaf_psc_exp_NodeUpdate(
+      i_thread - group.i_thread_0_, group.i_node_0_, group.var_arr_, group.param_arr_, group.input_spikes_ );
   }
 }
 
+// body of the update kernel compiled at run time, see iaf_psc_exp_Update.
+// The parameters are accessed through the macros defined by JitSource
+static const std::string iaf_psc_exp_jit_body = "    if ( refractory_step > 0.0 )\n"
+                                                "    {\n"
+                                                "      refractory_step -= 1.0;\n"
+                                                "    }\n"
+                                                "    else\n"
+                                                "    {\n"
+                                                "      V_m_rel = V_m_rel * P22 + I_syn_ex * P21ex + I_syn_in * P21in"
+                                                " + I_e * P20;\n"
+                                                "    }\n"
+                                                "    I_syn_ex *= P11ex;\n"
+                                                "    I_syn_in *= P11in;\n"
+                                                "    if ( V_m_rel >= Theta_rel )\n"
+                                                "    {\n"
+                                                "      EmitSpike();\n"
+                                                "      V_m_rel = V_reset_rel;\n"
+                                                "      refractory_step = ( int ) round( t_ref / time_resolution );\n"
+                                                "    }\n";
+
 iaf_psc_exp::~iaf_psc_exp()
 {
   FreeVarArr();
@@ -126,13 +187,16 @@ iaf_psc_exp::Init( int i_node_0, int n_node, int /*n_port*/, int i_group, unsign
   n_scal_var_ = N_SCAL_VAR;
   n_var_ = n_scal_var_;
   n_scal_param_ = N_SCAL_PARAM;
+  n_group_param_ = N_GROUP_PARAM;
   n_param_ = n_scal_param_;
 
   AllocParamArr();
   AllocVarArr();
+  group_param_ = new float[ N_GROUP_PARAM ];
 
   scal_var_name_ = iaf_psc_exp_scal_var_name;
   scal_param_name_ = iaf_psc_exp_scal_param_name;
+  group_param_name_ = iaf_psc_exp_group_param_name;
 
   SetScalParam( 0, n_node, "tau_m", 10.0 );                    // in ms
   SetScalParam( 0, n_node, "C_m", 250.0 );                     // in pF
@@ -158,6 +222,13 @@ iaf_psc_exp::Init( int i_node_0, int n_node, int /*n_port*/, int i_group, unsign
   SetScalVar( 0, n_node, "V_m_rel", -70.0 - ( -70.0 ) ); // in mV, relative to E_L
   SetScalVar( 0, n_node, "refractory_step", 0 );
 
+  SetGroupParam( "jit", 0.0 );
+  jit_kernel_ = NULL;
+  jit_param_mask_ = 0;
+  batch_n_group_ = 1;
+  batch_n_node_ = n_node;
+  d_batch_group_arr_ = NULL;
+
   // multiplication factor of input signal is always 1 for all nodes
   float input_weight = 1.0;
   gpuErrchk( cudaMalloc( &port_weight_arr_, sizeof( float ) ) );
@@ -179,8 +250,24 @@ int
 iaf_psc_exp::Update( long long it, double t1 )
 {
   // std::cout << "iaf_psc_exp neuron update\n";
-  iaf_psc_exp_Update<<< ( n_node_ + 1023 ) / 1024, 1024 >>>(
-    n_node_, i_node_0_, var_arr_, param_arr_, n_var_, n_param_ );
+  // the compiled kernel is used only if the parameters written in it
+  // as constants have not been changed after calibration
+  if ( jit_ != 0.0 && jit_kernel_ != NULL && jit_kernel_->Loaded() && jit_param_mask_ == const_param_mask_ )
+  {
+    // the compiled kernel does not fold the input spikes
+    FoldInputSpikesKernel<<< ( n_node_ + 1023 ) / 1024, 1024, 0, stream_ >>>( input_spikes_ );
+    jit_kernel_->Update( i_node_0_, var_arr_, param_arr_, stream_ );
+  }
+  else if ( batch_n_group_ > 1 )
+  {
+    iaf_psc_exp_BatchUpdate<<< ( batch_n_node_ + 1023 ) / 1024, 1024, 0, stream_ >>>(
+      batch_n_group_, batch_n_node_, d_batch_group_arr_ );
+  }
+  else
+  {
+    iaf_psc_exp_Update<<< ( n_node_ + 1023 ) / 1024, 1024, 0, stream_ >>>(
+      n_node_, i_node_0_, var_arr_, param_arr_, input_spikes_ );
+  }
   // gpuErrchk( cudaDeviceSynchronize() );
 
   return 0;
@@ -191,6 +278,14 @@ iaf_psc_exp::Free()
 {
   FreeVarArr();
   FreeParamArr();
+  delete jit_kernel_;
+  jit_kernel_ = NULL;
+  delete[] group_param_;
+  if ( d_batch_group_arr_ != NULL )
+  {
+    gpuErrchk( cudaFree( d_batch_group_arr_ ) );
+    d_batch_group_arr_ = NULL;
+  }
 
   return 0;
 }
@@ -199,6 +294,83 @@ int
 iaf_psc_exp::Calibrate( double, float time_resolution )
 {
   iaf_psc_exp_Calibrate<<< ( n_node_ + 1023 ) / 1024, 1024 >>>( n_node_, param_arr_, n_param_, time_resolution );
+  input_spikes_ = FuseInputSpikes();
+  if ( jit_ != 0.0 )
+  {
+    JitCompile( time_resolution );
+  }
+
+  return 0;
+}
+
+// the groups with an update kernel compiled at run time are not merged
+bool
+iaf_psc_exp::CanMergeUpdate( BaseNeuron* node )
+{
+  return node->GetNodeType() == node_type_ && jit_ == 0.0 && node->GetGroupParam( "jit" ) == 0.0;
+}
+
+int
+iaf_psc_exp::MergeUpdate( std::vector< BaseNeuron* > group_vect )
+{
+  std::vector< iaf_psc_exp_batch_group > h_group_arr;
+  int i_thread_0 = 0;
+  for ( unsigned int i = 0; i < group_vect.size(); i++ )
+  {
+    iaf_psc_exp* node = static_cast< iaf_psc_exp* >( group_vect[ i ] );
+    iaf_psc_exp_batch_group group;
+    group.i_node_0_ = node->i_node_0_;
+    group.n_node_ = node->n_node_;
+    group.i_thread_0_ = i_thread_0;
+    group.var_arr_ = node->var_arr_;
+    group.param_arr_ = node->param_arr_;
+    group.input_spikes_ = node->input_spikes_;
+    h_group_arr.push_back( group );
+    i_thread_0 += node->n_node_;
+  }
+  batch_n_group_ = h_group_arr.size();
+  batch_n_node_ = i_thread_0;
+  gpuErrchk( cudaMalloc( &d_batch_group_arr_, batch_n_group_ * sizeof( iaf_psc_exp_batch_group ) ) );
+  gpuErrchk( cudaMemcpy( d_batch_group_arr_,
+    h_group_arr.data(),
+    batch_n_group_ * sizeof( iaf_psc_exp_batch_group ),
+    cudaMemcpyHostToDevice ) );
+
+  return 0;
+}
+
+// Generates the update kernel of the group, with the parameters that have
+// the same value in all the neurons, including the propagators computed
+// by iaf_psc_exp_Calibrate, written as constants, and compiles it
+int
+iaf_psc_exp::JitCompile( float time_resolution )
+{
+  FoldConstParam( 0 );
+  JitSource jit_source( "iaf_psc_exp_jit_Update", n_var_, n_param_ );
+  for ( int i_var = 0; i_var < n_scal_var_; i_var++ )
+  {
+    jit_source.AddVar( scal_var_name_[ i_var ], i_var );
+  }
+  for ( int i_param = 0; i_param < n_scal_param_; i_param++ )
+  {
+    if ( i_param < MAX_FOLDED_PARAM && ( ( const_param_mask_ >> i_param ) & 1ULL ) )
+    {
+      jit_source.AddConst( scal_param_name_[ i_param ], const_param_val_[ i_param ] );
+    }
+    else
+    {
+      jit_source.AddParam( scal_param_name_[ i_param ], i_param );
+    }
+  }
+  jit_source.AddConst( "time_resolution", time_resolution );
+  jit_source.SetBody( iaf_psc_exp_jit_body );
+
+  if ( jit_kernel_ == NULL )
+  {
+    jit_kernel_ = new JitKernel;
+  }
+  jit_kernel_->Compile( jit_source, n_node_ );
+  jit_param_mask_ = const_param_mask_;
 
   return 0;
 }
@@ -88,6 +88,9 @@ The following parameters can be set in the status dictionary.
                        current kernel
  t_ref         ms      Duration of refractory period (V_m = V_reset)
  den_delay     ms      Dendritic delay
+ jit                   If nonzero, the update kernel is compiled at run time
+                       (NVRTC), with the parameters that have the same value
+                       in all the neurons of the group written as constants
 ============  =======  ========================================================
 
 References
@@ -153,6 +156,12 @@ enum ScalParamIndexes
   N_SCAL_PARAM
 };
 
+enum GroupParamIndexes
+{
+  i_jit = 0, // if nonzero the update kernel is compiled at run time
+  N_GROUP_PARAM
+};
+
 
 const std::string iaf_psc_exp_scal_var_name[ N_SCAL_VAR ] = { "I_syn_ex", "I_syn_in", "V_m_rel", "refractory_step" };
 
@@ -176,10 +185,37 @@ const std::string iaf_psc_exp_scal_param_name[ N_SCAL_PARAM ] = { "tau_m",
   "P21in",
   "P22" };
 
+const std::string iaf_psc_exp_group_param_name[ N_GROUP_PARAM ] = { "jit" };
+
 } // namespace
 
+class JitKernel;
+
+// neuron group of a batch updated by a single kernel launch
+struct iaf_psc_exp_batch_group
+{
+  int i_node_0_;
+  int n_node_;
+  int i_thread_0_; // index of the thread that updates the first neuron
+  float* var_arr_;
+  float* param_arr_;
+  InputSpikeArray input_spikes_;
+};
+
 class iaf_psc_exp : public BaseNeuron
 {
+  JitKernel* jit_kernel_;             // update kernel compiled at run time
+  unsigned long long jit_param_mask_; // parameters written as constants
+                                      // in the compiled kernel
+  InputSpikeArray input_spikes_;      // input spikes folded by the
+                                      // update kernel
+  int batch_n_group_;                 // number of groups updated by
+                                      // the group, including itself
+  int batch_n_node_;                  // total number of their neurons
+  iaf_psc_exp_batch_group* d_batch_group_arr_;
+
+  int JitCompile( float time_resolution );
+
 public:
   ~iaf_psc_exp();
 
@@ -190,6 +226,10 @@ public:
   int Update( long long it, double t1 );
 
   int Free();
+
+  bool CanMergeUpdate( BaseNeuron* node );
+
+  int MergeUpdate( std::vector< BaseNeuron* > group_vect );
 };
 
 
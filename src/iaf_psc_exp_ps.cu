@@ -0,0 +1,282 @@
+/*
+ *  iaf_psc_exp_ps.cu
+ *
+ *  This file is part of NEST GPU.
+ *
+ *  Copyright (C) 2021 The NEST Initiative
+ *
+ *  NEST GPU is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NEST GPU is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NEST GPU.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+// adapted from:
+// https://github.com/nest/nest-simulator/blob/master/models/iaf_psc_exp_ps.cpp
+
+#include "get_spike.h"
+#include "iaf_psc_exp_ps.h"
+#include "precise_spike_kernel.h"
+#include "propagator_stability.h"
+#include "spike_buffer.h"
+#include <cmath>
+#include <config.h>
+#include <iostream>
+
+using namespace iaf_psc_exp_ps_ns;
+
+extern __constant__ float NESTGPUTimeResolution;
+extern __device__ double propagator_32( double, double, double, double );
+
+#define I_syn_ex var[ i_I_syn_ex ]
+#define I_syn_in var[ i_I_syn_in ]
+#define V_m_rel var[ i_V_m_rel ]
+#define refractory_time var[ i_refractory_time ]
+#define in_I_syn_ex var[ i_in_I_syn_ex ]
+#define in_I_syn_in var[ i_in_I_syn_in ]
+#define in_V_m_rel var[ i_in_V_m_rel ]
+
+#define tau_m param[ i_tau_m ]
+#define C_m param[ i_C_m ]
+#define E_L param[ i_E_L ]
+#define I_e param[ i_I_e ]
+#define Theta_rel param[ i_Theta_rel ]
+#define V_reset_rel param[ i_V_reset_rel ]
+#define tau_ex param[ i_tau_ex ]
+#define tau_in param[ i_tau_in ]
+#define t_ref param[ i_t_ref ]
+#define den_delay param[ i_den_delay ]
+
+#define P20 param[ i_P20 ]
+#define P11ex param[ i_P11ex ]
+#define P11in param[ i_P11in ]
+#define P21ex param[ i_P21ex ]
+#define P21in param[ i_P21in ]
+#define P22 param[ i_P22 ]
+
+
+__global__ void
+iaf_psc_exp_ps_Calibrate( int n_node, float* param_arr, int n_param, float h )
+{
+  int i_neuron = threadIdx.x + blockIdx.x * blockDim.x;
+  if ( i_neuron < n_node )
+  {
+    float* param = param_arr + n_param * i_neuron;
+
+    P11ex = exp( -h / tau_ex );
+    P11in = exp( -h / tau_in );
+    P22 = exp( -h / tau_m );
+    P21ex = ( float ) propagator_32( tau_ex, tau_m, C_m, h );
+    P21in = ( float ) propagator_32( tau_in, tau_m, C_m, h );
+    P20 = tau_m / C_m * ( 1.0 - P22 );
+  }
+}
+
+// Adds the contributions of the spikes with offset received in the time
+// step to the state at the end of the step. The membrane potential is
+// affected only after the end of the refractory period
+__global__ void
+iaf_psc_exp_ps_Deliver( float* var_arr, float* param_arr, PreciseSpikeArray precise_spikes )
+{
+  int n_spike = *precise_spikes.n_spike_;
+  n_spike = ( n_spike < precise_spikes.max_n_spike_ ) ? n_spike : precise_spikes.max_n_spike_;
+  float h = NESTGPUTimeResolution;
+  for ( int i_spike = threadIdx.x + blockIdx.x * blockDim.x; i_spike < n_spike; i_spike += blockDim.x * gridDim.x )
+  {
+    int i_neuron = precise_spikes.i_target_[ i_spike ];
+    int port = precise_spikes.port_[ i_spike ];
+    float weight = precise_spikes.weight_[ i_spike ];
+    float offset = precise_spikes.offset_[ i_spike ];
+    float* var = var_arr + N_SCAL_VAR * i_neuron;
+    float* param = param_arr + N_SCAL_PARAM * i_neuron;
+    float tau_syn = ( port == 0 ) ? tau_ex : tau_in;
+
+    atomicAdd( ( port == 0 ) ? &in_I_syn_ex : &in_I_syn_in, weight * exp( -offset / tau_syn ) );
+    if ( refractory_time < h )
+    {
+      // arrival time and time when the input starts affecting V_m,
+      // from the beginning of the step
+      float t_arr = h - offset;
+      float t_v = ( t_arr > refractory_time ) ? t_arr : refractory_time;
+      float dV = weight * exp( -( t_v - t_arr ) / tau_syn ) * propagator_32( tau_syn, tau_m, C_m, h - t_v );
+      atomicAdd( &in_V_m_rel, dV );
+    }
+  }
+}
+
+__global__ void
+iaf_psc_exp_ps_Update( int n_node,
+  int i_node_0,
+  float* var_arr,
+  float* param_arr,
+  InputSpikeArray input_spikes,
+  PreciseSpikeArray precise_spikes )
+{
+  int i_neuron = threadIdx.x + blockIdx.x * blockDim.x;
+  if ( i_neuron == 0 )
+  {
+    // the spikes with offset have been delivered
+    *precise_spikes.n_spike_ = 0;
+  }
+  if ( i_neuron < n_node )
+  {
+    FoldInputSpikes( input_spikes, i_neuron );
+    float* var = var_arr + N_SCAL_VAR * i_neuron;
+    float* param = param_arr + N_SCAL_PARAM * i_neuron;
+    float h = NESTGPUTimeResolution;
+
+    // time when the neuron leaves the refractory period,
+    // from the beginning of the step
+    float t0 = ( refractory_time < h ) ? refractory_time : h;
+    float I_syn_ex_0 = I_syn_ex;
+    float I_syn_in_0 = I_syn_in;
+    float V_m_rel_0 = V_m_rel;
+    if ( t0 == 0.0 )
+    {
+      V_m_rel = V_m_rel * P22 + I_syn_ex * P21ex + I_syn_in * P21in + I_e * P20 + in_V_m_rel;
+    }
+    else if ( t0 < h )
+    {
+      // the neuron leaves the refractory period within the step
+      float dt = h - t0;
+      I_syn_ex_0 *= exp( -t0 / tau_ex );
+      I_syn_in_0 *= exp( -t0 / tau_in );
+      V_m_rel_0 = V_reset_rel;
+      V_m_rel = V_reset_rel * exp( -dt / tau_m ) + I_syn_ex_0 * propagator_32( tau_ex, tau_m, C_m, dt )
+        + I_syn_in_0 * propagator_32( tau_in, tau_m, C_m, dt ) - I_e * tau_m / C_m * expm1( -dt / tau_m ) + in_V_m_rel;
+    }
+    refractory_time = ( refractory_time > h ) ? refractory_time - h : 0.0;
+    // exponential decaying PSCs
+    I_syn_ex = I_syn_ex * P11ex + in_I_syn_ex;
+    I_syn_in = I_syn_in * P11in + in_I_syn_in;
+    in_I_syn_ex = 0.0;
+    in_I_syn_in = 0.0;
+    in_V_m_rel = 0.0;
+
+    if ( t0 < h && V_m_rel >= Theta_rel )
+    { // threshold crossing, its time is interpolated using the
+      // derivatives of V_m at the boundaries of the interval [t0, h]
+      float dV0 = -V_m_rel_0 / tau_m + ( I_syn_ex_0 + I_syn_in_0 + I_e ) / C_m;
+      float dV1 = -V_m_rel / tau_m + ( I_syn_ex + I_syn_in + I_e ) / C_m;
+      float t_spike =
+        t0 + PreciseSpikeCrossingTime( V_m_rel_0 - Theta_rel, V_m_rel - Theta_rel, dV0, dV1, h - t0 );
+      float offset = h - t_spike;
+      PushSpike( i_node_0 + i_neuron, 1.0, offset );
+      V_m_rel = V_reset_rel;
+      refractory_time = ( t_ref > offset ) ? t_ref - offset : 0.0;
+    }
+  }
+}
+
+iaf_psc_exp_ps::~iaf_psc_exp_ps()
+{
+  FreeVarArr();
+  FreeParamArr();
+  FreePreciseSpikeArray();
+}
+
+int
+iaf_psc_exp_ps::Init( int i_node_0, int n_node, int /*n_port*/, int i_group, unsigned long long* seed )
+{
+  BaseNeuron::Init( i_node_0, n_node, 2 /*n_port*/, i_group, seed );
+  node_type_ = i_iaf_psc_exp_ps_model;
+  precise_spike_ = true;
+
+  n_scal_var_ = N_SCAL_VAR;
+  n_var_ = n_scal_var_;
+  n_scal_param_ = N_SCAL_PARAM;
+  n_group_param_ = N_GROUP_PARAM;
+  n_param_ = n_scal_param_;
+
+  AllocParamArr();
+  AllocVarArr();
+  group_param_ = new float[ N_GROUP_PARAM ];
+
+  scal_var_name_ = iaf_psc_exp_ps_scal_var_name;
+  scal_param_name_ = iaf_psc_exp_ps_scal_param_name;
+  group_param_name_ = iaf_psc_exp_ps_group_param_name;
+
+  SetScalParam( 0, n_node, "tau_m", 10.0 );                    // in ms
+  SetScalParam( 0, n_node, "C_m", 250.0 );                     // in pF
+  SetScalParam( 0, n_node, "E_L", -70.0 );                     // in mV
+  SetScalParam( 0, n_node, "I_e", 0.0 );                       // in pA
+  SetScalParam( 0, n_node, "Theta_rel", -55.0 - ( -70.0 ) );   // relative to E_L_
+  SetScalParam( 0, n_node, "V_reset_rel", -70.0 - ( -70.0 ) ); // relative to E_L_
+  SetScalParam( 0, n_node, "tau_ex", 2.0 );                    // in ms
+  SetScalParam( 0, n_node, "tau_in", 2.0 );                    // in ms
+  SetScalParam( 0, n_node, "t_ref", 2.0 );                     // in ms
+  SetScalParam( 0, n_node, "den_delay", 0.0 );                 // in ms
+  SetScalParam( 0, n_node, "P20", 0.0 );
+  SetScalParam( 0, n_node, "P11ex", 0.0 );
+  SetScalParam( 0, n_node, "P11in", 0.0 );
+  SetScalParam( 0, n_node, "P21ex", 0.0 );
+  SetScalParam( 0, n_node, "P21in", 0.0 );
+  SetScalParam( 0, n_node, "P22", 0.0 );
+
+  SetScalVar( 0, n_node, "I_syn_ex", 0.0 );
+  SetScalVar( 0, n_node, "I_syn_in", 0.0 );
+  SetScalVar( 0, n_node, "V_m_rel", -70.0 - ( -70.0 ) ); // in mV, relative to E_L
+  SetScalVar( 0, n_node, "refractory_time", 0.0 );       // in ms
+  SetScalVar( 0, n_node, "in_I_syn_ex", 0.0 );
+  SetScalVar( 0, n_node, "in_I_syn_in", 0.0 );
+  SetScalVar( 0, n_node, "in_V_m_rel", 0.0 );
+
+  SetGroupParam( "max_input_spikes", 16.0 );
+
+  // multiplication factor of input signal is always 1 for all nodes
+  float input_weight = 1.0;
+  gpuErrchk( cudaMalloc( &port_weight_arr_, sizeof( float ) ) );
+  gpuErrchk( cudaMemcpy( port_weight_arr_, &input_weight, sizeof( float ), cudaMemcpyHostToDevice ) );
+  port_weight_arr_step_ = 0;
+  port_weight_port_step_ = 0;
+
+  // input spike signal on the grid is stored in I_syn_ex, I_syn_in
+  port_input_arr_ = GetVarArr() + GetScalVarIdx( "I_syn_ex" );
+  port_input_arr_step_ = n_var_;
+  port_input_port_step_ = 1;
+
+  den_delay_arr_ = GetParamArr() + GetScalParamIdx( "den_delay" );
+
+  return 0;
+}
+
+int
+iaf_psc_exp_ps::Update( long long it, double t1 )
+{
+  iaf_psc_exp_ps_Deliver<<< ( n_node_ + 1023 ) / 1024, 1024, 0, stream_ >>>( var_arr_, param_arr_, precise_spikes_ );
+  iaf_psc_exp_ps_Update<<< ( n_node_ + 1023 ) / 1024, 1024, 0, stream_ >>>(
+    n_node_, i_node_0_, var_arr_, param_arr_, input_spikes_, precise_spikes_ );
+  // gpuErrchk( cudaDeviceSynchronize() );
+
+  return 0;
+}
+
+int
+iaf_psc_exp_ps::Free()
+{
+  FreeVarArr();
+  FreeParamArr();
+  FreePreciseSpikeArray();
+  delete[] group_param_;
+
+  return 0;
+}
+
+int
+iaf_psc_exp_ps::Calibrate( double, float time_resolution )
+{
+  iaf_psc_exp_ps_Calibrate<<< ( n_node_ + 1023 ) / 1024, 1024 >>>( n_node_, param_arr_, n_param_, time_resolution );
+  input_spikes_ = FuseInputSpikes();
+
+  return 0;
+}
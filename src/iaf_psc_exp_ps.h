@@ -0,0 +1,216 @@
+/*
+ *  iaf_psc_exp_ps.h
+ *
+ *  This file is part of NEST GPU.
+ *
+ *  Copyright (C) 2021 The NEST Initiative
+ *
+ *  NEST GPU is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NEST GPU is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NEST GPU.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+// adapted from:
+// https://github.com/nest/nest-simulator/blob/master/models/iaf_psc_exp_ps.h
+
+
+#ifndef IAFPSCEXPPS_H
+#define IAFPSCEXPPS_H
+
+#include "base_neuron.h"
+#include "cuda_error.h"
+#include "neuron_models.h"
+#include "node_group.h"
+#include <iostream>
+#include <string>
+
+
+/* BeginUserDocs: neuron, integrate-and-fire, current-based, precise
+
+Short description
++++++++++++++++++
+
+Leaky integrate-and-fire neuron model with exponential PSCs and
+precise spike timing
+
+Description
++++++++++++
+
+iaf_psc_exp_ps is the precise-spiking version of iaf_psc_exp [1]_ [2]_.
+The emitted spikes are not forced into the time grid: the time of the
+threshold crossing within the time step is located by cubic
+interpolation of the membrane potential, and it is sent to the targets
+as an offset from the end of the time step. The spikes received from
+precise-spiking models are handled at their arrival times within the
+time step, while the spikes of the other models arrive on the grid.
+
+Since the subthreshold dynamics is linear, the state at the end of the
+time step is computed exactly by adding the contributions of the input
+spikes, propagated from their arrival times, to the free evolution of
+the state. Therefore the time step can be considerably larger than the
+one needed by iaf_psc_exp for the same accuracy. The refractory period
+is also handled in continuous time.
+
+The threshold is checked at the end of each time step, so that a threshold
+crossing followed by a return below the threshold within the same time
+step is missed. The spikes coming from remote hosts through MPI lose their
+offsets and arrive on the grid.
+
+The spikes with offset received by a group in a time step are stored in
+an array whose size is max_input_spikes times the number of neurons. The
+spikes exceeding this size are delivered on the grid.
+
+Parameters
+++++++++++
+
+The following parameters can be set in the status dictionary.
+
+================= ======= =====================================================
+ V_m_rel          mV      Membrane potential in mV (relative to resting
+                          potential)
+ I_syn_ex         pA      Excitatory synaptic current
+ I_syn_in         pA      Inhibitory synaptic current
+ refractory_time  ms      Remaining time of the refractory period
+ tau_m            ms      Membrane time constant
+ C_m              pF      Capacity of the membrane
+ E_L              mV      Resting membrane potential
+ I_e              pA      Constant input current
+ Theta_rel        mV      Spike threshold in mV (relative to resting potential)
+ V_reset_rel      mV      Reset membrane potential after a spike
+ tau_ex           ms      Exponential decay time constant of excitatory
+                          synaptic current kernel
+ tau_in           ms      Exponential decay time constant of inhibitory
+                          synaptic current kernel
+ t_ref            ms      Duration of refractory period (V_m = V_reset)
+ den_delay        ms      Dendritic delay
+ max_input_spikes         Maximum mean number of spikes with offset received
+                          by a neuron in a time step (group parameter)
+================= ======= =====================================================
+
+References
+++++++++++
+
+.. [1] Morrison A, Straube S, Plesser H E, Diesmann M (2007). Exact
+       subthreshold integration with continuous spike times in discrete time
+       neural network simulations. Neural Computation 19:47-79.
+       DOI: https://doi.org/10.1162/neco.2007.19.1.47
+.. [2] Hanuschkin A, Kunkel S, Helias M, Morrison A, Diesmann M (2010).
+       A general and efficient methof for incorporating precise spike
+       times in globally time-driven simulations. Frontiers in Neuroinformatics.
+       DOI: https://doi.org/10.3389/fninf.2010.00113
+
+See also
+++++++++
+
+iaf_psc_exp, iaf_psc_alpha_ps
+
+EndUserDocs */
+
+
+namespace iaf_psc_exp_ps_ns
+{
+enum ScalVarIndexes
+{
+  i_I_syn_ex = 0,    // postsynaptic current for exc. inputs
+  i_I_syn_in,        // postsynaptic current for inh. inputs
+  i_V_m_rel,         // membrane potential
+  i_refractory_time, // remaining time of the refractory period
+  // contributions of the spikes with offset received in the time step
+  // to the state at the end of the step
+  i_in_I_syn_ex,
+  i_in_I_syn_in,
+  i_in_V_m_rel,
+  N_SCAL_VAR
+};
+
+enum ScalParamIndexes
+{
+  i_tau_m = 0,   // Membrane time constant in ms
+  i_C_m,         // Membrane capacitance in pF
+  i_E_L,         // Resting potential in mV
+  i_I_e,         // External current in pA
+  i_Theta_rel,   // Threshold, RELATIVE TO RESTING POTENTAIL(!)
+                 // i.e. the real threshold is (E_L_+Theta_rel_)
+  i_V_reset_rel, // relative reset value of the membrane potential
+  i_tau_ex,      // Time constant of excitatory synaptic current in ms
+  i_tau_in,      // Time constant of inhibitory synaptic current in ms
+  i_t_ref,       // Refractory period in ms
+  i_den_delay,   // dendritic backpropagation delay
+  // time evolution operator
+  i_P20,
+  i_P11ex,
+  i_P11in,
+  i_P21ex,
+  i_P21in,
+  i_P22,
+  N_SCAL_PARAM
+};
+
+enum GroupParamIndexes
+{
+  i_max_input_spikes = 0, // size of the array of the spikes with offset
+                          // received in a time step, per neuron
+  N_GROUP_PARAM
+};
+
+
+const std::string iaf_psc_exp_ps_scal_var_name[ N_SCAL_VAR ] = { "I_syn_ex",
+  "I_syn_in",
+  "V_m_rel",
+  "refractory_time",
+  "in_I_syn_ex",
+  "in_I_syn_in",
+  "in_V_m_rel" };
+
+
+const std::string iaf_psc_exp_ps_scal_param_name[ N_SCAL_PARAM ] = { "tau_m",
+  "C_m",
+  "E_L",
+  "I_e",
+  "Theta_rel",
+  "V_reset_rel",
+  "tau_ex",
+  "tau_in",
+  "t_ref",
+  "den_delay",
+  "P20",
+  "P11ex",
+  "P11in",
+  "P21ex",
+  "P21in",
+  "P22" };
+
+const std::string iaf_psc_exp_ps_group_param_name[ N_GROUP_PARAM ] = { "max_input_spikes" };
+
+} // namespace
+
+class iaf_psc_exp_ps : public BaseNeuron
+{
+  InputSpikeArray input_spikes_; // input spikes on the grid, folded by
+                                 // the update kernel
+
+public:
+  ~iaf_psc_exp_ps();
+
+  int Init( int i_node_0, int n_neuron, int n_port, int i_group, unsigned long long* seed );
+
+  int Calibrate( double, float time_resolution );
+
+  int Update( long long it, double t1 );
+
+  int Free();
+};
+
+
+#endif
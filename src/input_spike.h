@@ -0,0 +1,45 @@
+/*
+ *  input_spike.h
+ *
+ *  This file is part of NEST GPU.
+ *
+ *  Copyright (C) 2021 The NEST Initiative
+ *
+ *  NEST GPU is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NEST GPU is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NEST GPU.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+
+#ifndef INPUTSPIKE_H
+#define INPUTSPIKE_H
+
+// Arrays used to fold the spikes received by a node group in the current
+// time step into the input variables of its ports. The models that do it
+// at the beginning of their Update kernel (see BaseNeuron::FuseInputSpikes)
+// receive this structure as kernel argument. n_port_ = 0 disables it.
+struct InputSpikeArray
+{
+  double* spike_array_;
+  int n_node_;
+  int n_port_;
+  float* port_weight_arr_;
+  int port_weight_arr_step_;
+  int port_weight_port_step_;
+  float* port_input_arr_;
+  int port_input_arr_step_;
+  int port_input_port_step_;
+};
+
+#endif
@@ -0,0 +1,223 @@
+/*
+ *  jit_kernel.cu
+ *
+ *  This file is part of NEST GPU.
+ *
+ *  Copyright (C) 2021 The NEST Initiative
+ *
+ *  NEST GPU is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NEST GPU is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NEST GPU.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <config.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#include "cuda_error.h"
+#include "jit_kernel.h"
+#include "ngpu_exception.h"
+#include "spike_buffer.h"
+
+#ifdef HAVE_NVRTC
+#include <cuda.h>
+#include <nvrtc.h>
+
+#define nvrtcErrchk( ans )                      \
+  {                                             \
+    nvrtcAssert( ( ans ), __FILE__, __LINE__ ); \
+  }
+inline void
+nvrtcAssert( nvrtcResult code, const char* file, int line )
+{
+  if ( code != NVRTC_SUCCESS )
+  {
+    fprintf( stderr, "NVRTCassert: %s %s %d\n", nvrtcGetErrorString( code ), file, line );
+    throw ngpu_exception( "NVRTC error" );
+  }
+}
+
+#define cuErrchk( ans )                      \
+  {                                          \
+    cuAssert( ( ans ), __FILE__, __LINE__ ); \
+  }
+inline void
+cuAssert( CUresult code, const char* file, int line )
+{
+  if ( code != CUDA_SUCCESS )
+  {
+    const char* msg = "unknown error";
+    cuGetErrorString( code, &msg );
+    fprintf( stderr, "CUassert: %s %s %d\n", msg, file, line );
+    throw ngpu_exception( "CUDA driver error" );
+  }
+}
+
+// compiles the source to a CUBIN image for the current device
+static int
+JitCompile( const std::string& source,
+  const std::string& kernel_name,
+  const std::vector< std::string >& options,
+  std::string& image )
+{
+  nvrtcProgram prog;
+  nvrtcErrchk( nvrtcCreateProgram( &prog, source.c_str(), ( kernel_name + ".cu" ).c_str(), 0, NULL, NULL ) );
+  std::vector< const char* > opt_pt;
+  for ( unsigned int i = 0; i < options.size(); i++ )
+  {
+    opt_pt.push_back( options[ i ].c_str() );
+  }
+  nvrtcResult res = nvrtcCompileProgram( prog, ( int ) opt_pt.size(), opt_pt.data() );
+  if ( res != NVRTC_SUCCESS )
+  {
+    size_t log_size;
+    nvrtcGetProgramLogSize( prog, &log_size );
+    std::string log( log_size, '\0' );
+    nvrtcGetProgramLog( prog, &log[ 0 ] );
+    nvrtcDestroyProgram( &prog );
+    throw ngpu_exception( "Error compiling kernel " + kernel_name + ":\n" + log + "\n" + source );
+  }
+  size_t image_size;
+  nvrtcErrchk( nvrtcGetCUBINSize( prog, &image_size ) );
+  image.resize( image_size );
+  nvrtcErrchk( nvrtcGetCUBIN( prog, &image[ 0 ] ) );
+  nvrtcErrchk( nvrtcDestroyProgram( &prog ) );
+
+  return 0;
+}
+#endif
+
+// sends the spikes emitted by the compiled kernel to the spike buffers
+__global__ void
+JitPushSpikeKernel( int i_node_0, int* spike_idx, int* n_spike )
+{
+  int i_spike = threadIdx.x + blockIdx.x * blockDim.x;
+  if ( i_spike < *n_spike )
+  {
+    PushSpike( i_node_0 + spike_idx[ i_spike ], 1.0 );
+  }
+}
+
+bool
+JitAvailable()
+{
+#ifdef HAVE_NVRTC
+  return true;
+#else
+  return false;
+#endif
+}
+
+JitKernel::JitKernel()
+{
+  module_ = NULL;
+  function_ = NULL;
+  n_node_ = 0;
+  d_spike_idx_ = NULL;
+  d_n_spike_ = NULL;
+}
+
+JitKernel::~JitKernel()
+{
+  Free();
+}
+
+int
+JitKernel::Compile( const JitSource& jit_source, int n_node )
+{
+#ifndef HAVE_NVRTC
+  throw ngpu_exception( "NEST GPU was built without NVRTC, "
+                        "run-time compilation of kernels is not available" );
+#else
+  Free();
+  int dev;
+  int cc_major;
+  int cc_minor;
+  gpuErrchk( cudaGetDevice( &dev ) );
+  gpuErrchk( cudaDeviceGetAttribute( &cc_major, cudaDevAttrComputeCapabilityMajor, dev ) );
+  gpuErrchk( cudaDeviceGetAttribute( &cc_minor, cudaDevAttrComputeCapabilityMinor, dev ) );
+  std::vector< std::string > options;
+  options.push_back( "--gpu-architecture=sm_" + std::to_string( cc_major * 10 + cc_minor ) );
+
+  // the image also depends on the NVRTC version
+  int nvrtc_major;
+  int nvrtc_minor;
+  nvrtcErrchk( nvrtcVersion( &nvrtc_major, &nvrtc_minor ) );
+  std::vector< std::string > key_options = options;
+  key_options.push_back( "nvrtc " + std::to_string( nvrtc_major ) + "." + std::to_string( nvrtc_minor ) );
+
+  std::string source = jit_source.Source();
+  key_ = JitKey( source, key_options );
+  JitCache cache;
+  std::string image;
+  CUmodule module;
+  // a module that cannot be loaded from the cache is compiled again
+  if ( !cache.Load( key_, image ) || cuModuleLoadData( &module, image.data() ) != CUDA_SUCCESS )
+  {
+    JitCompile( source, jit_source.KernelName(), options, image );
+    cache.Store( key_, image );
+    cuErrchk( cuModuleLoadData( &module, image.data() ) );
+  }
+  CUfunction function;
+  cuErrchk( cuModuleGetFunction( &function, module, jit_source.KernelName().c_str() ) );
+  module_ = module;
+  function_ = function;
+
+  n_node_ = n_node;
+  gpuErrchk( cudaMalloc( &d_spike_idx_, n_node_ * sizeof( int ) ) );
+  gpuErrchk( cudaMalloc( &d_n_spike_, sizeof( int ) ) );
+
+  return 0;
+#endif
+}
+
+int
+JitKernel::Update( int i_node_0, float* var_arr, float* param_arr, cudaStream_t stream )
+{
+#ifdef HAVE_NVRTC
+  gpuErrchk( cudaMemsetAsync( d_n_spike_, 0, sizeof( int ), stream ) );
+  void* args[] = { &n_node_, &var_arr, &param_arr, &d_spike_idx_, &d_n_spike_ };
+  cuErrchk( cuLaunchKernel(
+    ( CUfunction ) function_, ( n_node_ + 1023 ) / 1024, 1, 1, 1024, 1, 1, 0, ( CUstream ) stream, args, NULL ) );
+  JitPushSpikeKernel<<< ( n_node_ + 1023 ) / 1024, 1024, 0, stream >>>( i_node_0, d_spike_idx_, d_n_spike_ );
+#endif
+
+  return 0;
+}
+
+int
+JitKernel::Free()
+{
+#ifdef HAVE_NVRTC
+  if ( module_ != NULL )
+  {
+    cuModuleUnload( ( CUmodule ) module_ );
+  }
+#endif
+  if ( d_spike_idx_ != NULL )
+  {
+    cudaFree( d_spike_idx_ );
+  }
+  if ( d_n_spike_ != NULL )
+  {
+    cudaFree( d_n_spike_ );
+  }
+  module_ = NULL;
+  function_ = NULL;
+  d_spike_idx_ = NULL;
+  d_n_spike_ = NULL;
+
+  return 0;
+}
@@ -0,0 +1,76 @@
+/*
+ *  jit_kernel.h
+ *
+ *  This file is part of NEST GPU.
+ *
+ *  Copyright (C) 2021 The NEST Initiative
+ *
+ *  NEST GPU is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NEST GPU is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NEST GPU.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef JITKERNEL_H
+#define JITKERNEL_H
+
+#include "jit_source.h"
+#include <string>
+
+struct CUstream_st;
+typedef struct CUstream_st* cudaStream_t;
+
+// Neuron update kernel compiled at run time with NVRTC, see JitSource.
+// The compiled modules are kept in a JitCache. The spikes emitted by
+// the kernel are collected in a list of neuron indexes and then sent
+// to the spike buffers by a precompiled kernel
+class JitKernel
+{
+  void* module_;   // CUmodule
+  void* function_; // CUfunction
+  std::string key_;
+  int n_node_;
+  int* d_spike_idx_;
+  int* d_n_spike_;
+
+public:
+  JitKernel();
+
+  ~JitKernel();
+
+  // compiles the kernel, or loads it from the cache
+  int Compile( const JitSource& jit_source, int n_node );
+
+  bool
+  Loaded()
+  {
+    return function_ != NULL;
+  }
+
+  std::string
+  Key()
+  {
+    return key_;
+  }
+
+  // updates the neurons i_node_0, ..., i_node_0 + n_node - 1,
+  // launching the kernels in the given stream
+  int Update( int i_node_0, float* var_arr, float* param_arr, cudaStream_t stream );
+
+  int Free();
+};
+
+// false if NEST GPU was built without NVRTC
+bool JitAvailable();
+
+#endif
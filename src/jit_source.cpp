@@ -0,0 +1,247 @@
+/*
+ *  jit_source.cpp
+ *
+ *  This file is part of NEST GPU.
+ *
+ *  Copyright (C) 2021 The NEST Initiative
+ *
+ *  NEST GPU is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NEST GPU is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NEST GPU.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include <vector>
+
+#include "jit_source.h"
+
+JitSource::JitSource( std::string kernel_name, int n_var, int n_param )
+{
+  kernel_name_ = kernel_name;
+  n_var_ = n_var;
+  n_param_ = n_param;
+}
+
+int
+JitSource::AddVar( std::string name, int i_var )
+{
+  define_vect_.push_back( "#define " + name + " var[ " + std::to_string( i_var ) + " ]" );
+
+  return 0;
+}
+
+int
+JitSource::AddParam( std::string name, int i_param )
+{
+  define_vect_.push_back( "#define " + name + " param[ " + std::to_string( i_param ) + " ]" );
+
+  return 0;
+}
+
+int
+JitSource::AddConst( std::string name, float val )
+{
+  define_vect_.push_back( "#define " + name + " " + JitFloatLiteral( val ) );
+
+  return 0;
+}
+
+int
+JitSource::SetBody( std::string body )
+{
+  body_ = body;
+
+  return 0;
+}
+
+std::string
+JitSource::KernelName() const
+{
+  return kernel_name_;
+}
+
+std::string
+JitSource::Source() const
+{
+  std::string src = "// update kernel generated by NEST GPU\n";
+  src += "#define N_VAR " + std::to_string( n_var_ ) + "\n";
+  src += "#define N_PARAM " + std::to_string( n_param_ ) + "\n";
+  src += "#define EmitSpike() spike_idx[ atomicAdd( n_spike, 1 ) ] = i_neuron\n";
+  for ( unsigned int i = 0; i < define_vect_.size(); i++ )
+  {
+    src += define_vect_[ i ] + "\n";
+  }
+  src += "\nextern \"C\" __global__ void\n";
+  src += kernel_name_ + "( int n_node, float* var_arr, float* param_arr, int* spike_idx, int* n_spike )\n";
+  src += "{\n";
+  src += "  int i_neuron = threadIdx.x + blockIdx.x * blockDim.x;\n";
+  src += "  if ( i_neuron < n_node )\n";
+  src += "  {\n";
+  src += "    float* var = var_arr + N_VAR * i_neuron;\n";
+  src += "    float* param = param_arr + N_PARAM * i_neuron;\n";
+  src += "    ( void ) param;\n";
+  src += body_;
+  src += "  }\n";
+  src += "}\n";
+
+  return src;
+}
+
+std::string
+JitFloatLiteral( float val )
+{
+  char buf[ 64 ];
+  if ( std::isfinite( val ) )
+  {
+    // 9 significant digits are enough to recover a float exactly
+    snprintf( buf, sizeof( buf ), "(%.8ef)", val );
+  }
+  else
+  {
+    unsigned int bits;
+    memcpy( &bits, &val, sizeof( float ) );
+    snprintf( buf, sizeof( buf ), "__int_as_float( 0x%08x )", bits );
+  }
+
+  return std::string( buf );
+}
+
+unsigned long long
+JitHash( const std::string& s )
+{
+  unsigned long long h = 14695981039346656037ULL;
+  for ( unsigned int i = 0; i < s.size(); i++ )
+  {
+    h ^= ( unsigned char ) s[ i ];
+    h *= 1099511628211ULL;
+  }
+
+  return h;
+}
+
+std::string
+JitKey( const std::string& source, const std::vector< std::string >& options )
+{
+  std::string s = source;
+  for ( unsigned int i = 0; i < options.size(); i++ )
+  {
+    // the separator cannot appear in the options
+    s += '\0' + options[ i ];
+  }
+  char buf[ 32 ];
+  snprintf( buf, sizeof( buf ), "%016llx", JitHash( s ) );
+
+  return std::string( buf );
+}
+
+JitCache::JitCache( std::string dir )
+{
+  if ( dir.empty() )
+  {
+    const char* env_dir = getenv( "NESTGPU_JIT_CACHE_DIR" );
+    const char* xdg_dir = getenv( "XDG_CACHE_HOME" );
+    const char* home_dir = getenv( "HOME" );
+    if ( env_dir != NULL && env_dir[ 0 ] != '\0' )
+    {
+      dir = env_dir;
+    }
+    else if ( xdg_dir != NULL && xdg_dir[ 0 ] != '\0' )
+    {
+      dir = std::string( xdg_dir ) + "/nestgpu/jit";
+    }
+    else if ( home_dir != NULL && home_dir[ 0 ] != '\0' )
+    {
+      dir = std::string( home_dir ) + "/.cache/nestgpu/jit";
+    }
+    else
+    {
+      dir = "/tmp/nestgpu_jit";
+    }
+  }
+  dir_ = dir;
+}
+
+std::string
+JitCache::Dir() const
+{
+  return dir_;
+}
+
+std::string
+JitCache::Path( const std::string& key ) const
+{
+  return dir_ + "/" + key + ".cubin";
+}
+
+bool
+JitCache::Load( const std::string& key, std::string& image ) const
+{
+  FILE* fp = fopen( Path( key ).c_str(), "rb" );
+  if ( fp == NULL )
+  {
+    return false;
+  }
+  image.clear();
+  char buf[ 65536 ];
+  size_t n;
+  while ( ( n = fread( buf, 1, sizeof( buf ), fp ) ) > 0 )
+  {
+    image.append( buf, n );
+  }
+  bool ok = !ferror( fp ) && !image.empty();
+  fclose( fp );
+
+  return ok;
+}
+
+int
+JitCache::Store( const std::string& key, const std::string& image ) const
+{
+  // create the directory and its parents
+  for ( size_t pos = 1; pos <= dir_.size(); pos++ )
+  {
+    if ( pos == dir_.size() || dir_[ pos ] == '/' )
+    {
+      std::string sub_dir = dir_.substr( 0, pos );
+      if ( mkdir( sub_dir.c_str(), 0755 ) != 0 && errno != EEXIST )
+      {
+        return -1;
+      }
+    }
+  }
+  // the module is written in a temporary file and then renamed, so that
+  // other processes never load a partially written module
+  std::string tmp_path = Path( key ) + ".tmp" + std::to_string( ( long ) getpid() );
+  FILE* fp = fopen( tmp_path.c_str(), "wb" );
+  if ( fp == NULL )
+  {
+    return -1;
+  }
+  size_t n = fwrite( image.data(), 1, image.size(), fp );
+  if ( fclose( fp ) != 0 || n != image.size() || rename( tmp_path.c_str(), Path( key ).c_str() ) != 0 )
+  {
+    remove( tmp_path.c_str() );
+    return -1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,105 @@
+/*
+ *  jit_source.h
+ *
+ *  This file is part of NEST GPU.
+ *
+ *  Copyright (C) 2021 The NEST Initiative
+ *
+ *  NEST GPU is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NEST GPU is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NEST GPU.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/////////////////////////////////////////////////////////////////
+// Source generation and on-disk cache of the neuron update kernels
+// compiled at run time. This part does not depend on CUDA, the
+// compilation is done in jit_kernel.cu
+/////////////////////////////////////////////////////////////////
+
+#ifndef JITSOURCE_H
+#define JITSOURCE_H
+
+#include <string>
+#include <vector>
+
+// Source of the update kernel of a neuron group. The kernel has the
+// signature
+//   extern "C" __global__ void kernel_name( int n_node, float* var_arr,
+//     float* param_arr, int* spike_idx, int* n_spike )
+// and runs the body with one thread per neuron. In the body the state
+// variables and the parameters are accessed by name through the macros
+// defined with AddVar, AddParam and AddConst, and a spike is emitted
+// with EmitSpike(), which appends the neuron index to spike_idx.
+// The parameters added with AddConst have the same value in all the
+// neurons of the group and are written in the source as literals
+class JitSource
+{
+  std::string kernel_name_;
+  int n_var_;
+  int n_param_;
+  std::vector< std::string > define_vect_;
+  std::string body_;
+
+public:
+  JitSource( std::string kernel_name, int n_var, int n_param );
+
+  // state variable of index i_var in the variable array of the neuron
+  int AddVar( std::string name, int i_var );
+
+  // parameter of index i_param in the parameter array of the neuron
+  int AddParam( std::string name, int i_param );
+
+  // group constant
+  int AddConst( std::string name, float val );
+
+  int SetBody( std::string body );
+
+  std::string KernelName() const;
+
+  std::string Source() const;
+};
+
+// float literal that is converted back to the same value
+std::string JitFloatLiteral( float val );
+
+// 64-bit FNV-1a hash
+unsigned long long JitHash( const std::string& s );
+
+// key of a compiled module, from its source and the compilation options
+std::string JitKey( const std::string& source, const std::vector< std::string >& options );
+
+// Directory of compiled modules. Each module is stored in a file
+// named after its key, so that a kernel with the same source and
+// options is loaded from the disk instead of being compiled again
+class JitCache
+{
+  std::string dir_;
+
+public:
+  // if dir is empty, the directory is taken from the environment variable
+  // NESTGPU_JIT_CACHE_DIR, or else it is nestgpu/jit in the user cache dir
+  JitCache( std::string dir = "" );
+
+  std::string Dir() const;
+
+  std::string Path( const std::string& key ) const;
+
+  // returns false if the module is not in the cache
+  bool Load( const std::string& key, std::string& image ) const;
+
+  // returns -1 if the module could not be written, the cache is optional
+  // and the simulation can go on without it
+  int Store( const std::string& key, const std::string& image ) const;
+};
+
+#endif
@@ -21,15 +21,19 @@
  */
 
 
+#include "buffer_pool.h"
 #include "cuda_error.h"
 #include "get_spike.h"
 #include "send_spike.h"
 #include "spike_buffer.h"
 #include <algorithm>
+#include <climits>
 #include <cmath>
 #include <config.h>
+#include <cstring>
 #include <curand.h>
 #include <iostream>
+#include <map>
 #include <stdint.h>
 #include <stdio.h>
 #include <string>
@@ -44,6 +48,7 @@
 #include "rev_spike.h"
 #include "spike_generator.h"
 #include "spike_mpi.h"
+#include "stream_pool.h"
 
 #ifdef HAVE_MPI
 #include <mpi.h>
@@ -72,12 +77,16 @@ enum KernelIntParamIndexes
   i_verbosity_level,
   i_max_spike_buffer_size,
   i_remote_spike_height_flag,
+  i_n_streams,
   N_KERNEL_INT_PARAM
 };
 
 enum KernelBoolParamIndexes
 {
   i_print_time,
+  i_merge_node_groups,
+  i_merge_dir_conn,
+  i_rev_conn_on_device,
   N_KERNEL_BOOL_PARAM
 };
 
@@ -88,17 +97,21 @@ const std::string kernel_float_param_name[ N_KERNEL_FLOAT_PARAM ] = { "time_reso
 const std::string kernel_int_param_name[ N_KERNEL_INT_PARAM ] = { "rnd_seed",
   "verbosity_level",
   "max_spike_buffer_size",
-  "remote_spike_height_flag" };
+  "remote_spike_height_flag",
+  "n_streams" };
 
-const std::string kernel_bool_param_name[ N_KERNEL_BOOL_PARAM ] = { "print_time" };
+const std::string kernel_bool_param_name[ N_KERNEL_BOOL_PARAM ] = { "print_time",
+  "merge_node_groups",
+  "merge_dir_conn",
+  "rev_conn_on_device" };
 
 NESTGPU::NESTGPU()
 {
   random_generator_ = new curandGenerator_t;
   CURAND_CALL( curandCreateGenerator( random_generator_, CURAND_RNG_PSEUDO_DEFAULT ) );
-  poiss_generator_ = new PoissonGenerator;
   multimeter_ = new Multimeter;
   net_connection_ = new NetConnection;
+  stream_pool_ = new StreamPool;
 
 
   calibrate_flag_ = false;
@@ -107,7 +120,6 @@ NESTGPU::NESTGPU()
   max_spike_buffer_size_ = 20;
   t_min_ = 0.0;
   sim_time_ = 1000.0; // Simulation time in ms
-  n_poiss_node_ = 0;
   n_remote_node_ = 0;
   SetTimeResolution( 0.1 ); // time resolution in ms
   max_spike_num_fact_ = 1.0;
@@ -121,6 +133,10 @@ NESTGPU::NESTGPU()
 
   verbosity_level_ = 4;
   print_time_ = false;
+  merge_node_groups_ = true;
+  merge_dir_conn_ = false;
+  rev_conn_on_device_ = true;
+  n_streams_ = 0;
 
   mpi_flag_ = false;
 #ifdef HAVE_MPI
@@ -169,7 +185,8 @@ NESTGPU::~NESTGPU()
 
   delete net_connection_;
   delete multimeter_;
-  delete poiss_generator_;
+  delete stream_pool_;
+  NodeAccessBufferPool.Free();
   curandDestroyGenerator( *random_generator_ );
   delete random_generator_;
 }
@@ -185,7 +202,6 @@ NESTGPU::SetRandomSeed( unsigned long long seed )
   random_generator_ = new curandGenerator_t;
   CURAND_CALL( curandCreateGenerator( random_generator_, CURAND_RNG_PSEUDO_DEFAULT ) );
   CURAND_CALL( curandSetPseudoRandomGeneratorSeed( *random_generator_, seed ) );
-  poiss_generator_->random_generator_ = random_generator_;
 
   return 0;
 }
@@ -264,23 +280,15 @@ NodeSeq
 NESTGPU::CreatePoissonGenerator( int n_node, float rate )
 {
   CheckUncalibrated( "Poisson generator cannot be created after calibration" );
-  if ( n_poiss_node_ != 0 )
-  {
-    throw ngpu_exception( "Number of poisson generators cannot be modified." );
-  }
-  else if ( n_node <= 0 )
+  if ( n_node <= 0 )
   {
     throw ngpu_exception( "Number of nodes must be greater than zero." );
   }
 
-  n_poiss_node_ = n_node;
-
-  BaseNeuron* bn = new BaseNeuron;
-  node_vect_.push_back( bn );
+  PoissonGenerator* pg = new PoissonGenerator;
+  node_vect_.push_back( pg );
   int i_node_0 = CreateNodeGroup( n_node, 0 );
-
-  float lambda = rate * time_resolution_ / 1000.0; // rate is in Hz, time in ms
-  poiss_generator_->Create( random_generator_, i_node_0, n_node, lambda );
+  pg->SetScalParam( 0, n_node, "rate", rate );
 
   return NodeSeq( i_node_0, n_node );
 }
@@ -326,6 +334,26 @@ NESTGPU::Calibrate()
     ( int ) round( max_spike_per_host_fact_ * net_connection_->connection_.size() * net_connection_->MaxDelayNum() );
   max_spike_per_host_ = ( max_spike_per_host_ > 1 ) ? max_spike_per_host_ : 1;
 
+  // the spike offsets are stored only if some node emits spikes with offset
+  SpikeOffsetFlag = false;
+  for ( unsigned int i = 0; i < node_vect_.size(); i++ )
+  {
+    if ( node_vect_[ i ]->precise_spike_ )
+    {
+      SpikeOffsetFlag = true;
+    }
+  }
+  // the time of the last spike is stored in the connections only
+  // for the synapse models that are not based on traces
+  ConnectionSpikeTimeFlag = false;
+  for ( unsigned int i = 0; i < syn_group_vect_.size(); i++ )
+  {
+    if ( syn_group_vect_[ i ]->type_ != i_stdp_trace_model )
+    {
+      ConnectionSpikeTimeFlag = true;
+    }
+  }
+  RevConnDeviceFlag = rev_conn_on_device_;
   SpikeInit( max_spike_num_ );
   SpikeBufferInit( net_connection_, max_spike_buffer_size_ );
 
@@ -341,14 +369,25 @@ NESTGPU::Calibrate()
   if ( net_connection_->NRevConnections() > 0 )
   {
     RevSpikeInit( net_connection_ );
+    STDPTraceCalibrate();
   }
 
   multimeter_->OpenFiles();
 
+  // the node groups are assigned to the streams of the pool in turn
+  stream_pool_->Init( n_streams_ );
+  for ( unsigned int i = 0; i < node_vect_.size(); i++ )
+  {
+    node_vect_[ i ]->stream_ = stream_pool_->Stream( i );
+  }
   for ( unsigned int i = 0; i < node_vect_.size(); i++ )
   {
     node_vect_[ i ]->Calibrate( t_min_, time_resolution_ );
   }
+  if ( merge_node_groups_ )
+  {
+    MergeNodeGroupUpdates();
+  }
 
   SynGroupCalibrate();
 
@@ -474,6 +513,39 @@ NESTGPU::EndSimulation()
 }
 
 
+// Groups of the same model that can be updated by a single kernel launch
+// are merged in batches, the first group of a batch updates all of them
+int
+NESTGPU::MergeNodeGroupUpdates()
+{
+  for ( unsigned int i = 0; i < node_vect_.size(); i++ )
+  {
+    if ( node_vect_[ i ]->merged_update_ )
+    {
+      continue;
+    }
+    std::vector< BaseNeuron* > group_vect( 1, node_vect_[ i ] );
+    for ( unsigned int j = i + 1; j < node_vect_.size(); j++ )
+    {
+      if ( !node_vect_[ j ]->merged_update_ && node_vect_[ i ]->CanMergeUpdate( node_vect_[ j ] ) )
+      {
+        group_vect.push_back( node_vect_[ j ] );
+        node_vect_[ j ]->merged_update_ = true;
+      }
+    }
+    if ( group_vect.size() > 1 )
+    {
+      node_vect_[ i ]->MergeUpdate( group_vect );
+      if ( verbosity_level_ >= 2 )
+      {
+        std::cout << MpiRankStr() << group_vect.size() << " groups merged with node group " << i << "\n";
+      }
+    }
+  }
+
+  return 0;
+}
+
 int
 NESTGPU::SimulationStep()
 {
@@ -488,18 +560,12 @@ NESTGPU::SimulationStep()
   gpuErrchk( cudaPeekAtLastError() );
   SpikeBufferUpdate_time_ += ( getRealTime() - time_mark );
   time_mark = getRealTime();
-  if ( n_poiss_node_ > 0 )
-  {
-    poiss_generator_->Update( Nt_ - it_ );
-    poisson_generator_time_ += ( getRealTime() - time_mark );
-  }
-  time_mark = getRealTime();
   neural_time_ = neur_t0_ + ( double ) time_resolution_ * ( it_ + 1 );
   gpuErrchk( cudaMemcpyToSymbolAsync( NESTGPUTime, &neural_time_, sizeof( double ) ) );
   long long time_idx = ( int ) round( neur_t0_ / time_resolution_ ) + it_ + 1;
   gpuErrchk( cudaMemcpyToSymbolAsync( NESTGPUTimeIdx, &time_idx, sizeof( long long ) ) );
 
-  if ( ConnectionSpikeTimeFlag )
+  if ( ConnectionSpikeTimeFlag && net_connection_->NRevConnections() > 0 )
   {
     if ( ( time_idx & 0xffff ) == 0x8000 )
     {
@@ -511,10 +577,31 @@ NESTGPU::SimulationStep()
     }
   }
 
+  // the spikes with offset are delivered to the precise-spiking models
+  // before their update, since they arrive within the current time step
+  int n_precise_spikes = 0;
+  if ( SpikeOffsetFlag )
+  {
+    gpuErrchk( cudaMemcpy( &n_precise_spikes, d_SpikeNum, sizeof( int ), cudaMemcpyDeviceToHost ) );
+    if ( n_precise_spikes > 0 )
+    {
+      CollectPreciseSpikeKernel<<< n_precise_spikes, 1024 >>>( n_precise_spikes, d_SpikeTargetNum );
+      gpuErrchk( cudaPeekAtLastError() );
+    }
+  }
+
+  // the groups are updated concurrently in their streams,
+  // the spikes are collected when all of them have been updated
+  stream_pool_->Fork();
   for ( unsigned int i = 0; i < node_vect_.size(); i++ )
   {
-    node_vect_[ i ]->Update( it_, neural_time_ );
+    // merged groups are updated by the first group of their batch
+    if ( !node_vect_[ i ]->merged_update_ )
+    {
+      node_vect_[ i ]->Update( it_, neural_time_ );
+    }
   }
+  stream_pool_->Join();
   gpuErrchk( cudaPeekAtLastError() );
 
   neuron_Update_time_ += ( getRealTime() - time_mark );
@@ -560,12 +647,13 @@ NESTGPU::SimulationStep()
   if ( n_spikes > 0 )
   {
     time_mark = getRealTime();
-    CollectSpikeKernel<<< n_spikes, 1024 >>>( n_spikes, d_SpikeTargetNum );
+    CollectSpikeKernel<<< n_spikes, 1024 >>>( n_spikes, d_SpikeTargetNum, n_precise_spikes );
     gpuErrchk( cudaPeekAtLastError() );
 
     NestedLoop_time_ += ( getRealTime() - time_mark );
   }
   time_mark = getRealTime();
+  stream_pool_->Fork();
   for ( unsigned int i = 0; i < node_vect_.size(); i++ )
   {
     if ( node_vect_[ i ]->has_dir_conn_ )
@@ -573,11 +661,15 @@ NESTGPU::SimulationStep()
       node_vect_[ i ]->SendDirectSpikes( neural_time_, time_resolution_ / 1000.0 );
     }
   }
+  // the input spikes are folded when all of them have been sent
+  stream_pool_->Join();
   poisson_generator_time_ += ( getRealTime() - time_mark );
   time_mark = getRealTime();
+  stream_pool_->Fork();
   for ( unsigned int i = 0; i < node_vect_.size(); i++ )
   {
-    if ( node_vect_[ i ]->n_port_ > 0 )
+    // groups with fused input fold the spikes in their Update kernel
+    if ( node_vect_[ i ]->n_port_ > 0 && !node_vect_[ i ]->fused_input_ )
     {
 
       int grid_dim_x = ( node_vect_[ i ]->n_node_ + 1023 ) / 1024;
@@ -585,7 +677,7 @@ NESTGPU::SimulationStep()
       dim3 grid_dim( grid_dim_x, grid_dim_y );
       // dim3 block_dim(1024,1);
 
-      GetSpikes<<< grid_dim, 1024 >>> // block_dim>>>
+      GetSpikes<<< grid_dim, 1024, 0, node_vect_[ i ]->stream_ >>> // block_dim>>>
         ( node_vect_[ i ]->get_spike_array_,
           node_vect_[ i ]->n_node_,
           node_vect_[ i ]->n_port_,
@@ -598,6 +690,7 @@ NESTGPU::SimulationStep()
           node_vect_[ i ]->port_input_port_step_ );
     }
   }
+  stream_pool_->Join();
   gpuErrchk( cudaPeekAtLastError() );
 
   GetSpike_time_ += ( getRealTime() - time_mark );
@@ -734,11 +827,30 @@ NESTGPU::GetNodeArrayWithOffset( int* i_node, int n_node, int& i_group )
   return nodes;
 }
 
+// After calibration, the direct connections merged from equivalent
+// sources remain valid only if the parameters are changed with the same
+// values for all the nodes of the group
+int
+NESTGPU::CheckMergedDirConn( int i_group, int n_node )
+{
+  if ( calibrate_flag_ && merge_dir_conn_ && node_vect_[ i_group ]->has_dir_conn_
+    && n_node != node_vect_[ i_group ]->n_node_ )
+  {
+    throw ngpu_exception(
+      "With merged direct connections (kernel parameter merge_dir_conn), "
+      "after calibration the parameters of the source nodes can be changed "
+      "only for all the nodes of the same group" );
+  }
+
+  return 0;
+}
+
 int
 NESTGPU::SetNeuronParam( int i_node, int n_node, std::string param_name, float val )
 {
   int i_group;
   int i_neuron = i_node - GetNodeSequenceOffset( i_node, n_node, i_group );
+  CheckMergedDirConn( i_group, n_node );
 
   return node_vect_[ i_group ]->SetScalParam( i_neuron, n_node, param_name, val );
 }
@@ -748,6 +860,7 @@ NESTGPU::SetNeuronParam( int* i_node, int n_node, std::string param_name, float
 {
   int i_group;
   std::vector< int > nodes = GetNodeArrayWithOffset( i_node, n_node, i_group );
+  CheckMergedDirConn( i_group, n_node );
   return node_vect_[ i_group ]->SetScalParam( nodes.data(), n_node, param_name, val );
 }
 
@@ -756,6 +869,7 @@ NESTGPU::SetNeuronParam( int i_node, int n_node, std::string param_name, float*
 {
   int i_group;
   int i_neuron = i_node - GetNodeSequenceOffset( i_node, n_node, i_group );
+  CheckMergedDirConn( i_group, n_node );
   if ( node_vect_[ i_group ]->IsPortParam( param_name ) )
   {
     return node_vect_[ i_group ]->SetPortParam( i_neuron, n_node, param_name, param, array_size );
@@ -771,6 +885,7 @@ NESTGPU::SetNeuronParam( int* i_node, int n_node, std::string param_name, float*
 {
   int i_group;
   std::vector< int > nodes = GetNodeArrayWithOffset( i_node, n_node, i_group );
+  CheckMergedDirConn( i_group, n_node );
   if ( node_vect_[ i_group ]->IsPortParam( param_name ) )
   {
     return node_vect_[ i_group ]->SetPortParam( nodes.data(), n_node, param_name, param, array_size );
@@ -1254,6 +1369,101 @@ NESTGPU::RandomNormalClipped( size_t n, float mean, float stddev, float vmin, fl
   return arr;
 }
 
+// Direct connections of a source group, with the index of the class of
+// equivalent sources (i.e. sources with the same parameters)
+struct DirConnClass
+{
+  DirectConnection dir_conn_;
+  int i_class_;
+};
+
+// Label the nodes of a group with the index of their class of
+// equivalent nodes, i.e. of nodes with equal values of all parameters
+static std::vector< int >
+NodeEquivalenceClasses( BaseNeuron* node_group, int n )
+{
+  std::vector< std::string > param_name = node_group->GetScalParamNames();
+  std::vector< float* > param_arr;
+  for ( unsigned int i_param = 0; i_param < param_name.size(); i_param++ )
+  {
+    param_arr.push_back( node_group->GetScalParam( 0, n, param_name[ i_param ] ) );
+  }
+  std::map< std::vector< float >, int > class_map;
+  std::vector< int > node_class( n );
+  for ( int i_node = 0; i_node < n; i_node++ )
+  {
+    std::vector< float > param( param_arr.size() );
+    for ( unsigned int i_param = 0; i_param < param_arr.size(); i_param++ )
+    {
+      param[ i_param ] = param_arr[ i_param ][ i_node ];
+    }
+    // new classes are labeled with consecutive indexes
+    int i_class = class_map.insert( std::make_pair( param, ( int ) class_map.size() ) ).first->second;
+    node_class[ i_node ] = i_class;
+  }
+  for ( unsigned int i_param = 0; i_param < param_arr.size(); i_param++ )
+  {
+    free( param_arr[ i_param ] );
+  }
+
+  return node_class;
+}
+
+// Replace direct connections with the same target, port, weight and delay
+// from equivalent sources with a single connection of higher multiplicity.
+// For Poisson generators, the sum of the spike counts of the replaced
+// connections has the same distribution as the count of a single
+// connection with rate multiplied by the multiplicity
+static std::vector< DirectConnection >
+MergeDirectConnections( std::vector< DirConnClass >& conn_class_vect )
+{
+  std::sort( conn_class_vect.begin(),
+    conn_class_vect.end(),
+    []( const DirConnClass& a, const DirConnClass& b )
+    {
+      const DirectConnection& ca = a.dir_conn_;
+      const DirectConnection& cb = b.dir_conn_;
+      if ( ca.i_target_ != cb.i_target_ )
+      {
+        return ca.i_target_ < cb.i_target_;
+      }
+      if ( ca.port_ != cb.port_ )
+      {
+        return ca.port_ < cb.port_;
+      }
+      if ( a.i_class_ != b.i_class_ )
+      {
+        return a.i_class_ < b.i_class_;
+      }
+      if ( ca.weight_ != cb.weight_ )
+      {
+        return ca.weight_ < cb.weight_;
+      }
+      return ca.delay_ < cb.delay_;
+    } );
+
+  std::vector< DirectConnection > dir_conn_vect;
+  for ( uint64_t i = 0; i < conn_class_vect.size(); i++ )
+  {
+    const DirectConnection& dir_conn = conn_class_vect[ i ].dir_conn_;
+    if ( i > 0 )
+    {
+      const DirectConnection& prev_conn = conn_class_vect[ i - 1 ].dir_conn_;
+      DirectConnection& last_conn = dir_conn_vect.back();
+      if ( dir_conn.i_target_ == prev_conn.i_target_ && dir_conn.port_ == prev_conn.port_
+        && conn_class_vect[ i ].i_class_ == conn_class_vect[ i - 1 ].i_class_ && dir_conn.weight_ == prev_conn.weight_
+        && dir_conn.delay_ == prev_conn.delay_ && last_conn.multiplicity_ < USHRT_MAX )
+      {
+        last_conn.multiplicity_++;
+        continue;
+      }
+    }
+    dir_conn_vect.push_back( dir_conn );
+  }
+
+  return dir_conn_vect;
+}
+
 int
 NESTGPU::BuildDirectConnections()
 {
@@ -1262,6 +1472,12 @@ NESTGPU::BuildDirectConnections()
     if ( node_vect_[ iv ]->has_dir_conn_ )
     {
       std::vector< DirectConnection > dir_conn_vect;
+      std::vector< DirConnClass > conn_class_vect;
+      std::vector< int > node_class;
+      if ( merge_dir_conn_ )
+      {
+        node_class = NodeEquivalenceClasses( node_vect_[ iv ], node_vect_[ iv ]->n_node_ );
+      }
       int i0 = node_vect_[ iv ]->i_node_0_;
       int n = node_vect_[ iv ]->n_node_;
       for ( int i_source = i0; i_source < i0 + n; i_source++ )
@@ -1276,12 +1492,25 @@ NESTGPU::BuildDirectConnections()
             dir_conn.irel_source_ = i_source - i0;
             dir_conn.i_target_ = tv[ i ].node;
             dir_conn.port_ = tv[ i ].port;
+            dir_conn.multiplicity_ = 1;
             dir_conn.weight_ = tv[ i ].weight;
             dir_conn.delay_ = time_resolution_ * ( conn[ id ].delay + 1 );
-            dir_conn_vect.push_back( dir_conn );
+            if ( merge_dir_conn_ )
+            {
+              DirConnClass conn_class = { dir_conn, node_class[ i_source - i0 ] };
+              conn_class_vect.push_back( conn_class );
+            }
+            else
+            {
+              dir_conn_vect.push_back( dir_conn );
+            }
           }
         }
       }
+      if ( merge_dir_conn_ )
+      {
+        dir_conn_vect = MergeDirectConnections( conn_class_vect );
+      }
       uint64_t n_dir_conn = dir_conn_vect.size();
       node_vect_[ iv ]->n_dir_conn_ = n_dir_conn;
 
@@ -1401,6 +1630,24 @@ NESTGPU::GetNScalParam( int i_node )
   return node_vect_[ i_group ]->GetNScalParam();
 }
 
+std::vector< std::string >
+NESTGPU::GetConstParamNames( int i_node )
+{
+  if ( i_node < 0 || i_node >= ( int ) node_group_map_.size() )
+  {
+    throw ngpu_exception( "Unrecognized node in reading parameter names" );
+  }
+  int i_group = node_group_map_[ i_node ];
+
+  return node_vect_[ i_group ]->GetConstParamNames();
+}
+
+int
+NESTGPU::GetNConstParam( int i_node )
+{
+  return GetConstParamNames( i_node ).size();
+}
+
 std::vector< std::string >
 NESTGPU::GetPortParamNames( int i_node )
 {
@@ -1489,7 +1736,7 @@ NESTGPU::GetConnectionStatus( ConnectionId conn_id )
   {
     int i_source = conn_id.i_source_;
     int i_group = conn_id.i_group_;
-    int i_conn = conn_id.i_conn_;
+    int i_conn = net_connection_->StoredIdx( i_source, i_group, conn_id.i_conn_ );
     int n_spike_buffer = net_connection_->connection_.size();
     conn_stat.weight = 0;
     float* d_weight_pt = h_ConnectionGroupTargetWeight[ i_group * n_spike_buffer + i_source ] + i_conn;
@@ -1501,15 +1748,240 @@ NESTGPU::GetConnectionStatus( ConnectionId conn_id )
 std::vector< ConnectionStatus >
 NESTGPU::GetConnectionStatus( std::vector< ConnectionId >& conn_id_vect )
 {
-  std::vector< ConnectionStatus > conn_stat_vect;
+  ConnectionColumns columns;
+  GetConnectionColumns( conn_id_vect, columns );
+  std::vector< ConnectionStatus > conn_stat_vect( conn_id_vect.size() );
   for ( unsigned int i = 0; i < conn_id_vect.size(); i++ )
   {
-    ConnectionStatus conn_stat = GetConnectionStatus( conn_id_vect[ i ] );
-    conn_stat_vect.push_back( conn_stat );
+    ConnectionStatus& conn_stat = conn_stat_vect[ i ];
+    conn_stat.i_source = columns.i_source[ i ];
+    conn_stat.i_target = columns.i_target[ i ];
+    conn_stat.port = columns.port[ i ];
+    conn_stat.syn_group = columns.syn_group[ i ];
+    conn_stat.delay = columns.delay[ i ];
+    conn_stat.weight = columns.weight[ i ];
   }
   return conn_stat_vect;
 }
 
+int
+NESTGPU::GetConnectionColumns( std::vector< ConnectionId >& conn_id_vect, ConnectionColumns& columns )
+{
+  net_connection_->GetConnectionColumns( conn_id_vect, columns );
+  if ( calibrate_flag_ == true )
+  {
+    // after calibration the weights are read from the GPU, with a single
+    // copy for each run of connections of the same connection group
+    int n_spike_buffer = net_connection_->connection_.size();
+    std::vector< float > h_weight;
+    size_t i = 0;
+    while ( i < conn_id_vect.size() )
+    {
+      int i_source = conn_id_vect[ i ].i_source_;
+      int i_group = conn_id_vect[ i ].i_group_;
+      size_t j = i;
+      int i_conn_min = net_connection_->StoredIdx( i_source, i_group, conn_id_vect[ i ].i_conn_ );
+      int i_conn_max = i_conn_min;
+      while ( j < conn_id_vect.size() && conn_id_vect[ j ].i_source_ == i_source
+        && conn_id_vect[ j ].i_group_ == i_group )
+      {
+        int i_conn = net_connection_->StoredIdx( i_source, i_group, conn_id_vect[ j ].i_conn_ );
+        i_conn_min = std::min( i_conn_min, i_conn );
+        i_conn_max = std::max( i_conn_max, i_conn );
+        j++;
+      }
+      h_weight.resize( i_conn_max - i_conn_min + 1 );
+      float* d_weight_pt = h_ConnectionGroupTargetWeight[ i_group * n_spike_buffer + i_source ] + i_conn_min;
+      gpuErrchk( cudaMemcpy( h_weight.data(), d_weight_pt, h_weight.size() * sizeof( float ), cudaMemcpyDeviceToHost ) );
+      for ( ; i < j; i++ )
+      {
+        int i_conn = net_connection_->StoredIdx( i_source, i_group, conn_id_vect[ i ].i_conn_ );
+        columns.weight[ i ] = h_weight[ i_conn - i_conn_min ];
+      }
+    }
+  }
+
+  return 0;
+}
+
+// Checks that the connections in conn_id_vect exist
+int
+NESTGPU::CheckConnectionIds( std::vector< ConnectionId >& conn_id_vect )
+{
+  int n_spike_buffer = net_connection_->connection_.size();
+  for ( size_t i = 0; i < conn_id_vect.size(); i++ )
+  {
+    int i_source = conn_id_vect[ i ].i_source_;
+    int i_group = conn_id_vect[ i ].i_group_;
+    int i_conn = conn_id_vect[ i ].i_conn_;
+    if ( i_source < 0 || i_source >= n_spike_buffer || i_group < 0
+      || i_group >= ( int ) net_connection_->connection_[ i_source ].size() || i_conn < 0
+      || i_conn >= ( int ) net_connection_->connection_[ i_source ][ i_group ].target_vect.size() )
+    {
+      throw ngpu_exception( "Connection index out of range" );
+    }
+  }
+
+  return 0;
+}
+
+// Copies to the GPU the indexes of the connections in conn_id_vect
+// in the arrays of connection parameters
+int
+NESTGPU::ConnectionWeightIdx( std::vector< ConnectionId >& conn_id_vect, unsigned int** d_conn_idx )
+{
+  int n_spike_buffer = net_connection_->connection_.size();
+  std::vector< unsigned int > h_conn_idx( conn_id_vect.size() );
+  for ( size_t i = 0; i < conn_id_vect.size(); i++ )
+  {
+    int i_source = conn_id_vect[ i ].i_source_;
+    int i_group = conn_id_vect[ i ].i_group_;
+    int i_conn = conn_id_vect[ i ].i_conn_;
+    float* d_weight_pt = h_ConnectionGroupTargetWeight[ i_group * n_spike_buffer + i_source ]
+      + net_connection_->StoredIdx( i_source, i_group, i_conn );
+    h_conn_idx[ i ] = d_weight_pt - d_ConnectionWeight;
+  }
+  gpuErrchk( cudaMalloc( d_conn_idx, conn_id_vect.size() * sizeof( unsigned int ) ) );
+  gpuErrchk( cudaMemcpy(
+    *d_conn_idx, h_conn_idx.data(), conn_id_vect.size() * sizeof( unsigned int ), cudaMemcpyHostToDevice ) );
+
+  return 0;
+}
+
+int
+NESTGPU::GetConnectionWeights( std::vector< ConnectionId >& conn_id_vect, float* weight )
+{
+  int n_conn = conn_id_vect.size();
+  if ( n_conn == 0 )
+  {
+    return 0;
+  }
+  CheckConnectionIds( conn_id_vect );
+  if ( calibrate_flag_ == false )
+  {
+    ConnectionColumns columns;
+    net_connection_->GetConnectionColumns( conn_id_vect, columns );
+    std::copy( columns.weight.begin(), columns.weight.end(), weight );
+    return 0;
+  }
+  unsigned int* d_conn_idx;
+  float* d_weight;
+  ConnectionWeightIdx( conn_id_vect, &d_conn_idx );
+  gpuErrchk( cudaMalloc( &d_weight, n_conn * sizeof( float ) ) );
+  ConnectionWeightGatherKernel<<< ( n_conn + 1023 ) / 1024, 1024 >>>( n_conn, d_conn_idx, d_weight );
+  gpuErrchk( cudaPeekAtLastError() );
+  gpuErrchk( cudaMemcpy( weight, d_weight, n_conn * sizeof( float ), cudaMemcpyDeviceToHost ) );
+  gpuErrchk( cudaFree( d_conn_idx ) );
+  gpuErrchk( cudaFree( d_weight ) );
+
+  return 0;
+}
+
+// After calibration only the weights on the GPU are changed, since they
+// are the only ones used and updated by the simulation
+int
+NESTGPU::SetConnectionWeights( std::vector< ConnectionId >& conn_id_vect, float* weight )
+{
+  int n_conn = conn_id_vect.size();
+  if ( n_conn == 0 )
+  {
+    return 0;
+  }
+  CheckConnectionIds( conn_id_vect );
+  if ( calibrate_flag_ == false )
+  {
+    for ( int i = 0; i < n_conn; i++ )
+    {
+      ConnectionId& conn_id = conn_id_vect[ i ];
+      net_connection_->connection_[ conn_id.i_source_ ][ conn_id.i_group_ ].target_vect[ conn_id.i_conn_ ].weight =
+        weight[ i ];
+    }
+    return 0;
+  }
+  unsigned int* d_conn_idx;
+  float* d_weight;
+  ConnectionWeightIdx( conn_id_vect, &d_conn_idx );
+  gpuErrchk( cudaMalloc( &d_weight, n_conn * sizeof( float ) ) );
+  gpuErrchk( cudaMemcpy( d_weight, weight, n_conn * sizeof( float ), cudaMemcpyHostToDevice ) );
+  ConnectionWeightScatterKernel<<< ( n_conn + 1023 ) / 1024, 1024 >>>( n_conn, d_conn_idx, d_weight );
+  gpuErrchk( cudaPeekAtLastError() );
+  gpuErrchk( cudaDeviceSynchronize() );
+  gpuErrchk( cudaFree( d_conn_idx ) );
+  gpuErrchk( cudaFree( d_weight ) );
+
+  return 0;
+}
+
+// The weights are written as float32 in native byte order. Before
+// calibration they are written in the order in which they will be
+// stored on the GPU, so that the file can be loaded in both phases
+int
+NESTGPU::SaveConnectionWeights( std::string file_name )
+{
+  std::vector< float > h_weight;
+  if ( calibrate_flag_ == true )
+  {
+    h_weight.resize( net_connection_->StoredNConnections() );
+    gpuErrchk(
+      cudaMemcpy( h_weight.data(), d_ConnectionWeight, h_weight.size() * sizeof( float ), cudaMemcpyDeviceToHost ) );
+  }
+  else
+  {
+    h_weight.resize( net_connection_->NConnections() );
+    net_connection_->GetStoredWeights( h_weight.data() );
+  }
+  FILE* fp = fopen( file_name.c_str(), "wb" );
+  if ( fp == NULL )
+  {
+    throw ngpu_exception( std::string( "Cannot open connection weight file " ) + file_name );
+  }
+  size_t n_written = fwrite( h_weight.data(), sizeof( float ), h_weight.size(), fp );
+  fclose( fp );
+  if ( n_written != h_weight.size() )
+  {
+    throw ngpu_exception( std::string( "Error writing connection weight file " ) + file_name );
+  }
+
+  return 0;
+}
+
+int
+NESTGPU::LoadConnectionWeights( std::string file_name )
+{
+  size_t n_conn = calibrate_flag_ ? net_connection_->StoredNConnections() : net_connection_->NConnections();
+  FILE* fp = fopen( file_name.c_str(), "rb" );
+  if ( fp == NULL )
+  {
+    throw ngpu_exception( std::string( "Cannot open connection weight file " ) + file_name );
+  }
+  fseek( fp, 0, SEEK_END );
+  int64_t file_size = ftell( fp );
+  fseek( fp, 0, SEEK_SET );
+  if ( file_size != ( int64_t ) ( n_conn * sizeof( float ) ) )
+  {
+    fclose( fp );
+    throw ngpu_exception( std::string( "Size of connection weight file " ) + file_name
+      + " does not match the number of connections" );
+  }
+  std::vector< float > h_weight( n_conn );
+  size_t n_read = fread( h_weight.data(), sizeof( float ), n_conn, fp );
+  fclose( fp );
+  if ( n_read != n_conn )
+  {
+    throw ngpu_exception( std::string( "Error reading connection weight file " ) + file_name );
+  }
+  if ( calibrate_flag_ == true )
+  {
+    gpuErrchk( cudaMemcpy( d_ConnectionWeight, h_weight.data(), n_conn * sizeof( float ), cudaMemcpyHostToDevice ) );
+  }
+  else
+  {
+    net_connection_->SetStoredWeights( h_weight.data() );
+  }
+
+  return 0;
+}
+
 std::vector< ConnectionId >
 NESTGPU::GetConnections( int i_source, int n_source, int i_target, int n_target, int syn_group )
 {
@@ -1603,6 +2075,46 @@ NESTGPU::ActivateSpikeCount( int i_node, int n_node )
   return 0;
 }
 
+// Set the spike trains of a sequence of spike generators from arrays of
+// events, see spike_generator::SetSpikeEvents
+int
+NESTGPU::SetSpikeGeneratorEvents( int i_node,
+  int n_node,
+  int64_t n_event,
+  int* event_node,
+  float* event_time,
+  float* event_height )
+{
+  CheckUncalibrated( "Spike generator events must be set before calibration" );
+  int i_group;
+  int i_neuron = i_node - GetNodeSequenceOffset( i_node, n_node, i_group );
+  if ( node_vect_[ i_group ]->GetNodeType() != i_spike_generator_model )
+  {
+    throw ngpu_exception( "Spike events can be set only for spike generators" );
+  }
+  spike_generator* sg = ( spike_generator* ) node_vect_[ i_group ];
+
+  return sg->SetSpikeEvents( i_neuron, n_node, n_event, event_node, event_time, event_height );
+}
+
+// Load the spike trains of a sequence of spike generators from a binary
+// file of events, each made of the node index relative to i_node (int32)
+// and the spike time in ms (float32), in native byte order
+int
+NESTGPU::LoadSpikeGeneratorEvents( int i_node, int n_node, std::string file_name )
+{
+  CheckUncalibrated( "Spike generator events must be loaded before calibration" );
+  int i_group;
+  int i_neuron = i_node - GetNodeSequenceOffset( i_node, n_node, i_group );
+  if ( node_vect_[ i_group ]->GetNodeType() != i_spike_generator_model )
+  {
+    throw ngpu_exception( "Spike events can be loaded only for spike generators" );
+  }
+  spike_generator* sg = ( spike_generator* ) node_vect_[ i_group ];
+
+  return sg->LoadSpikeEvents( i_neuron, n_node, file_name );
+}
+
 int
 NESTGPU::ActivateRecSpikeTimes( int i_node, int n_node, int max_n_rec_spike_times )
 {
@@ -1882,6 +2394,12 @@ NESTGPU::GetBoolParam( std::string param_name )
   {
   case i_print_time:
     return print_time_;
+  case i_merge_node_groups:
+    return merge_node_groups_;
+  case i_merge_dir_conn:
+    return merge_dir_conn_;
+  case i_rev_conn_on_device:
+    return rev_conn_on_device_;
   default:
     throw ngpu_exception( std::string( "Unrecognized kernel boolean parameter " ) + param_name );
   }
@@ -1894,9 +2412,18 @@ NESTGPU::SetBoolParam( std::string param_name, bool val )
 
   switch ( i_param )
   {
-  case i_time_resolution:
+  case i_print_time:
     print_time_ = val;
     break;
+  case i_merge_node_groups:
+    merge_node_groups_ = val;
+    break;
+  case i_merge_dir_conn:
+    merge_dir_conn_ = val;
+    break;
+  case i_rev_conn_on_device:
+    rev_conn_on_device_ = val;
+    break;
   default:
     throw ngpu_exception( std::string( "Unrecognized kernel boolean parameter " ) + param_name );
   }
@@ -2059,6 +2586,8 @@ NESTGPU::GetIntParam( std::string param_name )
     return verbosity_level_;
   case i_max_spike_buffer_size:
     return max_spike_buffer_size_;
+  case i_n_streams:
+    return n_streams_;
   case i_remote_spike_height_flag:
 #ifdef HAVE_MPI
     if ( connect_mpi_->remote_spike_height_ )
@@ -2092,6 +2621,10 @@ NESTGPU::SetIntParam( std::string param_name, int val )
   case i_max_spike_per_host_fact:
     SetMaxSpikeBufferSize( val );
     break;
+  case i_n_streams:
+    CheckUncalibrated( "Number of streams cannot be changed after calibration" );
+    n_streams_ = val;
+    break;
   case i_remote_spike_height_flag:
 #ifdef HAVE_MPI
     if ( val == 0 )
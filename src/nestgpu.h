@@ -41,8 +41,8 @@
 class ConnectMpi;
 #endif
 
-class PoissonGenerator;
 class Multimeter;
+class StreamPool;
 class NetConnection;
 struct curandGenerator_st;
 typedef struct curandGenerator_st* curandGenerator_t;
@@ -128,7 +128,6 @@ class NESTGPU
   unsigned long long kernel_seed_;
   bool calibrate_flag_; // becomes true after calibration
 
-  PoissonGenerator* poiss_generator_;
   Multimeter* multimeter_;
   std::vector< BaseNeuron* > node_vect_; // -> node_group_vect
   std::vector< SynModel* > syn_group_vect_;
@@ -157,7 +156,6 @@ class NESTGPU
   double neur_t0_;     // Neural activity simulation time origin
   long long it_;       // simulation time index
   long long Nt_;       // number of simulation time steps
-  int n_poiss_node_;
   int n_remote_node_;
   int i_remote_node_0_;
 
@@ -172,6 +170,11 @@ class NESTGPU
 
   int verbosity_level_;
   bool print_time_;
+  bool merge_node_groups_;  // update groups of the same model together
+  bool merge_dir_conn_;     // merge direct connections from equivalent sources
+  bool rev_conn_on_device_; // build the reverse connection index on the device
+  int n_streams_;           // number of streams for the node groups
+  StreamPool* stream_pool_;
 
   std::vector< RemoteConnection > remote_connection_vect_;
   std::vector< int > ext_neuron_input_spike_node_;
@@ -180,11 +183,15 @@ class NESTGPU
 
   int CreateNodeGroup( int n_neuron, int n_port );
   int CheckUncalibrated( std::string message );
+  int CheckMergedDirConn( int i_group, int n_node );
   double* InitGetSpikeArray( int n_node, int n_port );
   int NodeGroupArrayInit();
   int ClearGetSpikeArrays();
   int FreeGetSpikeArrays();
   int FreeNodeGroupMap();
+  int MergeNodeGroupUpdates();
+  int CheckConnectionIds( std::vector< ConnectionId >& conn_id_vect );
+  int ConnectionWeightIdx( std::vector< ConnectionId >& conn_id_vect, unsigned int** d_conn_idx );
 
 
   template < class T1, class T2 >
@@ -223,10 +230,42 @@ class NESTGPU
   int _ConnectFixedTotalNumber( T1 source, int n_source, T2 target, int n_target, int n_conn, SynSpec& syn_spec );
 
   template < class T1, class T2 >
-  int _ConnectFixedIndegree( T1 source, int n_source, T2 target, int n_target, int indegree, SynSpec& syn_spec );
+  int _ConnectFixedIndegree( T1 source,
+    int n_source,
+    T2 target,
+    int n_target,
+    int indegree,
+    bool allow_autapses,
+    bool allow_multapses,
+    SynSpec& syn_spec );
+
+  template < class T1, class T2 >
+  int _ConnectFixedOutdegree( T1 source,
+    int n_source,
+    T2 target,
+    int n_target,
+    int outdegree,
+    bool allow_autapses,
+    bool allow_multapses,
+    SynSpec& syn_spec );
 
   template < class T1, class T2 >
-  int _ConnectFixedOutdegree( T1 source, int n_source, T2 target, int n_target, int outdegree, SynSpec& syn_spec );
+  int _ConnectPairwiseBernoulli( T1 source,
+    int n_source,
+    T2 target,
+    int n_target,
+    float p,
+    bool allow_autapses,
+    SynSpec& syn_spec );
+
+  template < class T1, class T2 >
+  int _ConnectSpatialPairwise( T1 source,
+    int n_source,
+    T2 target,
+    int n_target,
+    SpatialKernel& kernel,
+    bool allow_autapses,
+    SynSpec& syn_spec );
 
 #ifdef HAVE_MPI
   template < class T1, class T2 >
@@ -261,6 +300,8 @@ class NESTGPU
     RemoteNode< T2 > target,
     int n_target,
     int indegree,
+    bool allow_autapses,
+    bool allow_multapses,
     SynSpec& syn_spec );
 
   template < class T1, class T2 >
@@ -269,10 +310,20 @@ class NESTGPU
     RemoteNode< T2 > target,
     int n_target,
     int outdegree,
+    bool allow_autapses,
+    bool allow_multapses,
     SynSpec& syn_spec );
 #endif
   int ConnectRemoteNodes();
 
+  unsigned long long ConnSamplerSeed();
+
+  int InitSynSpecDistributions( SynSpec& syn_spec );
+
+  int GatherNodePositions( std::vector< int >& node_vect, std::vector< float >& pos_vect );
+
+  SpatialExtent GetSpatialExtent( int i_node, std::vector< float >& pos_vect, int n_dim );
+
   double SpikeBufferUpdate_time_;
   double poisson_generator_time_;
   double neuron_Update_time_;
@@ -329,6 +380,27 @@ public:
     return 0;
   }
 
+  inline int
+  SetMergeNodeGroups( bool merge_node_groups )
+  {
+    merge_node_groups_ = merge_node_groups;
+    return 0;
+  }
+
+  inline int
+  SetMergeDirConn( bool merge_dir_conn )
+  {
+    merge_dir_conn_ = merge_dir_conn;
+    return 0;
+  }
+
+  inline int
+  SetRevConnOnDevice( bool rev_conn_on_device )
+  {
+    rev_conn_on_device_ = rev_conn_on_device;
+    return 0;
+  }
+
 
   int SetMaxSpikeBufferSize( int max_size );
   int GetMaxSpikeBufferSize();
@@ -394,6 +466,25 @@ public:
     return SetNeuronParam( nodes.data(), nodes.size(), param_name, param, array_size );
   }
 
+  // pos[i*n_dim + i_dim] is the position of the node i_node+i along i_dim
+  int SetNodePositions( int i_node, int n_node, float* pos, int n_dim );
+
+  int
+  SetNodePositions( NodeSeq nodes, float* pos, int n_dim )
+  {
+    return SetNodePositions( nodes.i0, nodes.n, pos, n_dim );
+  }
+
+  // region containing the positions of the node group of i_node.
+  // If it is not set, the bounding box of the source nodes is used
+  int SetSpatialExtent( int i_node, float* lower_left, float* extent, int n_dim, bool periodic );
+
+  int
+  SetSpatialExtent( NodeSeq nodes, float* lower_left, float* extent, int n_dim, bool periodic )
+  {
+    return SetSpatialExtent( nodes.i0, lower_left, extent, n_dim, periodic );
+  }
+
   int SetNeuronIntVar( int i_node, int n_neuron, std::string var_name, int val );
 
   int SetNeuronIntVar( int* i_node, int n_neuron, std::string var_name, int val );
@@ -703,6 +794,12 @@ public:
 
   int GetNScalParam( int i_node );
 
+  // scalar parameters folded in the constant-memory block at calibration,
+  // because they have the same value in all the neurons of the group
+  std::vector< std::string > GetConstParamNames( int i_node );
+
+  int GetNConstParam( int i_node );
+
   std::vector< std::string > GetPortParamNames( int i_node );
 
   int GetNPortParam( int i_node );
@@ -723,6 +820,21 @@ public:
 
   std::vector< ConnectionStatus > GetConnectionStatus( std::vector< ConnectionId >& conn_id_vect );
 
+  // parameters of the connections in conn_id_vect in columnar form
+  int GetConnectionColumns( std::vector< ConnectionId >& conn_id_vect, ConnectionColumns& columns );
+
+  // bulk access to the weights of the connections in conn_id_vect,
+  // after calibration with a single kernel and a single transfer
+  int GetConnectionWeights( std::vector< ConnectionId >& conn_id_vect, float* weight );
+
+  int SetConnectionWeights( std::vector< ConnectionId >& conn_id_vect, float* weight );
+
+  // binary dump of the weights of all the connections, in the order
+  // in which they are stored on the GPU
+  int SaveConnectionWeights( std::string file_name );
+
+  int LoadConnectionWeights( std::string file_name );
+
   std::vector< ConnectionId >
   GetConnections( int i_source, int n_source, int i_target, int n_target, int syn_group = -1 );
 
@@ -760,6 +872,8 @@ public:
 
   int SynGroupCalibrate();
 
+  int STDPTraceCalibrate();
+
   int ActivateSpikeCount( int i_node, int n_node );
 
   int
@@ -768,6 +882,27 @@ public:
     return ActivateSpikeCount( nodes.i0, nodes.n );
   }
 
+  int SetSpikeGeneratorEvents( int i_node,
+    int n_node,
+    int64_t n_event,
+    int* event_node,
+    float* event_time,
+    float* event_height );
+
+  int
+  SetSpikeGeneratorEvents( NodeSeq nodes, int64_t n_event, int* event_node, float* event_time, float* event_height )
+  {
+    return SetSpikeGeneratorEvents( nodes.i0, nodes.n, n_event, event_node, event_time, event_height );
+  }
+
+  int LoadSpikeGeneratorEvents( int i_node, int n_node, std::string file_name );
+
+  int
+  LoadSpikeGeneratorEvents( NodeSeq nodes, std::string file_name )
+  {
+    return LoadSpikeGeneratorEvents( nodes.i0, nodes.n, file_name );
+  }
+
   int ActivateRecSpikeTimes( int i_node, int n_node, int max_n_rec_spike_times );
 
   int
@@ -272,6 +272,28 @@ extern "C"
     END_ERR_PROP return ret;
   }
 
+  int
+  NESTGPU_SetNodePositions( int i_node, int n_node, float* pos, int n_dim )
+  {
+    int ret = 0;
+    BEGIN_ERR_PROP
+    {
+      ret = NESTGPU_instance->SetNodePositions( i_node, n_node, pos, n_dim );
+    }
+    END_ERR_PROP return ret;
+  }
+
+  int
+  NESTGPU_SetSpatialExtent( int i_node, float* lower_left, float* extent, int n_dim, int periodic )
+  {
+    int ret = 0;
+    BEGIN_ERR_PROP
+    {
+      ret = NESTGPU_instance->SetSpatialExtent( i_node, lower_left, extent, n_dim, periodic != 0 );
+    }
+    END_ERR_PROP return ret;
+  }
+
   int
   NESTGPU_SetNeuronPtArrayParam( int* i_node, int n_neuron, char* param_name, float* param, int array_size )
   {
@@ -790,6 +812,30 @@ extern "C"
     END_ERR_PROP return ret;
   }
 
+  int
+  NESTGPU_SetConnSpecFloatParam( char* param_name, float value )
+  {
+    int ret = 0;
+    BEGIN_ERR_PROP
+    {
+      std::string param_name_str = std::string( param_name );
+      ret = ConnSpec_instance.SetParam( param_name_str, value );
+    }
+    END_ERR_PROP return ret;
+  }
+
+  int
+  NESTGPU_ConnSpecIsFloatParam( char* param_name )
+  {
+    int ret = 0;
+    BEGIN_ERR_PROP
+    {
+      std::string param_name_str = std::string( param_name );
+      ret = ConnSpec::IsFloatParam( param_name_str );
+    }
+    END_ERR_PROP return ret;
+  }
+
   int
   NESTGPU_SynSpecInit()
   {
@@ -1120,6 +1166,40 @@ extern "C"
   }
 
 
+  char**
+  NESTGPU_GetConstParamNames( int i_node )
+  {
+    char** ret = NULL;
+    BEGIN_ERR_PROP
+    {
+      std::vector< std::string > var_name_vect = NESTGPU_instance->GetConstParamNames( i_node );
+      char** var_name_array = ( char** ) malloc( var_name_vect.size() * sizeof( char* ) );
+      for ( unsigned int i = 0; i < var_name_vect.size(); i++ )
+      {
+        uint vl = var_name_vect[ i ].length() + 1;
+        char* var_name = ( char* ) malloc( vl * sizeof( char ) );
+
+        std::strncpy( var_name, var_name_vect[ i ].c_str(), vl );
+        var_name_array[ i ] = var_name;
+      }
+      ret = var_name_array;
+    }
+    END_ERR_PROP return ret;
+  }
+
+
+  int
+  NESTGPU_GetNConstParam( int i_node )
+  {
+    int ret = 0;
+    BEGIN_ERR_PROP
+    {
+      ret = NESTGPU_instance->GetNConstParam( i_node );
+    }
+    END_ERR_PROP return ret;
+  }
+
+
   char**
   NESTGPU_GetGroupParamNames( int i_node )
   {
@@ -1373,6 +1453,104 @@ extern "C"
   }
 
 
+  // conn_id_arr contains n_conn triplets (i_source, i_group, i_conn),
+  // the output arrays must have size n_conn
+  int
+  NESTGPU_GetConnectionColumns( int* conn_id_arr,
+    int n_conn,
+    int* i_source,
+    int* i_target,
+    int* port,
+    int* syn_group,
+    float* delay,
+    float* weight )
+  {
+    int ret = 0;
+    BEGIN_ERR_PROP
+    {
+      std::vector< ConnectionId > conn_id_vect( n_conn );
+      for ( int i = 0; i < n_conn; i++ )
+      {
+        conn_id_vect[ i ].i_source_ = conn_id_arr[ i * 3 ];
+        conn_id_vect[ i ].i_group_ = conn_id_arr[ i * 3 + 1 ];
+        conn_id_vect[ i ].i_conn_ = conn_id_arr[ i * 3 + 2 ];
+      }
+      ConnectionColumns columns;
+      NESTGPU_instance->GetConnectionColumns( conn_id_vect, columns );
+      std::copy( columns.i_source.begin(), columns.i_source.end(), i_source );
+      std::copy( columns.i_target.begin(), columns.i_target.end(), i_target );
+      std::copy( columns.port.begin(), columns.port.end(), port );
+      std::copy( columns.syn_group.begin(), columns.syn_group.end(), syn_group );
+      std::copy( columns.delay.begin(), columns.delay.end(), delay );
+      std::copy( columns.weight.begin(), columns.weight.end(), weight );
+
+      ret = 0;
+    }
+    END_ERR_PROP return ret;
+  }
+
+  // conn_id_arr contains n_conn triplets (i_source, i_group, i_conn),
+  // the weight array must have size n_conn
+  int
+  NESTGPU_GetConnectionWeights( int* conn_id_arr, int n_conn, float* weight )
+  {
+    int ret = 0;
+    BEGIN_ERR_PROP
+    {
+      std::vector< ConnectionId > conn_id_vect( n_conn );
+      for ( int i = 0; i < n_conn; i++ )
+      {
+        conn_id_vect[ i ].i_source_ = conn_id_arr[ i * 3 ];
+        conn_id_vect[ i ].i_group_ = conn_id_arr[ i * 3 + 1 ];
+        conn_id_vect[ i ].i_conn_ = conn_id_arr[ i * 3 + 2 ];
+      }
+      ret = NESTGPU_instance->GetConnectionWeights( conn_id_vect, weight );
+    }
+    END_ERR_PROP return ret;
+  }
+
+  int
+  NESTGPU_SetConnectionWeights( int* conn_id_arr, int n_conn, float* weight )
+  {
+    int ret = 0;
+    BEGIN_ERR_PROP
+    {
+      std::vector< ConnectionId > conn_id_vect( n_conn );
+      for ( int i = 0; i < n_conn; i++ )
+      {
+        conn_id_vect[ i ].i_source_ = conn_id_arr[ i * 3 ];
+        conn_id_vect[ i ].i_group_ = conn_id_arr[ i * 3 + 1 ];
+        conn_id_vect[ i ].i_conn_ = conn_id_arr[ i * 3 + 2 ];
+      }
+      ret = NESTGPU_instance->SetConnectionWeights( conn_id_vect, weight );
+    }
+    END_ERR_PROP return ret;
+  }
+
+  int
+  NESTGPU_SaveConnectionWeights( char* file_name )
+  {
+    int ret = 0;
+    BEGIN_ERR_PROP
+    {
+      std::string file_name_str = std::string( file_name );
+      ret = NESTGPU_instance->SaveConnectionWeights( file_name_str );
+    }
+    END_ERR_PROP return ret;
+  }
+
+  int
+  NESTGPU_LoadConnectionWeights( char* file_name )
+  {
+    int ret = 0;
+    BEGIN_ERR_PROP
+    {
+      std::string file_name_str = std::string( file_name );
+      ret = NESTGPU_instance->LoadConnectionWeights( file_name_str );
+    }
+    END_ERR_PROP return ret;
+  }
+
   int
   NESTGPU_CreateSynGroup( char* model_name )
   {
@@ -1489,6 +1667,35 @@ extern "C"
   }
 
 
+  int
+  NESTGPU_SetSpikeGeneratorEvents( int i_node,
+    int n_node,
+    long long n_event,
+    int* event_node,
+    float* event_time,
+    float* event_height )
+  {
+    int ret = 0;
+    BEGIN_ERR_PROP
+    {
+
+      ret = NESTGPU_instance->SetSpikeGeneratorEvents( i_node, n_node, n_event, event_node, event_time, event_height );
+    }
+    END_ERR_PROP return ret;
+  }
+
+  int
+  NESTGPU_LoadSpikeGeneratorEvents( int i_node, int n_node, char* file_name )
+  {
+    int ret = 0;
+    BEGIN_ERR_PROP
+    {
+      std::string file_name_str = std::string( file_name );
+      ret = NESTGPU_instance->LoadSpikeGeneratorEvents( i_node, n_node, file_name_str );
+    }
+    END_ERR_PROP return ret;
+  }
+
   int
   NESTGPU_ActivateRecSpikeTimes( int i_node, int n_node, int max_n_rec_spike_times )
   {
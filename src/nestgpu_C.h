@@ -67,6 +67,10 @@ extern "C"
 
   int NESTGPU_SetNeuronPtScalParam( int* i_node, int n_neuron, char* param_name, float val );
 
+  int NESTGPU_SetNodePositions( int i_node, int n_node, float* pos, int n_dim );
+
+  int NESTGPU_SetSpatialExtent( int i_node, float* lower_left, float* extent, int n_dim, int periodic );
+
   int NESTGPU_SetNeuronPtArrayParam( int* i_node, int n_neuron, char* param_name, float* param, int array_size );
 
   int NESTGPU_IsNeuronScalParam( int i_node, char* param_name );
@@ -157,6 +161,10 @@ extern "C"
 
   int NESTGPU_ConnSpecIsParam( char* param_name );
 
+  int NESTGPU_SetConnSpecFloatParam( char* param_name, float value );
+
+  int NESTGPU_ConnSpecIsFloatParam( char* param_name );
+
   int NESTGPU_SynSpecInit();
 
   int NESTGPU_SetSynSpecIntParam( char* param_name, int value );
@@ -223,6 +231,10 @@ extern "C"
 
   int NESTGPU_GetNScalParam( int i_node );
 
+  char** NESTGPU_GetConstParamNames( int i_node );
+
+  int NESTGPU_GetNConstParam( int i_node );
+
   char** NESTGPU_GetPortParamNames( int i_node );
 
   int NESTGPU_GetNGroupParam( int i_node );
@@ -263,6 +275,23 @@ extern "C"
     float* delay,
     float* weight );
 
+  int NESTGPU_GetConnectionColumns( int* conn_id_arr,
+    int n_conn,
+    int* i_source,
+    int* i_target,
+    int* port,
+    int* syn_group,
+    float* delay,
+    float* weight );
+
+  int NESTGPU_GetConnectionWeights( int* conn_id_arr, int n_conn, float* weight );
+
+  int NESTGPU_SetConnectionWeights( int* conn_id_arr, int n_conn, float* weight );
+
+  int NESTGPU_SaveConnectionWeights( char* file_name );
+
+  int NESTGPU_LoadConnectionWeights( char* file_name );
+
   int NESTGPU_CreateSynGroup( char* model_name );
 
   int NESTGPU_GetSynGroupNParam( int i_syn_group );
@@ -279,6 +308,15 @@ extern "C"
 
   int NESTGPU_ActivateSpikeCount( int i_node, int n_node );
 
+  int NESTGPU_SetSpikeGeneratorEvents( int i_node,
+    int n_node,
+    long long n_event,
+    int* event_node,
+    float* event_time,
+    float* event_height );
+
+  int NESTGPU_LoadSpikeGeneratorEvents( int i_node, int n_node, char* file_name );
+
   int NESTGPU_ActivateRecSpikeTimes( int i_node, int n_node, int max_n_rec_spike_times );
 
   int NESTGPU_SetRecSpikeTimesStep( int i_node, int n_node, int rec_spike_times_step );
@@ -37,9 +37,11 @@
 #include "cuda_error.h"
 #include "ext_neuron.h"
 #include "iaf_psc_alpha.h"
+#include "iaf_psc_alpha_ps.h"
 #include "iaf_psc_exp.h"
 #include "iaf_psc_exp_g.h"
 #include "iaf_psc_exp_hc.h"
+#include "iaf_psc_exp_ps.h"
 #include "izhikevich.h"
 #include "izhikevich_cond_beta.h"
 #include "izhikevich_psc_exp.h"
@@ -91,6 +93,18 @@ NESTGPU::Create( std::string model_name, int n_node /*=1*/, int n_port /*=1*/ )
     iaf_psc_alpha* iaf_psc_alpha_group = new iaf_psc_alpha;
     node_vect_.push_back( iaf_psc_alpha_group );
   }
+  else if ( model_name == neuron_model_name[ i_iaf_psc_exp_ps_model ] )
+  {
+    n_port = 2;
+    iaf_psc_exp_ps* iaf_psc_exp_ps_group = new iaf_psc_exp_ps;
+    node_vect_.push_back( iaf_psc_exp_ps_group );
+  }
+  else if ( model_name == neuron_model_name[ i_iaf_psc_alpha_ps_model ] )
+  {
+    n_port = 2;
+    iaf_psc_alpha_ps* iaf_psc_alpha_ps_group = new iaf_psc_alpha_ps;
+    node_vect_.push_back( iaf_psc_alpha_ps_group );
+  }
   else if ( model_name == neuron_model_name[ i_ext_neuron_model ] )
   {
     ext_neuron* ext_neuron_group = new ext_neuron;
@@ -31,6 +31,8 @@ enum NeuronModels
   i_iaf_psc_exp_hc_model,
   i_iaf_psc_exp_model,
   i_iaf_psc_alpha_model,
+  i_iaf_psc_exp_ps_model,
+  i_iaf_psc_alpha_ps_model,
   i_ext_neuron_model,
   i_aeif_cond_alpha_model,
   i_aeif_cond_beta_model,
@@ -60,6 +62,8 @@ const std::string neuron_model_name[ N_NEURON_MODELS ] = { "",
   "iaf_psc_exp_hc",
   "iaf_psc_exp",
   "iaf_psc_alpha",
+  "iaf_psc_exp_ps",
+  "iaf_psc_alpha_ps",
   "ext_neuron",
   "aeif_cond_alpha",
   "aeif_cond_beta",
@@ -58,6 +58,11 @@ NESTGPU::NodeGroupArrayInit()
     ngs.n_rec_spike_times_ = node_vect_[ i ]->n_rec_spike_times_;
     ngs.max_n_rec_spike_times_ = node_vect_[ i ]->max_n_rec_spike_times_;
     ngs.den_delay_arr_ = node_vect_[ i ]->den_delay_arr_;
+    if ( node_vect_[ i ]->precise_spike_ )
+    {
+      node_vect_[ i ]->InitPreciseSpikeArray();
+    }
+    ngs.precise_spikes_ = node_vect_[ i ]->precise_spikes_;
 
     ngs_vect.push_back( ngs );
   }
@@ -81,6 +86,8 @@ NESTGPU::InitGetSpikeArray( int n_node, int n_port )
   if ( n_node * n_port > 0 )
   {
     gpuErrchk( cudaMalloc( &d_get_spike_array, n_node * n_port * sizeof( double ) ) );
+    // the groups with fused input read the array before it is cleared
+    gpuErrchk( cudaMemset( d_get_spike_array, 0, n_node * n_port * sizeof( double ) ) );
   }
 
   return d_get_spike_array;
@@ -24,6 +24,8 @@
 #ifndef NODEGROUP_H
 #define NODEGROUP_H
 
+#include "precise_spike.h"
+
 #define MAX_N_NODE_GROUPS 128
 
 struct NodeGroupStruct
@@ -39,6 +41,7 @@ struct NodeGroupStruct
   int* n_rec_spike_times_;
   int max_n_rec_spike_times_;
   float* den_delay_arr_;
+  PreciseSpikeArray precise_spikes_;
 };
 
 #endif
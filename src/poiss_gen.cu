@@ -28,6 +28,8 @@
 #include <curand.h>
 #include <curand_kernel.h>
 #include <stdint.h>
+#include <algorithm>
+#include <vector>
 
 #include "nestgpu.h"
 #include "neuron_models.h"
@@ -39,6 +41,31 @@ extern __device__ signed char* NodeGroupMap;
 
 extern __device__ double atomicAddDouble( double* address, double val );
 
+// Grid of blocks of 1024 threads for n_thread threads
+static dim3
+PoissGenGridDim( uint64_t n_thread )
+{
+  unsigned int grid_dim_x, grid_dim_y;
+
+  if ( n_thread < 65536 * 1024 )
+  { // max grid dim * max block dim
+    grid_dim_x = ( n_thread + 1023 ) / 1024;
+    grid_dim_y = 1;
+  }
+  else
+  {
+    grid_dim_x = 64; // I think it's not necessary to increase it
+    if ( n_thread > grid_dim_x * 1024 * 65535 )
+    {
+      throw ngpu_exception( std::string( "Number of direct connections " ) + std::to_string( n_thread )
+        + " larger than threshold " + std::to_string( grid_dim_x * 1024 * 65535 ) );
+    }
+    grid_dim_y = ( n_thread + grid_dim_x * 1024 - 1 ) / ( grid_dim_x * 1024 );
+  }
+
+  return dim3( grid_dim_x, grid_dim_y );
+}
+
 __global__ void
 SetupPoissKernel( curandState* curand_state, uint64_t n_dir_conn, unsigned long long seed )
 {
@@ -67,6 +94,7 @@ PoissGenSendSpikeKernel( curandState* curand_state,
     int irel = dir_conn.irel_source_;
     int i_target = dir_conn.i_target_;
     int port = dir_conn.port_;
+    int multiplicity = dir_conn.multiplicity_;
     float weight = dir_conn.weight_;
     float delay = dir_conn.delay_;
     float* param = param_arr + irel * n_param;
@@ -74,7 +102,7 @@ PoissGenSendSpikeKernel( curandState* curand_state,
 
     if ( ( t_rel >= start ) && ( t_rel <= stop ) )
     {
-      int n = curand_poisson( curand_state + i_conn, time_step * rate );
+      int n = curand_poisson( curand_state + i_conn, time_step * rate * multiplicity );
       if ( n > 0 )
       { // //Send direct spike (i_target, port, weight*n);
         /////////////////////////////////////////////////////////////////
@@ -88,6 +116,75 @@ PoissGenSendSpikeKernel( curandState* curand_state,
   }
 }
 
+// Stateless version: one thread per segment of connections with the
+// same target and port. The Poisson count of each connection is drawn
+// from a Philox generator whose counter is set from the connection index
+// (subsequence) and the time step (offset), so that nothing is stored
+// between time steps; the inputs of the segment are summed in a register
+// and delivered with a single atomic operation
+__global__ void
+PoissGenSendSpikeStatelessKernel( unsigned long long seed,
+  long long i_step,
+  double t,
+  float time_step,
+  float* param_arr,
+  int n_param,
+  uint64_t n_seg,
+  uint64_t* seg_first_conn,
+  int* seg_target,
+  int* seg_port,
+  int* conn_source,
+  unsigned short* conn_multiplicity,
+  float* conn_weight,
+  float* conn_delay )
+{
+  uint64_t blockId = ( uint64_t ) blockIdx.y * gridDim.x + blockIdx.x;
+  uint64_t i_seg = blockId * blockDim.x + threadIdx.x;
+  if ( i_seg < n_seg )
+  {
+    double d_val = 0.0;
+    for ( uint64_t i_conn = seg_first_conn[ i_seg ]; i_conn < seg_first_conn[ i_seg + 1 ]; i_conn++ )
+    {
+      float* param = param_arr + conn_source[ i_conn ] * n_param;
+      double t_rel = t - origin - conn_delay[ i_conn ];
+
+      if ( ( t_rel >= start ) && ( t_rel <= stop ) )
+      {
+        curandStatePhilox4_32_10_t rng_state;
+        // up to 2^16 random numbers per connection and time step
+        curand_init( seed, i_conn, ( unsigned long long ) i_step << 16, &rng_state );
+        int n = curand_poisson( &rng_state, time_step * rate * conn_multiplicity[ i_conn ] );
+        d_val += ( double ) ( conn_weight[ i_conn ] * n );
+      }
+    }
+    if ( d_val != 0.0 )
+    {
+      int i_target = seg_target[ i_seg ];
+      int i_group = NodeGroupMap[ i_target ];
+      int i = seg_port[ i_seg ] * NodeGroupArray[ i_group ].n_node_ + i_target - NodeGroupArray[ i_group ].i_node_0_;
+      atomicAddDouble( &NodeGroupArray[ i_group ].get_spike_array_[ i ], d_val );
+    }
+  }
+}
+
+poiss_gen::~poiss_gen()
+{
+  if ( d_curand_state_ != NULL )
+  {
+    gpuErrchk( cudaFree( d_curand_state_ ) );
+  }
+  if ( d_seg_first_conn_ != NULL )
+  {
+    gpuErrchk( cudaFree( d_seg_first_conn_ ) );
+    gpuErrchk( cudaFree( d_seg_target_ ) );
+    gpuErrchk( cudaFree( d_seg_port_ ) );
+    gpuErrchk( cudaFree( d_conn_source_ ) );
+    gpuErrchk( cudaFree( d_conn_multiplicity_ ) );
+    gpuErrchk( cudaFree( d_conn_weight_ ) );
+    gpuErrchk( cudaFree( d_conn_delay_ ) );
+  }
+  delete[] group_param_;
+}
 
 int
 poiss_gen::Init( int i_node_0, int n_node, int /*n_port*/, int i_group, unsigned long long* seed )
@@ -95,9 +192,22 @@ poiss_gen::Init( int i_node_0, int n_node, int /*n_port*/, int i_group, unsigned
   BaseNeuron::Init( i_node_0, n_node, 0 /*n_port*/, i_group, seed );
   node_type_ = i_poisson_generator_model;
   n_scal_param_ = N_POISS_GEN_SCAL_PARAM;
+  n_group_param_ = N_POISS_GEN_GROUP_PARAM;
   n_param_ = n_scal_param_;
   scal_param_name_ = poiss_gen_scal_param_name;
+  group_param_name_ = poiss_gen_group_param_name;
+  group_param_ = new float[ N_POISS_GEN_GROUP_PARAM ];
   has_dir_conn_ = true;
+  d_curand_state_ = NULL;
+  n_seg_ = 0;
+  d_seg_first_conn_ = NULL;
+  d_seg_target_ = NULL;
+  d_seg_port_ = NULL;
+  d_conn_source_ = NULL;
+  d_conn_multiplicity_ = NULL;
+  d_conn_weight_ = NULL;
+  d_conn_delay_ = NULL;
+  i_step_ = 0;
 
   gpuErrchk( cudaMalloc( &param_arr_, n_node_ * n_param_ * sizeof( float ) ) );
 
@@ -105,33 +215,92 @@ poiss_gen::Init( int i_node_0, int n_node, int /*n_port*/, int i_group, unsigned
   SetScalParam( 0, n_node, "origin", 0.0 );
   SetScalParam( 0, n_node, "start", 0.0 );
   SetScalParam( 0, n_node, "stop", 1.0e30 );
+  SetGroupParam( "stateless", 0.0 );
 
   return 0;
 }
 
+// Sort the direct connections by target and port, group them in segments
+// with the same target and port and replace the array of structures with
+// the arrays used by the stateless kernel
 int
-poiss_gen::Calibrate( double, float )
+poiss_gen::BuildTargetSegments()
 {
-  gpuErrchk( cudaMalloc( &d_curand_state_, n_dir_conn_ * sizeof( curandState ) ) );
+  std::vector< DirectConnection > h_dir_conn( n_dir_conn_ );
+  gpuErrchk( cudaMemcpy(
+    h_dir_conn.data(), d_dir_conn_array_, n_dir_conn_ * sizeof( DirectConnection ), cudaMemcpyDeviceToHost ) );
+  gpuErrchk( cudaFree( d_dir_conn_array_ ) );
+  d_dir_conn_array_ = NULL;
 
-  unsigned int grid_dim_x, grid_dim_y;
+  std::stable_sort( h_dir_conn.begin(),
+    h_dir_conn.end(),
+    []( const DirectConnection& a, const DirectConnection& b )
+    { return a.i_target_ < b.i_target_ || ( a.i_target_ == b.i_target_ && a.port_ < b.port_ ); } );
 
-  if ( n_dir_conn_ < 65536 * 1024 )
-  { // max grid dim * max block dim
-    grid_dim_x = ( n_dir_conn_ + 1023 ) / 1024;
-    grid_dim_y = 1;
+  std::vector< uint64_t > h_seg_first_conn;
+  std::vector< int > h_seg_target;
+  std::vector< int > h_seg_port;
+  std::vector< int > h_conn_source( n_dir_conn_ );
+  std::vector< unsigned short > h_conn_multiplicity( n_dir_conn_ );
+  std::vector< float > h_conn_weight( n_dir_conn_ );
+  std::vector< float > h_conn_delay( n_dir_conn_ );
+  for ( uint64_t i_conn = 0; i_conn < n_dir_conn_; i_conn++ )
+  {
+    const DirectConnection& dir_conn = h_dir_conn[ i_conn ];
+    if ( i_conn == 0 || dir_conn.i_target_ != h_seg_target.back() || dir_conn.port_ != h_seg_port.back() )
+    {
+      h_seg_first_conn.push_back( i_conn );
+      h_seg_target.push_back( dir_conn.i_target_ );
+      h_seg_port.push_back( dir_conn.port_ );
+    }
+    h_conn_source[ i_conn ] = dir_conn.irel_source_;
+    h_conn_multiplicity[ i_conn ] = dir_conn.multiplicity_;
+    h_conn_weight[ i_conn ] = dir_conn.weight_;
+    h_conn_delay[ i_conn ] = dir_conn.delay_;
   }
-  else
+  n_seg_ = h_seg_target.size();
+  h_seg_first_conn.push_back( n_dir_conn_ );
+
+  gpuErrchk( cudaMalloc( &d_seg_first_conn_, ( n_seg_ + 1 ) * sizeof( uint64_t ) ) );
+  gpuErrchk( cudaMalloc( &d_seg_target_, n_seg_ * sizeof( int ) ) );
+  gpuErrchk( cudaMalloc( &d_seg_port_, n_seg_ * sizeof( int ) ) );
+  gpuErrchk( cudaMalloc( &d_conn_source_, n_dir_conn_ * sizeof( int ) ) );
+  gpuErrchk( cudaMalloc( &d_conn_multiplicity_, n_dir_conn_ * sizeof( unsigned short ) ) );
+  gpuErrchk( cudaMalloc( &d_conn_weight_, n_dir_conn_ * sizeof( float ) ) );
+  gpuErrchk( cudaMalloc( &d_conn_delay_, n_dir_conn_ * sizeof( float ) ) );
+  gpuErrchk( cudaMemcpy(
+    d_seg_first_conn_, h_seg_first_conn.data(), ( n_seg_ + 1 ) * sizeof( uint64_t ), cudaMemcpyHostToDevice ) );
+  gpuErrchk( cudaMemcpy( d_seg_target_, h_seg_target.data(), n_seg_ * sizeof( int ), cudaMemcpyHostToDevice ) );
+  gpuErrchk( cudaMemcpy( d_seg_port_, h_seg_port.data(), n_seg_ * sizeof( int ), cudaMemcpyHostToDevice ) );
+  gpuErrchk(
+    cudaMemcpy( d_conn_source_, h_conn_source.data(), n_dir_conn_ * sizeof( int ), cudaMemcpyHostToDevice ) );
+  gpuErrchk( cudaMemcpy( d_conn_multiplicity_,
+    h_conn_multiplicity.data(),
+    n_dir_conn_ * sizeof( unsigned short ),
+    cudaMemcpyHostToDevice ) );
+  gpuErrchk(
+    cudaMemcpy( d_conn_weight_, h_conn_weight.data(), n_dir_conn_ * sizeof( float ), cudaMemcpyHostToDevice ) );
+  gpuErrchk(
+    cudaMemcpy( d_conn_delay_, h_conn_delay.data(), n_dir_conn_ * sizeof( float ), cudaMemcpyHostToDevice ) );
+
+  return 0;
+}
+
+int
+poiss_gen::Calibrate( double, float )
+{
+  if ( group_param_[ i_stateless ] != 0 )
   {
-    grid_dim_x = 64; // I think it's not necessary to increase it
-    if ( n_dir_conn_ > grid_dim_x * 1024 * 65535 )
+    if ( d_seg_first_conn_ == NULL )
     {
-      throw ngpu_exception( std::string( "Number of direct connections " ) + std::to_string( n_dir_conn_ )
-        + " larger than threshold " + std::to_string( grid_dim_x * 1024 * 65535 ) );
+      BuildTargetSegments();
     }
-    grid_dim_y = ( n_dir_conn_ + grid_dim_x * 1024 - 1 ) / ( grid_dim_x * 1024 );
+    return 0;
   }
-  dim3 numBlocks( grid_dim_x, grid_dim_y );
+
+  gpuErrchk( cudaMalloc( &d_curand_state_, n_dir_conn_ * sizeof( curandState ) ) );
+
+  dim3 numBlocks = PoissGenGridDim( n_dir_conn_ );
   SetupPoissKernel<<< numBlocks, 1024 >>>( d_curand_state_, n_dir_conn_, *seed_ );
   gpuErrchk( cudaPeekAtLastError() );
   gpuErrchk( cudaDeviceSynchronize() );
@@ -149,29 +318,40 @@ poiss_gen::Update( long long it, double t1 )
 int
 poiss_gen::SendDirectSpikes( double t, float time_step )
 {
-  unsigned int grid_dim_x, grid_dim_y;
-
-  if ( n_dir_conn_ < 65536 * 1024 )
-  { // max grid dim * max block dim
-    grid_dim_x = ( n_dir_conn_ + 1023 ) / 1024;
-    grid_dim_y = 1;
-  }
-  else
+  if ( group_param_[ i_stateless ] != 0 )
   {
-    grid_dim_x = 64; // I think it's not necessary to increase it
-    if ( n_dir_conn_ > grid_dim_x * 1024 * 65535 )
+    if ( n_seg_ > 0 )
     {
-      throw ngpu_exception( std::string( "Number of direct connections " ) + std::to_string( n_dir_conn_ )
-        + " larger than threshold " + std::to_string( grid_dim_x * 1024 * 65535 ) );
+      dim3 numBlocks = PoissGenGridDim( n_seg_ );
+      // the group index is included in the key, so that different groups
+      // draw independent numbers
+      unsigned long long seed = *seed_ + ( ( unsigned long long ) i_group_ << 32 );
+      PoissGenSendSpikeStatelessKernel<<< numBlocks, 1024, 0, stream_ >>>( seed,
+        i_step_,
+        t,
+        time_step,
+        param_arr_,
+        n_param_,
+        n_seg_,
+        d_seg_first_conn_,
+        d_seg_target_,
+        d_seg_port_,
+        d_conn_source_,
+        d_conn_multiplicity_,
+        d_conn_weight_,
+        d_conn_delay_ );
+      gpuErrchk( cudaPeekAtLastError() );
     }
-    grid_dim_y = ( n_dir_conn_ + grid_dim_x * 1024 - 1 ) / ( grid_dim_x * 1024 );
+    i_step_++;
+
+    return 0;
   }
-  dim3 numBlocks( grid_dim_x, grid_dim_y );
-  PoissGenSendSpikeKernel<<< numBlocks, 1024 >>>(
+
+  dim3 numBlocks = PoissGenGridDim( n_dir_conn_ );
+  PoissGenSendSpikeKernel<<< numBlocks, 1024, 0, stream_ >>>(
     d_curand_state_, t, time_step, param_arr_, n_param_, d_dir_conn_array_, n_dir_conn_ );
 
   gpuErrchk( cudaPeekAtLastError() );
-  gpuErrchk( cudaDeviceSynchronize() );
 
   return 0;
 }
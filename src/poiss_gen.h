@@ -59,6 +59,14 @@ generate a `unique` spike train for each of it's targets. If you do not want
 this behavior and need the same spike train for all targets, you have to use a
 ``parrot_neuron`` between the poisson generator and the targets.
 
+If the kernel parameter ``merge_dir_conn`` is true (default false),
+connections to the same target with the same receptor, weight and delay
+from generators of the same group with equal parameters are merged
+before the simulation into a single connection, whose spike count is
+drawn with the sum of their rates. In this case, after the first
+simulation the parameters can be changed only for all the generators
+of the group at once.
+
 Parameters
 ++++++++++
 
@@ -71,6 +79,18 @@ The following parameters can be set in the status dictionary.
  stop    ms      Deactivation time, relative to origin
 ======== ======= =======================================
 
+The following group parameter applies to all the generators of a group.
+
+========= =========================================================
+stateless If nonzero, the Poisson counts are drawn from a
+          counter-based random number generator (Philox) keyed by
+          the seed, the connection and the time step, so that no
+          random generator state is stored for the connections.
+          The connections are grouped by target and the inputs
+          of a target are summed before being delivered.
+          Default: 0
+========= =========================================================
+
 
 EndUserDocs */
 
@@ -78,7 +98,23 @@ class poiss_gen : public BaseNeuron
 {
   curandState* d_curand_state_;
 
+  // stateless mode: direct connections sorted by target and port
+  // and grouped in segments of connections with the same target and port
+  uint64_t n_seg_;                      // number of segments
+  uint64_t* d_seg_first_conn_;          // first connection of each segment, n_seg_+1
+  int* d_seg_target_;                   // target node of each segment
+  int* d_seg_port_;                     // receptor port of each segment
+  int* d_conn_source_;                  // relative index of the source generator
+  unsigned short* d_conn_multiplicity_; // number of merged connections
+  float* d_conn_weight_;                // connection weight
+  float* d_conn_delay_;                 // connection delay
+  long long i_step_;                    // time step index used as RNG counter
+
+  int BuildTargetSegments();
+
 public:
+  ~poiss_gen();
+
   int Init( int i_node_0, int n_node, int n_port, int i_group, unsigned long long* seed );
 
   int Calibrate( double, float );
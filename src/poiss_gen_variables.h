@@ -42,6 +42,14 @@ const std::string poiss_gen_scal_param_name[ N_POISS_GEN_SCAL_PARAM ] = {
   "stop",
 };
 
+enum PoissGenGroupParamIndexes
+{
+  i_stateless = 0, // if nonzero the spikes are drawn without stored states
+  N_POISS_GEN_GROUP_PARAM
+};
+
+const std::string poiss_gen_group_param_name[ N_POISS_GEN_GROUP_PARAM ] = { "stateless" };
+
 #define rate param[ i_rate ]
 #define origin param[ i_origin ]
 #define start param[ i_start ]
@@ -21,149 +21,227 @@
  */
 
 
+
 #include "cuda_error.h"
 #include "poisson.h"
 #include "spike_buffer.h"
 #include <algorithm>
+#include <cmath>
 #include <config.h>
 #include <cuda.h>
-#include <curand.h>
+#include <curand_kernel.h>
 #include <stdio.h>
 #include <stdlib.h>
 
-__device__ unsigned int* PoissonData;
-
-__global__ void
-PoissonUpdate( unsigned int* poisson_data )
-{
-  PoissonData = poisson_data;
-}
-
+// Draw the number of spikes of each node in the time step i_step,
+// with mean rate*lambda_fact, and push them as a single spike
+// with height equal to their number
 __global__ void
-PoissonSendSpikes( int i_node_0, int n_node )
+PoissonGeneratorUpdate( int i_node_0,
+  int n_node,
+  float* param_arr,
+  int n_param,
+  unsigned long long seed,
+  long long i_step,
+  float lambda_fact )
 {
-  int i_node = threadIdx.x + blockIdx.x * blockDim.x;
-  if ( i_node < n_node )
+  int irel_node = threadIdx.x + blockIdx.x * blockDim.x;
+  if ( irel_node < n_node )
   {
-    int i_node_abs = i_node_0 + i_node;
-    unsigned int height = PoissonData[ i_node ];
-    if ( height > 0 )
+    float lambda = param_arr[ irel_node * n_param + i_poisson_rate ] * lambda_fact;
+    if ( lambda > 0.0 )
     {
-      PushSpike( i_node_abs, ( float ) height );
+      curandStatePhilox4_32_10_t rng_state;
+      // up to 2^16 random numbers per node and time step
+      curand_init( seed, irel_node, ( unsigned long long ) i_step << 16, &rng_state );
+      unsigned int n = curand_poisson( &rng_state, lambda );
+      if ( n > 0 )
+      {
+        PushSpike( i_node_0 + irel_node, ( float ) n );
+      }
     }
   }
 }
 
-__global__ void
-FixPoissonGenerator( unsigned int* poisson_data, int n, float mean )
+PoissonGenerator::~PoissonGenerator()
 {
-  int i = threadIdx.x + blockIdx.x * blockDim.x;
-  if ( i < n )
-  {
-    unsigned int val = poisson_data[ i ];
-    if ( val > mean * 5 )
-    {
-      poisson_data[ i ] = 0;
-    }
-  }
+  FreeParamArr();
+  delete[] group_param_;
 }
 
 int
-PoissonGenerator::Init( curandGenerator_t* random_generator, unsigned int n )
+PoissonGenerator::Init( int i_node_0, int n_node, int /*n_port*/, int i_group, unsigned long long* seed )
 {
-  poisson_data_size_ = n;
-  // Allocate n integers on device
-  CUDA_CALL( cudaMalloc( ( void** ) &dev_poisson_data_, n * sizeof( unsigned int ) ) );
-  random_generator_ = random_generator;
+  BaseNeuron::Init( i_node_0, n_node, 0 /*n_port*/, i_group, seed );
+
+  n_scal_param_ = N_POISSON_SCAL_PARAM;
+  n_group_param_ = N_POISSON_GROUP_PARAM;
+  n_param_ = n_scal_param_;
+
+  AllocParamArr();
+  group_param_ = new float[ N_POISSON_GROUP_PARAM ];
+
+  scal_param_name_ = poisson_scal_param_name;
+  group_param_name_ = poisson_group_param_name;
+  for ( int i = 0; i < N_POISSON_ARRAY_PARAM; i++ )
+  {
+    array_param_name_.push_back( poisson_array_param_name[ i ] );
+  }
+
+  SetScalParam( 0, n_node, "rate", 0.0 ); // in Hz
+  SetGroupParam( "mod_type", i_mod_none );
+  SetGroupParam( "mod_amplitude", 0.0 );
+  SetGroupParam( "mod_frequency", 0.0 ); // in Hz
+  SetGroupParam( "mod_phase", 0.0 );     // in degrees
+
+  time_resolution_ = 0.1;
+  i_step_ = 0;
 
   return 0;
 }
 
 int
-PoissonGenerator::Generate()
+PoissonGenerator::Calibrate( double, float time_resolution )
 {
-  return Generate( n_steps_ );
-}
+  time_resolution_ = time_resolution;
 
-int
-PoissonGenerator::Generate( int max_n_steps )
-{
-  if ( max_n_steps <= 0 )
+  int mod_type = ( int ) group_param_[ i_poisson_mod_type ];
+  if ( mod_type < 0 || mod_type >= N_POISSON_MOD_TYPE )
   {
-    more_steps_ = n_steps_;
+    throw ngpu_exception(
+      std::string( "Unrecognized poisson generator modulation type " ) + std::to_string( mod_type ) );
   }
-  else
+  if ( mod_time_.size() != mod_factor_.size() )
   {
-    more_steps_ = std::min( n_steps_, max_n_steps );
+    throw ngpu_exception( "Poisson generator mod_times and mod_factors must have the same size" );
+  }
+  for ( unsigned int i = 1; i < mod_time_.size(); i++ )
+  {
+    if ( mod_time_[ i ] <= mod_time_[ i - 1 ] )
+    {
+      throw ngpu_exception( "Poisson generator mod_times must be in increasing order" );
+    }
   }
-  // Generate N floats on device
-  CURAND_CALL( curandGeneratePoisson( *random_generator_, dev_poisson_data_, n_node_ * more_steps_, lambda_ ) );
-  FixPoissonGenerator<<< ( n_node_ + 1023 ) / 1024, 1024 >>>( dev_poisson_data_, n_node_ * more_steps_, lambda_ );
 
   return 0;
 }
 
+// Modulation factor of the rate at time t (in ms)
+float
+PoissonGenerator::RateFactor( double t )
+{
+  switch ( ( int ) group_param_[ i_poisson_mod_type ] )
+  {
+  case i_mod_piecewise:
+  {
+    // index of the first modulation time larger than t
+    int k = std::upper_bound( mod_time_.begin(), mod_time_.end(), ( float ) t ) - mod_time_.begin();
+    return k == 0 ? 1.0 : mod_factor_[ k - 1 ];
+  }
+  case i_mod_sinusoidal:
+  {
+    double phase = 2.0 * M_PI * ( group_param_[ i_poisson_mod_frequency ] * t / 1000.0
+                                  + group_param_[ i_poisson_mod_phase ] / 360.0 );
+    float factor = 1.0 + group_param_[ i_poisson_mod_amplitude ] * sin( phase );
+    return factor > 0.0 ? factor : 0.0;
+  }
+  default:
+    return 1.0;
+  }
+}
+
 int
-PoissonGenerator::Free()
+PoissonGenerator::Update( long long, double t1 )
 {
-  CUDA_CALL( cudaFree( dev_poisson_data_ ) );
+  // the modulation is evaluated at the beginning of the time step
+  float lambda_fact = time_resolution_ / 1000.0 * RateFactor( t1 - time_resolution_ );
+  // the group index is included in the key, so that different groups
+  // draw independent numbers
+  unsigned long long seed = *seed_ + ( ( unsigned long long ) i_group_ << 32 );
+
+  PoissonGeneratorUpdate<<< ( n_node_ + 1023 ) / 1024, 1024, 0, stream_ >>>(
+    i_node_0_, n_node_, param_arr_, n_param_, seed, i_step_, lambda_fact );
+  gpuErrchk( cudaPeekAtLastError() );
+  i_step_++;
 
   return 0;
 }
 
-PoissonGenerator::~PoissonGenerator()
+// The modulation arrays are shared by all the nodes of the group
+int
+PoissonGenerator::CheckWholeGroup( int i_neuron, int n_neuron )
 {
-  // Free();
+  if ( i_neuron != 0 || n_neuron != n_node_ )
+  {
+    throw ngpu_exception( "Poisson generator modulation arrays must be set for the whole group" );
+  }
+
+  return 0;
 }
 
-PoissonGenerator::PoissonGenerator()
+int
+PoissonGenerator::SetArrayParam( int i_neuron, int n_neuron, std::string param_name, float* array, int array_size )
 {
-  buffer_size_ = 100000;
-  n_node_ = 0;
+  CheckWholeGroup( i_neuron, n_neuron );
+
+  if ( param_name == array_param_name_[ i_poisson_mod_times ] )
+  {
+    mod_time_ = std::vector< float >( array, array + array_size );
+  }
+  else if ( param_name == array_param_name_[ i_poisson_mod_factors ] )
+  {
+    mod_factor_ = std::vector< float >( array, array + array_size );
+  }
+  else
+  {
+    throw ngpu_exception( std::string( "Unrecognized array parameter " ) + param_name );
+  }
+
+  return 0;
 }
 
 int
-PoissonGenerator::Create( curandGenerator_t* random_generator, int i_node_0, int n_node, float lambda )
+PoissonGenerator::SetArrayParam( int* i_neuron, int n_neuron, std::string param_name, float* array, int array_size )
 {
-  i_node_0_ = i_node_0;
-  n_node_ = n_node;
-  lambda_ = lambda;
-
-  n_steps_ = ( buffer_size_ - 1 ) / n_node + 1;
-  // with the above formula:
-  // buffer_size <= n_node*n_steps <= buffer_size + n_node - 1
-  Init( random_generator, n_node_ * n_steps_ );
-  i_step_ = 0;
+  // a list of nodes is accepted only if it covers the whole group
+  std::vector< int > node_vect( i_neuron, i_neuron + n_neuron );
+  std::sort( node_vect.begin(), node_vect.end() );
+  node_vect.erase( std::unique( node_vect.begin(), node_vect.end() ), node_vect.end() );
+  CheckWholeGroup( node_vect.empty() ? -1 : node_vect[ 0 ], node_vect.size() );
 
-  return 0;
+  return SetArrayParam( 0, n_node_, param_name, array, array_size );
 }
 
 int
-PoissonGenerator::Update( int max_n_steps )
+PoissonGenerator::GetArrayParamSize( int, std::string param_name )
 {
-  if ( i_step_ == 0 )
+  if ( param_name == array_param_name_[ i_poisson_mod_times ] )
   {
-    Generate( max_n_steps );
+    return mod_time_.size();
   }
-
-  if ( i_step_ == more_steps_ )
+  else if ( param_name == array_param_name_[ i_poisson_mod_factors ] )
   {
-    throw ngpu_exception(
-      "Step index larger than maximum number of steps "
-      "in poisson generator" );
+    return mod_factor_.size();
   }
-
-  PoissonUpdate<<< 1, 1 >>>( &dev_poisson_data_[ i_step_ * n_node_ ] );
-  gpuErrchk( cudaPeekAtLastError() );
-
-  PoissonSendSpikes<<< ( n_node_ + 1023 ) / 1024, 1024 >>>( i_node_0_, n_node_ );
-  gpuErrchk( cudaPeekAtLastError() );
-
-  i_step_++;
-  if ( i_step_ == n_steps_ )
+  else
   {
-    i_step_ = 0;
+    throw ngpu_exception( std::string( "Unrecognized parameter " ) + param_name );
   }
+}
 
-  return 0;
+float*
+PoissonGenerator::GetArrayParam( int, std::string param_name )
+{
+  if ( param_name == array_param_name_[ i_poisson_mod_times ] )
+  {
+    return mod_time_.data();
+  }
+  else if ( param_name == array_param_name_[ i_poisson_mod_factors ] )
+  {
+    return mod_factor_.data();
+  }
+  else
+  {
+    throw ngpu_exception( std::string( "Unrecognized parameter " ) + param_name );
+  }
 }
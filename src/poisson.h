@@ -21,45 +21,99 @@
  */
 
 
+
 #ifndef POISSON_H
 #define POISSON_H
-#include <cuda.h>
-#include <curand.h>
 
-extern __device__ unsigned int* PoissonData;
+#include "base_neuron.h"
+#include <string>
+#include <vector>
+
+// Poisson spike generators created by NESTGPU::CreatePoissonGenerator.
+// Unlike poisson_generator, which delivers the spikes through direct
+// connections, these generators emit spikes through the spike buffer,
+// with height equal to the number of spikes drawn in the time step,
+// so that they can be connected with any synapse model and delay.
+// The number of spikes of each node in each time step is drawn from a
+// counter-based random number generator (Philox) keyed by the seed, the
+// group, the node and the time step, with mean rate*h*factor(t), where
+// rate is the scalar parameter of the node and factor(t) a modulation
+// shared by all the nodes of the group, selected by the group parameter
+// mod_type:
+//   0: no modulation, factor(t) = 1
+//   1: piecewise constant, factor(t) = mod_factors[k] with
+//      mod_times[k] <= t < mod_times[k+1], factor(t) = 1 for t < mod_times[0]
+//   2: sinusoidal, factor(t) = 1 + mod_amplitude
+//      * sin(2*pi*mod_frequency*t + mod_phase), clipped at 0
+// t is in ms, mod_frequency in Hz and mod_phase in degrees.
+// The arrays mod_times and mod_factors must be set for the whole group.
+
+enum PoissonGeneratorModType
+{
+  i_mod_none = 0,
+  i_mod_piecewise,
+  i_mod_sinusoidal,
+  N_POISSON_MOD_TYPE
+};
+
+enum PoissonGeneratorScalParamIndexes
+{
+  i_poisson_rate = 0,
+  N_POISSON_SCAL_PARAM
+};
+
+enum PoissonGeneratorGroupParamIndexes
+{
+  i_poisson_mod_type = 0,
+  i_poisson_mod_amplitude,
+  i_poisson_mod_frequency,
+  i_poisson_mod_phase,
+  N_POISSON_GROUP_PARAM
+};
 
-class PoissonGenerator
+enum PoissonGeneratorArrayParamIndexes
 {
-  unsigned int* dev_poisson_data_;
-  int poisson_data_size_;
+  i_poisson_mod_times = 0,
+  i_poisson_mod_factors,
+  N_POISSON_ARRAY_PARAM
+};
 
-  int buffer_size_;
-  int n_steps_;
-  int i_step_;
-  float lambda_;
-  int more_steps_;
-  int i_node_0_;
+const std::string poisson_scal_param_name[ N_POISSON_SCAL_PARAM ] = { "rate" };
 
+const std::string poisson_group_param_name[ N_POISSON_GROUP_PARAM ] = { "mod_type",
+  "mod_amplitude",
+  "mod_frequency",
+  "mod_phase" };
 
-  int Init( curandGenerator_t* random_generator, unsigned int n );
+const std::string poisson_array_param_name[ N_POISSON_ARRAY_PARAM ] = { "mod_times", "mod_factors" };
 
-public:
-  curandGenerator_t* random_generator_;
-  int n_node_;
+class PoissonGenerator : public BaseNeuron
+{
+  float time_resolution_;           // in ms
+  long long i_step_;                // time step index used as RNG counter
+  std::vector< float > mod_time_;   // piecewise-constant modulation times
+  std::vector< float > mod_factor_; // piecewise-constant modulation factors
 
-  PoissonGenerator();
+  float RateFactor( double t );
 
+  int CheckWholeGroup( int i_neuron, int n_neuron );
+
+public:
   ~PoissonGenerator();
 
-  int Free();
+  int Init( int i_node_0, int n_node, int n_port, int i_group, unsigned long long* seed );
+
+  int Calibrate( double time_min, float time_resolution );
+
+  int Update( long long it, double t1 );
 
-  int Create( curandGenerator_t* random_generator, int i_node_0, int n_node, float lambda );
+  int SetArrayParam( int i_neuron, int n_neuron, std::string param_name, float* array, int array_size );
 
-  int Generate();
+  int SetArrayParam( int* i_neuron, int n_neuron, std::string param_name, float* array, int array_size );
 
-  int Generate( int max_n_steps );
+  int GetArrayParamSize( int i_neuron, std::string param_name );
 
-  int Update( int max_n_steps );
+  float* GetArrayParam( int i_neuron, std::string param_name );
 };
 
 #endif
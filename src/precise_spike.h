@@ -0,0 +1,45 @@
+/*
+ *  precise_spike.h
+ *
+ *  This file is part of NEST GPU.
+ *
+ *  Copyright (C) 2021 The NEST Initiative
+ *
+ *  NEST GPU is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NEST GPU is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NEST GPU.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef PRECISESPIKE_H
+#define PRECISESPIKE_H
+
+// Spikes with an offset received in the current time step by a node group
+// of a precise-spiking model (e.g. iaf_psc_exp_ps). The spike offset is
+// the time interval between the spike and the end of the time step in
+// which it is emitted; with integer delays the spike arrives at the same
+// offset from the end of the time step in which it is delivered.
+// The spikes are stored by CollectPreciseSpikeKernel before the update
+// of the nodes, which handles them at their arrival times.
+// n_spike_ = NULL for the groups of the other models.
+struct PreciseSpikeArray
+{
+  int max_n_spike_;
+  int* n_spike_;   // number of spikes stored in the time step
+  int* i_target_;  // index of the target node in the group
+  int* port_;      // receptor port
+  float* weight_;  // spike height times connection weight
+  float* offset_;  // time from the arrival to the end of the time step
+};
+
+#endif
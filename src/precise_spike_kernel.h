@@ -0,0 +1,58 @@
+/*
+ *  precise_spike_kernel.h
+ *
+ *  This file is part of NEST GPU.
+ *
+ *  Copyright (C) 2021 The NEST Initiative
+ *
+ *  NEST GPU is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NEST GPU is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NEST GPU.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef PRECISESPIKEKERNEL_H
+#define PRECISESPIKEKERNEL_H
+
+// Time of the threshold crossing of the membrane potential in a time
+// interval of length dt of a precise-spiking model, relative to the
+// beginning of the interval. The membrane potential relative to the
+// threshold, v0 < 0 and v1 >= 0, and its derivatives, dv0 and dv1, at the
+// boundaries of the interval are interpolated by a cubic Hermite polynomial,
+// whose zero is found by bisection
+__device__ __forceinline__ float
+PreciseSpikeCrossingTime( float v0, float v1, float dv0, float dv1, float dt )
+{
+  float x0 = 0.0;
+  float x1 = 1.0;
+  for ( int i = 0; i < 20; i++ )
+  {
+    float x = 0.5 * ( x0 + x1 );
+    float x2 = x * x;
+    float x3 = x2 * x;
+    float v = ( 2.0 * x3 - 3.0 * x2 + 1.0 ) * v0 + ( x3 - 2.0 * x2 + x ) * dt * dv0 + ( -2.0 * x3 + 3.0 * x2 ) * v1
+      + ( x3 - x2 ) * dt * dv1;
+    if ( v < 0.0 )
+    {
+      x0 = x;
+    }
+    else
+    {
+      x1 = x;
+    }
+  }
+
+  return 0.5 * ( x0 + x1 ) * dt;
+}
+
+#endif
@@ -23,6 +23,7 @@
 
 #include "cuda_error.h"
 #include "spike_buffer.h"
+#include "stdp_trace.h"
 #include "syn_model.h"
 #include <config.h>
 #include <stdio.h>
@@ -39,6 +40,8 @@ int* d_RevSpikeNConn;
 
 extern __device__ void SynapseUpdate( int syn_group, float* w, float Dt );
 
+extern __device__ bool SynapsePostSpikeUpdate( int syn_group, float* w, unsigned int i_conn );
+
 __device__ unsigned int* RevSpikeNum;
 __device__ unsigned int* RevSpikeTarget;
 __device__ int* RevSpikeNConn;
@@ -56,7 +59,15 @@ SynapseUpdateFunction( int i_spike, int i_target_rev_conn )
   if ( syn_group > 0 )
   {
     float* weight = &ConnectionWeight[ i_conn ];
-    unsigned short spike_time_idx = ConnectionSpikeTime[ i_conn ];
+    if ( SynapsePostSpikeUpdate( syn_group, weight, i_conn ) )
+    {
+      return;
+    }
+    // the plastic connections are the last ones of their group
+    int i_conn_group = ConnGroupIdx( i_conn );
+    unsigned int i_plastic =
+      ConnGroupFirstPlastic[ i_conn_group + 1 ] - ( ConnGroupFirstConn[ i_conn_group + 1 ] - i_conn );
+    unsigned short spike_time_idx = ConnectionSpikeTime[ i_plastic ];
     unsigned short time_idx = ( unsigned short ) ( NESTGPUTimeIdx & 0xffff );
     unsigned short Dt_int = time_idx - spike_time_idx;
     if ( Dt_int < MAX_SYN_DT )
@@ -95,6 +106,10 @@ RevSpikeBufferUpdate( unsigned int n_node )
   {
     return;
   }
+  if ( PostTrace != NULL )
+  {
+    PostTraceUpdate( i_node );
+  }
   int n_conn = TargetRevConnectionSize[ i_node ];
   if ( n_conn > 0 )
   {
@@ -164,8 +179,8 @@ RevSpikeReset()
 int
 ResetConnectionSpikeTimeUp( NetConnection* net_connection )
 {
-  ResetConnectionSpikeTimeUpKernel <<< ( net_connection->StoredNConnections() + 1023 ) / 1024, 1024 >>>(
-    net_connection->StoredNConnections() );
+  ResetConnectionSpikeTimeUpKernel <<< ( net_connection->NRevConnections() + 1023 ) / 1024, 1024 >>>(
+    net_connection->NRevConnections() );
   gpuErrchk( cudaPeekAtLastError() );
 
   return 0;
@@ -174,8 +189,8 @@ ResetConnectionSpikeTimeUp( NetConnection* net_connection )
 int
 ResetConnectionSpikeTimeDown( NetConnection* net_connection )
 {
-  ResetConnectionSpikeTimeDownKernel <<< ( net_connection->StoredNConnections() + 1023 ) / 1024, 1024 >>>(
-    net_connection->StoredNConnections() );
+  ResetConnectionSpikeTimeDownKernel <<< ( net_connection->NRevConnections() + 1023 ) / 1024, 1024 >>>(
+    net_connection->NRevConnections() );
   gpuErrchk( cudaPeekAtLastError() );
 
   return 0;
@@ -186,9 +201,12 @@ RevSpikeInit( NetConnection* net_connection )
 {
   int n_spike_buffers = net_connection->connection_.size();
 
-  SetConnectionSpikeTime <<< ( net_connection->StoredNConnections() + 1023 ) / 1024, 1024 >>>(
-    net_connection->StoredNConnections(), 0x8000 );
-  gpuErrchk( cudaPeekAtLastError() );
+  if ( ConnectionSpikeTimeFlag && net_connection->NRevConnections() > 0 )
+  {
+    SetConnectionSpikeTime <<< ( net_connection->NRevConnections() + 1023 ) / 1024, 1024 >>>(
+      net_connection->NRevConnections(), 0x8000 );
+    gpuErrchk( cudaPeekAtLastError() );
+  }
 
   gpuErrchk( cudaMalloc( &d_RevSpikeNum, sizeof( unsigned int ) ) );
 
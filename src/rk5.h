@@ -25,12 +25,41 @@
 #define RK5_H
 
 #include "cuda_error.h"
+#include "fixed_step.h"
+#include "get_spike.h"
+#include "ngpu_exception.h"
 #include "rk5_const.h"
 #include "rk5_interface.h"
+#include "rk5_param.h"
 
 #define MIN( a, b ) ( ( ( a ) < ( b ) ) ? ( a ) : ( b ) )
 #define MAX( a, b ) ( ( ( a ) > ( b ) ) ? ( a ) : ( b ) )
 
+#define FULL_WARP_MASK 0xffffffff
+#define RK5_LARGE_STEP 1.0e30f
+
+// minimum and maximum of a value over the threads of a warp.
+// All the threads of the warp must call them
+__device__ __forceinline__ float
+WarpMin( float val )
+{
+  for ( int offset = 16; offset > 0; offset /= 2 )
+  {
+    val = fminf( val, __shfl_xor_sync( FULL_WARP_MASK, val, offset ) );
+  }
+  return val;
+}
+
+__device__ __forceinline__ float
+WarpMax( float val )
+{
+  for ( int offset = 16; offset > 0; offset /= 2 )
+  {
+    val = fmaxf( val, __shfl_xor_sync( FULL_WARP_MASK, val, offset ) );
+  }
+  return val;
+}
+
 __global__ void SetFloatArray( float* arr, int n_elem, int step, float val );
 
 template < class DataStruct >
@@ -206,6 +235,9 @@ ArrayUpdate( int array_size,
   float* par_arr,
   double x1,
   float h_min,
+  unsigned long long const_mask,
+  int const_offset,
+  InputSpikeArray input_spikes,
   DataStruct data_struct )
 {
   int ArrayIdx = threadIdx.x + blockIdx.x * blockDim.x;
@@ -216,14 +248,12 @@ ArrayUpdate( int array_size,
     float y[ NVAR ];
     float param[ NPARAM ];
 
+    FoldInputSpikes( input_spikes, ArrayIdx );
     for ( int i = 0; i < NVAR; i++ )
     {
       y[ i ] = y_arr[ ArrayIdx * NVAR + i ];
     }
-    for ( int j = 0; j < NPARAM; j++ )
-    {
-      param[ j ] = par_arr[ ArrayIdx * NPARAM + j ];
-    }
+    LoadParam< NPARAM >( param, &par_arr[ ArrayIdx * NPARAM ], const_mask, const_offset );
 
     RK5Update< NVAR, NPARAM, DataStruct >( x, y, x1, h, h_min, param, data_struct );
 
@@ -233,10 +263,203 @@ ArrayUpdate( int array_size,
     {
       y_arr[ ArrayIdx * NVAR + i ] = y[ i ];
     }
-    for ( int j = 0; j < NPARAM; j++ )
+    StoreParam< NPARAM, DataStruct >( &par_arr[ ArrayIdx * NPARAM ], param );
+  }
+}
+
+// Step with a size common to all the threads of a warp. The error is
+// the maximum over the warp, so that all the threads accept or reject
+// the step together and the retry loop does not diverge.
+// Inactive threads take part in the reductions only
+template < int NVAR, int NPARAM, class DataStruct >
+__device__ void
+RK5StepWarp( double& x,
+  float* y,
+  float& h,
+  float h_min,
+  float h_max,
+  float* param,
+  DataStruct data_struct,
+  bool active )
+{
+  float y_new[ NVAR ];
+  float k1[ NVAR ];
+  float k2[ NVAR ];
+  float k3[ NVAR ];
+  float k4[ NVAR ];
+  float k5[ NVAR ];
+  float k6[ NVAR ];
+  float y_scal[ NVAR ];
+
+  if ( active )
+  {
+    Derivatives< NVAR, NPARAM >( x, y, k1, param, data_struct );
+    for ( int i = 0; i < NVAR; i++ )
+    {
+      y_scal[ i ] = fabs( y[ i ] ) + fabs( k1[ i ] * h ) + scal_min;
+    }
+  }
+
+  float err;
+  for ( ;; )
+  {
+    if ( h > h_max )
+    {
+      h = h_max;
+    }
+    if ( h < h_min )
+    {
+      h = h_min;
+    }
+
+    err = 0.0;
+    if ( active )
+    {
+      for ( int i = 0; i < NVAR; i++ )
+      {
+        y_new[ i ] = y[ i ] + h * a21 * k1[ i ];
+      }
+      Derivatives< NVAR, NPARAM >( x + c2 * h, y_new, k2, param, data_struct );
+
+      for ( int i = 0; i < NVAR; i++ )
+      {
+        y_new[ i ] = y[ i ] + h * ( a31 * k1[ i ] + a32 * k2[ i ] );
+      }
+      Derivatives< NVAR, NPARAM >( x + c3 * h, y_new, k3, param, data_struct );
+
+      for ( int i = 0; i < NVAR; i++ )
+      {
+        y_new[ i ] = y[ i ] + h * ( a41 * k1[ i ] + a42 * k2[ i ] + a43 * k3[ i ] );
+      }
+      Derivatives< NVAR, NPARAM >( x + c4 * h, y_new, k4, param, data_struct );
+
+      for ( int i = 0; i < NVAR; i++ )
+      {
+        y_new[ i ] = y[ i ] + h * ( a51 * k1[ i ] + a52 * k2[ i ] + a53 * k3[ i ] + a54 * k4[ i ] );
+      }
+      Derivatives< NVAR, NPARAM >( x + c5 * h, y_new, k5, param, data_struct );
+
+      for ( int i = 0; i < NVAR; i++ )
+      {
+        y_new[ i ] = y[ i ] + h * ( a61 * k1[ i ] + a62 * k2[ i ] + a63 * k3[ i ] + a64 * k4[ i ] + a65 * k5[ i ] );
+      }
+      Derivatives< NVAR, NPARAM >( x + c6 * h, y_new, k6, param, data_struct );
+
+      for ( int i = 0; i < NVAR; i++ )
+      {
+        y_new[ i ] = y[ i ] + h * ( a71 * k1[ i ] + a73 * k3[ i ] + a74 * k4[ i ] + a76 * k6[ i ] );
+      }
+
+      for ( int i = 0; i < NVAR; i++ )
+      {
+        float val = h * ( e1 * k1[ i ] + e3 * k3[ i ] + e4 * k4[ i ] + e5 * k5[ i ] + e6 * k6[ i ] );
+        val /= y_scal[ i ];
+        err = MAX( err, fabs( val ) );
+      }
+      err /= eps;
+    }
+    err = WarpMax( err );
+    if ( err <= 1.0 || h <= h_min * ( 1.0 + 1.0e-5 ) )
+    {
+      break;
+    }
+
+    float h_new = h * coeff * pow( err, exp_dec );
+    h = MAX( h_new, 0.1 * h );
+  }
+
+  if ( active )
+  {
+    x += h;
+    for ( int i = 0; i < NVAR; i++ )
+    {
+      y[ i ] = y_new[ i ];
+    }
+  }
+
+  if ( err > err_min )
+  {
+    h = h * coeff * pow( err, exp_inc );
+  }
+  else
+  {
+    h = 5.0 * h;
+  }
+}
+
+template < int NVAR, int NPARAM, class DataStruct >
+__device__ void
+RK5UpdateWarp( double& x,
+  float* y,
+  double x1,
+  float& h,
+  float h_min,
+  float* param,
+  DataStruct data_struct,
+  bool active )
+{
+  bool end_time_step = !active;
+  while ( __any_sync( FULL_WARP_MASK, !end_time_step ) )
+  {
+    // no thread of the warp can go beyond x1
+    float hmax = end_time_step ? RK5_LARGE_STEP : ( float ) ( x1 - x );
+    hmax = WarpMin( hmax );
+    RK5StepWarp< NVAR, NPARAM, DataStruct >( x, y, h, h_min, hmax, param, data_struct, !end_time_step );
+    if ( !end_time_step )
+    {
+      end_time_step = ( x >= x1 - h_min );
+      ExternalUpdate< NVAR, NPARAM >( x, y, param, end_time_step, data_struct );
+    }
+  }
+}
+
+// Same as ArrayUpdate, with a step size common to each warp.
+// All the threads of the block must execute the kernel up to the end,
+// because they take part in the warp reductions
+template < int NVAR, int NPARAM, class DataStruct >
+__global__ void
+ArrayUpdateWarp( int array_size,
+  double* x_arr,
+  float* h_arr,
+  float* y_arr,
+  float* par_arr,
+  double x1,
+  float h_min,
+  unsigned long long const_mask,
+  int const_offset,
+  InputSpikeArray input_spikes,
+  DataStruct data_struct )
+{
+  int ArrayIdx = threadIdx.x + blockIdx.x * blockDim.x;
+  bool active = ( ArrayIdx < array_size );
+  double x = 0.0;
+  float h = RK5_LARGE_STEP;
+  float y[ NVAR ];
+  float param[ NPARAM ];
+  if ( active )
+  {
+    x = x_arr[ ArrayIdx ];
+    h = h_arr[ ArrayIdx ];
+    FoldInputSpikes( input_spikes, ArrayIdx );
+    for ( int i = 0; i < NVAR; i++ )
     {
-      par_arr[ ArrayIdx * NPARAM + j ] = param[ j ];
+      y[ i ] = y_arr[ ArrayIdx * NVAR + i ];
     }
+    LoadParam< NPARAM >( param, &par_arr[ ArrayIdx * NPARAM ], const_mask, const_offset );
+  }
+  h = WarpMin( h );
+
+  RK5UpdateWarp< NVAR, NPARAM, DataStruct >( x, y, x1, h, h_min, param, data_struct, active );
+
+  if ( active )
+  {
+    x_arr[ ArrayIdx ] = x;
+    h_arr[ ArrayIdx ] = h;
+    for ( int i = 0; i < NVAR; i++ )
+    {
+      y_arr[ ArrayIdx * NVAR + i ] = y[ i ];
+    }
+    StoreParam< NPARAM, DataStruct >( &par_arr[ ArrayIdx * NPARAM ], param );
   }
 }
 
@@ -246,6 +469,16 @@ class RungeKutta5
   int array_size_;
   int n_var_;
   int n_param_;
+  bool warp_step_; // if true the threads of a warp share the step size
+  int integrator_; // RK5 or one of the fixed-step integrators
+  // mask of the parameters folded in the constant-memory block,
+  // owned by the neuron group, and their offset in the block
+  const unsigned long long* const_param_mask_pt_;
+  int const_param_offset_;
+  // input spikes folded by the update kernels, if the neuron group
+  // has fused input
+  InputSpikeArray input_spikes_;
+  cudaStream_t stream_; // stream of the update kernels
 
   double* d_XArr;
   float* d_HArr;
@@ -278,6 +511,46 @@ public:
   int Init( int array_size, int n_var, int n_param, double x_min, float h, DataStruct data_struct );
   int Calibrate( double x_min, float h, DataStruct data_struct );
 
+  int
+  SetWarpStep( bool warp_step )
+  {
+    warp_step_ = warp_step;
+    return 0;
+  }
+
+  int
+  SetConstParam( const unsigned long long* const_param_mask_pt, int const_param_offset )
+  {
+    const_param_mask_pt_ = const_param_mask_pt;
+    const_param_offset_ = const_param_offset;
+    return 0;
+  }
+
+  int
+  SetInputSpikes( InputSpikeArray input_spikes )
+  {
+    input_spikes_ = input_spikes;
+    return 0;
+  }
+
+  int
+  SetStream( cudaStream_t stream )
+  {
+    stream_ = stream;
+    return 0;
+  }
+
+  int
+  SetIntegrator( int integrator )
+  {
+    if ( integrator < 0 || integrator >= N_INTEGRATOR )
+    {
+      throw ngpu_exception( "Unrecognized ODE integrator index " + std::to_string( integrator ) );
+    }
+    integrator_ = integrator;
+    return 0;
+  }
+
   int Free();
 
   int GetX( int i_array, int n_elem, double* x );
@@ -294,8 +567,51 @@ template < int NVAR, int NPARAM >
 int
 RungeKutta5< DataStruct >::Update( double x1, float h_min, DataStruct data_struct )
 {
-  ArrayUpdate< NVAR, NPARAM, DataStruct > <<< ( array_size_ + 1023 ) / 1024, 1024 >>>(
-    array_size_, d_XArr, d_HArr, d_YArr, d_ParamArr, x1, h_min, data_struct );
+  unsigned long long const_mask = ( const_param_mask_pt_ != NULL ) ? *const_param_mask_pt_ : 0;
+  if ( integrator_ != INTEGRATOR_RK5 )
+  {
+    ArrayUpdateFixedStep< NVAR, NPARAM, DataStruct > <<< ( array_size_ + 1023 ) / 1024, 1024, 0, stream_ >>>(
+      array_size_,
+      d_XArr,
+      d_YArr,
+      d_ParamArr,
+      x1,
+      integrator_,
+      const_mask,
+      const_param_offset_,
+      input_spikes_,
+      data_struct );
+  }
+  else if ( warp_step_ )
+  {
+    ArrayUpdateWarp< NVAR, NPARAM, DataStruct > <<< ( array_size_ + 1023 ) / 1024, 1024, 0, stream_ >>>(
+      array_size_,
+      d_XArr,
+      d_HArr,
+      d_YArr,
+      d_ParamArr,
+      x1,
+      h_min,
+      const_mask,
+      const_param_offset_,
+      input_spikes_,
+      data_struct );
+  }
+  else
+  {
+    ArrayUpdate< NVAR, NPARAM, DataStruct > <<< ( array_size_ + 1023 ) / 1024, 1024, 0, stream_ >>>(
+      array_size_,
+      d_XArr,
+      d_HArr,
+      d_YArr,
+      d_ParamArr,
+      x1,
+      h_min,
+      const_mask,
+      const_param_offset_,
+      input_spikes_,
+      data_struct );
+  }
   // gpuErrchk( cudaPeekAtLastError() );
   // gpuErrchk( cudaDeviceSynchronize() );
 
@@ -327,6 +643,13 @@ RungeKutta5< DataStruct >::Init( int array_size, int n_var, int n_param, double
   array_size_ = array_size;
   n_var_ = n_var;
   n_param_ = n_param;
+  warp_step_ = false;
+  integrator_ = INTEGRATOR_RK5;
+  const_param_mask_pt_ = NULL;
+  const_param_offset_ = 0;
+  input_spikes_.spike_array_ = NULL;
+  input_spikes_.n_port_ = 0;
+  stream_ = 0;
 
   gpuErrchk( cudaMalloc( &d_XArr, array_size_ * sizeof( double ) ) );
   gpuErrchk( cudaMalloc( &d_HArr, array_size_ * sizeof( float ) ) );
@@ -0,0 +1,132 @@
+/*
+ *  rk5_param.h
+ *
+ *  This file is part of NEST GPU.
+ *
+ *  Copyright (C) 2021 The NEST Initiative
+ *
+ *  NEST GPU is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NEST GPU is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NEST GPU.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef RK5PARAM_H
+#define RK5PARAM_H
+
+#include "base_neuron.h"
+
+extern __constant__ float NESTGPUConstParam[ MAX_CONST_PARAM ];
+
+// Parameters that the ExternalUpdate function of a model can modify.
+// At the end of the update kernels only these parameters are written
+// back to the parameter array, all the others are read-only.
+// A model declares them by specializing this template for its
+// data structure, e.g.
+//
+// template <>
+// struct RK5MutableParam< aeif_cond_beta_rk5 >
+// {
+//   static const int N_MUTABLE = 1;
+//   __host__ __device__ static int
+//   Idx( int i_mut )
+//   {
+//     return aeif_cond_beta_ns::i_refractory_step;
+//   }
+// };
+//
+// If the template is not specialized all the parameters are written back
+template < class DataStruct >
+struct RK5MutableParam
+{
+  static const int N_MUTABLE = -1;
+  __host__ __device__ static int
+  Idx( int i_mut )
+  {
+    return i_mut;
+  }
+};
+
+// Loads the parameters of a node. The parameters in const_mask have the
+// same value in all the nodes of the group and are read from the
+// constant-memory block, starting from const_offset. They keep their
+// slot in the parameter array, whose stride stays NPARAM, because the
+// parameter accessors, the port weight arrays and the recorders address
+// the parameters by index in that array. The kernels skip the folded
+// slots, so only the loads of the other parameters remain. These are
+// read through the read-only data cache: the parameter array is written
+// only at the end of the update kernels, each thread writing the
+// parameters that it has read, so the cache does not return stale values
+template < int NPARAM >
+__device__ __forceinline__ void
+LoadParam( float* param, const float* node_par_arr, unsigned long long const_mask, int const_offset )
+{
+  for ( int j = 0; j < NPARAM; j++ )
+  {
+    if ( j < MAX_FOLDED_PARAM && ( ( const_mask >> j ) & 1ULL ) )
+    {
+      param[ j ] = NESTGPUConstParam[ const_offset + j ];
+    }
+    else
+    {
+      param[ j ] = __ldg( &node_par_arr[ j ] );
+    }
+  }
+}
+
+// mask of the parameters that ExternalUpdate can modify,
+// they must not be folded in the constant-memory block
+template < class DataStruct >
+unsigned long long
+MutableParamMask()
+{
+  if ( RK5MutableParam< DataStruct >::N_MUTABLE < 0 )
+  {
+    return ~0ULL;
+  }
+  unsigned long long mask = 0;
+  for ( int i_mut = 0; i_mut < RK5MutableParam< DataStruct >::N_MUTABLE; i_mut++ )
+  {
+    int j = RK5MutableParam< DataStruct >::Idx( i_mut );
+    if ( j < MAX_FOLDED_PARAM )
+    {
+      mask |= ( 1ULL << j );
+    }
+  }
+
+  return mask;
+}
+
+// Writes back the parameters of a node that ExternalUpdate can modify
+template < int NPARAM, class DataStruct >
+__device__ __forceinline__ void
+StoreParam( float* node_par_arr, const float* param )
+{
+  if ( RK5MutableParam< DataStruct >::N_MUTABLE < 0 )
+  {
+    for ( int j = 0; j < NPARAM; j++ )
+    {
+      node_par_arr[ j ] = param[ j ];
+    }
+  }
+  else
+  {
+#pragma unroll
+    for ( int i_mut = 0; i_mut < RK5MutableParam< DataStruct >::N_MUTABLE; i_mut++ )
+    {
+      int j = RK5MutableParam< DataStruct >::Idx( i_mut );
+      node_par_arr[ j ] = param[ j ];
+    }
+  }
+}
+
+#endif
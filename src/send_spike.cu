@@ -23,6 +23,7 @@
 
 #include "cuda_error.h"
 #include "send_spike.h"
+#include "spike_buffer.h"
 #include <config.h>
 #include <stdio.h>
 
@@ -30,6 +31,7 @@ int* d_SpikeNum;
 int* d_SpikeSourceIdx;
 int* d_SpikeConnIdx;
 float* d_SpikeHeight;
+float* d_SpikeOffset;
 int* d_SpikeTargetNum;
 
 __device__ int MaxSpikeNum;
@@ -37,10 +39,11 @@ __device__ int* SpikeNum;
 __device__ int* SpikeSourceIdx;
 __device__ int* SpikeConnIdx;
 __device__ float* SpikeHeight;
+__device__ float* SpikeOffset;
 __device__ int* SpikeTargetNum;
 
 __device__ void
-SendSpike( int i_source, int i_conn, float height, int target_num )
+SendSpike( int i_source, int i_conn, float height, int target_num, float offset )
 {
   int pos = atomicAdd( SpikeNum, 1 );
   if ( pos >= MaxSpikeNum )
@@ -52,6 +55,10 @@ SendSpike( int i_source, int i_conn, float height, int target_num )
   SpikeSourceIdx[ pos ] = i_source;
   SpikeConnIdx[ pos ] = i_conn;
   SpikeHeight[ pos ] = height;
+  if ( SpikeOffset != NULL )
+  {
+    SpikeOffset[ pos ] = offset;
+  }
   SpikeTargetNum[ pos ] = target_num;
 }
 
@@ -60,6 +67,7 @@ DeviceSpikeInit( int* spike_num,
   int* spike_source_idx,
   int* spike_conn_idx,
   float* spike_height,
+  float* spike_offset,
   int* spike_target_num,
   int max_spike_num )
 {
@@ -67,6 +75,7 @@ DeviceSpikeInit( int* spike_num,
   SpikeSourceIdx = spike_source_idx;
   SpikeConnIdx = spike_conn_idx;
   SpikeHeight = spike_height;
+  SpikeOffset = spike_offset;
   SpikeTargetNum = spike_target_num;
   MaxSpikeNum = max_spike_num;
   *SpikeNum = 0;
@@ -82,10 +91,15 @@ SpikeInit( int max_spike_num )
   gpuErrchk( cudaMalloc( &d_SpikeSourceIdx, max_spike_num * sizeof( int ) ) );
   gpuErrchk( cudaMalloc( &d_SpikeConnIdx, max_spike_num * sizeof( int ) ) );
   gpuErrchk( cudaMalloc( &d_SpikeHeight, max_spike_num * sizeof( float ) ) );
+  d_SpikeOffset = NULL;
+  if ( SpikeOffsetFlag )
+  {
+    gpuErrchk( cudaMalloc( &d_SpikeOffset, max_spike_num * sizeof( float ) ) );
+  }
   gpuErrchk( cudaMalloc( &d_SpikeTargetNum, max_spike_num * sizeof( int ) ) );
   // printf("here: SpikeTargetNum size: %d", max_spike_num);
   DeviceSpikeInit<<< 1, 1 >>>(
-    d_SpikeNum, d_SpikeSourceIdx, d_SpikeConnIdx, d_SpikeHeight, d_SpikeTargetNum, max_spike_num );
+    d_SpikeNum, d_SpikeSourceIdx, d_SpikeConnIdx, d_SpikeHeight, d_SpikeOffset, d_SpikeTargetNum, max_spike_num );
   gpuErrchk( cudaPeekAtLastError() );
 }
 
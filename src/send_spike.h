@@ -28,6 +28,7 @@ extern int* d_SpikeNum;
 extern int* d_SpikeSourceIdx;
 extern int* d_SpikeConnIdx;
 extern float* d_SpikeHeight;
+extern float* d_SpikeOffset;
 extern int* d_SpikeTargetNum;
 
 extern __device__ int MaxSpikeNum;
@@ -35,16 +36,18 @@ extern __device__ int* SpikeNum;
 extern __device__ int* SpikeSourceIdx;
 extern __device__ int* SpikeConnIdx;
 extern __device__ float* SpikeHeight;
+extern __device__ float* SpikeOffset; // NULL if no node emits spikes with offset
 extern __device__ int* SpikeTargetNum;
 
 __global__ void DeviceSpikeInit( int* spike_num,
   int* spike_source_idx,
   int* spike_conn_idx,
   float* spike_height,
+  float* spike_offset,
   int* spike_target_num,
   int max_spike_num );
 
-__device__ void SendSpike( int i_source, int i_conn, float height, int target_num );
+__device__ void SendSpike( int i_source, int i_conn, float height, int target_num, float offset = 0.0 );
 
 void SpikeInit( int max_spike_num );
 
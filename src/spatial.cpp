@@ -0,0 +1,368 @@
+/*
+ *  spatial.cpp
+ *
+ *  This file is part of NEST GPU.
+ *
+ *  Copyright (C) 2021 The NEST Initiative
+ *
+ *  NEST GPU is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NEST GPU is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NEST GPU.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "ngpu_exception.h"
+#include "spatial.h"
+
+SpatialKernel::SpatialKernel()
+{
+  Init();
+}
+
+int
+SpatialKernel::Init()
+{
+  kernel_idx_ = KERNEL_CONSTANT;
+  p_ = 1.0;
+  sigma_ = 0.0;
+  tau_ = 0.0;
+  cutoff_ = 0.0;
+
+  return 0;
+}
+
+int
+SpatialKernel::SetParam( std::string param_name, float value )
+{
+  if ( param_name == "p" )
+  {
+    if ( value < 0.0 || value > 1.0 )
+    {
+      throw ngpu_exception( "Connection probability p must be in the range [0,1]" );
+    }
+    p_ = value;
+  }
+  else if ( param_name == "sigma" )
+  {
+    if ( value <= 0.0 )
+    {
+      throw ngpu_exception( "Kernel parameter sigma must be >0" );
+    }
+    sigma_ = value;
+  }
+  else if ( param_name == "tau" )
+  {
+    if ( value <= 0.0 )
+    {
+      throw ngpu_exception( "Kernel parameter tau must be >0" );
+    }
+    tau_ = value;
+  }
+  else if ( param_name == "cutoff" )
+  {
+    if ( value <= 0.0 )
+    {
+      throw ngpu_exception( "Kernel cutoff must be >0" );
+    }
+    cutoff_ = value;
+  }
+  else
+  {
+    throw ngpu_exception( "Unknown kernel parameter " + param_name );
+  }
+
+  return 0;
+}
+
+bool
+SpatialKernel::IsFloatParam( std::string param_name )
+{
+  if ( param_name == "p" || param_name == "sigma" || param_name == "tau" || param_name == "cutoff" )
+  {
+    return true;
+  }
+  else
+  {
+    return false;
+  }
+}
+
+float
+SpatialKernel::Cutoff()
+{
+  if ( ( kernel_idx_ == KERNEL_GAUSSIAN && sigma_ <= 0.0 ) || ( kernel_idx_ == KERNEL_EXPONENTIAL && tau_ <= 0.0 ) )
+  {
+    throw ngpu_exception( "Parameter sigma (gaussian) or tau (exponential) of the spatial kernel must be >0" );
+  }
+  if ( cutoff_ > 0.0 )
+  {
+    return cutoff_;
+  }
+  if ( kernel_idx_ == KERNEL_GAUSSIAN )
+  {
+    return 4.0 * sigma_;
+  }
+  if ( kernel_idx_ == KERNEL_EXPONENTIAL )
+  {
+    return 8.0 * tau_;
+  }
+  throw ngpu_exception( "The constant spatial kernel requires the parameter cutoff" );
+}
+
+double
+SpatialKernel::Prob( double d2 )
+{
+  switch ( kernel_idx_ )
+  {
+  case KERNEL_CONSTANT:
+    return p_;
+  case KERNEL_GAUSSIAN:
+    return p_ * exp( -d2 / ( 2.0 * sigma_ * sigma_ ) );
+  case KERNEL_EXPONENTIAL:
+    return p_ * exp( -sqrt( d2 ) / tau_ );
+  default:
+    throw ngpu_exception( "Unknown spatial kernel" );
+  }
+}
+
+SpatialGrid::SpatialGrid( SpatialExtent ext, float cutoff )
+  : ext_( ext )
+  , cutoff_( cutoff )
+{
+  if ( ext_.n_dim_ < 1 || ext_.n_dim_ > MAX_SPATIAL_DIM )
+  {
+    throw ngpu_exception( "Number of spatial dimensions must be 1, 2 or 3" );
+  }
+  for ( int i_dim = 0; i_dim < MAX_SPATIAL_DIM; i_dim++ )
+  {
+    n_cell_[ i_dim ] = 1;
+    cell_size_[ i_dim ] = 1.0;
+  }
+  for ( int i_dim = 0; i_dim < ext_.n_dim_; i_dim++ )
+  {
+    if ( ext_.extent_[ i_dim ] <= 0.0 )
+    {
+      throw ngpu_exception( "Spatial extent must be >0 in all dimensions" );
+    }
+    // cells must not be smaller than the cutoff
+    double n_cell = floor( ext_.extent_[ i_dim ] / cutoff_ );
+    n_cell_[ i_dim ] = ( n_cell < 1.0 ) ? 1 : ( n_cell > 1.0e6 ? 1000000 : ( int ) n_cell );
+    cell_size_[ i_dim ] = ext_.extent_[ i_dim ] / n_cell_[ i_dim ];
+  }
+}
+
+int
+SpatialGrid::CellCoord( float x, int i_dim )
+{
+  int c = ( int ) floor( ( x - ext_.lower_left_[ i_dim ] ) / cell_size_[ i_dim ] );
+  int n = n_cell_[ i_dim ];
+  if ( ext_.periodic_ )
+  {
+    c = ( ( c % n ) + n ) % n;
+  }
+  else
+  {
+    c = ( c < 0 ) ? 0 : ( ( c >= n ) ? n - 1 : c );
+  }
+  return c;
+}
+
+int
+SpatialGrid::Build( const float* pos, int n_point )
+{
+  int n_dim = ext_.n_dim_;
+  // avoid an index with many more cells than points
+  long long n_cell_tot = ( long long ) n_cell_[ 0 ] * n_cell_[ 1 ] * n_cell_[ 2 ];
+  while ( n_cell_tot > 4LL * n_point + 64 )
+  {
+    for ( int i_dim = 0; i_dim < n_dim; i_dim++ )
+    {
+      n_cell_[ i_dim ] = ( n_cell_[ i_dim ] + 1 ) / 2;
+      cell_size_[ i_dim ] = ext_.extent_[ i_dim ] / n_cell_[ i_dim ];
+    }
+    n_cell_tot = ( long long ) n_cell_[ 0 ] * n_cell_[ 1 ] * n_cell_[ 2 ];
+  }
+
+  // counting sort of the points by cell
+  std::vector< int > point_cell( n_point );
+  cell_start_.assign( n_cell_tot + 1, 0 );
+  for ( int i = 0; i < n_point; i++ )
+  {
+    int i_cell = 0;
+    for ( int i_dim = 0; i_dim < MAX_SPATIAL_DIM; i_dim++ )
+    {
+      int c = ( i_dim < n_dim ) ? CellCoord( pos[ ( size_t ) i * n_dim + i_dim ], i_dim ) : 0;
+      i_cell = i_cell * n_cell_[ i_dim ] + c;
+    }
+    point_cell[ i ] = i_cell;
+    cell_start_[ i_cell + 1 ]++;
+  }
+  for ( long long i_cell = 0; i_cell < n_cell_tot; i_cell++ )
+  {
+    cell_start_[ i_cell + 1 ] += cell_start_[ i_cell ];
+  }
+  cell_point_.resize( n_point );
+  cell_pos_.resize( ( size_t ) n_point * n_dim );
+  std::vector< int > cell_fill( cell_start_.begin(), cell_start_.end() - 1 );
+  for ( int i = 0; i < n_point; i++ )
+  {
+    int k = cell_fill[ point_cell[ i ] ]++;
+    cell_point_[ k ] = i;
+    for ( int i_dim = 0; i_dim < n_dim; i_dim++ )
+    {
+      cell_pos_[ ( size_t ) k * n_dim + i_dim ] = Wrap( pos[ ( size_t ) i * n_dim + i_dim ], i_dim );
+    }
+  }
+
+  return 0;
+}
+
+float
+SpatialGrid::Wrap( float x, int i_dim )
+{
+  if ( !ext_.periodic_ )
+  {
+    return x;
+  }
+  double L = ext_.extent_[ i_dim ];
+  double x0 = ext_.lower_left_[ i_dim ];
+
+  float y = x0 + ( x - x0 ) - L * floor( ( x - x0 ) / L );
+
+  // rounding can give the upper boundary, which is equivalent to x0
+  return ( y >= x0 + L ) ? x0 : y;
+}
+
+double
+SpatialGrid::Dist2( const float* pos1, const float* pos2 )
+{
+  double d2 = 0;
+  for ( int i_dim = 0; i_dim < ext_.n_dim_; i_dim++ )
+  {
+    double dx = ( double ) pos1[ i_dim ] - pos2[ i_dim ];
+    if ( ext_.periodic_ )
+    {
+      double L = ext_.extent_[ i_dim ];
+      dx -= L * round( dx / L );
+    }
+    d2 += dx * dx;
+  }
+  return d2;
+}
+
+int
+SpatialGrid::SamplePairwise( const float* target_pos,
+  SpatialKernel& kernel,
+  ConnSampler& sampler,
+  std::vector< int >& idx_vect )
+{
+  int n_dim = ext_.n_dim_;
+  double cutoff2 = ( double ) cutoff_ * cutoff_;
+  // cell coordinates to be visited in each dimension, and the shift
+  // of the periodic image of the cells that wrap around the boundary
+  int coord[ MAX_SPATIAL_DIM ][ 3 ];
+  float shift[ MAX_SPATIAL_DIM ][ 3 ];
+  int n_coord[ MAX_SPATIAL_DIM ];
+  // dimensions with less than four periodic cells, where the nearest
+  // image must be computed point by point
+  bool min_image[ MAX_SPATIAL_DIM ];
+  float x[ MAX_SPATIAL_DIM ];
+  for ( int i_dim = 0; i_dim < MAX_SPATIAL_DIM; i_dim++ )
+  {
+    int n = n_cell_[ i_dim ];
+    min_image[ i_dim ] = false;
+    x[ i_dim ] = 0.0;
+    if ( i_dim >= n_dim )
+    {
+      coord[ i_dim ][ 0 ] = 0;
+      shift[ i_dim ][ 0 ] = 0.0;
+      n_coord[ i_dim ] = 1;
+      continue;
+    }
+    x[ i_dim ] = Wrap( target_pos[ i_dim ], i_dim );
+    if ( n <= 3 )
+    {
+      // all cells, each only once
+      for ( int c = 0; c < n; c++ )
+      {
+        coord[ i_dim ][ c ] = c;
+        shift[ i_dim ][ c ] = 0.0;
+      }
+      n_coord[ i_dim ] = n;
+      min_image[ i_dim ] = ext_.periodic_;
+    }
+    else
+    {
+      int c0 = CellCoord( x[ i_dim ], i_dim );
+      n_coord[ i_dim ] = 0;
+      for ( int dc = -1; dc <= 1; dc++ )
+      {
+        int c = c0 + dc;
+        if ( ext_.periodic_ )
+        {
+          int j = n_coord[ i_dim ]++;
+          coord[ i_dim ][ j ] = ( c + n ) % n;
+          shift[ i_dim ][ j ] = ( c < 0 ) ? -ext_.extent_[ i_dim ] : ( ( c >= n ) ? ext_.extent_[ i_dim ] : 0.0 );
+        }
+        else if ( c >= 0 && c < n )
+        {
+          int j = n_coord[ i_dim ]++;
+          coord[ i_dim ][ j ] = c;
+          shift[ i_dim ][ j ] = 0.0;
+        }
+      }
+    }
+  }
+
+  int n_sel = 0;
+  for ( int i0 = 0; i0 < n_coord[ 0 ]; i0++ )
+  {
+    for ( int i1 = 0; i1 < n_coord[ 1 ]; i1++ )
+    {
+      for ( int i2 = 0; i2 < n_coord[ 2 ]; i2++ )
+      {
+        int i_cell = ( coord[ 0 ][ i0 ] * n_cell_[ 1 ] + coord[ 1 ][ i1 ] ) * n_cell_[ 2 ] + coord[ 2 ][ i2 ];
+        // target position relative to the image of the cell
+        double y[ MAX_SPATIAL_DIM ] = {
+          x[ 0 ] - shift[ 0 ][ i0 ], x[ 1 ] - shift[ 1 ][ i1 ], x[ 2 ] - shift[ 2 ][ i2 ]
+        };
+        for ( int k = cell_start_[ i_cell ]; k < cell_start_[ i_cell + 1 ]; k++ )
+        {
+          const float* pos = &cell_pos_[ ( size_t ) k * n_dim ];
+          double d2 = 0;
+          for ( int i_dim = 0; i_dim < n_dim; i_dim++ )
+          {
+            double dx = y[ i_dim ] - pos[ i_dim ];
+            if ( min_image[ i_dim ] )
+            {
+              double L = ext_.extent_[ i_dim ];
+              dx -= L * round( dx / L );
+            }
+            d2 += dx * dx;
+          }
+          if ( d2 <= cutoff2 && sampler.Uniform() <= kernel.Prob( d2 ) )
+          {
+            idx_vect.push_back( cell_point_[ k ] );
+            n_sel++;
+          }
+        }
+      }
+    }
+  }
+
+  return n_sel;
+}
@@ -0,0 +1,119 @@
+/*
+ *  spatial.h
+ *
+ *  This file is part of NEST GPU.
+ *
+ *  Copyright (C) 2021 The NEST Initiative
+ *
+ *  NEST GPU is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NEST GPU is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NEST GPU.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/////////////////////////////////////////////////////////////////
+// Host-side support of spatially structured connection rules:
+// distance-dependent connection kernels and a cell-list index
+// of node positions, so that only the nodes within the kernel
+// cutoff are examined
+/////////////////////////////////////////////////////////////////
+
+#ifndef SPATIAL_H
+#define SPATIAL_H
+
+#include <string>
+#include <vector>
+
+#include "conn_sampler.h"
+
+#define MAX_SPATIAL_DIM 3
+
+enum SpatialKernelType
+{
+  KERNEL_CONSTANT = 0,
+  KERNEL_GAUSSIAN,
+  KERNEL_EXPONENTIAL,
+  N_KERNEL
+};
+
+const std::string spatial_kernel_name[ N_KERNEL ] = { "constant", "gaussian", "exponential" };
+
+// connection probability as a function of distance d:
+// constant:    p
+// gaussian:    p*exp(-d^2/(2*sigma^2))
+// exponential: p*exp(-d/tau)
+// and zero for d > cutoff
+class SpatialKernel
+{
+public:
+  int kernel_idx_;
+  float p_;
+  float sigma_;
+  float tau_;
+  float cutoff_;
+
+  SpatialKernel();
+  int Init();
+  int SetParam( std::string param_name, float value );
+  static bool IsFloatParam( std::string param_name );
+
+  // cutoff distance, if not set it is 4 sigma for the gaussian kernel
+  // and 8 tau for the exponential kernel
+  float Cutoff();
+
+  double Prob( double d2 ); // probability as a function of the squared distance
+};
+
+// Spatial region containing the node positions
+struct SpatialExtent
+{
+  int n_dim_;
+  float lower_left_[ MAX_SPATIAL_DIM ];
+  float extent_[ MAX_SPATIAL_DIM ];
+  bool periodic_;
+};
+
+// Cell-list index of a set of positions. The region is divided in cells
+// with size not smaller than the cutoff, so that all the points within
+// the cutoff from a given position are in the same or in adjacent cells
+class SpatialGrid
+{
+  SpatialExtent ext_;
+  float cutoff_;
+  int n_cell_[ MAX_SPATIAL_DIM ];
+  float cell_size_[ MAX_SPATIAL_DIM ];
+  std::vector< int > cell_start_;   // CSR offsets of the cells
+  std::vector< int > cell_point_;   // point indexes sorted by cell
+  std::vector< float > cell_pos_;   // positions sorted by cell, wrapped
+                                    // in the extent if it is periodic
+
+  int CellCoord( float x, int i_dim );
+  float Wrap( float x, int i_dim ); // into the extent, if periodic
+
+public:
+  SpatialGrid( SpatialExtent ext, float cutoff );
+
+  // builds the index of n_point positions, stored in pos as
+  // pos[i_point*n_dim + i_dim]. The positions are copied in cell order
+  int Build( const float* pos, int n_point );
+
+  // squared distance between two positions, with periodic boundaries
+  // if the extent is periodic
+  double Dist2( const float* pos1, const float* pos2 );
+
+  // Appends to idx_vect the indexes of the points connected to the position
+  // target_pos, drawn with the probabilities given by the kernel.
+  // Only the points in the cells adjacent to target_pos are examined
+  int SamplePairwise( const float* target_pos, SpatialKernel& kernel, ConnSampler& sampler, std::vector< int >& idx_vect );
+};
+
+#endif
@@ -29,6 +29,7 @@
 #include "connect.h"
 #include "cuda_error.h"
 #include "node_group.h"
+#include "scan.h"
 #include "send_spike.h"
 #include "spike_buffer.h"
 
@@ -50,6 +51,8 @@ __device__ int MaxDelayNum;
 
 int h_NSpikeBuffer;
 bool ConnectionSpikeTimeFlag;
+bool SpikeOffsetFlag = false;
+bool RevConnDeviceFlag = true;
 
 float* d_LastSpikeHeight;          // [NSpikeBuffer];
 __device__ float* LastSpikeHeight; //
@@ -66,8 +69,10 @@ __device__ float* ConnectionWeight; //
 unsigned char* d_ConnectionSynGroup;          // [NConnection];
 __device__ unsigned char* ConnectionSynGroup; //
 
-unsigned short* d_ConnectionSpikeTime;          // [NConnection];
+unsigned short* d_ConnectionSpikeTime;          // [NPlasticConnection];
 __device__ unsigned short* ConnectionSpikeTime; //
+// time index of the last spike of the plastic connections,
+// which are the last ones of each connection group
 
 int* d_ConnectionGroupSize;          // [NSpikeBuffer];
 __device__ int* ConnectionGroupSize; // [NSpikeBuffer];
@@ -106,10 +111,23 @@ __device__ float** ConnectionGroupTargetWeight; // [NSpikeBuffer*MaxDelayNum];
 // ConnectionGroupTargetWeight[i_delay*NSpikeBuffer+i_spike_buffer];
 // Connection weight
 
-unsigned short** d_ConnectionGroupTargetSpikeTime; //[NSpikeBuffer*MaxDelayNum];
-__device__ unsigned short** ConnectionGroupTargetSpikeTime;
-// ConnectionGroupTargetSpikeTime[i_delay*NSpikeBuffer+i_spike_buffer];
-// Connection last spike time index
+// The connection groups are numbered in the order in which they are
+// stored, i.e. by source node and delay index
+int h_NConnGroup;
+__device__ int NConnGroup;
+
+int* d_SourceFirstConnGroup;          // [NSpikeBuffer];
+__device__ int* SourceFirstConnGroup; //
+// index of the first connection group of each source node
+
+unsigned int* d_ConnGroupFirstConn;          // [NConnGroup + 1];
+__device__ unsigned int* ConnGroupFirstConn; //
+// index of the first connection of each connection group
+
+unsigned int* d_ConnGroupFirstPlastic;          // [NConnGroup + 1];
+__device__ unsigned int* ConnGroupFirstPlastic; //
+// index of the first plastic connection of each connection group
+// in the arrays of the plastic connections
 
 //////////////////////////////////////////////////////////////////////
 
@@ -140,6 +158,12 @@ __device__ float* SpikeBufferHeight; // [NSpikeBuffer*MaxSpikeBufferNum];
 // SpikeBufferHeight[i_spike*NSpikeBuffer+i_spike_buffer];
 // spike height
 
+float* d_SpikeBufferOffset;          // [NSpikeBuffer*MaxSpikeBufferNum];
+__device__ float* SpikeBufferOffset; // [NSpikeBuffer*MaxSpikeBufferNum];
+// SpikeBufferOffset[i_spike*NSpikeBuffer+i_spike_buffer];
+// time from the spike to the end of the time step in which it is
+// emitted, for precise-spiking models. NULL if SpikeOffsetFlag is false
+
 
 unsigned int* d_RevConnections; //[i] i=0,..., n_rev_conn - 1;
 __device__ unsigned int* RevConnections;
@@ -150,14 +174,63 @@ __device__ int* TargetRevConnectionSize;
 unsigned int** d_TargetRevConnection; //[i][j] j=0,...,RevConnectionSize[i]-1
 __device__ unsigned int** TargetRevConnection;
 
+// Index of the connection group of a connection, found by bisection
+__device__ int
+ConnGroupIdx( unsigned int i_conn )
+{
+  int i_left = 0;
+  int i_right = NConnGroup;
+  while ( i_right - i_left > 1 )
+  {
+    int i_mid = ( i_left + i_right ) / 2;
+    if ( ConnGroupFirstConn[ i_mid ] <= i_conn )
+    {
+      i_left = i_mid;
+    }
+    else
+    {
+      i_right = i_mid;
+    }
+  }
+  return i_left;
+}
+
+// Copies the weights of the connections with flat indexes conn_idx
+// from the device connection array to weight
+__global__ void
+ConnectionWeightGatherKernel( int n_conn, unsigned int* conn_idx, float* weight )
+{
+  int i = threadIdx.x + blockIdx.x * blockDim.x;
+  if ( i >= n_conn )
+  {
+    return;
+  }
+  weight[ i ] = ConnectionWeight[ conn_idx[ i ] ];
+}
+
+// Sets the weights of the connections with flat indexes conn_idx
+// in the device connection array
+__global__ void
+ConnectionWeightScatterKernel( int n_conn, unsigned int* conn_idx, float* weight )
+{
+  int i = threadIdx.x + blockIdx.x * blockDim.x;
+  if ( i >= n_conn )
+  {
+    return;
+  }
+  ConnectionWeight[ conn_idx[ i ] ] = weight[ i ];
+}
+
 ////////////////////////////////////////////////////////////
 // push a new spike in spike buffer of a node
 ////////////////////////////////////////////////////////////
 // i_spike_buffer : node index
 // height: spike multiplicity
+// offset: time from the spike to the end of the time step,
+//         for precise-spiking models, 0 for spikes on the grid
 ////////////////////////////////////////////////////////////
 __device__ void
-PushSpike( int i_spike_buffer, float height )
+PushSpike( int i_spike_buffer, float height, float offset )
 {
   LastSpikeTimeIdx[ i_spike_buffer ] = NESTGPUTimeIdx;
   LastSpikeHeight[ i_spike_buffer ] = height;
@@ -216,7 +289,7 @@ PushSpike( int i_spike_buffer, float height )
     else
     { // record spike time
       NodeGroupArray[ i_group ].rec_spike_times_[ i_node_rel * max_n_rec_spike_times + n_rec_spike_times ] =
-        NESTGPUTime;
+        NESTGPUTime - offset;
       NodeGroupArray[ i_group ].n_rec_spike_times_[ i_node_rel ]++;
     }
   }
@@ -246,6 +319,10 @@ PushSpike( int i_spike_buffer, float height )
     SpikeBufferTimeIdx[ i_arr ] = 0;                 // time index is initialized to 0
     SpikeBufferConnIdx[ i_arr ] = 0;                 // connect. group index is initialized to 0
     SpikeBufferHeight[ i_arr ] = height;             // spike multiplicity
+    if ( SpikeBufferOffset != NULL )
+    {
+      SpikeBufferOffset[ i_arr ] = offset;
+    }
   }
 }
 
@@ -304,8 +381,9 @@ SpikeBufferUpdate()
     {
       // spike time matches connection group delay
       float height = SpikeBufferHeight[ i_arr ]; // spike multiplicity
+      float offset = ( SpikeBufferOffset != NULL ) ? SpikeBufferOffset[ i_arr ] : 0.0;
       // deliver spike
-      SendSpike( i_spike_buffer, i_conn, height, ConnectionGroupTargetSize[ i_conn_arr ] );
+      SendSpike( i_spike_buffer, i_conn, height, ConnectionGroupTargetSize[ i_conn_arr ], offset );
       // increase index of the next conn. group that will emit this spike
       i_conn++;
       SpikeBufferConnIdx[ i_arr ] = i_conn;
@@ -345,12 +423,177 @@ InitLastSpikeTimeIdx( unsigned int n_spike_buffers, int spike_time_idx )
 }
 
 
+// Counts the plastic connections of each target node
+__global__ void
+RevConnCountKernel( unsigned int n_conn,
+  unsigned int* conn_target,
+  unsigned char* conn_syn_group,
+  int* target_rev_conn_size )
+{
+  unsigned int i_conn = threadIdx.x + blockIdx.x * blockDim.x;
+  if ( i_conn >= n_conn || conn_syn_group[ i_conn ] == 0 )
+  {
+    return;
+  }
+  int target = conn_target[ i_conn ] & PORT_MASK;
+  atomicAdd( &target_rev_conn_size[ target ], 1 );
+}
+
+// Stores the indexes of the plastic connections in the segments of
+// their target nodes. The order of the connections in a segment is not
+// defined, since they are updated independently of each other
+__global__ void
+RevConnFillKernel( unsigned int n_conn,
+  unsigned int* conn_target,
+  unsigned char* conn_syn_group,
+  int* target_rev_conn_cumul,
+  int* target_rev_conn_size,
+  unsigned int* rev_conn )
+{
+  unsigned int i_conn = threadIdx.x + blockIdx.x * blockDim.x;
+  if ( i_conn >= n_conn || conn_syn_group[ i_conn ] == 0 )
+  {
+    return;
+  }
+  int target = conn_target[ i_conn ] & PORT_MASK;
+  int pos = target_rev_conn_cumul[ target ] + atomicAdd( &target_rev_conn_size[ target ], 1 );
+  rev_conn[ pos ] = i_conn;
+}
+
+__global__ void
+RevConnSetPointerKernel( unsigned int n_node,
+  unsigned int* rev_conn,
+  int* target_rev_conn_cumul,
+  unsigned int** target_rev_conn )
+{
+  unsigned int i_node = threadIdx.x + blockIdx.x * blockDim.x;
+  if ( i_node >= n_node )
+  {
+    return;
+  }
+  target_rev_conn[ i_node ] = rev_conn + target_rev_conn_cumul[ i_node ];
+}
+
+// Builds the reverse connection index on the device, from the targets
+// and the synapse groups of the connections, with a histogram of the
+// targets of the plastic connections and a prefix scan of the counts.
+// Returns the number of plastic connections
+unsigned int
+RevConnDeviceInit( unsigned int n_node,
+  unsigned int n_conn,
+  unsigned int* d_conn_target,
+  unsigned char* d_conn_syn_group )
+{
+  if ( n_conn == 0 )
+  {
+    return 0;
+  }
+  int* d_target_rev_conn_cumul;
+  gpuErrchk( cudaMalloc( &d_TargetRevConnectionSize, ( n_node + 1 ) * sizeof( int ) ) );
+  gpuErrchk( cudaMalloc( &d_target_rev_conn_cumul, ( n_node + 1 ) * sizeof( int ) ) );
+  gpuErrchk( cudaMemset( d_TargetRevConnectionSize, 0, ( n_node + 1 ) * sizeof( int ) ) );
+
+  RevConnCountKernel<<< ( n_conn + 1023 ) / 1024, 1024 >>>(
+    n_conn, d_conn_target, d_conn_syn_group, d_TargetRevConnectionSize );
+  gpuErrchk( cudaPeekAtLastError() );
+  prefix_scan( d_target_rev_conn_cumul, d_TargetRevConnectionSize, n_node + 1, true );
+
+  int n_rev_conn;
+  gpuErrchk( cudaMemcpy( &n_rev_conn, &d_target_rev_conn_cumul[ n_node ], sizeof( int ), cudaMemcpyDeviceToHost ) );
+  if ( n_rev_conn == 0 )
+  {
+    gpuErrchk( cudaFree( d_TargetRevConnectionSize ) );
+    gpuErrchk( cudaFree( d_target_rev_conn_cumul ) );
+    d_TargetRevConnectionSize = NULL;
+    return 0;
+  }
+  gpuErrchk( cudaMalloc( &d_RevConnections, n_rev_conn * sizeof( unsigned int ) ) );
+  gpuErrchk( cudaMalloc( &d_TargetRevConnection, n_node * sizeof( unsigned int* ) ) );
+
+  // the sizes are counted again while the segments are filled
+  gpuErrchk( cudaMemset( d_TargetRevConnectionSize, 0, n_node * sizeof( int ) ) );
+  RevConnFillKernel<<< ( n_conn + 1023 ) / 1024, 1024 >>>( n_conn,
+    d_conn_target,
+    d_conn_syn_group,
+    d_target_rev_conn_cumul,
+    d_TargetRevConnectionSize,
+    d_RevConnections );
+  gpuErrchk( cudaPeekAtLastError() );
+  RevConnSetPointerKernel<<< ( n_node + 1023 ) / 1024, 1024 >>>(
+    n_node, d_RevConnections, d_target_rev_conn_cumul, d_TargetRevConnection );
+  gpuErrchk( cudaPeekAtLastError() );
+  gpuErrchk( cudaDeviceSynchronize() );
+  gpuErrchk( cudaFree( d_target_rev_conn_cumul ) );
+
+  return n_rev_conn;
+}
+
+// Reference implementation of the reverse connection index on the host,
+// with the connections of each target node in increasing order
+unsigned int
+RevConnHostInit( unsigned int n_spike_buffers,
+  unsigned int n_conn,
+  unsigned int* h_conn_target,
+  unsigned char* h_conn_syn_group )
+{
+  unsigned int n_rev_conn = 0;
+  std::vector< std::vector< unsigned int > > rev_connections( n_spike_buffers );
+  for ( unsigned int i_conn = 0; i_conn < n_conn; i_conn++ )
+  {
+    unsigned char syn_group = h_conn_syn_group[ i_conn ];
+    if ( syn_group >= 1 )
+    {
+      n_rev_conn++;
+      int target = h_conn_target[ i_conn ] & PORT_MASK;
+      rev_connections[ target ].push_back( i_conn );
+    }
+  }
+
+  if ( n_rev_conn > 0 )
+  {
+    unsigned int* h_rev_conn = new unsigned int[ n_rev_conn ];
+    int* h_target_rev_conn_size = new int[ n_spike_buffers ];
+    unsigned int** h_target_rev_conn = new unsigned int*[ n_spike_buffers ];
+
+    gpuErrchk( cudaMalloc( &d_RevConnections, n_rev_conn * sizeof( unsigned int ) ) );
+    gpuErrchk( cudaMalloc( &d_TargetRevConnectionSize, n_spike_buffers * sizeof( int ) ) );
+    gpuErrchk( cudaMalloc( &d_TargetRevConnection, n_spike_buffers * sizeof( unsigned int* ) ) );
+
+    unsigned int i_rev_conn = 0;
+    for ( unsigned int target = 0; target < n_spike_buffers; target++ )
+    {
+      h_target_rev_conn[ target ] = &d_RevConnections[ i_rev_conn ];
+      int n_target_rev_conn = rev_connections[ target ].size();
+      h_target_rev_conn_size[ target ] = n_target_rev_conn;
+      for ( int i = 0; i < n_target_rev_conn; i++ )
+      {
+        h_rev_conn[ i_rev_conn ] = rev_connections[ target ][ i ];
+        i_rev_conn++;
+      }
+    }
+    cudaMemcpyAsync( d_RevConnections, h_rev_conn, n_rev_conn * sizeof( unsigned int ), cudaMemcpyHostToDevice );
+    cudaMemcpyAsync(
+      d_TargetRevConnectionSize, h_target_rev_conn_size, n_spike_buffers * sizeof( int ), cudaMemcpyHostToDevice );
+    cudaMemcpy(
+      d_TargetRevConnection, h_target_rev_conn, n_spike_buffers * sizeof( unsigned int* ), cudaMemcpyHostToDevice );
+
+    delete[] h_rev_conn;
+    delete[] h_target_rev_conn_size;
+    delete[] h_target_rev_conn;
+  }
+
+  return n_rev_conn;
+}
+
 int
 SpikeBufferInit( NetConnection* net_connection, int max_spike_buffer_size )
 {
   unsigned int n_spike_buffers = net_connection->connection_.size();
   h_NSpikeBuffer = n_spike_buffers;
   int max_delay_num = net_connection->MaxDelayNum();
+  // the static connections of each group are delivered separately
+  // from the plastic ones, which are stored after them
+  net_connection->BuildStoredIndex();
   // printf("mdn: %d\n", max_delay_num);
 
   gpuErrchk( cudaMalloc( &d_LastSpikeTimeIdx, n_spike_buffers * sizeof( long long ) ) );
@@ -372,7 +615,9 @@ SpikeBufferInit( NetConnection* net_connection, int max_spike_buffer_size )
   unsigned int** h_ConnectionGroupTargetNode = new unsigned int*[ n_spike_buffers * max_delay_num ];
   unsigned char** h_ConnectionGroupTargetSynGroup = new unsigned char*[ n_spike_buffers * max_delay_num ];
   h_ConnectionGroupTargetWeight = new float*[ n_spike_buffers * max_delay_num ];
-  unsigned short** h_ConnectionGroupTargetSpikeTime = NULL;
+  std::vector< int > h_source_first_conn_group( n_spike_buffers );
+  std::vector< unsigned int > h_conn_group_first_conn;
+  std::vector< unsigned int > h_conn_group_first_plastic;
 
   gpuErrchk( cudaMalloc( &d_ConnectionGroupSize, n_spike_buffers * sizeof( int ) ) );
   gpuErrchk( cudaMalloc( &d_ConnectionGroupDelay, n_spike_buffers * max_delay_num * sizeof( int ) ) );
@@ -382,6 +627,11 @@ SpikeBufferInit( NetConnection* net_connection, int max_spike_buffer_size )
   gpuErrchk( cudaMalloc( &d_SpikeBufferTimeIdx, n_spike_buffers * max_spike_buffer_size * sizeof( int ) ) );
   gpuErrchk( cudaMalloc( &d_SpikeBufferConnIdx, n_spike_buffers * max_spike_buffer_size * sizeof( int ) ) );
   gpuErrchk( cudaMalloc( &d_SpikeBufferHeight, n_spike_buffers * max_spike_buffer_size * sizeof( float ) ) );
+  d_SpikeBufferOffset = NULL;
+  if ( SpikeOffsetFlag )
+  {
+    gpuErrchk( cudaMalloc( &d_SpikeBufferOffset, n_spike_buffers * max_spike_buffer_size * sizeof( float ) ) );
+  }
   gpuErrchk( cudaMemsetAsync( d_SpikeBufferSize, 0, n_spike_buffers * sizeof( int ) ) );
   gpuErrchk( cudaMemsetAsync( d_SpikeBufferIdx0, 0, n_spike_buffers * sizeof( int ) ) );
 
@@ -390,24 +640,17 @@ SpikeBufferInit( NetConnection* net_connection, int max_spike_buffer_size )
     cudaMalloc( &d_ConnectionGroupTargetSynGroup, n_spike_buffers * max_delay_num * sizeof( unsigned char* ) ) );
   gpuErrchk( cudaMalloc( &d_ConnectionGroupTargetWeight, n_spike_buffers * max_delay_num * sizeof( float* ) ) );
 
-  if ( ConnectionSpikeTimeFlag )
-  {
-    // h_conn_spike_time = new unsigned short[n_conn];
-    gpuErrchk( cudaMalloc( &d_ConnectionSpikeTime, n_conn * sizeof( unsigned short ) ) );
-    // gpuErrchk(cudaMemset(d_ConnectionSpikeTime, 0,
-    //			 n_conn*sizeof(unsigned short)));
-    h_ConnectionGroupTargetSpikeTime = new unsigned short*[ n_spike_buffers * max_delay_num ];
-    gpuErrchk(
-      cudaMalloc( &d_ConnectionGroupTargetSpikeTime, n_spike_buffers * max_delay_num * sizeof( unsigned short* ) ) );
-  }
-
   unsigned int i_conn = 0;
+  unsigned int i_plastic = 0;
   for ( unsigned int i_source = 0; i_source < n_spike_buffers; i_source++ )
   {
     std::vector< ConnGroup >* conn = &( net_connection->connection_[ i_source ] );
     h_ConnectionGroupSize[ i_source ] = conn->size();
+    h_source_first_conn_group[ i_source ] = h_conn_group_first_conn.size();
     for ( unsigned int id = 0; id < conn->size(); id++ )
     {
+      h_conn_group_first_conn.push_back( i_conn );
+      h_conn_group_first_plastic.push_back( i_plastic );
       h_ConnectionGroupDelay[ id * n_spike_buffers + i_source ] = conn->at( id ).delay;
       int n_target = conn->at( id ).target_vect.size();
       h_ConnectionGroupTargetSize[ id * n_spike_buffers + i_source ] = n_target;
@@ -415,77 +658,67 @@ SpikeBufferInit( NetConnection* net_connection, int max_spike_buffer_size )
       h_ConnectionGroupTargetNode[ id * n_spike_buffers + i_source ] = &d_conn_target[ i_conn ];
       h_ConnectionGroupTargetSynGroup[ id * n_spike_buffers + i_source ] = &d_ConnectionSynGroup[ i_conn ];
       h_ConnectionGroupTargetWeight[ id * n_spike_buffers + i_source ] = &d_ConnectionWeight[ i_conn ];
-      if ( ConnectionSpikeTimeFlag )
-      {
-        h_ConnectionGroupTargetSpikeTime[ id * n_spike_buffers + i_source ] = &d_ConnectionSpikeTime[ i_conn ];
-      }
       unsigned int* target_arr = &h_conn_target[ i_conn ];
       unsigned char* syn_group_arr = &h_conn_syn_group[ i_conn ];
       float* weight_arr = &h_conn_weight[ i_conn ];
       for ( int it = 0; it < n_target; it++ )
       {
+        int is = net_connection->StoredIdx( i_source, id, it );
         unsigned int target = conn->at( id ).target_vect[ it ].node;
         unsigned int port = conn->at( id ).target_vect[ it ].port;
-        target_arr[ it ] = ( port << ( 24 + PORT_N_SHIFT ) ) | target;
-        syn_group_arr[ it ] = conn->at( id ).target_vect[ it ].syn_group;
-        weight_arr[ it ] = conn->at( id ).target_vect[ it ].weight;
+        target_arr[ is ] = ( port << ( 24 + PORT_N_SHIFT ) ) | target;
+        syn_group_arr[ is ] = conn->at( id ).target_vect[ it ].syn_group;
+        weight_arr[ is ] = conn->at( id ).target_vect[ it ].weight;
+        if ( syn_group_arr[ is ] > 0 )
+        {
+          i_plastic++;
+        }
       }
       i_conn += n_target;
     }
   }
+  h_NConnGroup = h_conn_group_first_conn.size();
+  h_conn_group_first_conn.push_back( i_conn );
+  h_conn_group_first_plastic.push_back( i_plastic );
+
+  gpuErrchk( cudaMalloc( &d_SourceFirstConnGroup, n_spike_buffers * sizeof( int ) ) );
+  gpuErrchk( cudaMalloc( &d_ConnGroupFirstConn, ( h_NConnGroup + 1 ) * sizeof( unsigned int ) ) );
+  gpuErrchk( cudaMalloc( &d_ConnGroupFirstPlastic, ( h_NConnGroup + 1 ) * sizeof( unsigned int ) ) );
+  cudaMemcpyAsync( d_SourceFirstConnGroup,
+    h_source_first_conn_group.data(),
+    n_spike_buffers * sizeof( int ),
+    cudaMemcpyHostToDevice );
+  cudaMemcpyAsync( d_ConnGroupFirstConn,
+    h_conn_group_first_conn.data(),
+    ( h_NConnGroup + 1 ) * sizeof( unsigned int ),
+    cudaMemcpyHostToDevice );
+  cudaMemcpyAsync( d_ConnGroupFirstPlastic,
+    h_conn_group_first_plastic.data(),
+    ( h_NConnGroup + 1 ) * sizeof( unsigned int ),
+    cudaMemcpyHostToDevice );
+
+  // the spike times are stored only for the plastic connections
+  d_ConnectionSpikeTime = NULL;
+  if ( ConnectionSpikeTimeFlag && i_plastic > 0 )
+  {
+    gpuErrchk( cudaMalloc( &d_ConnectionSpikeTime, i_plastic * sizeof( unsigned short ) ) );
+  }
 
   cudaMemcpyAsync( d_conn_target, h_conn_target, n_conn * sizeof( unsigned int ), cudaMemcpyHostToDevice );
   cudaMemcpyAsync( d_ConnectionSynGroup, h_conn_syn_group, n_conn * sizeof( unsigned char ), cudaMemcpyHostToDevice );
   cudaMemcpyAsync( d_ConnectionWeight, h_conn_weight, n_conn * sizeof( float ), cudaMemcpyHostToDevice );
 
 
-  unsigned int n_rev_conn = 0;
-  std::vector< std::vector< unsigned int > > rev_connections( n_spike_buffers );
-  for ( unsigned int i_conn = 0; i_conn < n_conn; i_conn++ )
+  unsigned int n_rev_conn;
+  if ( RevConnDeviceFlag )
   {
-    unsigned char syn_group = h_conn_syn_group[ i_conn ];
-    if ( syn_group >= 1 )
-    { // TEMPORARY, TO BE IMPROVED
-      n_rev_conn++;
-      int target = h_conn_target[ i_conn ] & PORT_MASK;
-      rev_connections[ target ].push_back( i_conn );
-    }
+    n_rev_conn = RevConnDeviceInit( n_spike_buffers, n_conn, d_conn_target, d_ConnectionSynGroup );
   }
-
-  net_connection->SetNRevConnections( n_rev_conn );
-
-  if ( n_rev_conn > 0 )
+  else
   {
-    unsigned int* h_rev_conn = new unsigned int[ n_rev_conn ];
-    int* h_target_rev_conn_size = new int[ n_spike_buffers ];
-    unsigned int** h_target_rev_conn = new unsigned int*[ n_spike_buffers ];
-
-    gpuErrchk( cudaMalloc( &d_RevConnections, n_rev_conn * sizeof( unsigned int ) ) );
-    gpuErrchk( cudaMalloc( &d_TargetRevConnectionSize, n_spike_buffers * sizeof( int ) ) );
-    gpuErrchk( cudaMalloc( &d_TargetRevConnection, n_spike_buffers * sizeof( unsigned int* ) ) );
-
-    unsigned int i_rev_conn = 0;
-    for ( unsigned int target = 0; target < n_spike_buffers; target++ )
-    {
-      h_target_rev_conn[ target ] = &d_RevConnections[ i_rev_conn ];
-      int n_target_rev_conn = rev_connections[ target ].size();
-      h_target_rev_conn_size[ target ] = n_target_rev_conn;
-      for ( int i = 0; i < n_target_rev_conn; i++ )
-      {
-        h_rev_conn[ i_rev_conn ] = rev_connections[ target ][ i ];
-        i_rev_conn++;
-      }
-    }
-    cudaMemcpyAsync( d_RevConnections, h_rev_conn, n_rev_conn * sizeof( unsigned int ), cudaMemcpyHostToDevice );
-    cudaMemcpyAsync(
-      d_TargetRevConnectionSize, h_target_rev_conn_size, n_spike_buffers * sizeof( int ), cudaMemcpyHostToDevice );
-    cudaMemcpy(
-      d_TargetRevConnection, h_target_rev_conn, n_spike_buffers * sizeof( unsigned int* ), cudaMemcpyHostToDevice );
-
-    delete[] h_rev_conn;
-    delete[] h_target_rev_conn_size;
-    delete[] h_target_rev_conn;
+    n_rev_conn = RevConnHostInit( n_spike_buffers, n_conn, h_conn_target, h_conn_syn_group );
   }
+  net_connection->SetNRevConnections( n_rev_conn );
 
   cudaMemcpyAsync(
     d_ConnectionGroupSize, h_ConnectionGroupSize, n_spike_buffers * sizeof( int ), cudaMemcpyHostToDevice );
@@ -512,13 +745,6 @@ SpikeBufferInit( NetConnection* net_connection, int max_spike_buffer_size )
     h_ConnectionGroupTargetWeight,
     n_spike_buffers * max_delay_num * sizeof( float* ),
     cudaMemcpyHostToDevice );
-  if ( ConnectionSpikeTimeFlag )
-  {
-    cudaMemcpyAsync( d_ConnectionGroupTargetSpikeTime,
-      h_ConnectionGroupTargetSpikeTime,
-      n_spike_buffers * max_delay_num * sizeof( unsigned short* ),
-      cudaMemcpyHostToDevice );
-  }
 
   DeviceSpikeBufferInit<<< 1, 1 >>>( n_spike_buffers,
     max_delay_num,
@@ -534,12 +760,16 @@ SpikeBufferInit( NetConnection* net_connection, int max_spike_buffer_size )
     d_ConnectionGroupTargetNode,
     d_ConnectionGroupTargetSynGroup,
     d_ConnectionGroupTargetWeight,
-    d_ConnectionGroupTargetSpikeTime,
+    h_NConnGroup,
+    d_SourceFirstConnGroup,
+    d_ConnGroupFirstConn,
+    d_ConnGroupFirstPlastic,
     d_SpikeBufferSize,
     d_SpikeBufferIdx0,
     d_SpikeBufferTimeIdx,
     d_SpikeBufferConnIdx,
     d_SpikeBufferHeight,
+    d_SpikeBufferOffset,
     d_RevConnections,
     d_TargetRevConnectionSize,
     d_TargetRevConnection,
@@ -561,10 +791,6 @@ SpikeBufferInit( NetConnection* net_connection, int max_spike_buffer_size )
   delete[] h_ConnectionGroupTargetNode;
   delete[] h_ConnectionGroupTargetSynGroup;
   // delete[] h_ConnectionGroupTargetWeight;
-  if ( h_ConnectionGroupTargetSpikeTime != NULL )
-  {
-    delete[] h_ConnectionGroupTargetSpikeTime;
-  }
 
   return 0;
 }
@@ -584,12 +810,16 @@ DeviceSpikeBufferInit( int n_spike_buffers,
   unsigned int** conn_group_target_node,
   unsigned char** conn_group_target_syn_group,
   float** conn_group_target_weight,
-  unsigned short** conn_group_target_spike_time,
+  int n_conn_group,
+  int* source_first_conn_group,
+  unsigned int* conn_group_first_conn,
+  unsigned int* conn_group_first_plastic,
   int* spike_buffer_size,
   int* spike_buffer_idx0,
   int* spike_buffer_time,
   int* spike_buffer_conn,
   float* spike_buffer_height,
+  float* spike_buffer_offset,
   unsigned int* rev_conn,
   int* target_rev_conn_size,
   unsigned int** target_rev_conn,
@@ -609,12 +839,16 @@ DeviceSpikeBufferInit( int n_spike_buffers,
   ConnectionGroupTargetNode = conn_group_target_node;
   ConnectionGroupTargetSynGroup = conn_group_target_syn_group;
   ConnectionGroupTargetWeight = conn_group_target_weight;
-  ConnectionGroupTargetSpikeTime = conn_group_target_spike_time;
+  NConnGroup = n_conn_group;
+  SourceFirstConnGroup = source_first_conn_group;
+  ConnGroupFirstConn = conn_group_first_conn;
+  ConnGroupFirstPlastic = conn_group_first_plastic;
   SpikeBufferSize = spike_buffer_size;
   SpikeBufferIdx0 = spike_buffer_idx0;
   SpikeBufferTimeIdx = spike_buffer_time;
   SpikeBufferConnIdx = spike_buffer_conn;
   SpikeBufferHeight = spike_buffer_height;
+  SpikeBufferOffset = spike_buffer_offset;
   RevConnections = rev_conn;
   TargetRevConnectionSize = target_rev_conn_size;
   TargetRevConnection = target_rev_conn;
@@ -31,6 +31,8 @@ extern __device__ int MaxDelayNum;
 
 extern int h_NSpikeBuffer;
 extern bool ConnectionSpikeTimeFlag;
+extern bool SpikeOffsetFlag;
+extern bool RevConnDeviceFlag;
 
 extern float* d_LastSpikeHeight;          // [NSpikeBuffer];
 extern __device__ float* LastSpikeHeight; //
@@ -47,8 +49,9 @@ extern __device__ float* ConnectionWeight; //
 extern unsigned char* d_ConnectionSynGroup;          // [NConnection];
 extern __device__ unsigned char* ConnectionSynGroup; //
 
-extern unsigned short* d_ConnectionSpikeTime;          // [NConnection];
+extern unsigned short* d_ConnectionSpikeTime;          // [NPlasticConnection];
 extern __device__ unsigned short* ConnectionSpikeTime; //
+// time index of the last spike of the plastic connections
 
 extern int* d_ConnectionGroupSize;
 extern __device__ int* ConnectionGroupSize;
@@ -77,9 +80,28 @@ extern float** d_ConnectionGroupTargetWeight;
 extern __device__ float** ConnectionGroupTargetWeight;
 // Connection weight
 
-extern unsigned short** d_ConnectionGroupTargetSpikeTime;
-extern __device__ unsigned short** ConnectionGroupTargetSpikeTime;
-// Connection last spike time index
+extern int h_NConnGroup;
+extern __device__ int NConnGroup;
+// number of connection groups, numbered by source node and delay index
+
+extern int* d_SourceFirstConnGroup;
+extern __device__ int* SourceFirstConnGroup;
+// index of the first connection group of each source node
+
+extern unsigned int* d_ConnGroupFirstConn;
+extern __device__ unsigned int* ConnGroupFirstConn;
+// index of the first connection of each connection group
+
+extern unsigned int* d_ConnGroupFirstPlastic;
+extern __device__ unsigned int* ConnGroupFirstPlastic;
+// index of the first plastic connection of each connection group.
+// The plastic connections are the last ones of each group
+
+__device__ int ConnGroupIdx( unsigned int i_conn );
+
+__global__ void ConnectionWeightGatherKernel( int n_conn, unsigned int* conn_idx, float* weight );
+
+__global__ void ConnectionWeightScatterKernel( int n_conn, unsigned int* conn_idx, float* weight );
 
 //////////////////////////////////////////////////////////////////////
 
@@ -103,6 +125,10 @@ extern float* d_SpikeBufferHeight;
 extern __device__ float* SpikeBufferHeight;
 // spike height
 
+extern float* d_SpikeBufferOffset;
+extern __device__ float* SpikeBufferOffset;
+// spike offset, allocated only if SpikeOffsetFlag is true
+
 
 extern unsigned int* d_RevConnections; //[i] i=0,..., n_rev_conn - 1;
 extern __device__ unsigned int* RevConnections;
@@ -114,7 +140,7 @@ extern unsigned int** d_TargetRevConnection; //[i][j] j<=RevConnectionSize[i]-1
 extern __device__ unsigned int** TargetRevConnection;
 
 
-__device__ void PushSpike( int i_spike_buffer, float height );
+__device__ void PushSpike( int i_spike_buffer, float height, float offset = 0.0 );
 
 __global__ void SpikeBufferUpdate();
 
@@ -132,17 +158,31 @@ __global__ void DeviceSpikeBufferInit( int n_spike_buffers,
   unsigned int** conn_group_target_node,
   unsigned char** conn_group_target_syn_group,
   float** conn_group_target_weight,
-  unsigned short** conn_group_target_spike_time,
+  int n_conn_group,
+  int* source_first_conn_group,
+  unsigned int* conn_group_first_conn,
+  unsigned int* conn_group_first_plastic,
   int* spike_buffer_size,
   int* spike_buffer_idx0,
   int* spike_buffer_time,
   int* spike_buffer_conn,
   float* spike_buffer_height,
+  float* spike_buffer_offset,
   unsigned int* rev_conn,
   int* target_rev_conn_size,
   unsigned int** target_rev_conn,
   long long* last_rev_spike_time_idx );
 
+unsigned int RevConnDeviceInit( unsigned int n_node,
+  unsigned int n_conn,
+  unsigned int* d_conn_target,
+  unsigned char* d_conn_syn_group );
+
+unsigned int RevConnHostInit( unsigned int n_spike_buffers,
+  unsigned int n_conn,
+  unsigned int* h_conn_target,
+  unsigned char* h_conn_syn_group );
+
 int SpikeBufferInit( NetConnection* net_connection, int max_spike_buffer_size );
 
 #endif
@@ -21,9 +21,15 @@
  */
 
 
+#include <algorithm>
 #include <cmath>
 #include <config.h>
+#include <cstdio>
 #include <iostream>
+#include <limits>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 // #include <stdio.h>
 
 #include "cuda_error.h"
@@ -43,29 +49,23 @@ enum
 
 const std::string spike_gen_array_param_name[ N_SPIKE_GEN_ARRAY_PARAM ] = { "spike_times", "spike_heights" };
 
+enum
+{
+  i_SPIKE_GEN_CHUNK_SIZE = 0,
+  N_SPIKE_GEN_GROUP_PARAM
+};
+
+const std::string spike_gen_group_param_name[ N_SPIKE_GEN_GROUP_PARAM ] = { "chunk_size" };
+
+// Push the n_spike spikes of the current time step,
+// which are contiguous in the chunk arrays
 __global__ void
-spike_generatorUpdate( int i_node_0,
-  int n_node,
-  long long i_time,
-  int* n_spikes,
-  int* i_spike,
-  int** spike_time_idx,
-  float** spike_height )
+spike_generatorUpdate( int i_node_0, int n_spike, int* spike_node, float* spike_height )
 {
-  int irel_node = threadIdx.x + blockIdx.x * blockDim.x;
-  if ( irel_node < n_node )
+  int i_spike = threadIdx.x + blockIdx.x * blockDim.x;
+  if ( i_spike < n_spike )
   {
-    if ( n_spikes[ irel_node ] > 0 )
-    {
-      int is = i_spike[ irel_node ];
-      if ( is < n_spikes[ irel_node ] && spike_time_idx[ irel_node ][ is ] == i_time )
-      {
-        int i_node = i_node_0 + irel_node;
-        float height = spike_height[ irel_node ][ is ];
-        PushSpike( i_node, height );
-        i_spike[ irel_node ]++;
-      }
-    }
+    PushSpike( i_node_0 + spike_node[ i_spike ], spike_height[ i_spike ] );
   }
 }
 
@@ -75,8 +75,11 @@ spike_generator::Init( int i_node_0, int n_node, int /*n_port*/, int i_group, un
   BaseNeuron::Init( i_node_0, n_node, 0 /*n_port*/, i_group, seed );
   node_type_ = i_spike_generator_model;
   n_scal_param_ = N_SPIKE_GEN_SCAL_PARAM;
+  n_group_param_ = N_SPIKE_GEN_GROUP_PARAM;
   n_param_ = n_scal_param_;
   scal_param_name_ = spike_gen_scal_param_name;
+  group_param_name_ = spike_gen_group_param_name;
+  group_param_ = new float[ N_SPIKE_GEN_GROUP_PARAM ];
 
   for ( int i = 0; i < N_SPIKE_GEN_ARRAY_PARAM; i++ )
   {
@@ -91,28 +94,21 @@ spike_generator::Init( int i_node_0, int n_node, int /*n_port*/, int i_group, un
   gpuErrchk( cudaMalloc( &param_arr_, n_node_ * n_param_ * sizeof( float ) ) );
 
   // SetScalParam(0, n_node, "origin", 0.0);
-
-  h_spike_time_idx_ = new int*[ n_node_ ];
-  h_spike_height_ = new float*[ n_node_ ];
-  for ( int i_node = 0; i_node < n_node_; i_node++ )
+  SetGroupParam( "chunk_size", 0.0 );
+
+  n_spike_ = 0;
+  h_spike_node_ = NULL;
+  h_spike_height_ = NULL;
+  i_spike_ = 0;
+  i_step_ = 0;
+  chunk_size_ = 0;
+  for ( int i_buf = 0; i_buf < 2; i_buf++ )
   {
-    h_spike_time_idx_[ i_node ] = 0;
-    h_spike_height_[ i_node ] = 0;
+    d_spike_node_[ i_buf ] = NULL;
+    d_spike_height_[ i_buf ] = NULL;
+    buf_chunk_[ i_buf ] = -1;
   }
 
-  gpuErrchk( cudaMalloc( &d_n_spikes_, n_node_ * sizeof( int ) ) );
-  gpuErrchk( cudaMalloc( &d_i_spike_, n_node_ * sizeof( int ) ) );
-  gpuErrchk( cudaMalloc( &d_spike_time_idx_, n_node_ * sizeof( int* ) ) );
-  gpuErrchk( cudaMalloc( &d_spike_height_, n_node_ * sizeof( float* ) ) );
-
-  gpuErrchk( cudaMemset( d_n_spikes_, 0, n_node_ * sizeof( int ) ) );
-  gpuErrchk( cudaMemset( d_i_spike_, 0, n_node_ * sizeof( int ) ) );
-  gpuErrchk( cudaMemset( d_spike_time_idx_, 0, n_node_ * sizeof( int* ) ) );
-  gpuErrchk( cudaMemset( d_spike_height_, 0, n_node_ * sizeof( float* ) ) );
-
-  gpuErrchk( cudaPeekAtLastError() );
-  gpuErrchk( cudaDeviceSynchronize() );
-
   return 0;
 }
 
@@ -120,21 +116,22 @@ spike_generator::Init( int i_node_0, int n_node, int /*n_port*/, int i_group, un
 int
 spike_generator::Free()
 {
-  for ( int i_node = 0; i_node < n_node_; i_node++ )
+  if ( n_spike_ > 0 )
   {
-    if ( h_spike_time_idx_[ i_node ] != 0 )
+    gpuErrchk( cudaFreeHost( h_spike_node_ ) );
+    gpuErrchk( cudaFreeHost( h_spike_height_ ) );
+    for ( int i_buf = 0; i_buf < 2; i_buf++ )
     {
-      gpuErrchk( cudaFree( h_spike_time_idx_[ i_node ] ) );
-      gpuErrchk( cudaFree( h_spike_height_[ i_node ] ) );
+      gpuErrchk( cudaFree( d_spike_node_[ i_buf ] ) );
+      gpuErrchk( cudaFree( d_spike_height_[ i_buf ] ) );
+      gpuErrchk( cudaEventDestroy( copy_done_event_[ i_buf ] ) );
+      gpuErrchk( cudaEventDestroy( buf_free_event_[ i_buf ] ) );
     }
+    gpuErrchk( cudaStreamDestroy( copy_stream_ ) );
+    n_spike_ = 0;
   }
-  gpuErrchk( cudaFree( d_n_spikes_ ) );
-  gpuErrchk( cudaFree( d_i_spike_ ) );
-  gpuErrchk( cudaFree( d_spike_time_idx_ ) );
-  gpuErrchk( cudaFree( d_spike_height_ ) );
-
-  delete[] h_spike_time_idx_;
-  delete[] h_spike_height_;
+  delete[] group_param_;
+  group_param_ = NULL;
 
   return 0;
 }
@@ -147,13 +144,69 @@ spike_generator::~spike_generator()
   }
 }
 
+// Copy asynchronously the chunk i_chunk to the buffer i_chunk % 2,
+// after the kernels that use the chunk previously stored there
 int
-spike_generator::Update( long long i_time, double /*t1*/ )
+spike_generator::LoadChunk( int64_t i_chunk )
 {
-  spike_generatorUpdate<<< ( n_node_ + 1023 ) / 1024, 1024 >>>(
-    i_node_0_, n_node_, i_time, d_n_spikes_, d_i_spike_, d_spike_time_idx_, d_spike_height_ );
-  // gpuErrchk( cudaPeekAtLastError() );
-  // gpuErrchk( cudaDeviceSynchronize() );
+  int i_buf = i_chunk % 2;
+  int64_t i0 = i_chunk * chunk_size_;
+  int64_t n = std::min( chunk_size_, n_spike_ - i0 );
+
+  gpuErrchk( cudaStreamWaitEvent( copy_stream_, buf_free_event_[ i_buf ], 0 ) );
+  gpuErrchk( cudaMemcpyAsync(
+    d_spike_node_[ i_buf ], h_spike_node_ + i0, n * sizeof( int ), cudaMemcpyHostToDevice, copy_stream_ ) );
+  gpuErrchk( cudaMemcpyAsync(
+    d_spike_height_[ i_buf ], h_spike_height_ + i0, n * sizeof( float ), cudaMemcpyHostToDevice, copy_stream_ ) );
+  gpuErrchk( cudaEventRecord( copy_done_event_[ i_buf ], copy_stream_ ) );
+  buf_chunk_[ i_buf ] = i_chunk;
+
+  return 0;
+}
+
+int
+spike_generator::Update( long long, double /*t1*/ )
+{
+  // spikes of the current time step, skipping those of past time steps
+  int64_t i_begin = i_spike_;
+  while ( i_begin < n_spike_ && spike_time_idx_[ i_begin ] < i_step_ )
+  {
+    i_begin++;
+  }
+  int64_t i_end = i_begin;
+  while ( i_end < n_spike_ && spike_time_idx_[ i_end ] == i_step_ )
+  {
+    i_end++;
+  }
+  i_spike_ = i_end;
+  i_step_++;
+
+  // the spikes of the time step can span two chunks
+  while ( i_begin < i_end )
+  {
+    int64_t i_chunk = i_begin / chunk_size_;
+    int i_buf = i_chunk % 2;
+    if ( buf_chunk_[ i_buf ] != i_chunk )
+    {
+      LoadChunk( i_chunk );
+    }
+    int64_t i_chunk_end = std::min( i_end, ( i_chunk + 1 ) * chunk_size_ );
+    int n = i_chunk_end - i_begin;
+    int i0 = i_begin - i_chunk * chunk_size_;
+
+    gpuErrchk( cudaStreamWaitEvent( stream_, copy_done_event_[ i_buf ], 0 ) );
+    spike_generatorUpdate<<< ( n + 1023 ) / 1024, 1024, 0, stream_ >>>(
+      i_node_0_, n, d_spike_node_[ i_buf ] + i0, d_spike_height_[ i_buf ] + i0 );
+    gpuErrchk( cudaPeekAtLastError() );
+    gpuErrchk( cudaEventRecord( buf_free_event_[ i_buf ], stream_ ) );
+
+    // prefetch the next chunk in the other buffer
+    if ( ( i_chunk + 1 ) * chunk_size_ < n_spike_ && buf_chunk_[ 1 - i_buf ] != i_chunk + 1 )
+    {
+      LoadChunk( i_chunk + 1 );
+    }
+    i_begin = i_chunk_end;
+  }
 
   return 0;
 }
@@ -163,6 +216,7 @@ spike_generator::SetArrayParam( int i_neuron, int n_neuron, std::string param_na
 {
   CheckNeuronIdx( i_neuron );
   CheckNeuronIdx( i_neuron + n_neuron - 1 );
+  EventsToVect();
 
   if ( param_name == array_param_name_[ i_SPIKE_TIME_ARRAY_PARAM ] )
   {
@@ -189,6 +243,7 @@ spike_generator::SetArrayParam( int i_neuron, int n_neuron, std::string param_na
 int
 spike_generator::SetArrayParam( int* i_neuron, int n_neuron, std::string param_name, float* array, int array_size )
 {
+  EventsToVect();
   if ( param_name == array_param_name_[ i_SPIKE_TIME_ARRAY_PARAM ] )
   {
     for ( int i = 0; i < n_neuron; i++ )
@@ -215,9 +270,189 @@ spike_generator::SetArrayParam( int* i_neuron, int n_neuron, std::string param_n
   return 0;
 }
 
+
+// Set the spike trains of the nodes i_neuron, ..., i_neuron + n_neuron - 1
+// from n_event events, in any order. event_node is relative to i_neuron,
+// event_height can be NULL for spikes of unit height
+int
+spike_generator::SetSpikeEvents( int i_neuron,
+  int n_neuron,
+  int64_t n_event,
+  const int* event_node,
+  const float* event_time,
+  const float* event_height )
+{
+  CheckNeuronIdx( i_neuron );
+  CheckNeuronIdx( i_neuron + n_neuron - 1 );
+
+  std::vector< SpikeEvent > event_vect( n_event );
+  for ( int64_t i = 0; i < n_event; i++ )
+  {
+    int in = event_node[ i ];
+    if ( in < 0 || in >= n_neuron )
+    {
+      throw ngpu_exception( std::string( "Spike event node index " ) + std::to_string( in ) + " out of range" );
+    }
+    SpikeEvent event = { event_time[ i ], i_neuron + in, event_height != NULL ? event_height[ i ] : 1.0f };
+    event_vect[ i ] = event;
+  }
+
+  return AddSpikeEvents( i_neuron, n_neuron, event_vect );
+}
+
+// Set the spike trains of the nodes i_neuron, ..., i_neuron + n_neuron - 1
+// from a binary file of events, each made of the node index relative to
+// i_neuron (int32) and the spike time in ms (float32), in native byte order.
+// The file is read in blocks, converted directly to the array of events
+int
+spike_generator::LoadSpikeEvents( int i_neuron, int n_neuron, std::string file_name )
+{
+  CheckNeuronIdx( i_neuron );
+  CheckNeuronIdx( i_neuron + n_neuron - 1 );
+
+  struct FileEvent
+  {
+    int node;
+    float time;
+  };
+  static_assert( sizeof( FileEvent ) == sizeof( int ) + sizeof( float ), "Wrong size of spike file event" );
+
+  FILE* fp = fopen( file_name.c_str(), "rb" );
+  if ( fp == NULL )
+  {
+    throw ngpu_exception( std::string( "Cannot open spike event file " ) + file_name );
+  }
+  fseek( fp, 0, SEEK_END );
+  int64_t file_size = ftell( fp );
+  fseek( fp, 0, SEEK_SET );
+  if ( file_size % sizeof( FileEvent ) != 0 )
+  {
+    fclose( fp );
+    throw ngpu_exception( std::string( "Wrong size of spike event file " ) + file_name );
+  }
+  int64_t n_event = file_size / sizeof( FileEvent );
+
+  std::vector< SpikeEvent > event_vect( n_event );
+  std::vector< FileEvent > block( std::min( n_event, ( int64_t ) 65536 ) );
+  for ( int64_t i0 = 0; i0 < n_event; i0 += block.size() )
+  {
+    int64_t n = std::min( n_event - i0, ( int64_t ) block.size() );
+    if ( ( int64_t ) fread( block.data(), sizeof( FileEvent ), n, fp ) != n )
+    {
+      fclose( fp );
+      throw ngpu_exception( std::string( "Error reading spike event file " ) + file_name );
+    }
+    for ( int64_t i = 0; i < n; i++ )
+    {
+      int in = block[ i ].node;
+      if ( in < 0 || in >= n_neuron )
+      {
+        fclose( fp );
+        throw ngpu_exception( std::string( "Spike event node index " ) + std::to_string( in ) + " out of range" );
+      }
+      SpikeEvent event = { block[ i ].time, i_neuron + in, 1.0f };
+      event_vect[ i0 + i ] = event;
+    }
+  }
+  fclose( fp );
+
+  return AddSpikeEvents( i_neuron, n_neuron, event_vect );
+}
+
+// Sort the events by time and node and merge them with the events
+// already set, replacing the spike trains of the nodes
+// i_neuron, ..., i_neuron + n_neuron - 1. The events are sorted in
+// parallel on contiguous parts of the array, which are then merged
+int
+spike_generator::AddSpikeEvents( int i_neuron, int n_neuron, std::vector< SpikeEvent >& event_vect )
+{
+  auto event_less = []( const SpikeEvent& a, const SpikeEvent& b )
+  { return a.time < b.time || ( a.time == b.time && a.node < b.node ); };
+
+  int n_part = 1;
+#ifdef _OPENMP
+  n_part = omp_get_max_threads();
+#endif
+  int64_t n_event = event_vect.size();
+  std::vector< int64_t > part_first( n_part + 1 );
+  for ( int i_part = 0; i_part <= n_part; i_part++ )
+  {
+    part_first[ i_part ] = n_event * i_part / n_part;
+  }
+  std::vector< SpikeEvent >::iterator first = event_vect.begin();
+#pragma omp parallel for
+  for ( int i_part = 0; i_part < n_part; i_part++ )
+  {
+    std::sort( first + part_first[ i_part ], first + part_first[ i_part + 1 ], event_less );
+  }
+  for ( int width = 1; width < n_part; width *= 2 )
+  {
+#pragma omp parallel for
+    for ( int i_part = 0; i_part < n_part - width; i_part += 2 * width )
+    {
+      std::inplace_merge( first + part_first[ i_part ],
+        first + part_first[ i_part + width ],
+        first + part_first[ std::min( i_part + 2 * width, n_part ) ],
+        event_less );
+    }
+  }
+
+  // the new events replace the spike trains of the nodes
+  for ( int in = i_neuron; in < i_neuron + n_neuron; in++ )
+  {
+    spike_time_vect_[ in ].clear();
+    spike_height_vect_[ in ].clear();
+  }
+  if ( event_vect_.empty() )
+  {
+    event_vect_.swap( event_vect );
+    return 0;
+  }
+  std::vector< SpikeEvent > old_event_vect;
+  old_event_vect.swap( event_vect_ );
+  old_event_vect.erase( std::remove_if( old_event_vect.begin(),
+                          old_event_vect.end(),
+                          [ i_neuron, n_neuron ]( const SpikeEvent& event )
+                          { return event.node >= i_neuron && event.node < i_neuron + n_neuron; } ),
+    old_event_vect.end() );
+  event_vect_.resize( old_event_vect.size() + event_vect.size() );
+  std::merge( old_event_vect.begin(),
+    old_event_vect.end(),
+    event_vect.begin(),
+    event_vect.end(),
+    event_vect_.begin(),
+    event_less );
+
+  return 0;
+}
+
+// Move the spike trains set from events to the per-node arrays,
+// before the array parameters of the nodes are accessed
+int
+spike_generator::EventsToVect()
+{
+  for ( const SpikeEvent& event : event_vect_ )
+  {
+    spike_time_vect_[ event.node ].push_back( event.time );
+    spike_height_vect_[ event.node ].push_back( event.height );
+  }
+  event_vect_.clear();
+  event_vect_.shrink_to_fit();
+
+  return 0;
+}
+
 int
 spike_generator::Calibrate( double time_min, float time_resolution )
 {
+  struct SpikeEntry
+  {
+    int time_idx;
+    int node;
+    float height;
+  };
+  std::vector< SpikeEntry > spike_vect;
+
   for ( int in = 0; in < n_node_; in++ )
   {
     unsigned int n_spikes = spike_time_vect_[ in ].size();
@@ -233,64 +468,96 @@ spike_generator::Calibrate( double time_min, float time_resolution )
           "spike time array and spike height array "
           "must have the same size in spike generator" );
       }
-      SetSpikes( in,
-        n_spikes,
-        spike_time_vect_[ in ].data(),
-        spike_height_vect_[ in ].data(),
-        ( float ) time_min,
-        time_resolution );
+      for ( unsigned int i = 0; i < n_spikes; i++ )
+      {
+        int time_idx = ( int ) round( ( spike_time_vect_[ in ][ i ] - ( float ) time_min ) / time_resolution );
+        if ( i > 0 && time_idx <= spike_vect.back().time_idx )
+        {
+          throw ngpu_exception(
+            "Spike times must be ordered, and the difference "
+            "between\nconsecutive spikes must be >= the "
+            "time resolution" );
+        }
+        SpikeEntry spike = { time_idx, in, spike_height_vect_[ in ][ i ] };
+        spike_vect.push_back( spike );
+      }
     }
   }
-
-  return 0;
-}
-
-
-int
-spike_generator::SetSpikes( int irel_node,
-  int n_spikes,
-  float* spike_time,
-  float* spike_height,
-  float time_min,
-  float time_resolution )
-{
-  if ( n_spikes <= 0 )
+  // the spikes of each node are already ordered by time,
+  // a stable sort keeps them ordered by node in each time step
+  std::stable_sort( spike_vect.begin(),
+    spike_vect.end(),
+    []( const SpikeEntry& a, const SpikeEntry& b ) { return a.time_idx < b.time_idx; } );
+
+  int64_t n_vect_spike = spike_vect.size();
+  int64_t n_event = event_vect_.size();
+  n_spike_ = n_vect_spike + n_event;
+  if ( n_spike_ == 0 )
   {
-    throw ngpu_exception(
-      "Number of spikes must be greater than 0 "
-      "in spike generator setting" );
+    return 0;
   }
-
-  cudaMemcpy( &d_n_spikes_[ irel_node ], &n_spikes, sizeof( int ), cudaMemcpyHostToDevice );
-  if ( h_spike_time_idx_[ irel_node ] != 0 )
+  spike_time_idx_.resize( n_spike_ );
+  gpuErrchk( cudaMallocHost( &h_spike_node_, n_spike_ * sizeof( int ) ) );
+  gpuErrchk( cudaMallocHost( &h_spike_height_, n_spike_ * sizeof( float ) ) );
+  // merge the spikes of the per-node arrays with the events,
+  // which are already sorted by time
+  std::vector< int > last_time_idx( n_event > 0 ? n_node_ : 0, std::numeric_limits< int >::min() );
+  int64_t i_vect = 0;
+  int64_t i_event = 0;
+  for ( int64_t i = 0; i < n_spike_; i++ )
   {
-    gpuErrchk( cudaFree( h_spike_time_idx_[ irel_node ] ) );
-    gpuErrchk( cudaFree( h_spike_height_[ irel_node ] ) );
+    int event_time_idx = 0;
+    if ( i_event < n_event )
+    {
+      event_time_idx = ( int ) round( ( event_vect_[ i_event ].time - ( float ) time_min ) / time_resolution );
+    }
+    if ( i_event == n_event || ( i_vect < n_vect_spike && spike_vect[ i_vect ].time_idx <= event_time_idx ) )
+    {
+      spike_time_idx_[ i ] = spike_vect[ i_vect ].time_idx;
+      h_spike_node_[ i ] = spike_vect[ i_vect ].node;
+      h_spike_height_[ i ] = spike_vect[ i_vect ].height;
+      i_vect++;
+    }
+    else
+    {
+      const SpikeEvent& event = event_vect_[ i_event ];
+      if ( event_time_idx <= last_time_idx[ event.node ] )
+      {
+        throw ngpu_exception(
+          "Spike times must be ordered, and the difference "
+          "between\nconsecutive spikes must be >= the "
+          "time resolution" );
+      }
+      last_time_idx[ event.node ] = event_time_idx;
+      spike_time_idx_[ i ] = event_time_idx;
+      h_spike_node_[ i ] = event.node;
+      h_spike_height_[ i ] = event.height;
+      i_event++;
+    }
   }
-  gpuErrchk( cudaMalloc( &h_spike_time_idx_[ irel_node ], n_spikes * sizeof( int ) ) );
-  gpuErrchk( cudaMalloc( &h_spike_height_[ irel_node ], n_spikes * sizeof( float ) ) );
-
-  cudaMemcpy(
-    &d_spike_time_idx_[ irel_node ], &h_spike_time_idx_[ irel_node ], sizeof( int* ), cudaMemcpyHostToDevice );
-  cudaMemcpy( &d_spike_height_[ irel_node ], &h_spike_height_[ irel_node ], sizeof( float* ), cudaMemcpyHostToDevice );
 
-  int* spike_time_idx = new int[ n_spikes ];
-  for ( int i = 0; i < n_spikes; i++ )
+  chunk_size_ = ( int64_t ) round( group_param_[ i_SPIKE_GEN_CHUNK_SIZE ] );
+  if ( chunk_size_ <= 0 || chunk_size_ > n_spike_ )
+  {
+    chunk_size_ = n_spike_;
+  }
+  // a single buffer is used if all the spikes fit in one chunk
+  int n_buf = chunk_size_ < n_spike_ ? 2 : 1;
+  gpuErrchk( cudaStreamCreateWithFlags( &copy_stream_, cudaStreamNonBlocking ) );
+  for ( int i_buf = 0; i_buf < 2; i_buf++ )
   {
-    spike_time_idx[ i ] = ( int ) round( ( spike_time[ i ] - time_min ) / time_resolution );
-    if ( i > 0 && spike_time_idx[ i ] <= spike_time_idx[ i - 1 ] )
+    if ( i_buf < n_buf )
     {
-      throw ngpu_exception(
-        "Spike times must be ordered, and the difference "
-        "between\nconsecutive spikes must be >= the "
-        "time resolution" );
+      gpuErrchk( cudaMalloc( &d_spike_node_[ i_buf ], chunk_size_ * sizeof( int ) ) );
+      gpuErrchk( cudaMalloc( &d_spike_height_[ i_buf ], chunk_size_ * sizeof( float ) ) );
     }
-    // cout << "ti " << spike_time_idx[i] << endl;
-    // cout << spike_time[i] << " " << time_min << endl;
+    gpuErrchk( cudaEventCreateWithFlags( &copy_done_event_[ i_buf ], cudaEventDisableTiming ) );
+    gpuErrchk( cudaEventCreateWithFlags( &buf_free_event_[ i_buf ], cudaEventDisableTiming ) );
+  }
+  for ( int64_t i_chunk = 0; i_chunk < n_buf; i_chunk++ )
+  {
+    LoadChunk( i_chunk );
   }
-
-  cudaMemcpy( h_spike_time_idx_[ irel_node ], spike_time_idx, n_spikes * sizeof( int ), cudaMemcpyHostToDevice );
-  cudaMemcpy( h_spike_height_[ irel_node ], spike_height, n_spikes * sizeof( float ), cudaMemcpyHostToDevice );
 
   return 0;
 }
@@ -298,6 +565,7 @@ spike_generator::SetSpikes( int irel_node,
 int
 spike_generator::GetArrayParamSize( int i_neuron, std::string param_name )
 {
+  EventsToVect();
   if ( param_name == array_param_name_[ i_SPIKE_TIME_ARRAY_PARAM ] )
   {
     return spike_time_vect_[ i_neuron ].size();
@@ -315,6 +583,7 @@ spike_generator::GetArrayParamSize( int i_neuron, std::string param_name )
 float*
 spike_generator::GetArrayParam( int i_neuron, std::string param_name )
 {
+  EventsToVect();
   if ( param_name == array_param_name_[ i_SPIKE_TIME_ARRAY_PARAM ] )
   {
     return spike_time_vect_[ i_neuron ].data();
@@ -26,7 +26,9 @@
 
 #include "cuda_error.h"
 #include <iostream>
+#include <stdint.h>
 #include <string>
+#include <vector>
 // #include "node_group.h"
 #include "base_neuron.h"
 #include "neuron_models.h"
@@ -68,6 +70,25 @@ having multiple spikes at once.
 The spikes are thus delivered with the weight indicated by
 the spike height multiplied with the weight of the connection.
 
+The spikes of all the generators of a group are copied to the GPU
+memory at calibration. For very long inputs, the group parameter
+chunk_size can be set to the maximum number of spikes kept in GPU
+memory: the spikes are then copied in chunks of chunk_size spikes,
+in order of time, while the simulation runs, and at most two chunks
+are stored in GPU memory at the same time.
+
+Large sets of spike trains can be set at once from arrays of events
+(node, time and optionally height) with NESTGPU::SetSpikeGeneratorEvents,
+or loaded from a binary file with NESTGPU::LoadSpikeGeneratorEvents
+(SetSpikeTrains and LoadSpikeTrains in Python).
+
+============== ======= =======================================
+**Group parameters:**
+--------------------------------------------------------------
+ chunk_size    int     Number of spikes per chunk, 0 for a
+                       single chunk. Default: 0
+============== ======= =======================================
+
 
 See also
 ++++++++
@@ -77,23 +98,49 @@ poisson_generator
 EndUserDocs
 */
 
+// spike event set from arrays or files of events
+struct SpikeEvent
+{
+  float time;   // spike time in ms
+  int node;     // index of the node in the group
+  float height; // spike height
+};
+
 class spike_generator : public BaseNeuron
 {
-  int* d_n_spikes_;
-  int* d_i_spike_;
-  int** d_spike_time_idx_;
-  float** d_spike_height_;
-  int** h_spike_time_idx_;
-  float** h_spike_height_;
   std::vector< std::vector< float > > spike_time_vect_;
   std::vector< std::vector< float > > spike_height_vect_;
 
-  int SetSpikes( int irel_node,
-    int n_spikes,
-    float* spike_time,
-    float* spike_height,
-    float time_min,
-    float time_resolution );
+  // spike trains set from events, sorted by time. They are stored
+  // in the order of emission and converted to per-node arrays only if
+  // the array parameters of the nodes are accessed
+  std::vector< SpikeEvent > event_vect_;
+
+  // spikes of all the nodes of the group sorted by time step,
+  // so that the spikes of a time step are contiguous.
+  // node and height are in pinned memory, to be copied asynchronously
+  // to the device in chunks
+  int64_t n_spike_;                   // total number of spikes
+  std::vector< int > spike_time_idx_; // time step index of the spikes
+  int* h_spike_node_;                 // relative index of the node
+  float* h_spike_height_;             // spike height
+  int64_t i_spike_;                   // first spike not emitted yet
+  long long i_step_;                  // index of the current time step
+
+  // double buffer of chunks of spikes on the device
+  int64_t chunk_size_; // number of spikes per chunk
+  int* d_spike_node_[ 2 ];
+  float* d_spike_height_[ 2 ];
+  int64_t buf_chunk_[ 2 ];           // chunk stored in each buffer, or -1
+  cudaStream_t copy_stream_;         // stream of the chunk copies
+  cudaEvent_t copy_done_event_[ 2 ]; // the copy to the buffer is done
+  cudaEvent_t buf_free_event_[ 2 ];  // the kernels using the buffer are done
+
+  int LoadChunk( int64_t i_chunk );
+
+  int AddSpikeEvents( int i_neuron, int n_neuron, std::vector< SpikeEvent >& event_vect );
+
+  int EventsToVect();
 
 public:
   ~spike_generator();
@@ -113,6 +160,15 @@ public:
   int GetArrayParamSize( int i_neuron, std::string param_name );
 
   float* GetArrayParam( int i_neuron, std::string param_name );
+
+  int SetSpikeEvents( int i_neuron,
+    int n_neuron,
+    int64_t n_event,
+    const int* event_node,
+    const float* event_time,
+    const float* event_height );
+
+  int LoadSpikeEvents( int i_neuron, int n_neuron, std::string file_name );
 };
 
 
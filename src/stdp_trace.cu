@@ -0,0 +1,172 @@
+/*
+ *  stdp_trace.cu
+ *
+ *  This file is part of NEST GPU.
+ *
+ *  Copyright (C) 2021 The NEST Initiative
+ *
+ *  NEST GPU is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NEST GPU is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NEST GPU.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "cuda_error.h"
+#include "ngpu_exception.h"
+#include "spike_buffer.h"
+#include "stdp_trace.h"
+#include <config.h>
+#include <iostream>
+#include <stdio.h>
+
+using namespace stdp_trace_ns;
+
+extern __constant__ long long NESTGPUTimeIdx;
+extern __constant__ float NESTGPUTimeResolution;
+
+// The presynaptic trace of a connection group (i.e. of the connections
+// of a source node with the same delay) is incremented when a spike
+// reaches its targets
+float* d_PreTrace;          // [n_conn_group]
+__device__ float* PreTrace; //
+
+long long* d_PreTraceTimeIdx;          // [n_conn_group]
+__device__ long long* PreTraceTimeIdx; //
+
+float* d_PostTrace;          // [n_node]
+__device__ float* PostTrace; //
+
+long long* d_PostTraceTimeIdx;          // [n_node]
+__device__ long long* PostTraceTimeIdx; //
+
+__device__ float PreTraceTau;
+__device__ float PostTraceTau;
+
+// Value of a trace at the current time step
+__device__ __forceinline__ double
+TraceValue( float trace, long long trace_time_idx, float tau )
+{
+  return trace * exp( -NESTGPUTimeResolution * ( double ) ( NESTGPUTimeIdx - trace_time_idx ) / tau );
+}
+
+__device__ void
+PreTraceUpdate( int i_conn_group, float height )
+{
+  PreTrace[ i_conn_group ] =
+    ( float ) ( TraceValue( PreTrace[ i_conn_group ], PreTraceTimeIdx[ i_conn_group ], PreTraceTau ) + height );
+  PreTraceTimeIdx[ i_conn_group ] = NESTGPUTimeIdx;
+}
+
+__device__ void
+PostTraceUpdate( int i_node )
+{
+  PostTrace[ i_node ] = ( float ) ( TraceValue( PostTrace[ i_node ], PostTraceTimeIdx[ i_node ], PostTraceTau ) + 1.0 );
+  PostTraceTimeIdx[ i_node ] = NESTGPUTimeIdx;
+}
+
+// Depression at the arrival of a presynaptic spike, paired with all
+// the previous spikes of the target node
+__device__ void
+STDPTraceDepress( float* weight_pt, int i_target, float* param )
+{
+  double lambda = param[ i_lambda ];
+  double alpha = param[ i_alpha ];
+  double mu_minus = param[ i_mu_minus ];
+  double Wmax = param[ i_Wmax ];
+
+  double post_trace = TraceValue( PostTrace[ i_target ], PostTraceTimeIdx[ i_target ], PostTraceTau );
+  double w = *weight_pt;
+  double w1 = w - alpha * lambda * Wmax * pow( w / Wmax, mu_minus ) * post_trace;
+
+  w1 = w1 > 0.0 ? w1 : 0.0;
+  w1 = w1 < Wmax ? w1 : Wmax;
+  *weight_pt = ( float ) w1;
+}
+
+// Potentiation at a postsynaptic spike, paired with all the presynaptic
+// spikes that have reached the synapse
+__device__ void
+STDPTracePotentiate( float* weight_pt, unsigned int i_conn, float* param )
+{
+  double lambda = param[ i_lambda ];
+  double mu_plus = param[ i_mu_plus ];
+  double Wmax = param[ i_Wmax ];
+
+  int i_conn_group = ConnGroupIdx( i_conn );
+  double pre_trace = TraceValue( PreTrace[ i_conn_group ], PreTraceTimeIdx[ i_conn_group ], PreTraceTau );
+  double w = *weight_pt;
+  double w1 = w + lambda * Wmax * pow( 1.0 - w / Wmax, mu_plus ) * pre_trace;
+
+  w1 = w1 > 0.0 ? w1 : 0.0;
+  w1 = w1 < Wmax ? w1 : Wmax;
+  *weight_pt = ( float ) w1;
+}
+
+__global__ void
+DeviceSTDPTraceInit( float* pre_trace,
+  long long* pre_trace_time_idx,
+  float* post_trace,
+  long long* post_trace_time_idx,
+  float tau_plus,
+  float tau_minus )
+{
+  PreTrace = pre_trace;
+  PreTraceTimeIdx = pre_trace_time_idx;
+  PostTrace = post_trace;
+  PostTraceTimeIdx = post_trace_time_idx;
+  PreTraceTau = tau_plus;
+  PostTraceTau = tau_minus;
+}
+
+int
+STDPTraceInit( NetConnection* net_connection, float tau_plus, float tau_minus )
+{
+  int n_node = net_connection->connection_.size();
+  int n_conn_group = h_NConnGroup;
+
+  gpuErrchk( cudaMalloc( &d_PreTrace, n_conn_group * sizeof( float ) ) );
+  gpuErrchk( cudaMalloc( &d_PreTraceTimeIdx, n_conn_group * sizeof( long long ) ) );
+  gpuErrchk( cudaMalloc( &d_PostTrace, n_node * sizeof( float ) ) );
+  gpuErrchk( cudaMalloc( &d_PostTraceTimeIdx, n_node * sizeof( long long ) ) );
+
+  // the traces are zero, so their time indexes are irrelevant
+  gpuErrchk( cudaMemset( d_PreTrace, 0, n_conn_group * sizeof( float ) ) );
+  gpuErrchk( cudaMemset( d_PreTraceTimeIdx, 0, n_conn_group * sizeof( long long ) ) );
+  gpuErrchk( cudaMemset( d_PostTrace, 0, n_node * sizeof( float ) ) );
+  gpuErrchk( cudaMemset( d_PostTraceTimeIdx, 0, n_node * sizeof( long long ) ) );
+
+  DeviceSTDPTraceInit<<< 1, 1 >>>(
+    d_PreTrace, d_PreTraceTimeIdx, d_PostTrace, d_PostTraceTimeIdx, tau_plus, tau_minus );
+  gpuErrchk( cudaPeekAtLastError() );
+  gpuErrchk( cudaDeviceSynchronize() );
+
+  return 0;
+}
+
+int
+STDPTrace::_Init()
+{
+  type_ = i_stdp_trace_model;
+  n_param_ = N_PARAM;
+  param_name_ = stdp_trace_param_name;
+  gpuErrchk( cudaMalloc( &d_param_arr_, n_param_ * sizeof( float ) ) );
+  SetParam( "tau_plus", 20.0 );
+  SetParam( "tau_minus", 20.0 );
+  SetParam( "lambda", 1.0e-4 );
+  SetParam( "alpha", 1.0 );
+  SetParam( "mu_plus", 1.0 );
+  SetParam( "mu_minus", 1.0 );
+  SetParam( "Wmax", 100.0 );
+
+  return 0;
+}
@@ -0,0 +1,138 @@
+/*
+ *  stdp_trace.h
+ *
+ *  This file is part of NEST GPU.
+ *
+ *  Copyright (C) 2021 The NEST Initiative
+ *
+ *  NEST GPU is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NEST GPU is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NEST GPU.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef STDPTRACE_H
+#define STDPTRACE_H
+
+#include "connect.h"
+#include "syn_model.h"
+
+/* BeginUserDocs: synapse, spike-timing-dependent plasticity
+
+Short description
++++++++++++++++++
+
+Synapse type for spike-timing dependent plasticity based on traces
+
+Description
++++++++++++
+
+The stdp_trace synapse model implements the same weight updates as
+the stdp model, with all-to-all pairing of the spikes as in the
+stdp_synapse model of NEST. Instead of storing the time of the last
+presynaptic spike in each connection, the spikes are paired through
+exponential traces:
+
+- a presynaptic trace for each source node and delay, incremented by
+  the spikes at their arrival time at the synapses, which is used
+  to potentiate the synapses at each postsynaptic spike;
+- a postsynaptic trace for each target node, incremented by its spikes
+  (after the dendritic delay), which is used to depress the synapses
+  at the arrival of each presynaptic spike.
+
+Since the traces are shared by all the synapses of a node, all the
+synapse groups of the stdp_trace model must have the same tau_plus
+and tau_minus, which must be set before calibration.
+
+Parameters
+++++++++++
+
+========== =======  ======================================================
+ tau_plus  ms       Time constant of the presynaptic trace, potentiation
+ tau_minus ms       Time constant of the postsynaptic trace, depression
+ lambda    real     Step size
+ alpha     real     Asymmetry parameter (scales depression increments as
+                    alpha*lambda)
+ mu_plus   real     Weight dependence exponent, potentiation
+ mu_minus  real     Weight dependence exponent, depression
+ Wmax      real     Maximum allowed weight
+========== =======  ======================================================
+
+
+References
+++++++++++
+
+.. [1] Guetig et al. (2003). Learning input correlations through nonlinear
+       temporally asymmetric hebbian plasticity. Journal of Neuroscience,
+       23:3697-3714 DOI: https://doi.org/10.1523/JNEUROSCI.23-09-03697.2003
+
+.. [2] Morrison A, Diesmann M, Gerstner W (2008). Phenomenological models of
+       synaptic plasticity based on spike timing. Biological Cybernetics,
+       98:459-478 DOI: https://doi.org/10.1007/s00422-008-0233-1
+
+
+EndUserDocs */
+
+class STDPTrace : public SynModel
+{
+  int _Init();
+
+public:
+  STDPTrace()
+  {
+    _Init();
+  }
+
+  int
+  Init()
+  {
+    return _Init();
+  }
+};
+
+namespace stdp_trace_ns
+{
+enum ParamIndexes
+{
+  i_tau_plus = 0,
+  i_tau_minus,
+  i_lambda,
+  i_alpha,
+  i_mu_plus,
+  i_mu_minus,
+  i_Wmax,
+  N_PARAM
+};
+
+const std::string stdp_trace_param_name[ N_PARAM ] = {
+  "tau_plus",
+  "tau_minus",
+  "lambda",
+  "alpha",
+  "mu_plus",
+  "mu_minus",
+  "Wmax"
+};
+
+}
+
+extern __device__ float* PreTrace;  // [n_conn_group]
+extern __device__ float* PostTrace; // [n_node]
+
+__device__ void PreTraceUpdate( int i_conn_group, float height );
+
+__device__ void PostTraceUpdate( int i_node );
+
+int STDPTraceInit( NetConnection* net_connection, float tau_plus, float tau_minus );
+
+#endif
@@ -0,0 +1,112 @@
+/*
+ *  stream_pool.cu
+ *
+ *  This file is part of NEST GPU.
+ *
+ *  Copyright (C) 2021 The NEST Initiative
+ *
+ *  NEST GPU is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NEST GPU is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NEST GPU.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+
+#include <config.h>
+
+#include "cuda_error.h"
+#include "stream_pool.h"
+
+StreamPool::~StreamPool()
+{
+  Free();
+}
+
+int
+StreamPool::Init( int n_stream )
+{
+  Free();
+  if ( n_stream <= 0 )
+  {
+    return 0;
+  }
+  // non-blocking streams do not synchronize implicitly with the
+  // default stream, the dependencies are given by Fork and Join
+  stream_vect_.resize( n_stream );
+  join_event_vect_.resize( n_stream );
+  for ( int i = 0; i < n_stream; i++ )
+  {
+    gpuErrchk( cudaStreamCreateWithFlags( &stream_vect_[ i ], cudaStreamNonBlocking ) );
+    gpuErrchk( cudaEventCreateWithFlags( &join_event_vect_[ i ], cudaEventDisableTiming ) );
+  }
+  gpuErrchk( cudaEventCreateWithFlags( &fork_event_, cudaEventDisableTiming ) );
+
+  return 0;
+}
+
+int
+StreamPool::Free()
+{
+  if ( stream_vect_.empty() )
+  {
+    return 0;
+  }
+  for ( unsigned int i = 0; i < stream_vect_.size(); i++ )
+  {
+    cudaStreamDestroy( stream_vect_[ i ] );
+    cudaEventDestroy( join_event_vect_[ i ] );
+  }
+  cudaEventDestroy( fork_event_ );
+  stream_vect_.clear();
+  join_event_vect_.clear();
+
+  return 0;
+}
+
+cudaStream_t
+StreamPool::Stream( int i )
+{
+  if ( stream_vect_.empty() )
+  {
+    return NULL;
+  }
+  return stream_vect_[ i % stream_vect_.size() ];
+}
+
+int
+StreamPool::Fork()
+{
+  if ( stream_vect_.empty() )
+  {
+    return 0;
+  }
+  gpuErrchk( cudaEventRecord( fork_event_, 0 ) );
+  for ( unsigned int i = 0; i < stream_vect_.size(); i++ )
+  {
+    gpuErrchk( cudaStreamWaitEvent( stream_vect_[ i ], fork_event_, 0 ) );
+  }
+
+  return 0;
+}
+
+int
+StreamPool::Join()
+{
+  for ( unsigned int i = 0; i < stream_vect_.size(); i++ )
+  {
+    gpuErrchk( cudaEventRecord( join_event_vect_[ i ], stream_vect_[ i ] ) );
+    gpuErrchk( cudaStreamWaitEvent( 0, join_event_vect_[ i ], 0 ) );
+  }
+
+  return 0;
+}
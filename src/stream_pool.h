@@ -0,0 +1,69 @@
+/*
+ *  stream_pool.h
+ *
+ *  This file is part of NEST GPU.
+ *
+ *  Copyright (C) 2021 The NEST Initiative
+ *
+ *  NEST GPU is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  NEST GPU is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with NEST GPU.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+
+#ifndef STREAMPOOL_H
+#define STREAMPOOL_H
+
+#include <vector>
+
+struct CUstream_st;
+typedef struct CUstream_st* cudaStream_t;
+struct CUevent_st;
+typedef struct CUevent_st* cudaEvent_t;
+
+// Pool of CUDA streams where the kernels of independent node groups run
+// concurrently. The kernels that depend on the work of all the groups
+// are issued in the default stream: Fork makes the streams of the pool
+// wait for the work previously issued in the default stream, Join makes
+// the default stream wait for the work issued in the streams of the pool.
+// With an empty pool all the kernels run in the default stream.
+class StreamPool
+{
+  std::vector< cudaStream_t > stream_vect_;
+  std::vector< cudaEvent_t > join_event_vect_;
+  cudaEvent_t fork_event_;
+
+public:
+  ~StreamPool();
+
+  int Init( int n_stream );
+
+  int Free();
+
+  int
+  NStream()
+  {
+    return stream_vect_.size();
+  }
+
+  // stream assigned to the i-th node group, NULL (default stream)
+  // if the pool is empty
+  cudaStream_t Stream( int i );
+
+  int Fork();
+
+  int Join();
+};
+
+#endif
@@ -25,6 +25,7 @@
 #include "nestgpu.h"
 #include "ngpu_exception.h"
 #include "stdp.h"
+#include "stdp_trace.h"
 #include "syn_model.h"
 #include "test_syn_model.h"
 #include <config.h>
@@ -40,6 +41,10 @@ __device__ void TestSynModelUpdate( float* w, float Dt, float* param );
 
 __device__ void STDPUpdate( float* w, float Dt, float* param );
 
+__device__ void STDPTraceDepress( float* w, int i_target, float* param );
+
+__device__ void STDPTracePotentiate( float* w, unsigned int i_conn, float* param );
+
 __device__ void
 SynapseUpdate( int syn_group, float* w, float Dt )
 {
@@ -56,6 +61,38 @@ SynapseUpdate( int syn_group, float* w, float Dt )
   }
 }
 
+// Updates of the synapses of the trace-based models at the arrival of
+// a presynaptic spike and at a postsynaptic spike. They return false
+// for the other models, which are updated by SynapseUpdate using the
+// time of the last presynaptic spike stored in the connection
+__device__ bool
+SynapsePreSpikeUpdate( int syn_group, float* w, int i_target )
+{
+  int syn_type = SynGroupTypeMap[ syn_group - 1 ];
+  float* param = SynGroupParamMap[ syn_group - 1 ];
+  switch ( syn_type )
+  {
+  case i_stdp_trace_model:
+    STDPTraceDepress( w, i_target, param );
+    return true;
+  }
+  return false;
+}
+
+__device__ bool
+SynapsePostSpikeUpdate( int syn_group, float* w, unsigned int i_conn )
+{
+  int syn_type = SynGroupTypeMap[ syn_group - 1 ];
+  float* param = SynGroupParamMap[ syn_group - 1 ];
+  switch ( syn_type )
+  {
+  case i_stdp_trace_model:
+    STDPTracePotentiate( w, i_conn, param );
+    return true;
+  }
+  return false;
+}
+
 
 __global__ void
 SynGroupInit( int* syn_group_type_map, float** syn_group_param_map )
@@ -158,6 +195,11 @@ NESTGPU::CreateSynGroup( std::string model_name )
     STDP* stdp_group = new STDP;
     syn_group_vect_.push_back( stdp_group );
   }
+  else if ( model_name == syn_model_name[ i_stdp_trace_model ] )
+  {
+    STDPTrace* stdp_trace_group = new STDPTrace;
+    syn_group_vect_.push_back( stdp_trace_group );
+  }
   else
   {
     throw ngpu_exception( std::string( "Unknown synapse model name: " ) + model_name );
@@ -261,3 +303,36 @@ NESTGPU::SynGroupCalibrate()
 
   return 0;
 }
+
+// Allocates the traces of the trace-based models, if they are used
+int
+NESTGPU::STDPTraceCalibrate()
+{
+  bool stdp_trace_flag = false;
+  float tau_plus = 0.0;
+  float tau_minus = 0.0;
+  for ( unsigned int i = 0; i < syn_group_vect_.size(); i++ )
+  {
+    if ( syn_group_vect_[ i ]->type_ != i_stdp_trace_model )
+    {
+      continue;
+    }
+    float tau_plus_i = syn_group_vect_[ i ]->GetParam( "tau_plus" );
+    float tau_minus_i = syn_group_vect_[ i ]->GetParam( "tau_minus" );
+    if ( stdp_trace_flag && ( tau_plus_i != tau_plus || tau_minus_i != tau_minus ) )
+    {
+      throw ngpu_exception(
+        "All the synapse groups of the stdp_trace model "
+        "must have the same tau_plus and tau_minus" );
+    }
+    stdp_trace_flag = true;
+    tau_plus = tau_plus_i;
+    tau_minus = tau_minus_i;
+  }
+  if ( stdp_trace_flag )
+  {
+    STDPTraceInit( net_connection_, tau_plus, tau_minus );
+  }
+
+  return 0;
+}
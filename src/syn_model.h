@@ -33,10 +33,11 @@ enum SynModels
   i_null_syn_model = 0,
   i_test_syn_model,
   i_stdp_model,
+  i_stdp_trace_model,
   N_SYN_MODELS
 };
 
-const std::string syn_model_name[ N_SYN_MODELS ] = { "", "test_syn_model", "stdp" };
+const std::string syn_model_name[ N_SYN_MODELS ] = { "", "test_syn_model", "stdp", "stdp_trace" };
 
 class SynModel
 {
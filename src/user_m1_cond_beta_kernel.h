@@ -82,6 +82,8 @@ enum GroupParamIndexes
 {
   i_h_min_rel = 0, // Min. step in ODE integr. relative to time resolution
   i_h0_rel,        // Starting step in ODE integr. relative to time resolution
+  i_warp_step,     // If not 0, the neurons of a warp share the integration step
+  i_integrator,    // ODE integrator: 0 adaptive RK5, 1 exp. Euler, 2 Rosenbrock
   N_GROUP_PARAM
 };
 
@@ -107,7 +109,7 @@ const std::string user_m1_scal_param_name[ N_SCAL_PARAM ] = { "V_th",
 
 const std::string user_m1_port_param_name[ N_PORT_PARAM ] = { "E_rev", "tau_rise", "tau_decay", "g0" };
 
-const std::string user_m1_group_param_name[ N_GROUP_PARAM ] = { "h_min_rel", "h0_rel" };
+const std::string user_m1_group_param_name[ N_GROUP_PARAM ] = { "h_min_rel", "h0_rel", "warp_step", "integrator" };
 
 //
 // I know that defines are "bad", but the defines below make the
@@ -146,6 +148,8 @@ const std::string user_m1_group_param_name[ N_GROUP_PARAM ] = { "h_min_rel", "h0
 
 #define h_min_rel_ group_param_[ i_h_min_rel ]
 #define h0_rel_ group_param_[ i_h0_rel ]
+#define warp_step_ group_param_[ i_warp_step ]
+#define integrator_ group_param_[ i_integrator ]
 
 
 template < int NVAR, int NPARAM > //, class DataStruct>
@@ -259,4 +263,16 @@ ExternalUpdate( double x, float* y, float* param, bool end_time_step, user_m1_rk
 }
 
 
+// refractory_step is the only parameter modified by ExternalUpdate
+template <>
+struct RK5MutableParam< user_m1_rk5 >
+{
+  static const int N_MUTABLE = 1;
+  __host__ __device__ static int
+  Idx( int i_mut )
+  {
+    return user_m1_ns::i_refractory_step;
+  }
+};
+
 #endif